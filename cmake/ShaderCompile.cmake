@@ -1,9 +1,10 @@
-function(compile_shader SHADERS TARGET_NAME SHADER_INCLUDE_FOLDER GENERATED_DIR GLSLANG_BIN)
+function(compile_shader SHADERS TARGET_NAME SHADER_INCLUDE_FOLDER GENERATED_DIR GLSLANG_BIN REFLECT_TARGET)
 
     set(working_dir "${CMAKE_CURRENT_SOURCE_DIR}")
 
     set(ALL_GENERATED_SPV_FILES "")
     set(ALL_GENERATED_CPP_FILES "")
+    set(ALL_GENERATED_LAYOUT_FILES "")
 
     if(UNIX)
         execute_process(COMMAND chmod a+x ${GLSLANG_BIN})
@@ -14,9 +15,11 @@ function(compile_shader SHADERS TARGET_NAME SHADER_INCLUDE_FOLDER GENERATED_DIR
         get_filename_component(SHADER_NAME ${SHADER} NAME)
         string(REPLACE "." "_" HEADER_NAME ${SHADER_NAME})
         string(TOUPPER ${HEADER_NAME} GLOBAL_SHADER_VAR)
+        string(TOLOWER ${HEADER_NAME} LAYOUT_NAMESPACE)
 
         set(SPV_FILE "${CMAKE_CURRENT_SOURCE_DIR}/${GENERATED_DIR}/spv/${SHADER_NAME}.spv")
         set(CPP_FILE "${CMAKE_CURRENT_SOURCE_DIR}/${GENERATED_DIR}/cpp/${HEADER_NAME}.h")
+        set(LAYOUT_FILE "${CMAKE_CURRENT_SOURCE_DIR}/${GENERATED_DIR}/cpp/${HEADER_NAME}_layout.h")
 
         add_custom_command(
             OUTPUT ${SPV_FILE}
@@ -35,9 +38,18 @@ function(compile_shader SHADERS TARGET_NAME SHADER_INCLUDE_FOLDER GENERATED_DIR
 
         list(APPEND ALL_GENERATED_CPP_FILES ${CPP_FILE})
 
+    # Descriptor, push constant, vertex input and block layouts reflected from the SPIR-V
+        add_custom_command(
+            OUTPUT ${LAYOUT_FILE}
+            COMMAND ${REFLECT_TARGET} ${SPV_FILE} ${LAYOUT_FILE} ${LAYOUT_NAMESPACE}
+            DEPENDS ${SPV_FILE} ${REFLECT_TARGET}
+            WORKING_DIRECTORY "${working_dir}")
+
+        list(APPEND ALL_GENERATED_LAYOUT_FILES ${LAYOUT_FILE})
+
     endforeach()
 
     add_custom_target(${TARGET_NAME}
-        DEPENDS ${ALL_GENERATED_SPV_FILES} ${ALL_GENERATED_CPP_FILES} SOURCES ${SHADERS})
+        DEPENDS ${ALL_GENERATED_SPV_FILES} ${ALL_GENERATED_CPP_FILES} ${ALL_GENERATED_LAYOUT_FILES} SOURCES ${SHADERS})
 
 endfunction()
\ No newline at end of file
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "runtime/core/meta/json.h"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Polaris
+{
+    struct BenchmarkOptions
+    {
+        std::vector<uint32_t> m_object_counts {1000, 10000, 100000};
+        float                 m_mesh_ratio {0.5f};
+        uint32_t              m_sub_mesh_count {2};
+        // share of objects moved before every tick, which makes their mesh parts dirty
+        float    m_dirty_ratio {0.1f};
+        uint32_t m_tick_count {100};
+        uint32_t m_warmup_count {1};
+        uint32_t m_repeat_count {5};
+        std::string m_output_file;
+    };
+
+    struct BenchmarkStats
+    {
+        std::string m_name;
+        uint32_t    m_object_count {0};
+        uint32_t    m_sample_count {0};
+        double      m_min_ms {0.0};
+        double      m_median_ms {0.0};
+        double      m_mean_ms {0.0};
+        double      m_stddev_ms {0.0};
+        double      m_p95_ms {0.0};
+        double      m_max_ms {0.0};
+
+        static BenchmarkStats fromSamples(const std::string& name, uint32_t object_count, std::vector<double> samples);
+        static BenchmarkStats fromJson(const Json& json);
+        Json                  toJson() const;
+    };
+
+    /**
+     *  Runs every benchmark for every object count of the options. Each measurement is
+     *  run m_warmup_count times unrecorded and then m_repeat_count times, the median of
+     *  the repetitions is what comparisons look at
+     */
+    class PolarisBenchmark
+    {
+    public:
+        explicit PolarisBenchmark(const BenchmarkOptions& options);
+
+        Json run();
+
+        /**
+         *  Compare two result files and print every benchmark whose median got slower
+         *  than threshold_percent. Returns the number of regressions, or -1 if a file
+         *  could not be read
+         */
+        static int compare(const std::string& baseline_file, const std::string& current_file, double threshold_percent);
+
+    private:
+        void runLevelBenchmarks(uint32_t object_count);
+        void runSerializationBenchmarks(uint32_t object_count, const std::string& level_url);
+        void runMathBenchmarks(uint32_t object_count);
+
+        // time measure_function, which returns the milliseconds of the part it wants measured
+        void measure(const std::string& name, uint32_t object_count, const std::function<double()>& measure_function);
+
+    private:
+        BenchmarkOptions            m_options;
+        std::vector<BenchmarkStats> m_results;
+    };
+} // namespace Polaris
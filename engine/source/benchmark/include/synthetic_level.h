@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace Polaris
+{
+    struct SyntheticLevelDesc
+    {
+        uint32_t m_object_count {1000};
+        // share of objects that also carry a MeshComponent, the others only have a TransformComponent
+        float    m_mesh_ratio {0.5f};
+        uint32_t m_sub_mesh_count {2};
+        uint32_t m_seed {1};
+    };
+
+    /**
+     *  Write a level of m_object_count instances spread over a grid, plus the object
+     *  definitions it references and a camera looking down on the grid, below
+     *  asset/benchmark of the binary root folder.
+     *  Every instance stores its position as a delta against its definition, like
+     *  levels saved by the editor. Sub meshes are cooked into lods by MeshCooker
+     */
+    class SyntheticLevel
+    {
+    public:
+        static const char* k_folder_url;
+
+        // returns the level url, empty on failure
+        static std::string generate(const SyntheticLevelDesc& desc);
+
+        // remove everything written by generate
+        static void clear();
+    };
+} // namespace Polaris
@@ -0,0 +1,393 @@
+#include "benchmark/include/benchmark.h"
+#include "benchmark/include/synthetic_level.h"
+
+#include "runtime/core/base/macro.h"
+#include "runtime/core/math/math_headers.h"
+#include "runtime/core/meta/serializer/serializer.h"
+
+#include "runtime/function/framework/component/transform/transform_component.h"
+#include "runtime/function/framework/level/level.h"
+#include "runtime/function/framework/object/object.h"
+
+#include "runtime/resource/asset_manager/asset_manager.h"
+#include "runtime/resource/res_type/common/level.h"
+
+#include "_generated/serializer/all_serializer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+
+namespace Polaris
+{
+    namespace
+    {
+        using BenchmarkClock = std::chrono::steady_clock;
+
+        double elapsedMs(BenchmarkClock::time_point begin)
+        {
+            return std::chrono::duration<double, std::milli>(BenchmarkClock::now() - begin).count();
+        }
+
+        bool readJsonFile(const std::string& file_path, Json& out_json)
+        {
+            std::ifstream json_file(file_path);
+            if (!json_file)
+            {
+                std::cerr << "open file " << file_path << " failed!" << std::endl;
+                return false;
+            }
+
+            std::stringstream buffer;
+            buffer << json_file.rdbuf();
+
+            std::string error;
+            out_json = Json::parse(buffer.str(), error);
+            if (!error.empty())
+            {
+                std::cerr << "parse json file " << file_path << " failed: " << error << std::endl;
+                return false;
+            }
+            return true;
+        }
+
+        // keeps the optimizer from dropping the math kernels
+        volatile float g_benchmark_sink = 0.f;
+    } // namespace
+
+    BenchmarkStats BenchmarkStats::fromSamples(const std::string& name, uint32_t object_count, std::vector<double> samples)
+    {
+        BenchmarkStats stats;
+        stats.m_name         = name;
+        stats.m_object_count = object_count;
+        stats.m_sample_count = static_cast<uint32_t>(samples.size());
+        if (samples.empty())
+        {
+            return stats;
+        }
+
+        std::sort(samples.begin(), samples.end());
+
+        double total_ms = 0.0;
+        for (double sample : samples)
+        {
+            total_ms += sample;
+        }
+        stats.m_mean_ms = total_ms / samples.size();
+
+        double variance = 0.0;
+        for (double sample : samples)
+        {
+            variance += (sample - stats.m_mean_ms) * (sample - stats.m_mean_ms);
+        }
+        stats.m_stddev_ms = std::sqrt(variance / samples.size());
+
+        const size_t middle = samples.size() / 2;
+        stats.m_median_ms =
+            samples.size() % 2 == 1 ? samples[middle] : 0.5 * (samples[middle - 1] + samples[middle]);
+        stats.m_min_ms = samples.front();
+        stats.m_max_ms = samples.back();
+        stats.m_p95_ms = samples[std::min(samples.size() - 1, samples.size() * 95 / 100)];
+        return stats;
+    }
+
+    BenchmarkStats BenchmarkStats::fromJson(const Json& json)
+    {
+        BenchmarkStats stats;
+        stats.m_name         = json["name"].string_value();
+        stats.m_object_count = static_cast<uint32_t>(json["object_count"].int_value());
+        stats.m_sample_count = static_cast<uint32_t>(json["sample_count"].int_value());
+        stats.m_min_ms       = json["min_ms"].number_value();
+        stats.m_median_ms    = json["median_ms"].number_value();
+        stats.m_mean_ms      = json["mean_ms"].number_value();
+        stats.m_stddev_ms    = json["stddev_ms"].number_value();
+        stats.m_p95_ms       = json["p95_ms"].number_value();
+        stats.m_max_ms       = json["max_ms"].number_value();
+        return stats;
+    }
+
+    Json BenchmarkStats::toJson() const
+    {
+        return Json::object {{"name", m_name},
+                             {"object_count", static_cast<int>(m_object_count)},
+                             {"sample_count", static_cast<int>(m_sample_count)},
+                             {"min_ms", m_min_ms},
+                             {"median_ms", m_median_ms},
+                             {"mean_ms", m_mean_ms},
+                             {"stddev_ms", m_stddev_ms},
+                             {"p95_ms", m_p95_ms},
+                             {"max_ms", m_max_ms}};
+    }
+
+    PolarisBenchmark::PolarisBenchmark(const BenchmarkOptions& options) : m_options(options) {}
+
+    Json PolarisBenchmark::run()
+    {
+        m_results.clear();
+
+        for (uint32_t object_count : m_options.m_object_counts)
+        {
+            LOG_INFO("benchmark with {} objects", object_count);
+            runLevelBenchmarks(object_count);
+            runMathBenchmarks(object_count);
+        }
+        SyntheticLevel::clear();
+
+        Json::array object_counts;
+        for (uint32_t object_count : m_options.m_object_counts)
+        {
+            object_counts.push_back(static_cast<int>(object_count));
+        }
+
+        Json::array results;
+        for (const BenchmarkStats& stats : m_results)
+        {
+            results.push_back(stats.toJson());
+        }
+
+        return Json::object {{"options",
+                              Json::object {{"object_counts", object_counts},
+                                            {"mesh_ratio", m_options.m_mesh_ratio},
+                                            {"sub_mesh_count", static_cast<int>(m_options.m_sub_mesh_count)},
+                                            {"dirty_ratio", m_options.m_dirty_ratio},
+                                            {"tick_count", static_cast<int>(m_options.m_tick_count)},
+                                            {"warmup_count", static_cast<int>(m_options.m_warmup_count)},
+                                            {"repeat_count", static_cast<int>(m_options.m_repeat_count)}}},
+                             {"results", results}};
+    }
+
+    void PolarisBenchmark::measure(const std::string&             name,
+                                   uint32_t                       object_count,
+                                   const std::function<double()>& measure_function)
+    {
+        for (uint32_t warmup_index = 0; warmup_index < m_options.m_warmup_count; ++warmup_index)
+        {
+            measure_function();
+        }
+
+        std::vector<double> samples;
+        samples.reserve(m_options.m_repeat_count);
+        for (uint32_t repeat_index = 0; repeat_index < m_options.m_repeat_count; ++repeat_index)
+        {
+            samples.push_back(measure_function());
+        }
+
+        m_results.push_back(BenchmarkStats::fromSamples(name, object_count, std::move(samples)));
+
+        const BenchmarkStats& stats = m_results.back();
+        LOG_INFO("{} ({} objects): median {:.3f} ms, min {:.3f} ms, stddev {:.3f} ms",
+                 name,
+                 object_count,
+                 stats.m_median_ms,
+                 stats.m_min_ms,
+                 stats.m_stddev_ms);
+    }
+
+    void PolarisBenchmark::runLevelBenchmarks(uint32_t object_count)
+    {
+        SyntheticLevelDesc level_desc;
+        level_desc.m_object_count   = object_count;
+        level_desc.m_mesh_ratio     = m_options.m_mesh_ratio;
+        level_desc.m_sub_mesh_count = m_options.m_sub_mesh_count;
+
+        const std::string level_url = SyntheticLevel::generate(level_desc);
+        if (level_url.empty())
+        {
+            LOG_ERROR("failed to generate a level of {} objects", object_count);
+            return;
+        }
+
+        // serialization runs on the generated file, before saving rewrites it
+        runSerializationBenchmarks(object_count, level_url);
+
+        measure("level_load", object_count, [&level_url]() {
+            Level level;
+
+            const BenchmarkClock::time_point begin = BenchmarkClock::now();
+            level.load(level_url);
+            const double load_ms = elapsedMs(begin);
+
+            level.unload();
+            return load_ms;
+        });
+
+        Level level;
+        if (!level.load(level_url))
+        {
+            LOG_ERROR("failed to load {}", level_url);
+            return;
+        }
+
+        std::vector<TransformComponent*> moving_transforms;
+        const size_t moving_count = static_cast<size_t>(level.getAllGObjects().size() * m_options.m_dirty_ratio);
+        for (const auto& id_object_pair : level.getAllGObjects())
+        {
+            if (moving_transforms.size() >= moving_count)
+                break;
+
+            TransformComponent* transform_component = id_object_pair.second->tryGetComponent(TransformComponent);
+            if (transform_component)
+            {
+                moving_transforms.push_back(transform_component);
+            }
+        }
+
+        // one sample is the average tick of m_tick_count ticks, moving objects are updated outside the timing
+        const float fixed_delta_time = 1.f / 60.f;
+        measure("level_tick", object_count, [this, &level, &moving_transforms, fixed_delta_time]() {
+            double tick_ms = 0.0;
+            for (uint32_t tick_index = 0; tick_index < m_options.m_tick_count; ++tick_index)
+            {
+                for (TransformComponent* transform_component : moving_transforms)
+                {
+                    transform_component->setPosition(transform_component->getPosition() + Vector3(0.f, 0.f, 0.01f));
+                }
+
+                const BenchmarkClock::time_point begin = BenchmarkClock::now();
+                level.tick(fixed_delta_time);
+                tick_ms += elapsedMs(begin);
+            }
+            return m_options.m_tick_count > 0 ? tick_ms / m_options.m_tick_count : 0.0;
+        });
+
+        measure("level_save", object_count, [&level]() {
+            const BenchmarkClock::time_point begin = BenchmarkClock::now();
+            level.save();
+            return elapsedMs(begin);
+        });
+
+        level.unload();
+    }
+
+    void PolarisBenchmark::runSerializationBenchmarks(uint32_t object_count, const std::string& level_url)
+    {
+        LevelRes level_res;
+        if (!g_runtime_global_context.m_asset_manager->loadAsset(level_url, level_res))
+        {
+            LOG_ERROR("failed to load {}", level_url);
+            return;
+        }
+
+        std::string level_json_text;
+        measure("serialize_write", object_count, [&level_res, &level_json_text]() {
+            const BenchmarkClock::time_point begin = BenchmarkClock::now();
+            level_json_text = Serializer::write(level_res).dump();
+            return elapsedMs(begin);
+        });
+
+        measure("serialize_read", object_count, [&level_json_text]() {
+            LevelRes read_level_res;
+
+            const BenchmarkClock::time_point begin = BenchmarkClock::now();
+            std::string error;
+            Serializer::read(Json::parse(level_json_text, error), read_level_res);
+            return elapsedMs(begin);
+        });
+    }
+
+    void PolarisBenchmark::runMathBenchmarks(uint32_t object_count)
+    {
+        std::mt19937                          random_engine(object_count);
+        std::uniform_real_distribution<float> distribution(-1.f, 1.f);
+
+        std::vector<Transform> transforms(object_count);
+        std::vector<Vector3>   vectors(object_count);
+        for (uint32_t index = 0; index < object_count; ++index)
+        {
+            const Vector3 axis = Vector3(distribution(random_engine), distribution(random_engine), 1.f).normalisedCopy();
+            transforms[index]  = Transform(Vector3(distribution(random_engine), distribution(random_engine), 0.f),
+                                          Quaternion(Radian(distribution(random_engine) * Math_PI), axis),
+                                          Vector3::UNIT_SCALE);
+            vectors[index]     = Vector3(distribution(random_engine), distribution(random_engine), distribution(random_engine));
+        }
+
+        // world matrix of every object below a shared parent
+        measure("math_transform", object_count, [&transforms]() {
+            const Matrix4x4 parent_matrix = Transform(Vector3(1.f, 2.f, 3.f), Quaternion::IDENTITY, Vector3::UNIT_SCALE).getMatrix();
+
+            const BenchmarkClock::time_point begin = BenchmarkClock::now();
+            float checksum = 0.f;
+            for (const Transform& transform : transforms)
+            {
+                const Matrix4x4 world_matrix = parent_matrix * transform.getMatrix();
+                checksum += world_matrix[0][3];
+            }
+            const double elapsed_ms = elapsedMs(begin);
+
+            g_benchmark_sink = checksum;
+            return elapsed_ms;
+        });
+
+        measure("math_vector", object_count, [&transforms, &vectors]() {
+            const BenchmarkClock::time_point begin = BenchmarkClock::now();
+            float checksum = 0.f;
+            for (size_t index = 0; index < vectors.size(); ++index)
+            {
+                Vector3 rotated = transforms[index].m_rotation * vectors[index];
+                Vector3 normal  = rotated.crossProduct(Vector3::UNIT_Z);
+                normal.normalise();
+                checksum += normal.dotProduct(vectors[index]);
+            }
+            const double elapsed_ms = elapsedMs(begin);
+
+            g_benchmark_sink = checksum;
+            return elapsed_ms;
+        });
+    }
+
+    int PolarisBenchmark::compare(const std::string& baseline_file, const std::string& current_file, double threshold_percent)
+    {
+        Json baseline_json;
+        Json current_json;
+        if (!readJsonFile(baseline_file, baseline_json) || !readJsonFile(current_file, current_json))
+        {
+            return -1;
+        }
+
+        // key: benchmark name and object count
+        std::map<std::pair<std::string, uint32_t>, BenchmarkStats> baseline_results;
+        for (const Json& result_json : baseline_json["results"].array_items())
+        {
+            BenchmarkStats stats = BenchmarkStats::fromJson(result_json);
+            baseline_results.emplace(std::make_pair(stats.m_name, stats.m_object_count), stats);
+        }
+
+        int regression_count = 0;
+        std::cout << std::left << std::setw(20) << "benchmark" << std::right << std::setw(10) << "objects"
+                  << std::setw(14) << "baseline ms" << std::setw(14) << "current ms" << std::setw(10) << "change"
+                  << std::endl;
+        for (const Json& result_json : current_json["results"].array_items())
+        {
+            const BenchmarkStats current = BenchmarkStats::fromJson(result_json);
+
+            auto baseline_iter = baseline_results.find(std::make_pair(current.m_name, current.m_object_count));
+            if (baseline_iter == baseline_results.end() || baseline_iter->second.m_median_ms <= 0.0)
+            {
+                continue;
+            }
+
+            const BenchmarkStats& baseline = baseline_iter->second;
+            const double change_percent = (current.m_median_ms / baseline.m_median_ms - 1.0) * 100.0;
+
+            // a change within the spread of the baseline is noise, not a regression
+            const bool is_regression = change_percent > threshold_percent &&
+                                       current.m_median_ms - baseline.m_median_ms > 2.0 * baseline.m_stddev_ms;
+            regression_count += is_regression ? 1 : 0;
+
+            std::cout << std::left << std::setw(20) << current.m_name << std::right << std::setw(10)
+                      << current.m_object_count << std::fixed << std::setprecision(3) << std::setw(14)
+                      << baseline.m_median_ms << std::setw(14) << current.m_median_ms << std::setprecision(1)
+                      << std::showpos << std::setw(9) << change_percent << "%" << std::noshowpos
+                      << (is_regression ? "  REGRESSION" : "") << std::endl;
+        }
+
+        std::cout << regression_count << " regression(s) above " << threshold_percent << "%" << std::endl;
+        return regression_count;
+    }
+} // namespace Polaris
@@ -0,0 +1,123 @@
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "runtime/engine.h"
+
+#include "benchmark/include/benchmark.h"
+
+namespace
+{
+	void printUsage()
+	{
+		std::cout << "usage:\n"
+				  << "  PolarisBenchmark [--objects 1000,10000,100000] [--mesh-ratio 0.5] [--sub-meshes 2]\n"
+				  << "                   [--dirty-ratio 0.1] [--ticks 100] [--warmup 1] [--repeat 5] [--output result.json]\n"
+				  << "  PolarisBenchmark --compare baseline.json current.json [--threshold 5]\n";
+	}
+
+	bool parseObjectCounts(const std::string& value, std::vector<uint32_t>& out_object_counts)
+	{
+		out_object_counts.clear();
+
+		std::stringstream value_stream(value);
+		std::string       object_count;
+		while (std::getline(value_stream, object_count, ','))
+		{
+			out_object_counts.push_back(static_cast<uint32_t>(std::stoul(object_count)));
+		}
+		return !out_object_counts.empty();
+	}
+} // namespace
+
+int main(int argc, char** argv)
+{
+	Polaris::BenchmarkOptions options;
+	std::string               compare_files[2];
+	double                    threshold_percent = 5.0;
+
+	try
+	{
+		for (int arg_index = 1; arg_index < argc; ++arg_index)
+		{
+			const std::string arg = argv[arg_index];
+			const bool has_value = arg_index + 1 < argc;
+
+			if (arg == "--compare" && arg_index + 2 < argc)
+			{
+				compare_files[0] = argv[++arg_index];
+				compare_files[1] = argv[++arg_index];
+			}
+			else if (arg == "--threshold" && has_value)
+				threshold_percent = std::stod(argv[++arg_index]);
+			else if (arg == "--objects" && has_value)
+			{
+				if (!parseObjectCounts(argv[++arg_index], options.m_object_counts))
+				{
+					printUsage();
+					return EXIT_FAILURE;
+				}
+			}
+			else if (arg == "--mesh-ratio" && has_value)
+				options.m_mesh_ratio = std::stof(argv[++arg_index]);
+			else if (arg == "--sub-meshes" && has_value)
+				options.m_sub_mesh_count = static_cast<uint32_t>(std::stoul(argv[++arg_index]));
+			else if (arg == "--dirty-ratio" && has_value)
+				options.m_dirty_ratio = std::stof(argv[++arg_index]);
+			else if (arg == "--ticks" && has_value)
+				options.m_tick_count = static_cast<uint32_t>(std::stoul(argv[++arg_index]));
+			else if (arg == "--warmup" && has_value)
+				options.m_warmup_count = static_cast<uint32_t>(std::stoul(argv[++arg_index]));
+			else if (arg == "--repeat" && has_value)
+				options.m_repeat_count = static_cast<uint32_t>(std::stoul(argv[++arg_index]));
+			else if (arg == "--output" && has_value)
+				options.m_output_file = argv[++arg_index];
+			else
+			{
+				printUsage();
+				return EXIT_FAILURE;
+			}
+		}
+	}
+	catch (const std::exception&)
+	{
+		printUsage();
+		return EXIT_FAILURE;
+	}
+
+	// comparing result files does not need the engine
+	if (!compare_files[0].empty())
+	{
+		const int regression_count = Polaris::PolarisBenchmark::compare(compare_files[0], compare_files[1], threshold_percent);
+		return regression_count == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	std::filesystem::path executable_path(argv[0]);
+	std::filesystem::path config_file_path = executable_path.parent_path() / "PolarisBenchmark.ini";
+
+	Polaris::PolarisEngine* engine = new Polaris::PolarisEngine();
+	engine->startEngine(config_file_path.generic_string());
+
+	Polaris::PolarisBenchmark benchmark(options);
+	const std::string result = benchmark.run().dump();
+
+	engine->clear();
+	engine->shutdownEngine();
+
+	std::cout << result << std::endl;
+	if (!options.m_output_file.empty())
+	{
+		std::ofstream output_file(options.m_output_file);
+		if (!output_file)
+		{
+			std::cerr << "open file " << options.m_output_file << " failed!" << std::endl;
+			return EXIT_FAILURE;
+		}
+		output_file << result;
+	}
+
+	return EXIT_SUCCESS;
+}
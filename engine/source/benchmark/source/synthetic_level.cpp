@@ -0,0 +1,217 @@
+#include "benchmark/include/synthetic_level.h"
+
+#include "runtime/core/base/macro.h"
+#include "runtime/core/math/transform.h"
+#include "runtime/core/meta/serializer/serializer.h"
+
+#include "runtime/resource/asset_manager/asset_manager.h"
+#include "runtime/resource/mesh_cooker/mesh_cooker.h"
+#include "runtime/resource/res_type/components/camera.h"
+#include "runtime/resource/res_type/components/mesh.h"
+
+#include "_generated/serializer/all_serializer.h"
+
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+namespace Polaris
+{
+    const char* SyntheticLevel::k_folder_url = "asset/benchmark";
+
+    namespace
+    {
+        const std::string k_transform_definition_url = "asset/benchmark/transform.object.json";
+        const std::string k_mesh_definition_url      = "asset/benchmark/mesh.object.json";
+        const std::string k_camera_definition_url    = "asset/benchmark/camera.object.json";
+
+        bool writeJson(const std::string& asset_url, const Json& json)
+        {
+            std::ofstream json_file(g_runtime_global_context.m_asset_manager->getFullPath(asset_url));
+            if (!json_file)
+            {
+                LOG_ERROR("open file {} failed!", asset_url);
+                return false;
+            }
+
+            json_file << json.dump();
+            return true;
+        }
+
+        std::string getSubMeshUrl(uint32_t sub_mesh_index)
+        {
+            return "asset/benchmark/sub_mesh_" + std::to_string(sub_mesh_index) + ".obj";
+        }
+
+        // a unit cube with every face split into a grid of quads, so the cooker has triangles to remove
+        bool writeSubMesh(const std::string& asset_url)
+        {
+            constexpr uint32_t k_face_grid_size = 8;
+
+            CookedMesh mesh;
+            for (uint32_t axis = 0; axis < 3; ++axis)
+            {
+                for (float side : {-0.5f, 0.5f})
+                {
+                    const uint32_t first_vertex = static_cast<uint32_t>(mesh.m_positions.size());
+                    for (uint32_t row = 0; row <= k_face_grid_size; ++row)
+                    {
+                        for (uint32_t column = 0; column <= k_face_grid_size; ++column)
+                        {
+                            Vector3 position;
+                            position[axis]           = side;
+                            position[(axis + 1) % 3] = static_cast<float>(column) / k_face_grid_size - 0.5f;
+                            position[(axis + 2) % 3] = static_cast<float>(row) / k_face_grid_size - 0.5f;
+                            mesh.m_positions.push_back(position);
+                        }
+                    }
+
+                    // the negative side is wound the other way so every face points out
+                    for (uint32_t row = 0; row < k_face_grid_size; ++row)
+                    {
+                        for (uint32_t column = 0; column < k_face_grid_size; ++column)
+                        {
+                            const uint32_t corner = first_vertex + row * (k_face_grid_size + 1) + column;
+                            const uint32_t right  = corner + 1;
+                            const uint32_t up     = corner + k_face_grid_size + 1;
+                            const uint32_t across = up + 1;
+                            if (side > 0.f)
+                            {
+                                mesh.m_indices.insert(mesh.m_indices.end(), {corner, right, across, corner, across, up});
+                            }
+                            else
+                            {
+                                mesh.m_indices.insert(mesh.m_indices.end(), {corner, across, right, corner, up, across});
+                            }
+                        }
+                    }
+                }
+            }
+
+            return MeshCooker::saveObj(g_runtime_global_context.m_asset_manager->getFullPath(asset_url).generic_string(),
+                                       mesh);
+        }
+
+        Json makeComponent(const std::string& type_name, const Json& context)
+        {
+            return Json::object {{"$typeName", type_name}, {"$context", context}};
+        }
+
+        Json makeTransformComponent()
+        {
+            return makeComponent("TransformComponent", Json::object {{"transform", Serializer::write(Transform())}});
+        }
+
+        // the obj files of the sub meshes have to be written already, their lods are cooked here
+        Json makeMeshComponent(uint32_t sub_mesh_count)
+        {
+            MeshComponentRes mesh_res;
+            mesh_res.m_sub_meshes.resize(sub_mesh_count);
+            for (uint32_t sub_mesh_index = 0; sub_mesh_index < sub_mesh_count; ++sub_mesh_index)
+            {
+                SubMeshRes& sub_mesh    = mesh_res.m_sub_meshes[sub_mesh_index];
+                sub_mesh.m_obj_file_ref = getSubMeshUrl(sub_mesh_index);
+                sub_mesh.m_transform.m_position = Vector3(0.f, 0.f, static_cast<float>(sub_mesh_index));
+                if (!MeshCooker::cookLods(*g_runtime_global_context.m_asset_manager, sub_mesh))
+                {
+                    return Json();
+                }
+            }
+            return makeComponent("MeshComponent", Json::object {{"mesh_res", Serializer::write(mesh_res)}});
+        }
+    } // namespace
+
+    std::string SyntheticLevel::generate(const SyntheticLevelDesc& desc)
+    {
+        std::error_code error_code;
+        std::filesystem::create_directories(g_runtime_global_context.m_asset_manager->getFullPath(k_folder_url),
+                                            error_code);
+        if (error_code)
+        {
+            LOG_ERROR("create folder {} failed: {}", k_folder_url, error_code.message());
+            return std::string();
+        }
+
+        for (uint32_t sub_mesh_index = 0; sub_mesh_index < desc.m_sub_mesh_count; ++sub_mesh_index)
+        {
+            if (!writeSubMesh(getSubMeshUrl(sub_mesh_index)))
+            {
+                return std::string();
+            }
+        }
+
+        const Json mesh_component = makeMeshComponent(desc.m_sub_mesh_count);
+        if (mesh_component.is_null())
+        {
+            return std::string();
+        }
+
+        const Json transform_definition = Json::object {{"components", Json::array {makeTransformComponent()}}};
+        const Json mesh_definition = Json::object {{"components", Json::array {makeTransformComponent(), mesh_component}}};
+        const Json camera_definition = Json::object {
+            {"components",
+             Json::array {makeTransformComponent(),
+                          makeComponent("CameraComponent",
+                                        Json::object {{"camera_res", Serializer::write(CameraComponentRes())}})}}};
+        if (!writeJson(k_transform_definition_url, transform_definition) ||
+            !writeJson(k_mesh_definition_url, mesh_definition) || !writeJson(k_camera_definition_url, camera_definition))
+        {
+            return std::string();
+        }
+
+        // objects are spread over a square grid in the xy plane
+        std::mt19937                          random_engine(desc.m_seed);
+        std::uniform_real_distribution<float> unit_distribution(0.f, 1.f);
+        const uint32_t grid_size = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<double>(desc.m_object_count))));
+        const float    grid_spacing = 4.f;
+
+        Json::array objects;
+        objects.reserve(desc.m_object_count + 1);
+        for (uint32_t object_index = 0; object_index < desc.m_object_count; ++object_index)
+        {
+            const bool is_mesh_object = unit_distribution(random_engine) < desc.m_mesh_ratio;
+
+            Transform transform;
+            transform.m_position = Vector3((object_index % grid_size) * grid_spacing,
+                                           (object_index / grid_size) * grid_spacing,
+                                           unit_distribution(random_engine));
+
+            Json transform_delta =
+                Json::object {{"type_name", "TransformComponent"},
+                              {"component", Json::object {{"transform", Serializer::writeDelta(transform, Transform())}}}};
+
+            objects.push_back(Json::object {
+                {"name", "object_" + std::to_string(object_index)},
+                {"definition", is_mesh_object ? k_mesh_definition_url : k_transform_definition_url},
+                {"instanced_component_deltas", Json::array {transform_delta}}});
+        }
+
+        // above the middle of the grid looking down, high enough to see most of it
+        const float grid_extent = grid_size * grid_spacing;
+        Transform   camera_transform;
+        camera_transform.m_position = Vector3(grid_extent * 0.5f, grid_extent * 0.5f, grid_extent * 0.5f + 2.f);
+        objects.push_back(Json::object {
+            {"name", "camera"},
+            {"definition", k_camera_definition_url},
+            {"instanced_component_deltas",
+             Json::array {Json::object {
+                 {"type_name", "TransformComponent"},
+                 {"component", Json::object {{"transform", Serializer::writeDelta(camera_transform, Transform())}}}}}}});
+
+        const std::string level_url =
+            std::string(k_folder_url) + "/synthetic_" + std::to_string(desc.m_object_count) + ".level.json";
+        if (!writeJson(level_url, Json::object {{"objects", objects}}))
+        {
+            return std::string();
+        }
+
+        return level_url;
+    }
+
+    void SyntheticLevel::clear()
+    {
+        std::error_code error_code;
+        std::filesystem::remove_all(g_runtime_global_context.m_asset_manager->getFullPath(k_folder_url), error_code);
+    }
+} // namespace Polaris
@@ -13,12 +13,20 @@ int main(int argc, char** argv)
 	Polaris::PolarisEngine* engine = new Polaris::PolarisEngine();
 	engine->startEngine(config_file_path.generic_string());
 
-	Polaris::PolarisEditor* editor = new Polaris::PolarisEditor();
-	editor->initialize(engine);
-
-	editor->run();
-
-	editor->clear();
+	// headless runs simulate the world without the editor, window or rendering
+	if (engine->isHeadless())
+	{
+		engine->run();
+	}
+	else
+	{
+		Polaris::PolarisEditor* editor = new Polaris::PolarisEditor();
+		editor->initialize(engine);
+
+		editor->run();
+
+		editor->clear();
+	}
 	engine->clear();
 	engine->shutdownEngine();
 	
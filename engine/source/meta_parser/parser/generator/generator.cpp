@@ -36,6 +36,20 @@ namespace Generator
         genClassFieldRenderData(class_temp, class_field_defines);
         class_def.set("class_field_defines", class_field_defines);
 
+        // compact classes are serialized as a fixed size array of their fields instead of a keyed object
+        bool is_compact_array = class_temp->getMetaData().getFlag(NativeProperty::CompactArray) &&
+                                class_temp->m_base_classes.empty();
+        int  field_count      = 0;
+        for (auto& field : class_temp->m_fields)
+        {
+            if (!field->shouldCompile())
+                continue;
+            is_compact_array = is_compact_array && field->m_type.find("std::vector<") != 0;
+            ++field_count;
+        }
+        class_def.set("class_is_compact_array", is_compact_array && field_count > 0);
+        class_def.set("class_field_count", std::to_string(field_count));
+
         
         Mustache::data class_method_defines = Mustache::data::type::list;
         genClassMethodRenderData(class_temp, class_method_defines);
@@ -45,6 +59,7 @@ namespace Generator
     {
         static const std::string vector_prefix = "std::vector<";
 
+        int field_index = 0;
         for (auto& field : class_temp->m_fields)
         {
             if (!field->shouldCompile())
@@ -52,6 +67,7 @@ namespace Generator
             Mustache::data filed_define;
 
             filed_define.set("class_field_name", field->m_name);
+            filed_define.set("class_field_index", std::to_string(field_index++));
             filed_define.set("class_field_type", field->m_type);
             filed_define.set("class_field_display_name", field->m_display_name);
             bool is_vector = field->m_type.find(vector_prefix) == 0;
@@ -13,4 +13,6 @@ namespace NativeProperty
     const auto WhiteListFields = "WhiteListFields";
     const auto WhiteListMethods = "WhiteListMethods";
 
+    const auto CompactArray = "CompactArray";
+
 } // namespace NativeProperty
@@ -0,0 +1,99 @@
+#include "runtime/core/base/frame_limiter.h"
+
+#include <algorithm>
+#include <thread>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <cerrno>
+#include <time.h>
+#endif
+
+namespace Polaris
+{
+    void FrameLimiter::setTargetPeriod(double period_seconds)
+    {
+        using namespace std::chrono;
+        m_target_period = duration_cast<steady_clock::duration>(duration<double>(std::max(period_seconds, 0.0)));
+        m_has_deadline  = false;
+    }
+
+    void FrameLimiter::wait()
+    {
+        using namespace std::chrono;
+        if (!isEnabled())
+        {
+            return;
+        }
+
+        const steady_clock::time_point now = steady_clock::now();
+        if (!m_has_deadline)
+        {
+            m_next_deadline = now + m_target_period;
+            m_has_deadline  = true;
+        }
+        else
+        {
+            m_next_deadline += m_target_period;
+        }
+
+        if (m_next_deadline <= now)
+        {
+            m_next_deadline = now;
+            return;
+        }
+
+        preciseSleepUntil(m_next_deadline);
+    }
+
+    /*
+    * steady_clock reads CLOCK_MONOTONIC on linux, so its time points are valid absolute deadlines there
+    */
+    void FrameLimiter::preciseSleepUntil(std::chrono::steady_clock::time_point deadline)
+    {
+        using namespace std::chrono;
+
+#if defined(_WIN32)
+        // one timer per thread, high resolution timers are not rounded up to the system tick
+        static thread_local HANDLE s_timer =
+            CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+
+        const steady_clock::duration remaining = deadline - steady_clock::now();
+        if (remaining <= steady_clock::duration::zero())
+        {
+            return;
+        }
+        if (s_timer == nullptr)
+        {
+            std::this_thread::sleep_for(remaining);
+            return;
+        }
+
+        // negative due times are relative, in 100 nanosecond units
+        LARGE_INTEGER due_time;
+        due_time.QuadPart = -static_cast<LONGLONG>(duration_cast<nanoseconds>(remaining).count() / 100);
+        if (SetWaitableTimerEx(s_timer, &due_time, 0, nullptr, nullptr, nullptr, 0))
+        {
+            WaitForSingleObject(s_timer, INFINITE);
+        }
+#elif defined(__linux__)
+        const int64_t deadline_ns = duration_cast<nanoseconds>(deadline.time_since_epoch()).count();
+        timespec      deadline_spec;
+        deadline_spec.tv_sec  = static_cast<time_t>(deadline_ns / 1000000000);
+        deadline_spec.tv_nsec = static_cast<long>(deadline_ns % 1000000000);
+
+        // restarted when a signal interrupts the sleep, the deadline is absolute so nothing drifts
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline_spec, nullptr) == EINTR)
+        {}
+#else
+        std::this_thread::sleep_until(deadline);
+#endif
+    }
+} // namespace Polaris
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace Polaris
+{
+    /**
+     *  Paces a loop to a target period. Waiting sleeps on an absolute deadline with a high resolution
+     *  timer of the os, so it neither burns a core nor overshoots the deadline by a whole scheduler
+     *  quantum
+     */
+    class FrameLimiter
+    {
+    public:
+        // a period of 0 disables the limiter
+        void setTargetPeriod(double period_seconds);
+        bool isEnabled() const { return m_target_period.count() > 0; }
+
+        /**
+         *  Block until one target period has passed since the previous deadline. A loop that
+         *  ran late restarts the schedule from now instead of trying to catch up
+         */
+        void wait();
+
+        // clock_nanosleep on the monotonic clock, a high resolution waitable timer on windows
+        static void preciseSleepUntil(std::chrono::steady_clock::time_point deadline);
+
+    private:
+        std::chrono::steady_clock::duration   m_target_period {0};
+        std::chrono::steady_clock::time_point m_next_deadline;
+        bool                                  m_has_deadline {false};
+    };
+} // namespace Polaris
@@ -4,17 +4,59 @@
 
 #include "runtime/function/global/global_context.h"
 
+// log levels below POLARIS_LOG_ACTIVE_LEVEL are compiled out, arguments included
+#define POLARIS_LOG_LEVEL_DEBUG 0
+#define POLARIS_LOG_LEVEL_INFO 1
+#define POLARIS_LOG_LEVEL_WARN 2
+#define POLARIS_LOG_LEVEL_ERROR 3
+#define POLARIS_LOG_LEVEL_FATAL 4
+
+#ifndef POLARIS_LOG_ACTIVE_LEVEL
+#ifdef NDEBUG
+#define POLARIS_LOG_ACTIVE_LEVEL POLARIS_LOG_LEVEL_INFO
+#else
+#define POLARIS_LOG_ACTIVE_LEVEL POLARIS_LOG_LEVEL_DEBUG
+#endif
+#endif
+
+// the runtime level is checked before the arguments are evaluated
 #define LOG_HELPER(LOG_LEVEL, ...) \
-    g_runtime_global_context.m_logger_system->log(LOG_LEVEL, "[" + std::string(__FUNCTION__) + "] " + __VA_ARGS__);
+    do \
+    { \
+        if (g_runtime_global_context.m_logger_system->shouldLog(LOG_LEVEL)) \
+            g_runtime_global_context.m_logger_system->log(LOG_LEVEL, __FUNCTION__, __VA_ARGS__); \
+    } while (0);
 
+#define LOG_DISABLED(...) \
+    do \
+    { \
+    } while (0);
+
+#if POLARIS_LOG_ACTIVE_LEVEL <= POLARIS_LOG_LEVEL_DEBUG
 #define LOG_DEBUG(...) LOG_HELPER(LogSystem::LogLevel::debug, __VA_ARGS__);
+#else
+#define LOG_DEBUG(...) LOG_DISABLED(__VA_ARGS__);
+#endif
 
+#if POLARIS_LOG_ACTIVE_LEVEL <= POLARIS_LOG_LEVEL_INFO
 #define LOG_INFO(...) LOG_HELPER(LogSystem::LogLevel::info, __VA_ARGS__);
+#else
+#define LOG_INFO(...) LOG_DISABLED(__VA_ARGS__);
+#endif
 
+#if POLARIS_LOG_ACTIVE_LEVEL <= POLARIS_LOG_LEVEL_WARN
 #define LOG_WARN(...) LOG_HELPER(LogSystem::LogLevel::warn, __VA_ARGS__);
+#else
+#define LOG_WARN(...) LOG_DISABLED(__VA_ARGS__);
+#endif
 
+#if POLARIS_LOG_ACTIVE_LEVEL <= POLARIS_LOG_LEVEL_ERROR
 #define LOG_ERROR(...) LOG_HELPER(LogSystem::LogLevel::error, __VA_ARGS__);
+#else
+#define LOG_ERROR(...) LOG_DISABLED(__VA_ARGS__);
+#endif
 
+// fatal logs throw, so they are never compiled out
 #define LOG_FATAL(...) LOG_HELPER(LogSystem::LogLevel::fatal, __VA_ARGS__);
 
 #ifdef NDEBUG
@@ -0,0 +1,146 @@
+#include "runtime/core/base/thread_pool.h"
+
+#include "runtime/core/profiler/profiler.h"
+
+#include <algorithm>
+#include <string>
+
+namespace Polaris
+{
+    ThreadPool::ThreadPool()
+    {
+        const uint32_t worker_count = std::max(1u, std::thread::hardware_concurrency()) - 1;
+
+        m_workers.reserve(worker_count);
+        for (uint32_t worker_index = 0; worker_index < worker_count; ++worker_index)
+        {
+            m_workers.emplace_back(&ThreadPool::workerLoop, this, worker_index);
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_is_quit = true;
+        }
+        m_work_condition.notify_all();
+
+        for (std::thread& worker : m_workers)
+        {
+            worker.join();
+        }
+    }
+
+    void ThreadPool::parallelFor(uint32_t task_count, const std::function<void(uint32_t)>& task)
+    {
+        if (task_count == 0)
+        {
+            return;
+        }
+        if (task_count == 1 || m_workers.empty())
+        {
+            for (uint32_t task_index = 0; task_index < task_count; ++task_index)
+            {
+                task(task_index);
+            }
+            return;
+        }
+
+        Job job;
+        job.m_task       = &task;
+        job.m_task_count = task_count;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_jobs.push_back(&job);
+        }
+        // one index is left for the calling thread
+        if (task_count - 1 >= m_workers.size())
+        {
+            m_work_condition.notify_all();
+        }
+        else
+        {
+            for (uint32_t worker_index = 0; worker_index < task_count - 1; ++worker_index)
+            {
+                m_work_condition.notify_one();
+            }
+        }
+
+        runJob(job);
+
+        {
+            // every index is claimed now, wait for the workers still running one
+            std::unique_lock<std::mutex> lock(m_mutex);
+            removeJob(job);
+            m_done_condition.wait(lock, [&job]() { return job.m_worker_count == 0; });
+        }
+
+        if (job.m_exception)
+        {
+            std::rethrow_exception(job.m_exception);
+        }
+    }
+
+    void ThreadPool::workerLoop(uint32_t worker_index)
+    {
+        PROFILE_THREAD("worker " + std::to_string(worker_index));
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true)
+        {
+            m_work_condition.wait(lock, [this]() { return m_is_quit || !m_jobs.empty(); });
+            if (m_jobs.empty())
+            {
+                return;
+            }
+
+            Job& job = *m_jobs.front();
+            ++job.m_worker_count;
+            lock.unlock();
+
+            runJob(job);
+
+            lock.lock();
+            removeJob(job);
+            if (--job.m_worker_count == 0)
+            {
+                m_done_condition.notify_all();
+            }
+        }
+    }
+
+    void ThreadPool::runJob(Job& job)
+    {
+        while (true)
+        {
+            const uint32_t task_index = job.m_next_index.fetch_add(1, std::memory_order_relaxed);
+            if (task_index >= job.m_task_count)
+            {
+                return;
+            }
+
+            try
+            {
+                (*job.m_task)(task_index);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (!job.m_exception)
+                {
+                    job.m_exception = std::current_exception();
+                }
+            }
+        }
+    }
+
+    void ThreadPool::removeJob(Job& job)
+    {
+        auto found = std::find(m_jobs.begin(), m_jobs.end(), &job);
+        if (found != m_jobs.end())
+        {
+            m_jobs.erase(found);
+        }
+    }
+} // namespace Polaris
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "runtime/core/base/public_singleton.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Polaris
+{
+    /**
+     *  Worker threads started once and shared by every parallel loop of the engine, so per frame
+     *  fan-outs do not pay for creating threads. The calling thread takes part in its own loop and
+     *  claims indices like the workers do, which also makes nested loops safe: a loop never waits
+     *  for a worker that is not already running one of its indices
+     */
+    class ThreadPool final : public PublicSingleton<ThreadPool>
+    {
+        friend class PublicSingleton<ThreadPool>;
+
+    public:
+        ~ThreadPool();
+
+        // workers plus the calling thread, the useful number of chunks to split a loop into
+        uint32_t getThreadCount() const { return static_cast<uint32_t>(m_workers.size()) + 1; }
+
+        /**
+         *  Call task once for every index below task_count and return when all calls finished.
+         *  Each index runs exactly once, on any thread. The first exception thrown by a task is
+         *  rethrown here after the remaining indices ran
+         */
+        void parallelFor(uint32_t task_count, const std::function<void(uint32_t)>& task);
+
+    private:
+        struct Job
+        {
+            const std::function<void(uint32_t)>* m_task {nullptr};
+            uint32_t                             m_task_count {0};
+            std::atomic<uint32_t>                m_next_index {0};
+            // workers inside runJob, guarded by m_mutex
+            uint32_t           m_worker_count {0};
+            std::exception_ptr m_exception;
+        };
+
+        ThreadPool();
+
+        void workerLoop(uint32_t worker_index);
+        void runJob(Job& job);
+        // the job stops being handed out, guarded by m_mutex
+        void removeJob(Job& job);
+
+        std::vector<std::thread> m_workers;
+
+        std::mutex              m_mutex;
+        std::condition_variable m_work_condition;
+        std::condition_variable m_done_condition;
+        std::deque<Job*>        m_jobs;
+        bool                    m_is_quit {false};
+    };
+} // namespace Polaris
@@ -7,9 +7,17 @@
 
 namespace Polaris
 {
-    LogSystem::LogSystem()
+    LogSystem::LogSystem(bool log_to_stderr)
     {
-        auto console_sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
+        spdlog::sink_ptr console_sink;
+        if (log_to_stderr)
+        {
+            console_sink = std::make_shared<spdlog::sinks::stderr_color_sink_mt>();
+        }
+        else
+        {
+            console_sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
+        }
         console_sink->set_level(spdlog::level::trace);
         console_sink->set_pattern("[%^%l%$] %v");
 
@@ -3,6 +3,7 @@
 #include <spdlog/spdlog.h>
 
 #include <cstdint>
+#include <iterator>
 #include <stdexcept>
 
 namespace Polaris
@@ -21,40 +22,77 @@ namespace Polaris
         };
 
     public:
-        LogSystem();
+        // console output goes to stderr instead of stdout when log_to_stderr is set
+        explicit LogSystem(bool log_to_stderr = false);
         ~LogSystem();
 
+        // runtime level filter, checked before any argument is formatted
+        bool shouldLog(LogLevel level) const { return m_logger->should_log(toSpdlogLevel(level)); }
+        void setLevel(LogLevel level) { m_logger->set_level(toSpdlogLevel(level)); }
+
+        /**
+         *  Format "[function_name] message" into a per-thread buffer and hand it to the async logger,
+         *  without any heap allocation once the buffer has grown to the largest message of the thread.
+         *  A message without arguments is logged as is, so it can contain braces
+         */
         template<typename... TARGS>
-        void log(LogLevel level, TARGS&&... args)
+        void log(LogLevel level, const char* function_name, fmt::string_view format, const TARGS&... args)
+        {
+            if (!shouldLog(level))
+                return;
+
+            fmt::memory_buffer& buffer = getThreadBuffer();
+            buffer.clear();
+            buffer.push_back('[');
+            buffer.append(fmt::string_view(function_name));
+            buffer.append(fmt::string_view("] "));
+            if constexpr (sizeof...(TARGS) == 0)
+            {
+                buffer.append(format);
+            }
+            else
+            {
+                fmt::vformat_to(std::back_inserter(buffer), format, fmt::make_format_args(args...));
+            }
+
+            const spdlog::string_view_t message(buffer.data(), buffer.size());
+            m_logger->log(toSpdlogLevel(level), message);
+
+            if (level == LogLevel::fatal)
+            {
+                fatalCallback(message);
+            }
+        }
+
+        void fatalCallback(spdlog::string_view_t message)
+        {
+            throw std::runtime_error(std::string(message.data(), message.size()));
+        }
+
+    private:
+        static spdlog::level::level_enum toSpdlogLevel(LogLevel level)
         {
             switch (level)
             {
                 case LogLevel::debug:
-                    m_logger->debug(std::forward<TARGS>(args)...);
-                    break;
+                    return spdlog::level::debug;
                 case LogLevel::info:
-                    m_logger->info(std::forward<TARGS>(args)...);
-                    break;
+                    return spdlog::level::info;
                 case LogLevel::warn:
-                    m_logger->warn(std::forward<TARGS>(args)...);
-                    break;
+                    return spdlog::level::warn;
                 case LogLevel::error:
-                    m_logger->error(std::forward<TARGS>(args)...);
-                    break;
+                    return spdlog::level::err;
                 case LogLevel::fatal:
-                    m_logger->critical(std::forward<TARGS>(args)...);
-                    fatalCallback(std::forward<TARGS>(args)...);
-                    break;
+                    return spdlog::level::critical;
                 default:
-                    break;
+                    return spdlog::level::off;
             }
         }
 
-        template<typename... TARGS>
-        void fatalCallback(TARGS&&... args)
+        static fmt::memory_buffer& getThreadBuffer()
         {
-            const std::string format_str = fmt::format(std::forward<TARGS>(args)...);
-            throw std::runtime_error(format_str);
+            static thread_local fmt::memory_buffer buffer;
+            return buffer;
         }
 
     private:
@@ -1,5 +1,7 @@
 #include "runtime/core/math/axis_aligned.h"
 
+#include <cmath>
+
 namespace Polaris
 {
     AxisAlignedBox::AxisAlignedBox(const Vector3& center, const Vector3& half_extent) { update(center, half_extent); }
@@ -13,6 +15,15 @@ namespace Polaris
         m_half_extent = m_center - m_min_corner;
     }
 
+    void AxisAlignedBox::merge(const AxisAlignedBox& other)
+    {
+        m_min_corner.makeFloor(other.m_min_corner);
+        m_max_corner.makeCeil(other.m_max_corner);
+
+        m_center      = 0.5f * (m_min_corner + m_max_corner);
+        m_half_extent = m_center - m_min_corner;
+    }
+
     void AxisAlignedBox::update(const Vector3& center, const Vector3& half_extent)
     {
         m_center      = center;
@@ -21,4 +32,37 @@ namespace Polaris
         m_max_corner  = center + half_extent;
     }
 
+    bool AxisAlignedBox::contains(const AxisAlignedBox& other) const
+    {
+        return m_min_corner.x <= other.m_min_corner.x && m_min_corner.y <= other.m_min_corner.y &&
+               m_min_corner.z <= other.m_min_corner.z && other.m_max_corner.x <= m_max_corner.x &&
+               other.m_max_corner.y <= m_max_corner.y && other.m_max_corner.z <= m_max_corner.z;
+    }
+
+    bool AxisAlignedBox::intersects(const AxisAlignedBox& other) const
+    {
+        return m_min_corner.x <= other.m_max_corner.x && other.m_min_corner.x <= m_max_corner.x &&
+               m_min_corner.y <= other.m_max_corner.y && other.m_min_corner.y <= m_max_corner.y &&
+               m_min_corner.z <= other.m_max_corner.z && other.m_min_corner.z <= m_max_corner.z;
+    }
+
+    float AxisAlignedBox::getSurfaceArea() const
+    {
+        const Vector3 size = m_max_corner - m_min_corner;
+        return 2.f * (size.x * size.y + size.y * size.z + size.z * size.x);
+    }
+
+    AxisAlignedBox AxisAlignedBox::getTransformed(const Matrix4x4& transform) const
+    {
+        // the extent along each axis is the half extent projected onto the absolute basis vectors
+        Vector3 half_extent;
+        for (size_t row = 0; row < 3; ++row)
+        {
+            half_extent[row] = std::fabs(transform[row][0]) * m_half_extent.x +
+                               std::fabs(transform[row][1]) * m_half_extent.y +
+                               std::fabs(transform[row][2]) * m_half_extent.z;
+        }
+        return AxisAlignedBox(transform.transformAffine(m_center), half_extent);
+    }
+
 } // namespace Polaris
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "runtime/core/math/matrix4.h"
 #include "runtime/core/math/vector3.h"
 #include "runtime/core/meta/reflection/reflection.h"
 #include <limits>
@@ -15,8 +16,16 @@ namespace Polaris
         AxisAlignedBox(const Vector3& center, const Vector3& half_extent);
 
         void merge(const Vector3& new_point);
+        void merge(const AxisAlignedBox& other);
         void update(const Vector3& center, const Vector3& half_extent);
 
+        bool  contains(const AxisAlignedBox& other) const;
+        bool  intersects(const AxisAlignedBox& other) const;
+        float getSurfaceArea() const;
+
+        // smallest box containing this box after an affine transform
+        AxisAlignedBox getTransformed(const Matrix4x4& transform) const;
+
         const Vector3& getCenter() const { return m_center; }
         const Vector3& getHalfExtent() const { return m_half_extent; }
         const Vector3& getMinCorner() const { return m_min_corner; }
@@ -0,0 +1,439 @@
+#include "runtime/core/math/dynamic_bvh.h"
+
+#include "runtime/core/base/macro.h"
+
+#include <cmath>
+#include <limits>
+
+namespace Polaris
+{
+    namespace
+    {
+        AxisAlignedBox combine(const AxisAlignedBox& a, const AxisAlignedBox& b)
+        {
+            AxisAlignedBox combined = a;
+            combined.merge(b);
+            return combined;
+        }
+    } // namespace
+
+    bool BVHSphereQuery::overlaps(const AxisAlignedBox& bounds) const
+    {
+        // distance from the center to the closest point of the box
+        const Vector3& min_corner = bounds.getMinCorner();
+        const Vector3& max_corner = bounds.getMaxCorner();
+
+        float squared_distance = 0.f;
+        for (size_t axis = 0; axis < 3; ++axis)
+        {
+            const float closest = std::min(std::max(m_center[axis], min_corner[axis]), max_corner[axis]);
+            const float delta   = m_center[axis] - closest;
+            squared_distance += delta * delta;
+        }
+        return squared_distance <= m_radius * m_radius;
+    }
+
+    bool BVHFrustumQuery::overlaps(const AxisAlignedBox& bounds) const
+    {
+        const Vector3& center      = bounds.getCenter();
+        const Vector3& half_extent = bounds.getHalfExtent();
+        for (const Vector4& plane : m_planes)
+        {
+            const float distance = plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w;
+            const float radius   = std::fabs(plane.x) * half_extent.x + std::fabs(plane.y) * half_extent.y +
+                                 std::fabs(plane.z) * half_extent.z;
+            if (distance + radius < 0.f)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    BVHRayQuery::BVHRayQuery(const Vector3& origin, const Vector3& direction, float max_distance) :
+        m_origin(origin), m_direction(direction), m_max_distance(max_distance)
+    {
+        for (size_t axis = 0; axis < 3; ++axis)
+        {
+            m_inverse_direction[axis] =
+                direction[axis] != 0.f ? 1.f / direction[axis] : std::numeric_limits<float>::infinity();
+        }
+    }
+
+    bool BVHRayQuery::overlaps(const AxisAlignedBox& bounds) const
+    {
+        // slab test, the ray overlaps when the parameter ranges of the three slabs intersect
+        float t_min = 0.f;
+        float t_max = m_max_distance;
+        for (size_t axis = 0; axis < 3; ++axis)
+        {
+            if (m_direction[axis] == 0.f)
+            {
+                if (m_origin[axis] < bounds.getMinCorner()[axis] || m_origin[axis] > bounds.getMaxCorner()[axis])
+                {
+                    return false;
+                }
+                continue;
+            }
+
+            float t_near = (bounds.getMinCorner()[axis] - m_origin[axis]) * m_inverse_direction[axis];
+            float t_far  = (bounds.getMaxCorner()[axis] - m_origin[axis]) * m_inverse_direction[axis];
+            if (t_near > t_far)
+            {
+                std::swap(t_near, t_far);
+            }
+
+            t_min = std::max(t_min, t_near);
+            t_max = std::min(t_max, t_far);
+            if (t_min > t_max)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    BVHProxyID DynamicBVH::createProxy(const AxisAlignedBox& bounds, uint64_t user_data)
+    {
+        const int32_t leaf = allocateNode();
+
+        Node& node          = m_nodes[leaf];
+        node.m_tight_bounds = bounds;
+        node.m_bounds       = getFattenedBounds(bounds);
+        node.m_user_data    = user_data;
+        node.m_height       = 0;
+
+        insertLeaf(leaf);
+        ++m_proxy_count;
+        return leaf;
+    }
+
+    void DynamicBVH::destroyProxy(BVHProxyID proxy_id)
+    {
+        ASSERT(proxy_id >= 0 && proxy_id < static_cast<BVHProxyID>(m_nodes.size()) && m_nodes[proxy_id].isLeaf());
+
+        removeLeaf(proxy_id);
+        freeNode(proxy_id);
+        --m_proxy_count;
+    }
+
+    bool DynamicBVH::moveProxy(BVHProxyID proxy_id, const AxisAlignedBox& bounds)
+    {
+        ASSERT(proxy_id >= 0 && proxy_id < static_cast<BVHProxyID>(m_nodes.size()) && m_nodes[proxy_id].isLeaf());
+
+        Node& node          = m_nodes[proxy_id];
+        node.m_tight_bounds = bounds;
+        if (node.m_bounds.contains(bounds))
+        {
+            return false;
+        }
+
+        removeLeaf(proxy_id);
+        m_nodes[proxy_id].m_bounds = getFattenedBounds(bounds);
+        insertLeaf(proxy_id);
+        return true;
+    }
+
+    void DynamicBVH::refit()
+    {
+        if (m_root != k_null_node)
+        {
+            refitNode(m_root);
+        }
+    }
+
+    void DynamicBVH::clear()
+    {
+        m_nodes.clear();
+        m_root        = k_null_node;
+        m_free_list   = k_null_node;
+        m_proxy_count = 0;
+    }
+
+    int32_t DynamicBVH::allocateNode()
+    {
+        if (m_free_list == k_null_node)
+        {
+            m_nodes.emplace_back();
+            return static_cast<int32_t>(m_nodes.size() - 1);
+        }
+
+        const int32_t node_index = m_free_list;
+        m_free_list              = m_nodes[node_index].m_next_free;
+        m_nodes[node_index]      = Node();
+        return node_index;
+    }
+
+    void DynamicBVH::freeNode(int32_t node_index)
+    {
+        Node& node       = m_nodes[node_index];
+        node.m_next_free = m_free_list;
+        node.m_height    = -1;
+        m_free_list      = node_index;
+    }
+
+    /*
+    * Walk down to the sibling that makes the new parent cheapest by surface area. The cost of a
+    * candidate is the area of the new parent plus the growth it causes in every ancestor; descending
+    * stops when creating the parent here is cheaper than descending into either child
+    */
+    void DynamicBVH::insertLeaf(int32_t leaf)
+    {
+        if (m_root == k_null_node)
+        {
+            m_root                 = leaf;
+            m_nodes[leaf].m_parent = k_null_node;
+            return;
+        }
+
+        const AxisAlignedBox leaf_bounds = m_nodes[leaf].m_bounds;
+
+        int32_t node_index = m_root;
+        while (!m_nodes[node_index].isLeaf())
+        {
+            const Node&   node   = m_nodes[node_index];
+            const int32_t child1 = node.m_child1;
+            const int32_t child2 = node.m_child2;
+
+            const float area          = node.m_bounds.getSurfaceArea();
+            const float combined_area = combine(node.m_bounds, leaf_bounds).getSurfaceArea();
+
+            // cost of a new parent for this node and the leaf, and the growth pushed onto the ancestors
+            const float cost             = 2.f * combined_area;
+            const float inheritance_cost = 2.f * (combined_area - area);
+
+            auto descend_cost = [&](int32_t child) {
+                const float child_combined_area = combine(leaf_bounds, m_nodes[child].m_bounds).getSurfaceArea();
+                if (m_nodes[child].isLeaf())
+                {
+                    return child_combined_area + inheritance_cost;
+                }
+                return child_combined_area - m_nodes[child].m_bounds.getSurfaceArea() + inheritance_cost;
+            };
+
+            const float cost1 = descend_cost(child1);
+            const float cost2 = descend_cost(child2);
+            if (cost < cost1 && cost < cost2)
+            {
+                break;
+            }
+            node_index = cost1 < cost2 ? child1 : child2;
+        }
+
+        const int32_t sibling    = node_index;
+        const int32_t old_parent = m_nodes[sibling].m_parent;
+        const int32_t new_parent = allocateNode();
+
+        Node& parent_node    = m_nodes[new_parent];
+        parent_node.m_parent = old_parent;
+        parent_node.m_bounds = combine(leaf_bounds, m_nodes[sibling].m_bounds);
+        parent_node.m_height = m_nodes[sibling].m_height + 1;
+        parent_node.m_child1 = sibling;
+        parent_node.m_child2 = leaf;
+
+        if (old_parent != k_null_node)
+        {
+            if (m_nodes[old_parent].m_child1 == sibling)
+            {
+                m_nodes[old_parent].m_child1 = new_parent;
+            }
+            else
+            {
+                m_nodes[old_parent].m_child2 = new_parent;
+            }
+        }
+        else
+        {
+            m_root = new_parent;
+        }
+        m_nodes[sibling].m_parent = new_parent;
+        m_nodes[leaf].m_parent    = new_parent;
+
+        // fix heights and bounds of the ancestors, rotating where they got unbalanced
+        node_index = m_nodes[leaf].m_parent;
+        while (node_index != k_null_node)
+        {
+            node_index = balance(node_index);
+
+            Node& node    = m_nodes[node_index];
+            node.m_height = 1 + std::max(m_nodes[node.m_child1].m_height, m_nodes[node.m_child2].m_height);
+            node.m_bounds = combine(m_nodes[node.m_child1].m_bounds, m_nodes[node.m_child2].m_bounds);
+            node_index    = node.m_parent;
+        }
+    }
+
+    void DynamicBVH::removeLeaf(int32_t leaf)
+    {
+        if (leaf == m_root)
+        {
+            m_root = k_null_node;
+            return;
+        }
+
+        const int32_t parent       = m_nodes[leaf].m_parent;
+        const int32_t grand_parent = m_nodes[parent].m_parent;
+        const int32_t sibling =
+            m_nodes[parent].m_child1 == leaf ? m_nodes[parent].m_child2 : m_nodes[parent].m_child1;
+
+        if (grand_parent == k_null_node)
+        {
+            m_root                    = sibling;
+            m_nodes[sibling].m_parent = k_null_node;
+            freeNode(parent);
+            return;
+        }
+
+        // the sibling takes the place of the parent
+        if (m_nodes[grand_parent].m_child1 == parent)
+        {
+            m_nodes[grand_parent].m_child1 = sibling;
+        }
+        else
+        {
+            m_nodes[grand_parent].m_child2 = sibling;
+        }
+        m_nodes[sibling].m_parent = grand_parent;
+        freeNode(parent);
+
+        int32_t node_index = grand_parent;
+        while (node_index != k_null_node)
+        {
+            node_index = balance(node_index);
+
+            Node& node    = m_nodes[node_index];
+            node.m_height = 1 + std::max(m_nodes[node.m_child1].m_height, m_nodes[node.m_child2].m_height);
+            node.m_bounds = combine(m_nodes[node.m_child1].m_bounds, m_nodes[node.m_child2].m_bounds);
+            node_index    = node.m_parent;
+        }
+    }
+
+    /*
+    * If one child of a is more than one level taller than the other, rotate that child up so it
+    * becomes the parent of a. Returns the node now at the position of a
+    */
+    int32_t DynamicBVH::balance(int32_t index_a)
+    {
+        Node& a = m_nodes[index_a];
+        if (a.isLeaf() || a.m_height < 2)
+        {
+            return index_a;
+        }
+
+        const int32_t index_b = a.m_child1;
+        const int32_t index_c = a.m_child2;
+        Node&         b       = m_nodes[index_b];
+        Node&         c       = m_nodes[index_c];
+
+        const int32_t height_difference = c.m_height - b.m_height;
+
+        auto replace_child_of_parent = [this](int32_t old_child, int32_t new_child, int32_t parent) {
+            if (parent == k_null_node)
+            {
+                m_root = new_child;
+            }
+            else if (m_nodes[parent].m_child1 == old_child)
+            {
+                m_nodes[parent].m_child1 = new_child;
+            }
+            else
+            {
+                m_nodes[parent].m_child2 = new_child;
+            }
+        };
+
+        // rotate c up
+        if (height_difference > 1)
+        {
+            const int32_t index_f = c.m_child1;
+            const int32_t index_g = c.m_child2;
+            Node&         f       = m_nodes[index_f];
+            Node&         g       = m_nodes[index_g];
+
+            c.m_child1 = index_a;
+            c.m_parent = a.m_parent;
+            a.m_parent = index_c;
+            replace_child_of_parent(index_a, index_c, c.m_parent);
+
+            // the taller grandchild stays under c, the other one moves under a
+            if (f.m_height > g.m_height)
+            {
+                c.m_child2 = index_f;
+                a.m_child2 = index_g;
+                g.m_parent = index_a;
+                a.m_bounds = combine(b.m_bounds, g.m_bounds);
+                c.m_bounds = combine(a.m_bounds, f.m_bounds);
+                a.m_height = 1 + std::max(b.m_height, g.m_height);
+                c.m_height = 1 + std::max(a.m_height, f.m_height);
+            }
+            else
+            {
+                c.m_child2 = index_g;
+                a.m_child2 = index_f;
+                f.m_parent = index_a;
+                a.m_bounds = combine(b.m_bounds, f.m_bounds);
+                c.m_bounds = combine(a.m_bounds, g.m_bounds);
+                a.m_height = 1 + std::max(b.m_height, f.m_height);
+                c.m_height = 1 + std::max(a.m_height, g.m_height);
+            }
+            return index_c;
+        }
+
+        // rotate b up
+        if (height_difference < -1)
+        {
+            const int32_t index_d = b.m_child1;
+            const int32_t index_e = b.m_child2;
+            Node&         d       = m_nodes[index_d];
+            Node&         e       = m_nodes[index_e];
+
+            b.m_child1 = index_a;
+            b.m_parent = a.m_parent;
+            a.m_parent = index_b;
+            replace_child_of_parent(index_a, index_b, b.m_parent);
+
+            if (d.m_height > e.m_height)
+            {
+                b.m_child2 = index_d;
+                a.m_child1 = index_e;
+                e.m_parent = index_a;
+                a.m_bounds = combine(c.m_bounds, e.m_bounds);
+                b.m_bounds = combine(a.m_bounds, d.m_bounds);
+                a.m_height = 1 + std::max(c.m_height, e.m_height);
+                b.m_height = 1 + std::max(a.m_height, d.m_height);
+            }
+            else
+            {
+                b.m_child2 = index_e;
+                a.m_child1 = index_d;
+                d.m_parent = index_a;
+                a.m_bounds = combine(c.m_bounds, d.m_bounds);
+                b.m_bounds = combine(a.m_bounds, e.m_bounds);
+                a.m_height = 1 + std::max(c.m_height, d.m_height);
+                b.m_height = 1 + std::max(a.m_height, e.m_height);
+            }
+            return index_b;
+        }
+
+        return index_a;
+    }
+
+    void DynamicBVH::refitNode(int32_t node_index)
+    {
+        Node& node = m_nodes[node_index];
+        if (node.isLeaf())
+        {
+            node.m_bounds = getFattenedBounds(node.m_tight_bounds);
+            return;
+        }
+
+        refitNode(node.m_child1);
+        refitNode(node.m_child2);
+        node.m_bounds = combine(m_nodes[node.m_child1].m_bounds, m_nodes[node.m_child2].m_bounds);
+    }
+
+    AxisAlignedBox DynamicBVH::getFattenedBounds(const AxisAlignedBox& bounds) const
+    {
+        const Vector3 margin(m_fat_margin, m_fat_margin, m_fat_margin);
+        return AxisAlignedBox(bounds.getCenter(), bounds.getHalfExtent() + margin);
+    }
+} // namespace Polaris
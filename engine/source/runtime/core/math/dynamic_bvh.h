@@ -0,0 +1,221 @@
+#pragma once
+
+#include "runtime/core/base/thread_pool.h"
+#include "runtime/core/math/axis_aligned.h"
+#include "runtime/core/math/vector3.h"
+#include "runtime/core/math/vector4.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace Polaris
+{
+    using BVHProxyID = int32_t;
+
+    constexpr BVHProxyID k_invalid_bvh_proxy_id = -1;
+
+    struct BVHBoxQuery
+    {
+        AxisAlignedBox m_box;
+
+        bool overlaps(const AxisAlignedBox& bounds) const { return m_box.intersects(bounds); }
+    };
+
+    struct BVHSphereQuery
+    {
+        Vector3 m_center {Vector3::ZERO};
+        float   m_radius {0.f};
+
+        bool overlaps(const AxisAlignedBox& bounds) const;
+    };
+
+    // planes point inwards, a box overlaps unless it lies completely behind one of them
+    struct BVHFrustumQuery
+    {
+        Vector4 m_planes[6];
+
+        bool overlaps(const AxisAlignedBox& bounds) const;
+    };
+
+    struct BVHRayQuery
+    {
+        BVHRayQuery() = default;
+        BVHRayQuery(const Vector3& origin, const Vector3& direction, float max_distance);
+
+        Vector3 m_origin {Vector3::ZERO};
+        Vector3 m_direction {Vector3::UNIT_Z};
+        Vector3 m_inverse_direction {Vector3::UNIT_Z};
+        float   m_max_distance {0.f};
+
+        bool overlaps(const AxisAlignedBox& bounds) const;
+    };
+
+    /**
+     *  Dynamic AABB tree. Each proxy is stored with its tight bounds and a fat copy enlarged by a
+     *  margin; moves that stay inside the fat bounds only update the tight bounds, larger moves
+     *  reinsert the leaf. Inserts pick the sibling by surface area cost and the tree is kept balanced
+     *  with rotations on the way up. refit() shrinks the fat bounds back around the tight ones and
+     *  is meant to be called now and then, not every frame. Not thread safe for writes, queries
+     *  may run concurrently
+     */
+    class DynamicBVH
+    {
+    public:
+        explicit DynamicBVH(float fat_margin = 0.1f) : m_fat_margin(fat_margin) {}
+
+        BVHProxyID createProxy(const AxisAlignedBox& bounds, uint64_t user_data);
+        void       destroyProxy(BVHProxyID proxy_id);
+        // returns true when the proxy left its fat bounds and was reinserted
+        bool moveProxy(BVHProxyID proxy_id, const AxisAlignedBox& bounds);
+
+        void refit();
+        void clear();
+
+        uint64_t              getUserData(BVHProxyID proxy_id) const { return m_nodes[proxy_id].m_user_data; }
+        const AxisAlignedBox& getBounds(BVHProxyID proxy_id) const { return m_nodes[proxy_id].m_tight_bounds; }
+        const AxisAlignedBox& getFatBounds(BVHProxyID proxy_id) const { return m_nodes[proxy_id].m_bounds; }
+
+        uint32_t getProxyCount() const { return m_proxy_count; }
+        int32_t  getHeight() const { return m_root == k_null_node ? 0 : m_nodes[m_root].m_height; }
+
+        /**
+         *  Calls callback(proxy_id) for every proxy whose tight bounds overlap the query, stops
+         *  early when the callback returns false
+         */
+        template<typename TQuery, typename TCallback>
+        void query(const TQuery& query, TCallback&& callback) const;
+
+        // user data of every proxy overlapping each query, queries are spread over worker threads
+        template<typename TQuery>
+        void queryBatch(const std::vector<TQuery>& queries, std::vector<std::vector<uint64_t>>& out_results) const;
+
+    private:
+        static constexpr int32_t k_null_node = -1;
+
+        struct Node
+        {
+            // fat bounds for leaves, union of the children otherwise
+            AxisAlignedBox m_bounds;
+            AxisAlignedBox m_tight_bounds;
+            uint64_t       m_user_data {0};
+
+            int32_t m_parent {k_null_node};
+            int32_t m_next_free {k_null_node};
+            int32_t m_child1 {k_null_node};
+            int32_t m_child2 {k_null_node};
+            // leaf: 0, free node: -1
+            int32_t m_height {-1};
+
+            bool isLeaf() const { return m_child1 == k_null_node; }
+        };
+
+        int32_t allocateNode();
+        void    freeNode(int32_t node_index);
+
+        void    insertLeaf(int32_t leaf);
+        void    removeLeaf(int32_t leaf);
+        int32_t balance(int32_t node_index);
+        void    refitNode(int32_t node_index);
+
+        AxisAlignedBox getFattenedBounds(const AxisAlignedBox& bounds) const;
+
+        std::vector<Node> m_nodes;
+        int32_t           m_root {k_null_node};
+        int32_t           m_free_list {k_null_node};
+        uint32_t          m_proxy_count {0};
+        float             m_fat_margin {0.1f};
+    };
+
+    template<typename TQuery, typename TCallback>
+    void DynamicBVH::query(const TQuery& query, TCallback&& callback) const
+    {
+        if (m_root == k_null_node)
+        {
+            return;
+        }
+
+        int32_t              local_stack[64];
+        std::vector<int32_t> overflow_stack;
+        int32_t              stack_size = 0;
+        local_stack[stack_size++]       = m_root;
+
+        while (stack_size > 0 || !overflow_stack.empty())
+        {
+            int32_t node_index;
+            if (!overflow_stack.empty())
+            {
+                node_index = overflow_stack.back();
+                overflow_stack.pop_back();
+            }
+            else
+            {
+                node_index = local_stack[--stack_size];
+            }
+
+            const Node& node = m_nodes[node_index];
+            if (!query.overlaps(node.m_bounds))
+            {
+                continue;
+            }
+
+            if (node.isLeaf())
+            {
+                if (query.overlaps(node.m_tight_bounds) && !callback(node_index))
+                {
+                    return;
+                }
+                continue;
+            }
+
+            for (int32_t child : {node.m_child1, node.m_child2})
+            {
+                if (stack_size < 64)
+                {
+                    local_stack[stack_size++] = child;
+                }
+                else
+                {
+                    overflow_stack.push_back(child);
+                }
+            }
+        }
+    }
+
+    template<typename TQuery>
+    void DynamicBVH::queryBatch(const std::vector<TQuery>& queries, std::vector<std::vector<uint64_t>>& out_results) const
+    {
+        // fewer queries than this are answered on the calling thread
+        constexpr size_t k_parallel_query_min_count = 64;
+
+        out_results.resize(queries.size());
+
+        auto run_range = [this, &queries, &out_results](size_t begin, size_t end) {
+            for (size_t query_index = begin; query_index < end; ++query_index)
+            {
+                std::vector<uint64_t>& result = out_results[query_index];
+                result.clear();
+                query(queries[query_index], [this, &result](BVHProxyID proxy_id) {
+                    result.push_back(m_nodes[proxy_id].m_user_data);
+                    return true;
+                });
+            }
+        };
+
+        ThreadPool&  thread_pool  = ThreadPool::getInstance();
+        const size_t worker_count = thread_pool.getThreadCount();
+        if (queries.size() < k_parallel_query_min_count || worker_count == 1)
+        {
+            run_range(0, queries.size());
+            return;
+        }
+
+        const size_t chunk_count = std::min(worker_count, queries.size() / (k_parallel_query_min_count / 2));
+        const size_t chunk_size  = (queries.size() + chunk_count - 1) / chunk_count;
+
+        thread_pool.parallelFor(static_cast<uint32_t>(chunk_count), [&](uint32_t chunk_index) {
+            const size_t begin = std::min(queries.size(), chunk_index * chunk_size);
+            run_range(begin, std::min(queries.size(), begin + chunk_size));
+        });
+    }
+} // namespace Polaris
@@ -41,7 +41,7 @@ namespace Polaris
     </pre>
     */
     REFLECTION_TYPE(Matrix4x4_)
-    CLASS(Matrix4x4_, Fields)
+    CLASS(Matrix4x4_, Fields, CompactArray)
     {
         REFLECTION_BODY(Matrix4x4_);
 
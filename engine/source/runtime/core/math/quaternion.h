@@ -11,7 +11,7 @@ namespace Polaris
     class Vector3;
 
     REFLECTION_TYPE(Quaternion)
-    CLASS(Quaternion, Fields)
+    CLASS(Quaternion, Fields, CompactArray)
     {
         REFLECTION_BODY(Quaternion);
 
@@ -27,5 +27,19 @@ namespace Polaris
             temp.makeTransform(m_position, m_scale, m_rotation);
             return temp;
         }
+
+        // nlerp on the rotation, alpha 0 gives from and 1 gives to
+        static Transform lerp(const Transform& from, const Transform& to, float alpha)
+        {
+            return Transform(Vector3::lerp(from.m_position, to.m_position, alpha),
+                             Quaternion::nLerp(alpha, from.m_rotation, to.m_rotation, true),
+                             Vector3::lerp(from.m_scale, to.m_scale, alpha));
+        }
+
+        bool operator==(const Transform& rhs) const
+        {
+            return m_position == rhs.m_position && m_scale == rhs.m_scale && m_rotation == rhs.m_rotation;
+        }
+        bool operator!=(const Transform& rhs) const { return !(*this == rhs); }
     };
 } // namespace Polaris
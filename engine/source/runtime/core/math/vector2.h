@@ -9,7 +9,7 @@
 namespace Polaris
 {
     REFLECTION_TYPE(Vector2)
-    CLASS(Vector2, Fields)
+    CLASS(Vector2, Fields, CompactArray)
     {
         REFLECTION_BODY(Vector2);
 
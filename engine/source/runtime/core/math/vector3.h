@@ -9,7 +9,7 @@
 namespace Polaris
 {
     REFLECTION_TYPE(Vector3)
-    CLASS(Vector3, Fields)
+    CLASS(Vector3, Fields, CompactArray)
     {
         REFLECTION_BODY(Vector3);
 
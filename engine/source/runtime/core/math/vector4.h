@@ -7,7 +7,7 @@
 namespace Polaris
 {
     REFLECTION_TYPE(Vector4)
-    CLASS(Vector4, Fields)
+    CLASS(Vector4, Fields, CompactArray)
     {
         REFLECTION_BODY(Vector4);
 
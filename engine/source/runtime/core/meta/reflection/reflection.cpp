@@ -136,6 +136,29 @@ namespace Polaris
             return Json();
         }
 
+        bool TypeMeta::readByName(std::string type_name, const Json& json_context, void* instance)
+        {
+            auto iter = m_class_map.find(type_name);
+
+            if (iter != m_class_map.end())
+            {
+                std::get<3>(*iter->second)(json_context, instance);
+                return true;
+            }
+            return false;
+        }
+
+        Json TypeMeta::writeDeltaByName(std::string type_name, void* instance, void* prototype)
+        {
+            auto iter = m_class_map.find(type_name);
+
+            if (iter != m_class_map.end())
+            {
+                return std::get<4>(*iter->second)(instance, prototype);
+            }
+            return Json();
+        }
+
         std::string TypeMeta::getTypeName() { return m_type_name; }
 
         int TypeMeta::getFieldsList(FieldAccessor*& out_list)
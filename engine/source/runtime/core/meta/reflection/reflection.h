@@ -87,12 +87,19 @@ namespace Polaris
 
     typedef std::function<void*(const Json&)>                           ConstructorWithJson;
     typedef std::function<Json(void*)>                                  WriteJsonByName;
+    typedef std::function<void(const Json&, void*)>                     ReadJsonByName;
+    typedef std::function<Json(void*, void*)>                           WriteDeltaJsonByName;
     typedef std::function<int(Reflection::ReflectionInstance*&, void*)> GetBaseClassReflectionInstanceListFunc;
 
     typedef std::tuple<SetFuncion, GetFuncion, GetNameFuncion, GetNameFuncion, GetNameFuncion, GetBoolFunc>
                                                        FieldFunctionTuple;
     typedef std::tuple<GetNameFuncion, InvokeFunction> MethodFunctionTuple;
-    typedef std::tuple<GetBaseClassReflectionInstanceListFunc, ConstructorWithJson, WriteJsonByName> ClassFunctionTuple;
+    typedef std::tuple<GetBaseClassReflectionInstanceListFunc,
+                       ConstructorWithJson,
+                       WriteJsonByName,
+                       ReadJsonByName,
+                       WriteDeltaJsonByName>
+        ClassFunctionTuple;
     typedef std::tuple<SetArrayFunc, GetArrayFunc, GetSizeFunc, GetNameFuncion, GetNameFuncion>      ArrayFunctionTuple;
 
     namespace Reflection
@@ -124,6 +131,8 @@ namespace Polaris
             static bool               newArrayAccessorFromName(std::string array_type_name, ArrayAccessor& accessor);
             static ReflectionInstance newFromNameAndJson(std::string type_name, const Json& json_context);
             static Json               writeByName(std::string type_name, void* instance);
+            static bool               readByName(std::string type_name, const Json& json_context, void* instance);
+            static Json               writeDeltaByName(std::string type_name, void* instance, void* prototype);
 
             std::string getTypeName();
 
@@ -87,6 +87,17 @@ namespace Polaris
         return instance = json_context.string_value();
     }
 
+    template<>
+    Json Serializer::write(const Json& instance)
+    {
+        return instance;
+    }
+    template<>
+    Json& Serializer::read(const Json& json_context, Json& instance)
+    {
+        return instance = json_context;
+    }
+
     // template<>
     // Json Serializer::write(const Reflection::object& instance)
     //{
@@ -54,6 +54,47 @@ namespace Polaris
             return readPointer(json_context, instance.getPtrReference());
         }
 
+        template<typename T>
+        static Json writeDelta(const Reflection::ReflectionPtr<T>& instance,
+                               const Reflection::ReflectionPtr<T>& prototype)
+        {
+            // polymorphic pointers are compared as a whole, a partial pointer context can not be read back
+            if (!prototype || instance.getTypeName() != prototype.getTypeName())
+            {
+                return write(instance);
+            }
+            T* instance_ptr  = static_cast<T*>(instance.operator->());
+            T* prototype_ptr = static_cast<T*>(prototype.operator->());
+            if (Reflection::TypeMeta::writeDeltaByName(instance.getTypeName(), instance_ptr, prototype_ptr).is_null())
+            {
+                return Json();
+            }
+            return write(instance);
+        }
+
+        /**
+         *  Write only the parts of instance that differ from prototype,
+         *  return a null Json if they are the same
+         */
+        template<typename T>
+        static Json writeDelta(const T& instance, const T& prototype)
+        {
+            if constexpr (std::is_arithmetic<T>::value || std::is_same<T, std::string>::value ||
+                          std::is_same<T, Json>::value)
+            {
+                return instance == prototype ? Json() : write(instance);
+            }
+            else if constexpr (std::is_pointer<T>::value)
+            {
+                return write(instance);
+            }
+            else
+            {
+                static_assert(always_false<T>, "Serializer::writeDelta<T> has not been implemented yet!");
+                return Json();
+            }
+        }
+
         template<typename T>
         static Json write(const T& instance)
         {
@@ -120,6 +161,11 @@ namespace Polaris
     template<>
     std::string& Serializer::read(const Json& json_context, std::string& instance);
 
+    template<>
+    Json Serializer::write(const Json& instance);
+    template<>
+    Json& Serializer::read(const Json& json_context, Json& instance);
+
     // template<>
     // Json Serializer::write(const Reflection::object& instance);
     // template<>
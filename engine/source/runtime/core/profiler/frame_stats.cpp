@@ -0,0 +1,192 @@
+#include "runtime/core/profiler/frame_stats.h"
+
+#include "runtime/core/base/macro.h"
+#include "runtime/core/profiler/profiler.h"
+
+#include <algorithm>
+#include <cassert>
+#include <fstream>
+
+namespace Polaris
+{
+    namespace
+    {
+        float toMilliseconds(std::chrono::steady_clock::duration duration)
+        {
+            return std::chrono::duration<float, std::milli>(duration).count();
+        }
+
+        float percentile(const std::vector<float>& sorted_values, float fraction)
+        {
+            const size_t index = std::min(sorted_values.size() - 1, static_cast<size_t>(sorted_values.size() * fraction));
+            return sorted_values[index];
+        }
+    } // namespace
+
+    FrameStats::FrameStats() : m_samples(k_capacity) {}
+
+    void FrameStats::beginFrame()
+    {
+        const auto now = std::chrono::steady_clock::now();
+        if (m_is_frame_open)
+        {
+            closeFrame(now);
+        }
+
+        m_current               = FrameTimeSample();
+        m_current.m_frame_index = m_recorded_count;
+        m_frame_begin           = now;
+        m_is_frame_open         = true;
+    }
+
+    void FrameStats::beginPhase(FramePhase phase)
+    {
+        m_phase_begin[static_cast<size_t>(phase)] = std::chrono::steady_clock::now();
+    }
+
+    void FrameStats::endPhase(FramePhase phase)
+    {
+        const size_t phase_index = static_cast<size_t>(phase);
+        m_current.m_phase_ms[phase_index] += toMilliseconds(std::chrono::steady_clock::now() - m_phase_begin[phase_index]);
+    }
+
+    void FrameStats::closeFrame(std::chrono::steady_clock::time_point frame_end)
+    {
+        float& frame_ms = m_current.m_phase_ms[static_cast<size_t>(FramePhase::frame)];
+        frame_ms        = toMilliseconds(frame_end - m_frame_begin);
+
+        const float work_ms = m_current.getPhaseMs(FramePhase::logic) + m_current.getPhaseMs(FramePhase::render);
+        m_current.m_phase_ms[static_cast<size_t>(FramePhase::wait)] = std::max(0.f, frame_ms - work_ms);
+
+        m_samples[m_recorded_count % k_capacity] = m_current;
+        m_recorded_count++;
+
+        if (m_stall_threshold_ms > 0.f && frame_ms > m_stall_threshold_ms)
+        {
+            reportStall(m_current);
+        }
+    }
+
+    /*
+    * The profiler has just drained the zones of the stalled frame in the PROFILE_FRAME that precedes beginFrame
+    */
+    void FrameStats::reportStall(const FrameTimeSample& sample) const
+    {
+        LOG_WARN("frame {} stalled: {:.2f} ms (logic {:.2f} ms, render {:.2f} ms, wait {:.2f} ms)",
+                 sample.m_frame_index,
+                 sample.getPhaseMs(FramePhase::frame),
+                 sample.getPhaseMs(FramePhase::logic),
+                 sample.getPhaseMs(FramePhase::render),
+                 sample.getPhaseMs(FramePhase::wait));
+
+        std::vector<ProfileZoneEvent> zone_events = Profiler::getInstance().getLastFrameEvents();
+        std::sort(zone_events.begin(), zone_events.end(), [](const ProfileZoneEvent& lhs, const ProfileZoneEvent& rhs) {
+            return lhs.m_begin_ns < rhs.m_begin_ns;
+        });
+        for (const ProfileZoneEvent& zone_event : zone_events)
+        {
+            LOG_WARN("{:>{}}{} {:.3f} ms",
+                     "",
+                     zone_event.m_depth * 2,
+                     zone_event.m_name,
+                     (zone_event.m_end_ns - zone_event.m_begin_ns) * 1e-6);
+        }
+    }
+
+    uint32_t FrameStats::getSampleCount() const
+    {
+        return static_cast<uint32_t>(std::min<uint64_t>(m_recorded_count, k_capacity));
+    }
+
+    const FrameTimeSample& FrameStats::getSample(uint32_t frames_ago) const
+    {
+        assert(frames_ago < getSampleCount());
+        return m_samples[(m_recorded_count - 1 - frames_ago) % k_capacity];
+    }
+
+    void FrameStats::collectWindow(FramePhase phase, uint32_t window_size, std::vector<float>& out_values) const
+    {
+        const uint32_t sample_count = getSampleCount();
+        if (window_size == 0 || window_size > sample_count)
+        {
+            window_size = sample_count;
+        }
+
+        out_values.clear();
+        out_values.reserve(window_size);
+        for (uint32_t frames_ago = 0; frames_ago < window_size; ++frames_ago)
+        {
+            out_values.push_back(getSample(frames_ago).getPhaseMs(phase));
+        }
+    }
+
+    FrameTimePercentiles FrameStats::getPercentiles(FramePhase phase, uint32_t window_size) const
+    {
+        std::vector<float> values;
+        collectWindow(phase, window_size, values);
+
+        FrameTimePercentiles percentiles;
+        if (values.empty())
+        {
+            return percentiles;
+        }
+
+        std::sort(values.begin(), values.end());
+
+        float total_ms = 0.f;
+        for (float value : values)
+        {
+            total_ms += value;
+        }
+
+        percentiles.m_sample_count = static_cast<uint32_t>(values.size());
+        percentiles.m_avg_ms       = total_ms / values.size();
+        percentiles.m_p50_ms       = percentile(values, 0.50f);
+        percentiles.m_p95_ms       = percentile(values, 0.95f);
+        percentiles.m_p99_ms       = percentile(values, 0.99f);
+        percentiles.m_max_ms       = values.back();
+        return percentiles;
+    }
+
+    std::vector<uint32_t>
+    FrameStats::getHistogram(FramePhase phase, float bucket_ms, uint32_t bucket_count, uint32_t window_size) const
+    {
+        std::vector<uint32_t> histogram(bucket_count, 0);
+        if (bucket_count == 0 || bucket_ms <= 0.f)
+        {
+            return histogram;
+        }
+
+        std::vector<float> values;
+        collectWindow(phase, window_size, values);
+        for (float value : values)
+        {
+            const uint32_t bucket = std::min(bucket_count - 1, static_cast<uint32_t>(value / bucket_ms));
+            histogram[bucket]++;
+        }
+        return histogram;
+    }
+
+    bool FrameStats::dumpToFile(const std::string& file_path) const
+    {
+        std::ofstream dump_file(file_path);
+        if (!dump_file)
+        {
+            LOG_ERROR("open frame stats file {} failed!", file_path);
+            return false;
+        }
+
+        dump_file << "frame,frame_ms,logic_ms,render_ms,wait_ms\n";
+        for (uint32_t frames_ago = getSampleCount(); frames_ago > 0; --frames_ago)
+        {
+            const FrameTimeSample& sample = getSample(frames_ago - 1);
+            dump_file << sample.m_frame_index << ',' << sample.getPhaseMs(FramePhase::frame) << ','
+                      << sample.getPhaseMs(FramePhase::logic) << ',' << sample.getPhaseMs(FramePhase::render) << ','
+                      << sample.getPhaseMs(FramePhase::wait) << '\n';
+        }
+        dump_file.flush();
+
+        LOG_INFO("frame stats of {} frames written to {}", getSampleCount(), file_path);
+        return true;
+    }
+} // namespace Polaris
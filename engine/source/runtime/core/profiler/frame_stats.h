@@ -0,0 +1,89 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Polaris
+{
+    enum class FramePhase : uint8_t
+    {
+        frame,
+        logic,
+        render,
+        wait, // everything outside of logic and render: event polling, editor ui, frame pacing
+        count
+    };
+
+    struct FrameTimeSample
+    {
+        uint64_t m_frame_index {0};
+        float    m_phase_ms[static_cast<size_t>(FramePhase::count)] {};
+
+        float getPhaseMs(FramePhase phase) const { return m_phase_ms[static_cast<size_t>(phase)]; }
+    };
+
+    struct FrameTimePercentiles
+    {
+        uint32_t m_sample_count {0};
+        float    m_avg_ms {0.f};
+        float    m_p50_ms {0.f};
+        float    m_p95_ms {0.f};
+        float    m_p99_ms {0.f};
+        float    m_max_ms {0.f};
+    };
+
+    /**
+     *  Per-frame phase durations kept in a ring buffer of the last k_capacity frames.
+     *  A frame is closed by the next beginFrame, so its duration includes the time
+     *  spent between two tickOneFrame calls
+     */
+    class FrameStats
+    {
+    public:
+        static constexpr uint32_t k_capacity = 4096;
+
+        FrameStats();
+
+        void beginFrame();
+        void beginPhase(FramePhase phase);
+        void endPhase(FramePhase phase);
+
+        // frames slower than the threshold are logged with the profile zones of that frame, 0 disables it
+        void  setStallThreshold(float threshold_ms) { m_stall_threshold_ms = threshold_ms; }
+        float getStallThreshold() const { return m_stall_threshold_ms; }
+
+        uint32_t               getSampleCount() const;
+        const FrameTimeSample& getSample(uint32_t frames_ago) const;
+
+        // percentiles over the last window_size frames, 0 means every recorded frame
+        FrameTimePercentiles getPercentiles(FramePhase phase, uint32_t window_size = 0) const;
+
+        /**
+         *  Count frames of the window into bucket_count buckets of bucket_ms each,
+         *  the last bucket also counts everything slower
+         */
+        std::vector<uint32_t>
+        getHistogram(FramePhase phase, float bucket_ms, uint32_t bucket_count, uint32_t window_size = 0) const;
+
+        // write every recorded frame as csv for offline analysis
+        bool dumpToFile(const std::string& file_path) const;
+
+    private:
+        void closeFrame(std::chrono::steady_clock::time_point frame_end);
+        void reportStall(const FrameTimeSample& sample) const;
+        void collectWindow(FramePhase phase, uint32_t window_size, std::vector<float>& out_values) const;
+
+    private:
+        std::vector<FrameTimeSample> m_samples;
+        uint64_t                     m_recorded_count {0};
+
+        bool                                  m_is_frame_open {false};
+        std::chrono::steady_clock::time_point m_frame_begin;
+        std::chrono::steady_clock::time_point m_phase_begin[static_cast<size_t>(FramePhase::count)];
+        FrameTimeSample                       m_current;
+
+        float m_stall_threshold_ms {0.f};
+    };
+} // namespace Polaris
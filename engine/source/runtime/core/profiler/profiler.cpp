@@ -0,0 +1,297 @@
+#include "runtime/core/profiler/profiler.h"
+
+#include "runtime/core/base/macro.h"
+#include "runtime/core/meta/json.h"
+
+#include <algorithm>
+#include <fstream>
+
+namespace Polaris
+{
+    ProfileThreadBuffer::ProfileThreadBuffer(uint32_t thread_index, std::string thread_name) :
+        m_slots(new Slot[k_capacity]), m_thread_index(thread_index), m_thread_name(std::move(thread_name))
+    {}
+
+    void ProfileThreadBuffer::drain(std::vector<ProfileZoneEvent>& out_events)
+    {
+        const uint64_t write_index = m_write_index.load(std::memory_order_acquire);
+        if (write_index - m_read_index > k_capacity)
+        {
+            m_read_index = write_index - k_capacity;
+        }
+
+        for (uint64_t index = m_read_index; index < write_index; ++index)
+        {
+            const Slot& slot = m_slots[index & (k_capacity - 1)];
+
+            const uint64_t sequence = slot.m_sequence.load(std::memory_order_acquire);
+            ProfileZoneEvent zone_event;
+            zone_event.m_name     = slot.m_name.load(std::memory_order_relaxed);
+            zone_event.m_begin_ns = slot.m_begin_ns.load(std::memory_order_relaxed);
+            zone_event.m_end_ns   = slot.m_end_ns.load(std::memory_order_relaxed);
+            zone_event.m_depth    = slot.m_depth.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            // the producer lapped the ring and rewrote the slot while it was being copied, drop it
+            if (sequence != index + 1 || slot.m_sequence.load(std::memory_order_relaxed) != sequence)
+            {
+                continue;
+            }
+            out_events.push_back(zone_event);
+        }
+
+        m_read_index = write_index;
+    }
+
+    Profiler::Profiler() : m_epoch(std::chrono::steady_clock::now()) {}
+
+    ProfileThreadBuffer& Profiler::getThreadBuffer()
+    {
+        // buffers are owned by the profiler so events of finished threads can still be drained
+        static thread_local ProfileThreadBuffer* thread_buffer = nullptr;
+        if (!thread_buffer)
+        {
+            std::lock_guard<std::mutex> lock(m_thread_buffers_mutex);
+            const uint32_t thread_index = static_cast<uint32_t>(m_thread_buffers.size());
+            m_thread_buffers.push_back(
+                std::make_unique<ProfileThreadBuffer>(thread_index, "thread " + std::to_string(thread_index)));
+            thread_buffer = m_thread_buffers.back().get();
+        }
+        return *thread_buffer;
+    }
+
+    void Profiler::setThreadName(const std::string& thread_name)
+    {
+        ProfileThreadBuffer& thread_buffer = getThreadBuffer();
+
+        std::lock_guard<std::mutex> lock(m_thread_buffers_mutex);
+        thread_buffer.setThreadName(thread_name);
+    }
+
+    ProfileThreadBuffer& Profiler::createTrack(const std::string& track_name)
+    {
+        std::lock_guard<std::mutex> lock(m_thread_buffers_mutex);
+        const uint32_t thread_index = static_cast<uint32_t>(m_thread_buffers.size());
+        m_thread_buffers.push_back(std::make_unique<ProfileThreadBuffer>(thread_index, track_name));
+        return *m_thread_buffers.back();
+    }
+
+    const char* Profiler::internName(const std::string& zone_name)
+    {
+        // elements of an unordered_set keep their address across rehashes
+        std::lock_guard<std::mutex> lock(m_interned_names_mutex);
+        return m_interned_names.insert(zone_name).first->c_str();
+    }
+
+    void Profiler::markFrame()
+    {
+        std::lock_guard<std::mutex> stats_lock(m_stats_mutex);
+
+        m_drain_events.clear();
+        {
+            std::lock_guard<std::mutex> buffers_lock(m_thread_buffers_mutex);
+            for (const auto& thread_buffer : m_thread_buffers)
+            {
+                const size_t first_event = m_drain_events.size();
+                thread_buffer->drain(m_drain_events);
+
+                if (m_capture_frame_count > 0)
+                {
+                    for (size_t index = first_event; index < m_drain_events.size(); ++index)
+                    {
+                        m_capture_events.push_back({m_drain_events[index], thread_buffer->getThreadIndex()});
+                    }
+                }
+            }
+        }
+
+        for (const ProfileZoneEvent& zone_event : m_drain_events)
+        {
+            recordZone(zone_event);
+        }
+
+        if (m_capture_frame_count > 0)
+        {
+            // the capture starts at the next frame mark and ends frame_count marks later
+            m_capture_frame_marks.push_back(now());
+            if (m_capture_frame_marks.size() > m_capture_frame_count)
+            {
+                writeCapture();
+
+                m_capture_frame_count = 0;
+                m_capture_events.clear();
+                m_capture_frame_marks.clear();
+            }
+        }
+    }
+
+    void Profiler::captureFrames(uint32_t frame_count, const std::string& output_path)
+    {
+        std::lock_guard<std::mutex> lock(m_stats_mutex);
+
+        m_capture_frame_count = frame_count;
+        m_capture_path        = output_path;
+        m_capture_events.clear();
+        m_capture_frame_marks.clear();
+    }
+
+    std::vector<ProfileZoneEvent> Profiler::getLastFrameEvents() const
+    {
+        std::lock_guard<std::mutex> lock(m_stats_mutex);
+        return m_drain_events;
+    }
+
+    std::vector<ProfileZoneStats> Profiler::getZoneStats() const
+    {
+        std::lock_guard<std::mutex> lock(m_stats_mutex);
+
+        std::vector<ProfileZoneStats> zone_stats;
+        zone_stats.reserve(m_zone_records.size());
+        for (const auto& name_record_pair : m_zone_records)
+        {
+            zone_stats.push_back(makeStats(name_record_pair.first, name_record_pair.second));
+        }
+        return zone_stats;
+    }
+
+    bool Profiler::getZoneStats(const std::string& zone_name, ProfileZoneStats& out_stats) const
+    {
+        std::lock_guard<std::mutex> lock(m_stats_mutex);
+
+        auto iter = m_zone_records.find(zone_name);
+        if (iter == m_zone_records.end())
+        {
+            return false;
+        }
+
+        out_stats = makeStats(iter->first, iter->second);
+        return true;
+    }
+
+    void Profiler::resetZoneStats()
+    {
+        std::lock_guard<std::mutex> lock(m_stats_mutex);
+
+        m_zone_lookup.clear();
+        m_zone_records.clear();
+    }
+
+    void Profiler::recordZone(const ProfileZoneEvent& zone_event)
+    {
+        ZoneRecord*& record = m_zone_lookup[zone_event.m_name];
+        if (!record)
+        {
+            record = &m_zone_records[zone_event.m_name];
+            record->m_recent_ns.reserve(k_recent_sample_count);
+        }
+
+        const uint64_t duration_ns = zone_event.m_end_ns - zone_event.m_begin_ns;
+        record->m_call_count++;
+        record->m_total_ns += duration_ns;
+        record->m_min_ns = std::min(record->m_min_ns, duration_ns);
+        record->m_max_ns = std::max(record->m_max_ns, duration_ns);
+
+        if (record->m_recent_ns.size() < k_recent_sample_count)
+        {
+            record->m_recent_ns.push_back(duration_ns);
+        }
+        else
+        {
+            record->m_recent_ns[record->m_recent_cursor] = duration_ns;
+            record->m_recent_cursor                      = (record->m_recent_cursor + 1) % k_recent_sample_count;
+        }
+    }
+
+    /*
+    * Min, average and max cover the whole lifetime of the zone, p99 only the most recent samples
+    */
+    ProfileZoneStats Profiler::makeStats(const std::string& zone_name, const ZoneRecord& record)
+    {
+        static constexpr double k_ns_to_ms = 1e-6;
+
+        ProfileZoneStats stats;
+        stats.m_name       = zone_name;
+        stats.m_call_count = record.m_call_count;
+        if (record.m_call_count == 0)
+        {
+            return stats;
+        }
+
+        stats.m_min_ms = record.m_min_ns * k_ns_to_ms;
+        stats.m_max_ms = record.m_max_ns * k_ns_to_ms;
+        stats.m_avg_ms = static_cast<double>(record.m_total_ns) / record.m_call_count * k_ns_to_ms;
+
+        std::vector<uint64_t> samples = record.m_recent_ns;
+        const size_t          p99_index = samples.size() * 99 / 100;
+        std::nth_element(samples.begin(), samples.begin() + p99_index, samples.end());
+        stats.m_p99_ms = samples[p99_index] * k_ns_to_ms;
+
+        return stats;
+    }
+
+    /*
+    * Write the captured zones as complete events of the Chrome trace event format,
+    * which both chrome://tracing and Perfetto open
+    */
+    void Profiler::writeCapture() const
+    {
+        static constexpr double k_ns_to_us = 1e-3;
+
+        const uint64_t capture_begin_ns = m_capture_frame_marks.front();
+        const uint64_t capture_end_ns   = m_capture_frame_marks.back();
+
+        Json::array trace_events;
+        trace_events.reserve(m_capture_events.size() + m_capture_frame_marks.size() + m_thread_buffers.size());
+
+        {
+            std::lock_guard<std::mutex> lock(m_thread_buffers_mutex);
+            for (const auto& thread_buffer : m_thread_buffers)
+            {
+                trace_events.push_back(Json::object {{"name", "thread_name"},
+                                                     {"ph", "M"},
+                                                     {"pid", 0},
+                                                     {"tid", static_cast<int>(thread_buffer->getThreadIndex())},
+                                                     {"args", Json::object {{"name", thread_buffer->getThreadName()}}}});
+            }
+        }
+
+        for (size_t frame_index = 0; frame_index + 1 < m_capture_frame_marks.size(); ++frame_index)
+        {
+            trace_events.push_back(Json::object {{"name", "frame " + std::to_string(frame_index)},
+                                                 {"ph", "i"},
+                                                 {"s", "g"},
+                                                 {"pid", 0},
+                                                 {"tid", 0},
+                                                 {"ts", m_capture_frame_marks[frame_index] * k_ns_to_us}});
+        }
+
+        for (const CapturedEvent& captured_event : m_capture_events)
+        {
+            const ProfileZoneEvent& zone_event = captured_event.m_event;
+            if (zone_event.m_end_ns < capture_begin_ns || zone_event.m_begin_ns > capture_end_ns)
+            {
+                continue;
+            }
+
+            trace_events.push_back(Json::object {{"name", zone_event.m_name},
+                                                 {"ph", "X"},
+                                                 {"pid", 0},
+                                                 {"tid", static_cast<int>(captured_event.m_thread_index)},
+                                                 {"ts", zone_event.m_begin_ns * k_ns_to_us},
+                                                 {"dur", (zone_event.m_end_ns - zone_event.m_begin_ns) * k_ns_to_us},
+                                                 {"args", Json::object {{"depth", static_cast<int>(zone_event.m_depth)}}}});
+        }
+
+        std::ofstream trace_file(m_capture_path);
+        if (!trace_file)
+        {
+            LOG_ERROR("open profile capture file {} failed!", m_capture_path);
+            return;
+        }
+
+        trace_file << Json(Json::object {{"traceEvents", trace_events}, {"displayTimeUnit", "ns"}}).dump();
+        trace_file.flush();
+
+        LOG_INFO("profile capture of {} frames written to {}", m_capture_frame_marks.size() - 1, m_capture_path);
+    }
+} // namespace Polaris
@@ -0,0 +1,252 @@
+#pragma once
+
+#include "runtime/core/base/public_singleton.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// profiling markers are compiled in by default so that spikes can be captured in release builds
+#ifndef POLARIS_ENABLE_PROFILER
+#define POLARIS_ENABLE_PROFILER 1
+#endif
+
+namespace Polaris
+{
+    struct ProfileZoneEvent
+    {
+        const char* m_name {nullptr};
+        uint64_t    m_begin_ns {0};
+        uint64_t    m_end_ns {0};
+        uint32_t    m_depth {0};
+    };
+
+    struct ProfileZoneStats
+    {
+        std::string m_name;
+        uint64_t    m_call_count {0};
+        double      m_min_ms {0.0};
+        double      m_avg_ms {0.0};
+        double      m_max_ms {0.0};
+        double      m_p99_ms {0.0};
+    };
+
+    /**
+     *  Single producer single consumer ring of zone events, written only by its owner thread
+     *  and drained by the profiler once per frame. When the consumer falls behind, the oldest
+     *  events are overwritten and dropped. Every slot carries the index it was written for, so
+     *  the consumer can tell a slot the producer rewrote while it was being copied
+     */
+    class ProfileThreadBuffer
+    {
+    public:
+        static constexpr uint32_t k_capacity = 1u << 16;
+
+        ProfileThreadBuffer(uint32_t thread_index, std::string thread_name);
+
+        void push(const ProfileZoneEvent& zone_event)
+        {
+            const uint64_t write_index = m_write_index.load(std::memory_order_relaxed);
+            Slot&          slot        = m_slots[write_index & (k_capacity - 1)];
+
+            // the slot is invalid while its fields are half written
+            slot.m_sequence.store(0, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            slot.m_name.store(zone_event.m_name, std::memory_order_relaxed);
+            slot.m_begin_ns.store(zone_event.m_begin_ns, std::memory_order_relaxed);
+            slot.m_end_ns.store(zone_event.m_end_ns, std::memory_order_relaxed);
+            slot.m_depth.store(zone_event.m_depth, std::memory_order_relaxed);
+            slot.m_sequence.store(write_index + 1, std::memory_order_release);
+
+            m_write_index.store(write_index + 1, std::memory_order_release);
+        }
+
+        // copy out every event pushed since the last drain
+        void drain(std::vector<ProfileZoneEvent>& out_events);
+
+        uint32_t           getThreadIndex() const { return m_thread_index; }
+        const std::string& getThreadName() const { return m_thread_name; }
+        void               setThreadName(const std::string& thread_name) { m_thread_name = thread_name; }
+
+        uint32_t m_depth {0};
+
+    private:
+        struct Slot
+        {
+            // write index + 1 of the event in the slot, 0 while it is being written
+            std::atomic<uint64_t>    m_sequence {0};
+            std::atomic<const char*> m_name {nullptr};
+            std::atomic<uint64_t>    m_begin_ns {0};
+            std::atomic<uint64_t>    m_end_ns {0};
+            std::atomic<uint32_t>    m_depth {0};
+        };
+
+        std::unique_ptr<Slot[]> m_slots;
+        std::atomic<uint64_t>   m_write_index {0};
+        uint64_t                m_read_index {0};
+        uint32_t                m_thread_index {0};
+        std::string             m_thread_name;
+    };
+
+    class Profiler final : public PublicSingleton<Profiler>
+    {
+        friend class PublicSingleton<Profiler>;
+
+    public:
+        bool isEnabled() const { return m_is_enabled.load(std::memory_order_relaxed); }
+        void setEnabled(bool is_enabled) { m_is_enabled.store(is_enabled, std::memory_order_relaxed); }
+
+        // nanoseconds since the profiler was created
+        uint64_t now() const
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_epoch)
+                .count();
+        }
+
+        // steady_clock nanoseconds since its epoch to profiler time, for timestamps taken outside of now()
+        uint64_t fromSteadyClock(uint64_t steady_clock_ns) const
+        {
+            const uint64_t epoch_ns =
+                std::chrono::duration_cast<std::chrono::nanoseconds>(m_epoch.time_since_epoch()).count();
+            return steady_clock_ns > epoch_ns ? steady_clock_ns - epoch_ns : 0;
+        }
+
+        ProfileThreadBuffer& getThreadBuffer();
+        void                 setThreadName(const std::string& thread_name);
+
+        /**
+         *  A track of its own that is not bound to the calling thread, for timelines recorded
+         *  elsewhere such as a GPU queue. Only one thread at a time may push to it
+         */
+        ProfileThreadBuffer& createTrack(const std::string& track_name);
+
+        // zone names built at runtime, the returned pointer stays valid as long as the profiler
+        const char* internName(const std::string& zone_name);
+
+        /**
+         *  Call once per frame from the main thread. Drains all thread buffers into the
+         *  zone statistics and, while a capture is running, into the capture
+         */
+        void markFrame();
+
+        /**
+         *  Record the next frame_count frames and write them as a Chrome/Perfetto trace json
+         *  to output_path once they are done
+         */
+        void captureFrames(uint32_t frame_count, const std::string& output_path);
+        bool isCapturing() const { return m_capture_frame_count.load(std::memory_order_relaxed) > 0; }
+
+        // zones of every thread drained by the last markFrame
+        std::vector<ProfileZoneEvent> getLastFrameEvents() const;
+
+        std::vector<ProfileZoneStats> getZoneStats() const;
+        bool                          getZoneStats(const std::string& zone_name, ProfileZoneStats& out_stats) const;
+        void                          resetZoneStats();
+
+    private:
+        Profiler();
+
+        struct ZoneRecord
+        {
+            uint64_t              m_call_count {0};
+            uint64_t              m_total_ns {0};
+            uint64_t              m_min_ns {UINT64_MAX};
+            uint64_t              m_max_ns {0};
+            std::vector<uint64_t> m_recent_ns;
+            size_t                m_recent_cursor {0};
+        };
+
+        struct CapturedEvent
+        {
+            ProfileZoneEvent m_event;
+            uint32_t         m_thread_index {0};
+        };
+
+        void recordZone(const ProfileZoneEvent& zone_event);
+        void writeCapture() const;
+
+        static ProfileZoneStats makeStats(const std::string& zone_name, const ZoneRecord& record);
+
+    private:
+        static constexpr size_t k_recent_sample_count = 1024;
+
+        std::atomic<bool>                     m_is_enabled {true};
+        std::chrono::steady_clock::time_point m_epoch;
+
+        mutable std::mutex                                m_thread_buffers_mutex;
+        std::vector<std::unique_ptr<ProfileThreadBuffer>> m_thread_buffers;
+
+        std::mutex                      m_interned_names_mutex;
+        std::unordered_set<std::string> m_interned_names;
+
+        // the same literal may have a different address per translation unit, so records are keyed by name
+        mutable std::mutex                           m_stats_mutex;
+        std::unordered_map<std::string, ZoneRecord>  m_zone_records;
+        std::unordered_map<const char*, ZoneRecord*> m_zone_lookup;
+        std::vector<ProfileZoneEvent>                m_drain_events;
+
+        // written under m_stats_mutex, atomic so isCapturing can poll it without the lock
+        std::atomic<uint32_t>      m_capture_frame_count {0};
+        std::string                m_capture_path;
+        std::vector<CapturedEvent> m_capture_events;
+        std::vector<uint64_t>      m_capture_frame_marks;
+    };
+
+    /**
+     *  RAII zone, the event is pushed when the scope ends. Zone names must be string
+     *  literals since only the pointer is stored
+     */
+    class ProfileScope
+    {
+    public:
+        explicit ProfileScope(const char* zone_name)
+        {
+            Profiler& profiler = Profiler::getInstance();
+            if (!profiler.isEnabled())
+                return;
+
+            m_buffer                = &profiler.getThreadBuffer();
+            m_zone_event.m_name     = zone_name;
+            m_zone_event.m_depth    = m_buffer->m_depth++;
+            m_zone_event.m_begin_ns = profiler.now();
+        }
+
+        ~ProfileScope()
+        {
+            if (!m_buffer)
+                return;
+
+            m_zone_event.m_end_ns = Profiler::getInstance().now();
+            m_buffer->m_depth--;
+            m_buffer->push(m_zone_event);
+        }
+
+        ProfileScope(const ProfileScope&) = delete;
+        ProfileScope& operator=(const ProfileScope&) = delete;
+
+    private:
+        ProfileThreadBuffer* m_buffer {nullptr};
+        ProfileZoneEvent     m_zone_event;
+    };
+} // namespace Polaris
+
+#define PROFILE_CONCAT_IMPL(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+
+#if POLARIS_ENABLE_PROFILER
+#define PROFILE_SCOPE(zone_name) Polaris::ProfileScope PROFILE_CONCAT(profile_scope_, __LINE__)(zone_name)
+#define PROFILE_FUNCTION() PROFILE_SCOPE(__FUNCTION__)
+#define PROFILE_FRAME() Polaris::Profiler::getInstance().markFrame()
+#define PROFILE_THREAD(thread_name) Polaris::Profiler::getInstance().setThreadName(thread_name)
+#else
+#define PROFILE_SCOPE(zone_name)
+#define PROFILE_FUNCTION()
+#define PROFILE_FRAME()
+#define PROFILE_THREAD(thread_name)
+#endif
@@ -1,12 +1,18 @@
 #include "runtime/engine.h"
 
 #include "runtime/core/base/macro.h"
+#include "runtime/core/profiler/profiler.h"
 #include "runtime/core/meta/reflection/reflection_register.h"
 
 #include "runtime/function/framework/world/world_manager.h"
 #include "runtime/function/global/global_context.h"
 #include "runtime/function/render/window_system.h"
 #include "runtime/function/render/render_system.h"
+#include "runtime/resource/config_manager/config_manager.h"
+
+#include <algorithm>
+#include <cmath>
+#include <csignal>
 
 
 
@@ -16,10 +22,29 @@ namespace Polaris
 	bool                            g_is_editor_mode{ false };
 	std::unordered_set<std::string> g_editor_tick_component_types{};
 
+	namespace
+	{
+		// set by SIGINT or SIGTERM, a headless run without a tick limit ends on it and still reports
+		volatile std::sig_atomic_t g_headless_stop_requested{ 0 };
+
+		void requestHeadlessStop(int) { g_headless_stop_requested = 1; }
+	} // namespace
+
 	void PolarisEngine::startEngine(const std::string& config_file_path)
 	{
+		PROFILE_THREAD("main");
+
 		Reflection::TypeMetaRegister::metaRegister();
 		g_runtime_global_context.startSystems(config_file_path);
+
+		const ConfigManager& config_manager = *g_runtime_global_context.m_config_manager;
+
+		m_is_headless = config_manager.isHeadless();
+		m_fixed_delta_time = 1.f / std::max(config_manager.getLogicTickRate(), 1.f);
+		m_max_logic_steps_per_frame = std::max(config_manager.getMaxLogicStepsPerFrame(), 1u);
+		m_frame_limiter.setTargetPeriod(config_manager.getFrameRateLimit() > 0.f ? 1.0 / config_manager.getFrameRateLimit() : 0.0);
+		m_frame_stats.setStallThreshold(config_manager.getFrameStallThreshold());
+
 		LOG_INFO("engine start");
 	}
 
@@ -27,6 +52,12 @@ namespace Polaris
 	{
 		LOG_INFO("engine shutdown");
 
+		const std::filesystem::path& frame_stats_file = g_runtime_global_context.m_config_manager->getFrameStatsFile();
+		if (!frame_stats_file.empty())
+		{
+			m_frame_stats.dumpToFile(frame_stats_file.generic_string());
+		}
+
 		g_runtime_global_context.shutdownSystems();
 	}
 
@@ -42,7 +73,88 @@ namespace Polaris
 
 	void PolarisEngine::run()
 	{
+		if (m_is_headless)
+		{
+			runHeadless();
+			return;
+		}
+
+		while (!m_is_quit)
+		{
+			float delta_time = calculateDeltaTime();
+			if (!tickOneFrame(delta_time))
+			{
+				break;
+			}
+		}
+	}
+
+	void PolarisEngine::runHeadless()
+	{
+		using namespace std::chrono;
+		static const steady_clock::duration k_report_interval = seconds(5);
+
+		const ConfigManager& config_manager = *g_runtime_global_context.m_config_manager;
+		const float          tick_rate = std::max(config_manager.getHeadlessTickRate(), 1.f);
+		const float          fixed_delta_time = 1.f / tick_rate;
+		const bool           is_realtime = config_manager.isHeadlessRealtime();
+		const uint64_t       max_ticks = config_manager.getHeadlessMaxTicks();
+
+		FrameLimiter tick_limiter;
+		if (is_realtime)
+		{
+			tick_limiter.setTargetPeriod(fixed_delta_time);
+		}
 
+		LOG_INFO("headless run at {} ticks per simulated second, {}", tick_rate, is_realtime ? "realtime" : "unpaced");
+
+		g_headless_stop_requested = 0;
+		auto previous_sigint_handler  = std::signal(SIGINT, requestHeadlessStop);
+		auto previous_sigterm_handler = std::signal(SIGTERM, requestHeadlessStop);
+
+		const steady_clock::time_point run_begin = steady_clock::now();
+		steady_clock::time_point report_begin = run_begin;
+		uint64_t tick_count = 0;
+		uint64_t report_tick_count = 0;
+
+		while (!m_is_quit && (max_ticks == 0 || tick_count < max_ticks))
+		{
+			PROFILE_FRAME();
+			m_frame_stats.beginFrame();
+
+			logicalTick(fixed_delta_time);
+			tick_count++;
+
+			tick_limiter.wait();
+
+			if (g_headless_stop_requested)
+			{
+				LOG_INFO("headless run interrupted");
+				m_is_quit = true;
+			}
+
+			const steady_clock::time_point now = steady_clock::now();
+			if (now - report_begin >= k_report_interval)
+			{
+				const double report_seconds = duration<double>(now - report_begin).count();
+				LOG_INFO("headless {:.1f} ticks per second", (tick_count - report_tick_count) / report_seconds);
+
+				report_begin = now;
+				report_tick_count = tick_count;
+			}
+		}
+
+		std::signal(SIGINT, previous_sigint_handler);
+		std::signal(SIGTERM, previous_sigterm_handler);
+
+		const double         run_seconds = duration<double>(steady_clock::now() - run_begin).count();
+		FrameTimePercentiles tick_percentiles = m_frame_stats.getPercentiles(FramePhase::logic);
+		LOG_INFO("headless run finished: {} ticks in {:.2f} s, {:.1f} ticks per second, tick p50 {:.3f} ms p99 {:.3f} ms",
+			tick_count,
+			run_seconds,
+			run_seconds > 0.0 ? tick_count / run_seconds : 0.0,
+			tick_percentiles.m_p50_ms,
+			tick_percentiles.m_p99_ms);
 	}
 
 	float PolarisEngine::calculateDeltaTime()
@@ -63,11 +175,40 @@ namespace Polaris
 
 	bool PolarisEngine::tickOneFrame(float delta_time)
 	{
-		logicalTick(delta_time);
+		PROFILE_FRAME();
+		PROFILE_SCOPE("tickOneFrame");
+		m_frame_stats.beginFrame();
+
+		// fixed step logic, a frame longer than the catch-up cap drops the time it cannot simulate
+		m_logic_time_accumulator += delta_time;
+		uint32_t logic_step_count = 0;
+		while (m_logic_time_accumulator >= m_fixed_delta_time && logic_step_count < m_max_logic_steps_per_frame)
+		{
+			logicalTick(m_fixed_delta_time);
+			m_logic_time_accumulator -= m_fixed_delta_time;
+			++logic_step_count;
+		}
+		if (m_logic_time_accumulator >= m_fixed_delta_time)
+		{
+			m_logic_time_accumulator = std::fmod(m_logic_time_accumulator, m_fixed_delta_time);
+		}
+		m_render_interpolation_alpha = m_logic_time_accumulator / m_fixed_delta_time;
+
 		calculateFPS(delta_time);
+
+		if (m_is_headless)
+		{
+			return !m_is_quit;
+		}
+
 		rendererTick();
 
-		g_runtime_global_context.m_window_system->pollEvents();
+		{
+			PROFILE_SCOPE("pollEvents");
+			g_runtime_global_context.m_window_system->pollEvents();
+		}
+
+		m_frame_limiter.wait();
 
 		const bool should_window_close = g_runtime_global_context.m_window_system->shouldClose();;
 		return !should_window_close;
@@ -76,12 +217,18 @@ namespace Polaris
 
 	void PolarisEngine::logicalTick(float delta_time)
 	{
+		PROFILE_SCOPE("logicalTick");
+		m_frame_stats.beginPhase(FramePhase::logic);
 		g_runtime_global_context.m_world_manager->tick(delta_time);
+		m_frame_stats.endPhase(FramePhase::logic);
 	}
 
 	bool PolarisEngine::rendererTick()
 	{
-		g_runtime_global_context.m_render_system->tick();
+		PROFILE_SCOPE("rendererTick");
+		m_frame_stats.beginPhase(FramePhase::render);
+		g_runtime_global_context.m_render_system->tick(m_render_interpolation_alpha);
+		m_frame_stats.endPhase(FramePhase::render);
 		return true;
 	}
 
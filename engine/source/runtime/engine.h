@@ -1,5 +1,8 @@
 #pragma once
 
+#include "runtime/core/base/frame_limiter.h"
+#include "runtime/core/profiler/frame_stats.h"
+
 #include <string>
 #include <chrono>
 #include <unordered_set>
@@ -21,15 +24,24 @@ namespace Polaris
 		void clear();
 
 		inline bool isQuit() const { return m_is_quit; }
+		inline bool isHeadless() const { return m_is_headless; }
 		void run();
 		bool tickOneFrame(float delta_time);
 
 		inline int getFPS() const { return m_fps; }
+		inline const FrameStats& getFrameStats() const { return m_frame_stats; }
+		inline float getRenderInterpolationAlpha() const { return m_render_interpolation_alpha; }
 
 	protected:
 		void logicalTick(float delta_time);
 		bool rendererTick();
 
+		/**
+		 *  Fixed step logic ticks without window and rendering, as fast as possible
+		 *  or paced to the configured tick rate
+		 */
+		void runHeadless();
+
 		void calculateFPS(float delta_time);
 
 		/**
@@ -39,12 +51,23 @@ namespace Polaris
 
 	protected:
 		bool m_is_quit{ 0 };
+		bool m_is_headless{ false };
+
+		// logic runs in fixed steps, the accumulator holds the frame time not simulated yet
+		float    m_fixed_delta_time{ 1.f / 60.f };
+		uint32_t m_max_logic_steps_per_frame{ 5 };
+		float    m_logic_time_accumulator{ 0.f };
+		float    m_render_interpolation_alpha{ 1.f };
+
+		FrameLimiter m_frame_limiter;
 
 		std::chrono::steady_clock::time_point m_last_tick_time_point{ std::chrono::steady_clock::now() };
 
 		float m_average_duration{ 0.f };
 		int   m_frame_count{ 0 };
 		int   m_fps{ 0 };
+
+		FrameStats m_frame_stats;
 	};
 
 } // namespace Polaris
\ No newline at end of file
@@ -0,0 +1,48 @@
+#include "runtime/function/framework/component/camera/camera_component.h"
+
+#include "runtime/core/math/math.h"
+
+#include "runtime/function/framework/component/transform/transform_component.h"
+#include "runtime/function/framework/object/object.h"
+#include "runtime/function/global/global_context.h"
+
+#include "runtime/function/render/render_system.h"
+#include "runtime/function/render/window_system.h"
+
+namespace Polaris
+{
+    void CameraComponent::tick(float delta_time)
+    {
+        std::shared_ptr<GObject> parent_object = m_parent_object.lock();
+        std::shared_ptr<RenderSystem> render_system = g_runtime_global_context.m_render_system;
+        if (!parent_object || !render_system)
+            return;
+
+        const TransformComponent* transform_component = parent_object->tryGetComponentConst(TransformComponent);
+        if (!transform_component)
+            return;
+
+        const Transform& transform = transform_component->getTransformConst();
+
+        CameraSwapData camera_swap_data;
+        camera_swap_data.m_view_matrix = Math::makeViewMatrix(transform.m_position, transform.m_rotation);
+        camera_swap_data.m_fov_x       = m_camera_res.m_fov_x;
+        camera_swap_data.m_z_near      = m_camera_res.m_z_near;
+        camera_swap_data.m_z_far       = m_camera_res.m_z_far;
+
+        // a minimized window has no size, the last aspect ratio is kept then
+        std::shared_ptr<WindowSystem> window_system = g_runtime_global_context.m_window_system;
+        if (window_system)
+        {
+            const std::array<int, 2> framebuffer_size = window_system->getFramebufferSize();
+            if (framebuffer_size[0] > 0 && framebuffer_size[1] > 0)
+            {
+                m_aspect_ratio = static_cast<float>(framebuffer_size[0]) / framebuffer_size[1];
+            }
+        }
+        camera_swap_data.m_aspect_ratio = m_aspect_ratio;
+
+        // sent on every tick, the render side keeps the last camera it received
+        render_system->getSwapContext().getLogicSwapData().m_camera_swap_data = camera_swap_data;
+    }
+} // namespace Polaris
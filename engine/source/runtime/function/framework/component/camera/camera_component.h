@@ -0,0 +1,29 @@
+#pragma once
+
+#include "runtime/function/framework/component/component.h"
+
+#include "runtime/resource/res_type/components/camera.h"
+
+namespace Polaris
+{
+    /**
+     *  The view the render system draws from. Every tick the transform of the object is sent as the
+     *  camera, looking down its local -z axis with y up
+     */
+    REFLECTION_TYPE(CameraComponent)
+    CLASS(CameraComponent : public Component, WhiteListFields)
+    {
+        REFLECTION_BODY(CameraComponent)
+    public:
+        CameraComponent() {};
+
+        void tick(float delta_time) override;
+
+    private:
+        META(Enable)
+        CameraComponentRes m_camera_res;
+
+        // follows the framebuffer of the window, headless runs keep the default
+        float m_aspect_ratio {16.f / 9.f};
+    };
+} // namespace Polaris
@@ -1,24 +1,37 @@
 #include "runtime/function/framework/component/mesh/mesh_component.h"
 
 #include "runtime/resource/asset_manager/asset_manager.h"
+#include "runtime/resource/mesh_cooker/mesh_lod_cache.h"
 #include "runtime/resource/res_type/data/material.h"
 
 #include "runtime/function/framework/component/transform/transform_component.h"
 #include "runtime/function/framework/object/object.h"
 #include "runtime/function/global/global_context.h"
 
+#include "runtime/function/render/mesh_bounds_cache.h"
 #include "runtime/function/render/render_system.h"
 
 namespace Polaris
 {
+    MeshComponent::~MeshComponent()
+    {
+        std::shared_ptr<RenderSystem> render_system = g_runtime_global_context.m_render_system;
+        if (m_is_render_object_added && render_system)
+        {
+            render_system->getSwapContext().getLogicSwapData().addDeleteGameObject(m_go_id);
+        }
+    }
+
     void MeshComponent::postLoadResource(std::weak_ptr<GObject> parent_object)
     {
         m_parent_object = parent_object;
+        m_go_id         = parent_object.lock()->getID();
 
         std::shared_ptr<AssetManager> asset_manager = g_runtime_global_context.m_asset_manager;
         ASSERT(asset_manager);
 
         m_raw_meshes.resize(m_mesh_res.m_sub_meshes.size());
+        m_local_bounds = AxisAlignedBox();
 
         size_t raw_mesh_count = 0;
         for (const SubMeshRes& sub_mesh : m_mesh_res.m_sub_meshes)
@@ -28,6 +41,19 @@ namespace Polaris
                 asset_manager->getFullPath(sub_mesh.m_obj_file_ref).generic_string();
 
             meshComponent.m_material_desc.m_with_texture = sub_mesh.m_material.empty() == false;
+            meshComponent.m_is_occluder                  = sub_mesh.m_is_occluder;
+
+            // meshes imported without lods get them cooked on their first load
+            const std::vector<MeshLodRes> lods =
+                sub_mesh.m_lods.empty() ? MeshLodCache::getInstance().getLods(*asset_manager, sub_mesh.m_obj_file_ref)
+                                        : sub_mesh.m_lods;
+            meshComponent.m_mesh_lods.resize(lods.size());
+            for (size_t lod_index = 0; lod_index < lods.size(); ++lod_index)
+            {
+                meshComponent.m_mesh_lods[lod_index].m_mesh_desc.m_mesh_file =
+                    asset_manager->getFullPath(lods[lod_index].m_obj_file_ref).generic_string();
+                meshComponent.m_mesh_lods[lod_index].m_geometric_error = lods[lod_index].m_geometric_error;
+            }
 
             if (meshComponent.m_material_desc.m_with_texture)
             {
@@ -50,6 +76,10 @@ namespace Polaris
 
             meshComponent.m_transform_desc.m_transform_matrix = object_space_transform;
 
+            m_local_bounds.merge(MeshBoundsCache::getInstance()
+                                     .getBounds(meshComponent.m_mesh_desc.m_mesh_file)
+                                     .getTransformed(object_space_transform));
+
             ++raw_mesh_count;
         }
     }
@@ -61,20 +91,34 @@ namespace Polaris
 
         TransformComponent*       transform_component = m_parent_object.lock()->tryGetComponent(TransformComponent);
 
-        if (transform_component->isDirty())
-        {
-            std::vector<GameObjectPartDesc> dirty_mesh_parts;
-            for (GameObjectPartDesc& mesh_part : m_raw_meshes)
-            {
-                Matrix4x4 object_transform_matrix = mesh_part.m_transform_desc.m_transform_matrix;
+        std::shared_ptr<RenderSystem> render_system = g_runtime_global_context.m_render_system;
 
-                mesh_part.m_transform_desc.m_transform_matrix =
-                    transform_component->getMatrix() * object_transform_matrix;
-                dirty_mesh_parts.push_back(mesh_part);
+        bool is_transform_dirty = transform_component->isDirty();
+        bool is_first_transform = false;
+        if (render_system && !m_is_render_object_added)
+        {
+            // part transforms stay in object space, the render scene applies the object transform
+            render_system->getSwapContext().getLogicSwapData().addGameObject(GameObjectDesc(m_go_id, m_raw_meshes));
+            m_is_render_object_added = true;
+            is_transform_dirty       = true;
+            is_first_transform       = true;
+        }
 
-                mesh_part.m_transform_desc.m_transform_matrix = object_transform_matrix;
+        // a moved object is sent once more after it stops, so the render side sees the previous
+        // transform catch up and stops blending
+        if (is_transform_dirty || m_is_transform_settling)
+        {
+            if (render_system)
+            {
+                // a new object shows up where it is instead of blending in from where it was loaded
+                const Transform& current_transform  = transform_component->getTransformConst();
+                const Transform& previous_transform =
+                    is_first_transform ? current_transform : transform_component->getPreviousTransformConst();
+                render_system->getSwapContext().getLogicSwapData().addTransformDelta(
+                    {m_go_id, previous_transform, current_transform});
             }
             transform_component->setDirtyFlag(false);
         }
+        m_is_transform_settling = is_transform_dirty;
     }
 } // namespace Polaris
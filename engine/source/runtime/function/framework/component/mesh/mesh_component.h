@@ -2,6 +2,8 @@
 
 #include "runtime/function/framework/component/component.h"
 
+#include "runtime/core/math/axis_aligned.h"
+
 #include "runtime/resource/res_type/components/mesh.h"
 
 #include "runtime/function/render/render_object.h"
@@ -10,18 +12,19 @@
 
 namespace Polaris
 {
-    class RenderSwapContext;
-
     REFLECTION_TYPE(MeshComponent)
     CLASS(MeshComponent : public Component, WhiteListFields)
     {
         REFLECTION_BODY(MeshComponent)
     public:
         MeshComponent() {};
+        ~MeshComponent() override;
 
         void postLoadResource(std::weak_ptr<GObject> parent_object) override;
 
         const std::vector<GameObjectPartDesc>& getRawMeshes() const { return m_raw_meshes; }
+        // bounds of all sub meshes in the space of the object
+        const AxisAlignedBox& getLocalBounds() const { return m_local_bounds; }
 
         void tick(float delta_time) override;
 
@@ -30,5 +33,11 @@ namespace Polaris
         MeshComponentRes m_mesh_res;
 
         std::vector<GameObjectPartDesc> m_raw_meshes;
+        AxisAlignedBox                  m_local_bounds;
+
+        GObjectID m_go_id {k_invalid_gobject_id};
+        // the full part descriptions were handed to the render system, only transforms follow
+        bool m_is_render_object_added {false};
+        bool m_is_transform_settling {false};
     };
 } // namespace Polaris
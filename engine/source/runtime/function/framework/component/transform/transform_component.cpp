@@ -10,42 +10,45 @@ namespace Polaris
         m_transform_buffer[0] = m_transform;
         m_transform_buffer[1] = m_transform;
         m_is_dirty            = true;
+        m_is_changed          = true;
     }
 
     void TransformComponent::setPosition(const Vector3& new_translation)
     {
-        m_transform_buffer[m_next_index].m_position = new_translation;
-        m_transform.m_position                      = new_translation;
-        m_is_dirty                                  = true;
+        m_transform.m_position = new_translation;
+        m_is_dirty             = true;
+        m_is_changed           = true;
     }
 
     void TransformComponent::setScale(const Vector3& new_scale)
     {
-        m_transform_buffer[m_next_index].m_scale = new_scale;
-        m_transform.m_scale                      = new_scale;
-        m_is_dirty                               = true;
-        m_is_scale_dirty                         = true;
+        m_transform.m_scale = new_scale;
+        m_is_dirty          = true;
+        m_is_scale_dirty    = true;
+        m_is_changed        = true;
     }
 
     void TransformComponent::setRotation(const Quaternion& new_rotation)
     {
-        m_transform_buffer[m_next_index].m_rotation = new_rotation;
-        m_transform.m_rotation                      = new_rotation;
-        m_is_dirty                                  = true;
+        m_transform.m_rotation = new_rotation;
+        m_is_dirty             = true;
+        m_is_changed           = true;
     }
 
     void TransformComponent::tick(float delta_time)
     {
-        std::swap(m_current_index, m_next_index);
+        // the current state becomes the previous one and everything set since the last tick the current
+        std::swap(m_current_index, m_previous_index);
+        m_transform_buffer[m_current_index] = m_transform;
 
-        if (m_is_dirty)
+        if (m_is_changed && m_change_list)
         {
-
-        }
-
-        if (g_is_editor_mode)
-        {
-            m_transform_buffer[m_next_index] = m_transform;
+            std::shared_ptr<GObject> parent_object = m_parent_object.lock();
+            if (parent_object)
+            {
+                m_change_list->push_back(parent_object->getID());
+            }
         }
+        m_is_changed = false;
     }
 } // namespace Polaris
\ No newline at end of file
@@ -29,18 +29,27 @@ namespace Polaris
         void setRotation(const Quaternion& new_rotation);
 
         const Transform& getTransformConst() const { return m_transform_buffer[m_current_index]; }
-        Transform&       getTransform() { return m_transform_buffer[m_next_index]; }
+        const Transform& getPreviousTransformConst() const { return m_transform_buffer[m_previous_index]; }
+        Transform&       getTransform() { return m_transform; }
 
         Matrix4x4 getMatrix() const { return m_transform_buffer[m_current_index].getMatrix(); }
 
         void tick(float delta_time) override;
 
+        // the id of the parent object is appended to change_list on every tick that changed the transform
+        void setChangeList(std::vector<GObjectID>* change_list) { m_change_list = change_list; }
+
     protected:
         META(Enable)
         Transform m_transform;
 
+        // state at the end of the current and the previous logic tick, changes made during a tick show up after it
         Transform m_transform_buffer[2];
         size_t    m_current_index {0};
-        size_t    m_next_index {1};
+        size_t    m_previous_index {1};
+
+        // set since the last tick, unlike the dirty flag it is not consumed by other components
+        bool                    m_is_changed {false};
+        std::vector<GObjectID>* m_change_list {nullptr};
     };
 } // namespace Polaris
@@ -1,21 +1,39 @@
 #include "runtime/function/framework/level/level.h"
 
 #include "runtime/core/base/macro.h"
+#include "runtime/core/profiler/profiler.h"
 
 #include "runtime/resource/asset_manager/asset_manager.h"
 #include "runtime/resource/res_type/common/level.h"
 
 #include "runtime/engine.h"
 #include "runtime/function/character/character.h"
+#include "runtime/function/framework/component/mesh/mesh_component.h"
+#include "runtime/function/framework/component/transform/transform_component.h"
 #include "runtime/function/framework/object/object.h"
 
 
 namespace Polaris
 {
+    namespace
+    {
+        // fat margin of the spatial index, moves smaller than this do not touch the tree
+        constexpr float k_spatial_index_fat_margin = 0.2f;
+        // fat bounds are shrunk back around the objects this often
+        constexpr uint32_t k_spatial_index_refit_interval = 256;
+    } // namespace
+
+    Level::Level() : m_spatial_index(k_spatial_index_fat_margin) {}
+
     void Level::clear()
     {
         m_current_active_character.reset();
         m_gobjects.clear();
+
+        m_spatial_index.clear();
+        m_spatial_proxies.clear();
+        m_changed_objects.clear();
+        m_ticks_since_spatial_refit = 0;
     }
 
     GObjectID Level::createObject(const ObjectInstanceRes& object_instance_res)
@@ -37,10 +55,11 @@ namespace Polaris
         if (is_loaded)
         {
             m_gobjects.emplace(object_id, gobject);
+            addToSpatialIndex(gobject);
         }
         else
         {
-            LOG_ERROR("loading object " + object_instance_res.m_name + " failed");
+            LOG_ERROR("loading object {} failed", object_instance_res.m_name);
             return k_invalid_gobject_id;
         }
         return object_id;
@@ -101,12 +120,30 @@ namespace Polaris
         std::vector<ObjectInstanceRes>& output_objects = output_level_res.m_objects;
         output_objects.resize(object_cout);
 
+        // object definitions are the prototypes that instanced components are saved against,
+        // key: definition url, value: loaded definition or nullptr if loading failed
+        std::unordered_map<std::string, std::shared_ptr<ObjectDefinitionRes>> definition_cache;
+
         size_t object_index = 0;
         for (const auto& id_object_pair : m_gobjects)
         {
             if (id_object_pair.second)
             {
-                id_object_pair.second->save(output_objects[object_index]);
+                const std::string& definition_url = id_object_pair.second->getDefinitionUrl();
+
+                auto definition_iter = definition_cache.find(definition_url);
+                if (definition_iter == definition_cache.end())
+                {
+                    auto definition_res = std::make_shared<ObjectDefinitionRes>();
+                    if (!g_runtime_global_context.m_asset_manager->loadAsset(definition_url, *definition_res))
+                    {
+                        LOG_WARN("cannot load definition {}, saving full components", definition_url);
+                        definition_res.reset();
+                    }
+                    definition_iter = definition_cache.emplace(definition_url, definition_res).first;
+                }
+
+                id_object_pair.second->save(output_objects[object_index], definition_iter->second.get());
                 ++object_index;
             }
         }
@@ -114,6 +151,17 @@ namespace Polaris
         const bool is_save_success =
             g_runtime_global_context.m_asset_manager->saveAsset(output_level_res, m_level_res_url);
 
+        for (auto& definition_pair : definition_cache)
+        {
+            if (definition_pair.second == nullptr)
+                continue;
+
+            for (auto& prototype : definition_pair.second->m_components)
+            {
+                POLARIS_REFLECTION_DELETE(prototype);
+            }
+        }
+
         if (is_save_success == false)
         {
             LOG_ERROR("failed to save {}", m_level_res_url);
@@ -128,11 +176,15 @@ namespace Polaris
 
     void Level::tick(float delta_time)
     {
+        PROFILE_SCOPE("Level::tick");
+
         if (!m_is_loaded)
         {
             return;
         }
 
+        m_changed_objects.clear();
+
         for (const auto& id_object_pair : m_gobjects)
         {
             assert(id_object_pair.second);
@@ -145,6 +197,58 @@ namespace Polaris
         {
             m_current_active_character->tick(delta_time);
         }
+
+        updateSpatialIndex();
+    }
+
+    void Level::addToSpatialIndex(const std::shared_ptr<GObject>& gobject)
+    {
+        TransformComponent* transform_component = gobject->tryGetComponent(TransformComponent);
+        if (transform_component)
+        {
+            transform_component->setChangeList(&m_changed_objects);
+        }
+
+        m_spatial_proxies[gobject->getID()] = m_spatial_index.createProxy(getObjectBounds(*gobject), gobject->getID());
+    }
+
+    void Level::updateSpatialIndex()
+    {
+        PROFILE_SCOPE("Level::updateSpatialIndex");
+
+        for (GObjectID go_id : m_changed_objects)
+        {
+            auto object_iter = m_gobjects.find(go_id);
+            auto proxy_iter  = m_spatial_proxies.find(go_id);
+            if (object_iter == m_gobjects.end() || proxy_iter == m_spatial_proxies.end() || !object_iter->second)
+            {
+                continue;
+            }
+            m_spatial_index.moveProxy(proxy_iter->second, getObjectBounds(*object_iter->second));
+        }
+
+        if (++m_ticks_since_spatial_refit >= k_spatial_index_refit_interval)
+        {
+            m_spatial_index.refit();
+            m_ticks_since_spatial_refit = 0;
+        }
+    }
+
+    AxisAlignedBox Level::getObjectBounds(GObject& gobject) const
+    {
+        const TransformComponent* transform_component = gobject.tryGetComponentConst(TransformComponent);
+        if (!transform_component)
+        {
+            return AxisAlignedBox(Vector3::ZERO, Vector3::ZERO);
+        }
+
+        // objects without meshes are points at their position
+        const MeshComponent* mesh_component = gobject.tryGetComponentConst(MeshComponent);
+        if (!mesh_component || mesh_component->getRawMeshes().empty())
+        {
+            return AxisAlignedBox(transform_component->getPosition(), Vector3::ZERO);
+        }
+        return mesh_component->getLocalBounds().getTransformed(transform_component->getMatrix());
     }
 
     std::weak_ptr<GObject> Level::getGObjectByID(GObjectID go_id) const
@@ -173,6 +277,13 @@ namespace Polaris
             }
         }
 
+        auto proxy_iter = m_spatial_proxies.find(go_id);
+        if (proxy_iter != m_spatial_proxies.end())
+        {
+            m_spatial_index.destroyProxy(proxy_iter->second);
+            m_spatial_proxies.erase(proxy_iter);
+        }
+
         m_gobjects.erase(go_id);
     }
 }
\ No newline at end of file
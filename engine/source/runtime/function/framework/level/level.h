@@ -1,10 +1,13 @@
 #pragma once
 
+#include "runtime/core/math/dynamic_bvh.h"
+
 #include "runtime/function/framework/object/object_id_allocator.h"
 
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace Polaris
 {
@@ -17,6 +20,7 @@ namespace Polaris
 	class Level
 	{
 	public:
+		Level();
 		virtual ~Level() {};
 
 		bool load(const std::string& level_res_url);
@@ -36,9 +40,28 @@ namespace Polaris
 		GObjectID createObject(const ObjectInstanceRes& object_instance_res);
 		void      deleteGObjectByID(GObjectID go_id);
 
+		// world space bounds of every object, user data of a proxy is the object id
+		const DynamicBVH& getSpatialIndex() const { return m_spatial_index; }
+		// objects whose transform changed during the last tick, the spatial index already reflects them
+		const std::vector<GObjectID>& getChangedObjects() const { return m_changed_objects; }
+
+		// ids of all objects whose bounds overlap the query, see BVHBoxQuery and its siblings
+		template<typename TQuery>
+		void queryObjects(const TQuery& query, std::vector<GObjectID>& out_object_ids) const
+		{
+			m_spatial_index.query(query, [this, &out_object_ids](BVHProxyID proxy_id) {
+				out_object_ids.push_back(static_cast<GObjectID>(m_spatial_index.getUserData(proxy_id)));
+				return true;
+			});
+		}
+
 	protected:
 		void clear();
 
+		void           addToSpatialIndex(const std::shared_ptr<GObject>& gobject);
+		void           updateSpatialIndex();
+		AxisAlignedBox getObjectBounds(GObject& gobject) const;
+
 		bool        m_is_loaded{ false };
 		std::string m_level_res_url;
 
@@ -46,6 +69,13 @@ namespace Polaris
 		LevelObjectsMap m_gobjects;
 
 		std::shared_ptr<Character> m_current_active_character;
+
+		DynamicBVH m_spatial_index;
+		// proxy of each object in the spatial index, key: object id
+		std::unordered_map<GObjectID, BVHProxyID> m_spatial_proxies;
+		// filled by the transform components during tick
+		std::vector<GObjectID> m_changed_objects;
+		uint32_t               m_ticks_since_spatial_refit{ 0 };
 	};
 
 } // namespace Polaris
\ No newline at end of file
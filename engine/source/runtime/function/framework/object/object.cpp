@@ -4,6 +4,8 @@
 
 #include "runtime/resource/asset_manager/asset_manager.h"
 
+#include <algorithm>
+
 namespace Polaris
 {
     bool shouldComponentTick(std::string component_type_name)
@@ -82,6 +84,17 @@ namespace Polaris
             if (hasComponent(type_name))
                 continue;
 
+            // apply the instanced overrides onto the definition component
+            for (const ComponentDeltaRes& component_delta : object_instance_res.m_instanced_component_deltas)
+            {
+                if (component_delta.m_type_name == type_name)
+                {
+                    Reflection::TypeMeta::readByName(
+                        type_name, component_delta.m_component, loaded_component.operator->());
+                    break;
+                }
+            }
+
             loaded_component->postLoadResource(weak_from_this());
 
             m_components.push_back(loaded_component);
@@ -90,12 +103,43 @@ namespace Polaris
         return true;
     }
 
-    void GObject::save(ObjectInstanceRes& out_object_instance_res)
+    void GObject::save(ObjectInstanceRes& out_object_instance_res, const ObjectDefinitionRes* definition_res)
     {
         out_object_instance_res.m_name = m_name;
         out_object_instance_res.m_definition = m_definition_url;
 
-        out_object_instance_res.m_instanced_components = m_components;
+        if (definition_res == nullptr)
+        {
+            out_object_instance_res.m_instanced_components = m_components;
+            return;
+        }
+
+        for (const auto& component : m_components)
+        {
+            const std::string type_name = component.getTypeName();
+
+            auto prototype_iter = std::find_if(definition_res->m_components.begin(),
+                                               definition_res->m_components.end(),
+                                               [&type_name](const Reflection::ReflectionPtr<Component>& prototype) {
+                                                   return prototype.getTypeName() == type_name;
+                                               });
+            // components not in the definition have nothing to diff against
+            if (prototype_iter == definition_res->m_components.end())
+            {
+                out_object_instance_res.m_instanced_components.push_back(component);
+                continue;
+            }
+
+            Json component_delta =
+                Reflection::TypeMeta::writeDeltaByName(type_name, component.getPtr(), prototype_iter->getPtr());
+            if (component_delta.is_null())
+                continue;
+
+            ComponentDeltaRes component_delta_res;
+            component_delta_res.m_type_name = type_name;
+            component_delta_res.m_component = component_delta;
+            out_object_instance_res.m_instanced_component_deltas.push_back(component_delta_res);
+        }
     }
 
 } // namespace Polaris
\ No newline at end of file
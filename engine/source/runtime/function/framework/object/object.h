@@ -24,13 +24,16 @@ namespace Polaris
         virtual void tick(float delta_time);
 
         bool load(const ObjectInstanceRes& object_instance_res);
-        void save(ObjectInstanceRes& out_object_instance_res);
+        // save the components as deltas against definition_res if given, otherwise save them entirely
+        void save(ObjectInstanceRes& out_object_instance_res, const ObjectDefinitionRes* definition_res = nullptr);
 
         GObjectID getID() const { return m_id; }
 
         void               setName(std::string name) { m_name = name; }
         const std::string& getName() const { return m_name; }
 
+        const std::string& getDefinitionUrl() const { return m_definition_url; }
+
         bool hasComponent(const std::string& compenent_type_name) const;
 
         std::vector<Reflection::ReflectionPtr<Component>> getComponents() { return m_components; }
@@ -21,26 +21,41 @@ namespace Polaris
         m_config_manager = std::make_shared<ConfigManager>();
         m_config_manager->initialize(config_file_path);
 
-        m_logger_system = std::make_shared<LogSystem>();
+        m_logger_system = std::make_shared<LogSystem>(m_config_manager->isLogToStderr());
 
         m_asset_manager = std::make_shared<AssetManager>();
 
         m_world_manager = std::make_shared<WorldManager>();
         m_world_manager->initialize();
 
+        // headless runs only simulate, so no window or gpu is required
+        if (m_config_manager->isHeadless())
+        {
+            return;
+        }
+
         m_window_system = std::make_shared<WindowSystem>();
         WindowCreateInfo window_create_info;
         m_window_system->initialize(window_create_info);
 
         m_render_system = std::make_shared<RenderSystem>();
         RenderSystemInitInfo render_init_info;
-        render_init_info.window_system = m_window_system;
+        render_init_info.window_system                  = m_window_system;
+        render_init_info.enable_render_thread           = m_config_manager->isRenderThreadEnabled();
+        render_init_info.enable_occlusion_culling       = m_config_manager->isOcclusionCullingEnabled();
+        render_init_info.lod_screen_error               = m_config_manager->getLodScreenError();
+        render_init_info.lod_triangle_budget            = m_config_manager->getLodTriangleBudget();
+        render_init_info.pipeline_cache_file            = m_config_manager->getPipelineCacheFile();
+        render_init_info.enable_gpu_pipeline_statistics = m_config_manager->isGpuPipelineStatisticsEnabled();
         m_render_system->initialize(render_init_info);
     }
 
     void RuntimeGlobalContext::shutdownSystems()
     {
-        m_render_system->clear();
+        if (m_render_system)
+        {
+            m_render_system->clear();
+        }
         m_render_system.reset();
 
         m_window_system.reset();
@@ -0,0 +1,93 @@
+#include "runtime/function/render/mesh_bounds_cache.h"
+
+#include "runtime/core/base/macro.h"
+
+#include <fstream>
+#include <sstream>
+
+namespace Polaris
+{
+    AxisAlignedBox MeshBoundsCache::getBounds(const std::string& mesh_file) { return getMeshInfo(mesh_file).m_bounds; }
+
+    uint32_t MeshBoundsCache::getTriangleCount(const std::string& mesh_file)
+    {
+        return getMeshInfo(mesh_file).m_triangle_count;
+    }
+
+    void MeshBoundsCache::clear()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_mesh_infos.clear();
+    }
+
+    MeshBoundsCache::MeshInfo MeshBoundsCache::getMeshInfo(const std::string& mesh_file)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto                        found = m_mesh_infos.find(mesh_file);
+            if (found != m_mesh_infos.end())
+            {
+                return found->second;
+            }
+        }
+
+        // read outside the lock, two threads racing on the same file both get the same result
+        const MeshInfo mesh_info = loadMeshInfo(mesh_file);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_mesh_infos.emplace(mesh_file, mesh_info);
+        return mesh_info;
+    }
+
+    /*
+    * Only the vertex positions and the face sizes of the obj file are read, the mesh itself is
+    * uploaded elsewhere. A mesh that cannot be read gets a unit box so it is still considered by culling
+    */
+    MeshBoundsCache::MeshInfo MeshBoundsCache::loadMeshInfo(const std::string& mesh_file)
+    {
+        MeshInfo mesh_info;
+
+        std::ifstream mesh_stream(mesh_file);
+        std::string   line;
+        bool          has_vertex = false;
+        while (mesh_stream && std::getline(mesh_stream, line))
+        {
+            if (line.size() < 2 || (line[1] != ' ' && line[1] != '\t'))
+            {
+                continue;
+            }
+
+            std::istringstream line_stream(line.substr(2));
+            if (line[0] == 'v')
+            {
+                Vector3 position;
+                if (line_stream >> position.x >> position.y >> position.z)
+                {
+                    mesh_info.m_bounds.merge(position);
+                    has_vertex = true;
+                }
+            }
+            else if (line[0] == 'f')
+            {
+                // polygons are triangulated as fans
+                uint32_t    corner_count = 0;
+                std::string corner;
+                while (line_stream >> corner)
+                {
+                    ++corner_count;
+                }
+                if (corner_count >= 3)
+                {
+                    mesh_info.m_triangle_count += corner_count - 2;
+                }
+            }
+        }
+
+        if (!has_vertex)
+        {
+            LOG_WARN("no vertex position read from mesh {}, using a unit bounding box", mesh_file);
+            mesh_info.m_bounds.update(Vector3::ZERO, Vector3::UNIT_SCALE);
+        }
+        return mesh_info;
+    }
+} // namespace Polaris
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "runtime/core/base/public_singleton.h"
+#include "runtime/core/math/axis_aligned.h"
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace Polaris
+{
+    /**
+     *  Object space bounds and triangle counts of mesh files, read once per file and shared by the
+     *  logic side (spatial index) and the render side (culling, lod budget). Safe to call from any thread
+     */
+    class MeshBoundsCache : public PublicSingleton<MeshBoundsCache>
+    {
+    public:
+        AxisAlignedBox getBounds(const std::string& mesh_file);
+        uint32_t       getTriangleCount(const std::string& mesh_file);
+        void           clear();
+
+    private:
+        struct MeshInfo
+        {
+            AxisAlignedBox m_bounds;
+            uint32_t       m_triangle_count {0};
+        };
+
+        MeshInfo        getMeshInfo(const std::string& mesh_file);
+        static MeshInfo loadMeshInfo(const std::string& mesh_file);
+
+        std::mutex                                m_mutex;
+        std::unordered_map<std::string, MeshInfo> m_mesh_infos;
+    };
+} // namespace Polaris
@@ -0,0 +1,473 @@
+#include "runtime/function/render/occlusion_culling.h"
+
+#include "runtime/core/base/thread_pool.h"
+#include "runtime/core/math/vector4.h"
+#include "runtime/core/profiler/profiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define POLARIS_OCCLUSION_SSE2 1
+#include <emmintrin.h>
+#else
+#define POLARIS_OCCLUSION_SSE2 0
+#endif
+
+namespace Polaris
+{
+    namespace
+    {
+        constexpr uint32_t k_tile_width  = 32;
+        constexpr uint32_t k_tile_height = 16;
+        // below this many triangles the tiles are rasterized on the calling thread
+        constexpr size_t k_parallel_rasterize_min_triangle_count = 256;
+        // points with a smaller clip w are treated as being at or behind the camera
+        constexpr float k_near_clip_w = 1e-4f;
+
+        Vector4 transformPoint(const Matrix4x4& matrix, const Vector3& point)
+        {
+            return matrix * Vector4(point, 1.f);
+        }
+    } // namespace
+
+    void OcclusionCulling::initialize(uint32_t width, uint32_t height)
+    {
+        m_width        = std::max(4u, (width + 3u) & ~3u);
+        m_height       = std::max(1u, height);
+        m_tile_count_x = (m_width + k_tile_width - 1) / k_tile_width;
+        m_tile_count_y = (m_height + k_tile_height - 1) / k_tile_height;
+
+        m_depth_buffer.assign(static_cast<size_t>(m_width) * m_height, 1.f);
+        m_tile_bins.assign(static_cast<size_t>(m_tile_count_x) * m_tile_count_y, {});
+
+        m_depth_pyramid.clear();
+        uint32_t level_width  = m_width;
+        uint32_t level_height = m_height;
+        do
+        {
+            level_width  = std::max(1u, (level_width + 1) / 2);
+            level_height = std::max(1u, (level_height + 1) / 2);
+
+            DepthLevel level;
+            level.m_width  = level_width;
+            level.m_height = level_height;
+            level.m_max_depth.assign(static_cast<size_t>(level_width) * level_height, 1.f);
+            m_depth_pyramid.push_back(std::move(level));
+        } while (level_width > 1 || level_height > 1);
+    }
+
+    void OcclusionCulling::beginFrame(const Matrix4x4& view_projection)
+    {
+        m_view_projection = view_projection;
+
+        std::fill(m_depth_buffer.begin(), m_depth_buffer.end(), 1.f);
+        m_triangles.clear();
+        for (std::vector<uint32_t>& tile_bin : m_tile_bins)
+        {
+            tile_bin.clear();
+        }
+    }
+
+    void OcclusionCulling::addOccluder(const OccluderMesh& mesh, const Matrix4x4& model_matrix)
+    {
+        const Matrix4x4 model_view_projection = m_view_projection * model_matrix;
+
+        std::vector<Vector4> clip_positions;
+        clip_positions.reserve(mesh.m_positions.size());
+        for (const Vector3& position : mesh.m_positions)
+        {
+            clip_positions.push_back(transformPoint(model_view_projection, position));
+        }
+
+        for (size_t index = 0; index + 2 < mesh.m_indices.size(); index += 3)
+        {
+            const Vector4 clip[3] = {clip_positions[mesh.m_indices[index]],
+                                     clip_positions[mesh.m_indices[index + 1]],
+                                     clip_positions[mesh.m_indices[index + 2]]};
+            addClipTriangle(clip);
+        }
+    }
+
+    /*
+    * Clip against the near plane z = 0 only, geometry in front of it is not drawn by the gpu either.
+    * Everything else is handled by clamping the bounding rectangle of the projected triangle
+    */
+    void OcclusionCulling::addClipTriangle(const Vector4 (&clip)[3])
+    {
+        const bool is_inside[3] = {clip[0].z >= 0.f, clip[1].z >= 0.f, clip[2].z >= 0.f};
+        const int  inside_count = is_inside[0] + is_inside[1] + is_inside[2];
+        if (inside_count == 0)
+        {
+            return;
+        }
+
+        // sutherland hodgman against the near plane, at most four vertices come out
+        Vector4 polygon[4];
+        int     polygon_size = 0;
+        for (int vertex = 0; vertex < 3; ++vertex)
+        {
+            const int      next_vertex = (vertex + 1) % 3;
+            const Vector4& current     = clip[vertex];
+            const Vector4& next        = clip[next_vertex];
+
+            if (is_inside[vertex])
+            {
+                polygon[polygon_size++] = current;
+            }
+            if (is_inside[vertex] != is_inside[next_vertex])
+            {
+                const float t           = current.z / (current.z - next.z);
+                polygon[polygon_size++] = current + (next - current) * t;
+            }
+        }
+
+        ScreenTriangle screen_polygon;
+        float          screen_x[4], screen_y[4], screen_z[4];
+        for (int vertex = 0; vertex < polygon_size; ++vertex)
+        {
+            const float inverse_w = 1.f / polygon[vertex].w;
+            screen_x[vertex]      = (polygon[vertex].x * inverse_w * 0.5f + 0.5f) * m_width;
+            screen_y[vertex]      = (polygon[vertex].y * inverse_w * 0.5f + 0.5f) * m_height;
+            screen_z[vertex]      = polygon[vertex].z * inverse_w;
+        }
+
+        // fan triangulation of the clipped polygon
+        for (int vertex = 1; vertex + 1 < polygon_size; ++vertex)
+        {
+            const int corners[3] = {0, vertex, vertex + 1};
+            for (int corner = 0; corner < 3; ++corner)
+            {
+                screen_polygon.m_x[corner] = screen_x[corners[corner]];
+                screen_polygon.m_y[corner] = screen_y[corners[corner]];
+                screen_polygon.m_z[corner] = screen_z[corners[corner]];
+            }
+            addScreenTriangle(screen_polygon);
+        }
+    }
+
+    void OcclusionCulling::addScreenTriangle(const ScreenTriangle& triangle)
+    {
+        const float min_x = std::min({triangle.m_x[0], triangle.m_x[1], triangle.m_x[2]});
+        const float max_x = std::max({triangle.m_x[0], triangle.m_x[1], triangle.m_x[2]});
+        const float min_y = std::min({triangle.m_y[0], triangle.m_y[1], triangle.m_y[2]});
+        const float max_y = std::max({triangle.m_y[0], triangle.m_y[1], triangle.m_y[2]});
+        if (max_x < 0.f || max_y < 0.f || min_x >= m_width || min_y >= m_height)
+        {
+            return;
+        }
+
+        const float area = (triangle.m_x[1] - triangle.m_x[0]) * (triangle.m_y[2] - triangle.m_y[0]) -
+                           (triangle.m_x[2] - triangle.m_x[0]) * (triangle.m_y[1] - triangle.m_y[0]);
+        if (std::fabs(area) < 1e-6f)
+        {
+            return;
+        }
+
+        const uint32_t triangle_index = static_cast<uint32_t>(m_triangles.size());
+        m_triangles.push_back(triangle);
+
+        const uint32_t first_tile_x = static_cast<uint32_t>(std::max(0.f, min_x)) / k_tile_width;
+        const uint32_t first_tile_y = static_cast<uint32_t>(std::max(0.f, min_y)) / k_tile_height;
+        const uint32_t last_tile_x =
+            std::min(m_tile_count_x - 1, static_cast<uint32_t>(std::min(max_x, m_width - 1.f)) / k_tile_width);
+        const uint32_t last_tile_y =
+            std::min(m_tile_count_y - 1, static_cast<uint32_t>(std::min(max_y, m_height - 1.f)) / k_tile_height);
+        for (uint32_t tile_y = first_tile_y; tile_y <= last_tile_y; ++tile_y)
+        {
+            for (uint32_t tile_x = first_tile_x; tile_x <= last_tile_x; ++tile_x)
+            {
+                m_tile_bins[tile_y * m_tile_count_x + tile_x].push_back(triangle_index);
+            }
+        }
+    }
+
+    void OcclusionCulling::rasterize()
+    {
+        PROFILE_SCOPE("OcclusionCulling::rasterize");
+
+        const uint32_t tile_count   = m_tile_count_x * m_tile_count_y;
+        ThreadPool&    thread_pool  = ThreadPool::getInstance();
+        const uint32_t worker_count = thread_pool.getThreadCount();
+        if (m_triangles.size() < k_parallel_rasterize_min_triangle_count || worker_count == 1)
+        {
+            for (uint32_t tile_index = 0; tile_index < tile_count; ++tile_index)
+            {
+                rasterizeTile(tile_index);
+            }
+        }
+        else
+        {
+            // tiles own disjoint pixels, so workers never touch the same part of the buffer
+            const uint32_t chunk_count = std::min(worker_count, tile_count);
+            thread_pool.parallelFor(chunk_count, [this, tile_count, chunk_count](uint32_t chunk_index) {
+                for (uint32_t tile_index = chunk_index; tile_index < tile_count; tile_index += chunk_count)
+                {
+                    rasterizeTile(tile_index);
+                }
+            });
+        }
+
+        buildDepthPyramid();
+    }
+
+    void OcclusionCulling::rasterizeTile(uint32_t tile_index)
+    {
+        const uint32_t tile_x = tile_index % m_tile_count_x;
+        const uint32_t tile_y = tile_index / m_tile_count_x;
+        const uint32_t min_x  = tile_x * k_tile_width;
+        const uint32_t min_y  = tile_y * k_tile_height;
+        const uint32_t max_x  = std::min(m_width, min_x + k_tile_width);
+        const uint32_t max_y  = std::min(m_height, min_y + k_tile_height);
+
+        for (uint32_t triangle_index : m_tile_bins[tile_index])
+        {
+            rasterizeTriangle(m_triangles[triangle_index], min_x, min_y, max_x, max_y);
+        }
+    }
+
+    /*
+    * Edge functions and depth are planes in screen space, evaluated at pixel centers. Pixels are
+    * visited in aligned groups of four along a row; the tile bounds are multiples of four so a
+    * group never crosses into another tile
+    */
+    void OcclusionCulling::rasterizeTriangle(const ScreenTriangle& triangle,
+                                             uint32_t              tile_min_x,
+                                             uint32_t              tile_min_y,
+                                             uint32_t              tile_max_x,
+                                             uint32_t              tile_max_y)
+    {
+        float x[3] = {triangle.m_x[0], triangle.m_x[1], triangle.m_x[2]};
+        float y[3] = {triangle.m_y[0], triangle.m_y[1], triangle.m_y[2]};
+        float z[3] = {triangle.m_z[0], triangle.m_z[1], triangle.m_z[2]};
+
+        float area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+        if (area < 0.f)
+        {
+            std::swap(x[1], x[2]);
+            std::swap(y[1], y[2]);
+            std::swap(z[1], z[2]);
+            area = -area;
+        }
+
+        // edge i is opposite to vertex i, e(px, py) = a * px + b * py + c is positive inside. c is
+        // always computed with the end points in the same order, so the two triangles sharing an
+        // edge get exactly opposite values and leave no gaps between them, even with fma contraction
+        float edge_a[3], edge_b[3], edge_c[3];
+        for (int edge = 0; edge < 3; ++edge)
+        {
+            const int  from       = (edge + 1) % 3;
+            const int  to         = (edge + 2) % 3;
+            const bool is_flipped = y[from] > y[to] || (y[from] == y[to] && x[from] > x[to]);
+            const int  first      = is_flipped ? to : from;
+            const int  second     = is_flipped ? from : to;
+            const float c         = x[first] * y[second] - x[second] * y[first];
+
+            edge_a[edge] = y[from] - y[to];
+            edge_b[edge] = x[to] - x[from];
+            edge_c[edge] = is_flipped ? -c : c;
+        }
+
+        // z = z0 + dz_dx * (px - x0) + dz_dy * (py - y0)
+        const float inverse_area = 1.f / area;
+        const float dz_dx = ((z[1] - z[0]) * (y[2] - y[0]) - (z[2] - z[0]) * (y[1] - y[0])) * inverse_area;
+        const float dz_dy = ((z[2] - z[0]) * (x[1] - x[0]) - (z[1] - z[0]) * (x[2] - x[0])) * inverse_area;
+        const float z_c   = z[0] - dz_dx * x[0] - dz_dy * y[0];
+
+        const float min_x = std::min({x[0], x[1], x[2]});
+        const float max_x = std::max({x[0], x[1], x[2]});
+        const float min_y = std::min({y[0], y[1], y[2]});
+        const float max_y = std::max({y[0], y[1], y[2]});
+
+        const uint32_t begin_x = std::max(tile_min_x, static_cast<uint32_t>(std::max(0.f, min_x)) & ~3u);
+        const uint32_t end_x   = std::min(tile_max_x, static_cast<uint32_t>(std::max(0.f, max_x + 1.f)));
+        const uint32_t begin_y = std::max(tile_min_y, static_cast<uint32_t>(std::max(0.f, min_y)));
+        const uint32_t end_y   = std::min(tile_max_y, static_cast<uint32_t>(std::max(0.f, max_y + 1.f)));
+
+#if POLARIS_OCCLUSION_SSE2
+        const __m128 lane_offset = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+        const __m128 zero        = _mm_setzero_ps();
+        for (uint32_t pixel_y = begin_y; pixel_y < end_y; ++pixel_y)
+        {
+            const float center_y = pixel_y + 0.5f;
+            float*      row      = m_depth_buffer.data() + static_cast<size_t>(pixel_y) * m_width;
+
+            for (uint32_t pixel_x = begin_x; pixel_x < end_x; pixel_x += 4)
+            {
+                const __m128 center_x = _mm_add_ps(_mm_set1_ps(static_cast<float>(pixel_x)), lane_offset);
+
+                __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+                for (int edge = 0; edge < 3; ++edge)
+                {
+                    const __m128 value = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(edge_a[edge]), center_x),
+                                                    _mm_set1_ps(edge_b[edge] * center_y + edge_c[edge]));
+                    inside             = _mm_and_ps(inside, _mm_cmpge_ps(value, zero));
+                }
+                if (_mm_movemask_ps(inside) == 0)
+                {
+                    continue;
+                }
+
+                const __m128 depth =
+                    _mm_add_ps(_mm_mul_ps(_mm_set1_ps(dz_dx), center_x), _mm_set1_ps(dz_dy * center_y + z_c));
+                const __m128 current = _mm_loadu_ps(row + pixel_x);
+                const __m128 nearest = _mm_min_ps(current, depth);
+                _mm_storeu_ps(row + pixel_x, _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, current)));
+            }
+        }
+#else
+        for (uint32_t pixel_y = begin_y; pixel_y < end_y; ++pixel_y)
+        {
+            const float center_y = pixel_y + 0.5f;
+            float*      row      = m_depth_buffer.data() + static_cast<size_t>(pixel_y) * m_width;
+
+            for (uint32_t pixel_x = begin_x; pixel_x < end_x; ++pixel_x)
+            {
+                const float center_x = pixel_x + 0.5f;
+
+                bool is_inside = true;
+                for (int edge = 0; edge < 3 && is_inside; ++edge)
+                {
+                    is_inside = edge_a[edge] * center_x + edge_b[edge] * center_y + edge_c[edge] >= 0.f;
+                }
+                if (is_inside)
+                {
+                    row[pixel_x] = std::min(row[pixel_x], dz_dx * center_x + dz_dy * center_y + z_c);
+                }
+            }
+        }
+#endif
+    }
+
+    void OcclusionCulling::buildDepthPyramid()
+    {
+        PROFILE_SCOPE("OcclusionCulling::buildDepthPyramid");
+
+        const float* source        = m_depth_buffer.data();
+        uint32_t     source_width  = m_width;
+        uint32_t     source_height = m_height;
+        for (DepthLevel& level : m_depth_pyramid)
+        {
+            for (uint32_t texel_y = 0; texel_y < level.m_height; ++texel_y)
+            {
+                const uint32_t y0 = std::min(texel_y * 2, source_height - 1);
+                const uint32_t y1 = std::min(texel_y * 2 + 1, source_height - 1);
+                for (uint32_t texel_x = 0; texel_x < level.m_width; ++texel_x)
+                {
+                    const uint32_t x0 = std::min(texel_x * 2, source_width - 1);
+                    const uint32_t x1 = std::min(texel_x * 2 + 1, source_width - 1);
+
+                    level.m_max_depth[texel_y * level.m_width + texel_x] =
+                        std::max({source[y0 * source_width + x0],
+                                  source[y0 * source_width + x1],
+                                  source[y1 * source_width + x0],
+                                  source[y1 * source_width + x1]});
+                }
+            }
+
+            source        = level.m_max_depth.data();
+            source_width  = level.m_width;
+            source_height = level.m_height;
+        }
+    }
+
+    /*
+    * The nearest depth of a box is found at one of its corners. The box is hidden when that depth
+    * is behind the farthest occluder depth everywhere inside its screen rectangle; the pyramid level
+    * is chosen so the rectangle covers at most 2x2 texels
+    */
+    bool OcclusionCulling::isVisible(const AxisAlignedBox& world_bounds) const
+    {
+        if (m_triangles.empty())
+        {
+            return true;
+        }
+
+        const Vector3& min_corner = world_bounds.getMinCorner();
+        const Vector3& max_corner = world_bounds.getMaxCorner();
+
+        float rect_min_x = std::numeric_limits<float>::max();
+        float rect_min_y = std::numeric_limits<float>::max();
+        float rect_max_x = -std::numeric_limits<float>::max();
+        float rect_max_y = -std::numeric_limits<float>::max();
+        float nearest_z  = std::numeric_limits<float>::max();
+        for (int corner = 0; corner < 8; ++corner)
+        {
+            const Vector3 position((corner & 1) ? max_corner.x : min_corner.x,
+                                   (corner & 2) ? max_corner.y : min_corner.y,
+                                   (corner & 4) ? max_corner.z : min_corner.z);
+            const Vector4 clip = transformPoint(m_view_projection, position);
+
+            // boxes reaching behind the camera are never hidden
+            if (clip.w <= k_near_clip_w)
+            {
+                return true;
+            }
+
+            const float inverse_w = 1.f / clip.w;
+            const float screen_x  = (clip.x * inverse_w * 0.5f + 0.5f) * m_width;
+            const float screen_y  = (clip.y * inverse_w * 0.5f + 0.5f) * m_height;
+            rect_min_x            = std::min(rect_min_x, screen_x);
+            rect_max_x            = std::max(rect_max_x, screen_x);
+            rect_min_y            = std::min(rect_min_y, screen_y);
+            rect_max_y            = std::max(rect_max_y, screen_y);
+            nearest_z             = std::min(nearest_z, clip.z * inverse_w);
+        }
+
+        if (nearest_z <= 0.f)
+        {
+            return true;
+        }
+
+        // the part of the rectangle outside the buffer is left to frustum culling
+        const int32_t pixel_min_x = std::max(0, static_cast<int32_t>(std::floor(rect_min_x)));
+        const int32_t pixel_min_y = std::max(0, static_cast<int32_t>(std::floor(rect_min_y)));
+        const int32_t pixel_max_x = std::min(static_cast<int32_t>(m_width) - 1, static_cast<int32_t>(std::floor(rect_max_x)));
+        const int32_t pixel_max_y = std::min(static_cast<int32_t>(m_height) - 1, static_cast<int32_t>(std::floor(rect_max_y)));
+        if (pixel_min_x > pixel_max_x || pixel_min_y > pixel_max_y)
+        {
+            return true;
+        }
+
+        // level i halves the resolution i + 1 times, pick the first one where the rectangle spans two texels
+        const uint32_t rect_size = static_cast<uint32_t>(std::max(pixel_max_x - pixel_min_x, pixel_max_y - pixel_min_y));
+        uint32_t       shift     = 1;
+        while ((rect_size >> shift) > 1 && shift < m_depth_pyramid.size())
+        {
+            ++shift;
+        }
+
+        const DepthLevel& level       = m_depth_pyramid[shift - 1];
+        const uint32_t    texel_max_x = std::min(level.m_width - 1, static_cast<uint32_t>(pixel_max_x) >> shift);
+        const uint32_t    texel_max_y = std::min(level.m_height - 1, static_cast<uint32_t>(pixel_max_y) >> shift);
+        for (uint32_t texel_y = static_cast<uint32_t>(pixel_min_y) >> shift; texel_y <= texel_max_y; ++texel_y)
+        {
+            for (uint32_t texel_x = static_cast<uint32_t>(pixel_min_x) >> shift; texel_x <= texel_max_x; ++texel_x)
+            {
+                if (nearest_z <= level.m_max_depth[texel_y * level.m_width + texel_x])
+                {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    void OcclusionCulling::cullVisibleEntities(const RenderEntityBounds& bounds, std::vector<uint32_t>& visible_entities) const
+    {
+        PROFILE_SCOPE("OcclusionCulling::cullVisibleEntities");
+
+        if (m_triangles.empty())
+        {
+            return;
+        }
+
+        visible_entities.erase(std::remove_if(visible_entities.begin(),
+                                              visible_entities.end(),
+                                              [this, &bounds](uint32_t entity_index) {
+                                                  return !isVisible(bounds.get(entity_index));
+                                              }),
+                               visible_entities.end());
+    }
+} // namespace Polaris
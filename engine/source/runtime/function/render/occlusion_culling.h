@@ -0,0 +1,84 @@
+#pragma once
+
+#include "runtime/core/math/axis_aligned.h"
+#include "runtime/core/math/matrix4.h"
+#include "runtime/core/math/vector3.h"
+
+#include "runtime/function/render/render_entity.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Polaris
+{
+    // triangle list of a mesh used as occluder, positions in the space of the mesh
+    struct OccluderMesh
+    {
+        std::vector<Vector3>  m_positions;
+        std::vector<uint32_t> m_indices;
+    };
+
+    /**
+     *  Occlusion culling against a small depth buffer rasterized on the cpu. Occluder triangles are
+     *  clipped to the near plane, projected and binned into screen tiles; tiles are rasterized in
+     *  parallel, four pixels at a time with sse2 where available, keeping the nearest depth. A max
+     *  depth pyramid built from the buffer then answers whether a box is hidden with a handful of
+     *  reads. Depth follows vulkan clip space, 0 near and 1 far
+     */
+    class OcclusionCulling
+    {
+    public:
+        // width is rounded up to a multiple of 4
+        void initialize(uint32_t width, uint32_t height);
+
+        // clears the depth buffer and drops the occluders of the previous frame
+        void beginFrame(const Matrix4x4& view_projection);
+        void addOccluder(const OccluderMesh& mesh, const Matrix4x4& model_matrix);
+        // rasterizes all added occluders and builds the depth pyramid
+        void rasterize();
+
+        // false when the box is completely behind the rasterized occluders
+        bool isVisible(const AxisAlignedBox& world_bounds) const;
+        // removes the hidden entities from visible_entities, keeping the order of the others
+        void cullVisibleEntities(const RenderEntityBounds& bounds, std::vector<uint32_t>& visible_entities) const;
+
+        uint32_t                  getWidth() const { return m_width; }
+        uint32_t                  getHeight() const { return m_height; }
+        const std::vector<float>& getDepthBuffer() const { return m_depth_buffer; }
+        size_t                    getOccluderTriangleCount() const { return m_triangles.size(); }
+
+    private:
+        struct ScreenTriangle
+        {
+            float m_x[3];
+            float m_y[3];
+            float m_z[3];
+        };
+
+        struct DepthLevel
+        {
+            uint32_t           m_width {0};
+            uint32_t           m_height {0};
+            std::vector<float> m_max_depth;
+        };
+
+        void addClipTriangle(const Vector4 (&clip)[3]);
+        void addScreenTriangle(const ScreenTriangle& triangle);
+        void rasterizeTile(uint32_t tile_index);
+        void rasterizeTriangle(const ScreenTriangle& triangle, uint32_t min_x, uint32_t min_y, uint32_t max_x, uint32_t max_y);
+        void buildDepthPyramid();
+
+        uint32_t m_width {0};
+        uint32_t m_height {0};
+        uint32_t m_tile_count_x {0};
+        uint32_t m_tile_count_y {0};
+
+        Matrix4x4 m_view_projection {Matrix4x4::IDENTITY};
+
+        std::vector<float>                 m_depth_buffer;
+        std::vector<ScreenTriangle>        m_triangles;
+        std::vector<std::vector<uint32_t>> m_tile_bins;
+        // level 0 is the depth buffer itself reduced 2x2, each texel the farthest depth below it
+        std::vector<DepthLevel> m_depth_pyramid;
+    };
+} // namespace Polaris
@@ -0,0 +1,239 @@
+#include "runtime/function/render/render_culling.h"
+
+#include "runtime/core/base/thread_pool.h"
+#include "runtime/core/profiler/profiler.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define POLARIS_CULLING_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+// msvc compiles avx intrinsics without enabling avx for the whole file
+#define POLARIS_TARGET_AVX
+#else
+#define POLARIS_TARGET_AVX __attribute__((target("avx")))
+#endif
+#else
+#define POLARIS_CULLING_X86 0
+#endif
+
+namespace Polaris
+{
+    namespace
+    {
+        // below this many entities a single thread finishes before workers would have started
+        constexpr uint32_t k_parallel_culling_min_entity_count = 32768;
+        constexpr uint32_t k_parallel_culling_chunk_size       = 16384;
+
+        Vector4 normalizePlane(const Vector4& plane)
+        {
+            const float length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+            return length > 0.f ? plane / length : plane;
+        }
+    } // namespace
+
+    RenderFrustum RenderFrustum::fromViewProjection(const Matrix4x4& view_projection)
+    {
+        const Vector4 row_x(view_projection[0][0], view_projection[0][1], view_projection[0][2], view_projection[0][3]);
+        const Vector4 row_y(view_projection[1][0], view_projection[1][1], view_projection[1][2], view_projection[1][3]);
+        const Vector4 row_z(view_projection[2][0], view_projection[2][1], view_projection[2][2], view_projection[2][3]);
+        const Vector4 row_w(view_projection[3][0], view_projection[3][1], view_projection[3][2], view_projection[3][3]);
+
+        RenderFrustum frustum;
+        frustum.m_planes[0] = normalizePlane(row_w + row_x); // left
+        frustum.m_planes[1] = normalizePlane(row_w - row_x); // right
+        frustum.m_planes[2] = normalizePlane(row_w + row_y); // bottom
+        frustum.m_planes[3] = normalizePlane(row_w - row_y); // top
+        frustum.m_planes[4] = normalizePlane(row_z);         // near
+        frustum.m_planes[5] = normalizePlane(row_w - row_z); // far
+        return frustum;
+    }
+
+    void FrustumCulling::cullView(const RenderEntityBounds& bounds, RenderView& view)
+    {
+        view.m_frustum = RenderFrustum::fromViewProjection(view.m_view_projection_matrix);
+        cull(bounds, view.m_frustum, view.m_visible_entities);
+    }
+
+    void FrustumCulling::cull(const RenderEntityBounds& bounds, const RenderFrustum& frustum, std::vector<uint32_t>& out_visible)
+    {
+        PROFILE_SCOPE("FrustumCulling::cull");
+
+        out_visible.clear();
+
+        const uint32_t entity_count = static_cast<uint32_t>(bounds.size());
+        ThreadPool&    thread_pool  = ThreadPool::getInstance();
+        const uint32_t worker_count = thread_pool.getThreadCount();
+        if (entity_count < k_parallel_culling_min_entity_count || worker_count == 1)
+        {
+            cullRange(bounds, frustum, 0, entity_count, out_visible);
+            return;
+        }
+
+        const uint32_t chunk_count = std::min(
+            worker_count, (entity_count + k_parallel_culling_chunk_size - 1) / k_parallel_culling_chunk_size);
+        const uint32_t chunk_size = (entity_count + chunk_count - 1) / chunk_count;
+
+        // chunk 0 writes straight into the output, the others are appended in order
+        std::vector<std::vector<uint32_t>> chunk_visibles(chunk_count);
+        thread_pool.parallelFor(chunk_count, [&](uint32_t chunk_index) {
+            const uint32_t begin = std::min(entity_count, chunk_index * chunk_size);
+            const uint32_t end   = std::min(entity_count, begin + chunk_size);
+            cullRange(bounds, frustum, begin, end, chunk_index == 0 ? out_visible : chunk_visibles[chunk_index]);
+        });
+
+        for (uint32_t chunk_index = 1; chunk_index < chunk_count; ++chunk_index)
+        {
+            out_visible.insert(out_visible.end(), chunk_visibles[chunk_index].begin(), chunk_visibles[chunk_index].end());
+        }
+    }
+
+    bool FrustumCulling::isAvxSupported()
+    {
+#if POLARIS_CULLING_X86
+#if defined(_MSC_VER)
+        static const bool is_supported = []() {
+            int cpu_info[4];
+            __cpuid(cpu_info, 1);
+            const bool has_avx     = (cpu_info[2] & (1 << 28)) != 0;
+            const bool has_osxsave = (cpu_info[2] & (1 << 27)) != 0;
+            // the os must also save the ymm registers on context switches
+            return has_avx && has_osxsave && (_xgetbv(0) & 0x6) == 0x6;
+        }();
+#else
+        static const bool is_supported = __builtin_cpu_supports("avx");
+#endif
+        return is_supported;
+#else
+        return false;
+#endif
+    }
+
+    void FrustumCulling::cullRange(const RenderEntityBounds& bounds,
+                                   const RenderFrustum&      frustum,
+                                   uint32_t                  begin,
+                                   uint32_t                  end,
+                                   std::vector<uint32_t>&    out_visible)
+    {
+        if (isAvxSupported())
+        {
+            cullRangeAvx(bounds, frustum, begin, end, out_visible);
+        }
+        else
+        {
+            cullRangeScalar(bounds, frustum, begin, end, out_visible);
+        }
+    }
+
+    /*
+    * A box is outside when it lies completely behind one plane, that is when the signed distance of
+    * its center plus its extent projected onto the plane normal is negative
+    */
+    void FrustumCulling::cullRangeScalar(const RenderEntityBounds& bounds,
+                                         const RenderFrustum&      frustum,
+                                         uint32_t                  begin,
+                                         uint32_t                  end,
+                                         std::vector<uint32_t>&    out_visible)
+    {
+        for (uint32_t index = begin; index < end; ++index)
+        {
+            bool is_visible = true;
+            for (const Vector4& plane : frustum.m_planes)
+            {
+                const float distance = plane.x * bounds.m_center_x[index] + plane.y * bounds.m_center_y[index] +
+                                       plane.z * bounds.m_center_z[index] + plane.w;
+                const float radius = std::fabs(plane.x) * bounds.m_half_extent_x[index] +
+                                     std::fabs(plane.y) * bounds.m_half_extent_y[index] +
+                                     std::fabs(plane.z) * bounds.m_half_extent_z[index];
+                if (distance + radius < 0.f)
+                {
+                    is_visible = false;
+                    break;
+                }
+            }
+
+            if (is_visible)
+            {
+                out_visible.push_back(index);
+            }
+        }
+    }
+
+#if POLARIS_CULLING_X86
+    POLARIS_TARGET_AVX void FrustumCulling::cullRangeAvx(const RenderEntityBounds& bounds,
+                                                         const RenderFrustum&      frustum,
+                                                         uint32_t                  begin,
+                                                         uint32_t                  end,
+                                                         std::vector<uint32_t>&    out_visible)
+    {
+        const __m256 sign_mask = _mm256_set1_ps(-0.f);
+
+        __m256 plane_x[6], plane_y[6], plane_z[6], plane_w[6];
+        __m256 abs_plane_x[6], abs_plane_y[6], abs_plane_z[6];
+        for (int plane_index = 0; plane_index < 6; ++plane_index)
+        {
+            const Vector4& plane     = frustum.m_planes[plane_index];
+            plane_x[plane_index]     = _mm256_set1_ps(plane.x);
+            plane_y[plane_index]     = _mm256_set1_ps(plane.y);
+            plane_z[plane_index]     = _mm256_set1_ps(plane.z);
+            plane_w[plane_index]     = _mm256_set1_ps(plane.w);
+            abs_plane_x[plane_index] = _mm256_andnot_ps(sign_mask, plane_x[plane_index]);
+            abs_plane_y[plane_index] = _mm256_andnot_ps(sign_mask, plane_y[plane_index]);
+            abs_plane_z[plane_index] = _mm256_andnot_ps(sign_mask, plane_z[plane_index]);
+        }
+
+        const __m256 zero  = _mm256_setzero_ps();
+        uint32_t     index = begin;
+        for (; index + 8 <= end; index += 8)
+        {
+            const __m256 center_x      = _mm256_loadu_ps(bounds.m_center_x.data() + index);
+            const __m256 center_y      = _mm256_loadu_ps(bounds.m_center_y.data() + index);
+            const __m256 center_z      = _mm256_loadu_ps(bounds.m_center_z.data() + index);
+            const __m256 half_extent_x = _mm256_loadu_ps(bounds.m_half_extent_x.data() + index);
+            const __m256 half_extent_y = _mm256_loadu_ps(bounds.m_half_extent_y.data() + index);
+            const __m256 half_extent_z = _mm256_loadu_ps(bounds.m_half_extent_z.data() + index);
+
+            __m256 outside = _mm256_setzero_ps();
+            for (int plane_index = 0; plane_index < 6; ++plane_index)
+            {
+                __m256 distance = _mm256_add_ps(_mm256_mul_ps(plane_x[plane_index], center_x), plane_w[plane_index]);
+                distance        = _mm256_add_ps(distance, _mm256_mul_ps(plane_y[plane_index], center_y));
+                distance        = _mm256_add_ps(distance, _mm256_mul_ps(plane_z[plane_index], center_z));
+
+                __m256 radius = _mm256_mul_ps(abs_plane_x[plane_index], half_extent_x);
+                radius        = _mm256_add_ps(radius, _mm256_mul_ps(abs_plane_y[plane_index], half_extent_y));
+                radius        = _mm256_add_ps(radius, _mm256_mul_ps(abs_plane_z[plane_index], half_extent_z));
+
+                outside = _mm256_or_ps(outside, _mm256_cmp_ps(_mm256_add_ps(distance, radius), zero, _CMP_LT_OQ));
+            }
+
+            uint32_t visible_mask = ~static_cast<uint32_t>(_mm256_movemask_ps(outside)) & 0xffu;
+            while (visible_mask != 0)
+            {
+                uint32_t lane = 0;
+                while ((visible_mask & (1u << lane)) == 0)
+                {
+                    ++lane;
+                }
+                out_visible.push_back(index + lane);
+                visible_mask &= visible_mask - 1;
+            }
+        }
+
+        // fewer than eight boxes left
+        cullRangeScalar(bounds, frustum, index, end, out_visible);
+    }
+#else
+    void FrustumCulling::cullRangeAvx(const RenderEntityBounds& bounds,
+                                      const RenderFrustum&      frustum,
+                                      uint32_t                  begin,
+                                      uint32_t                  end,
+                                      std::vector<uint32_t>&    out_visible)
+    {
+        cullRangeScalar(bounds, frustum, begin, end, out_visible);
+    }
+#endif
+} // namespace Polaris
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "runtime/core/math/matrix4.h"
+#include "runtime/core/math/vector4.h"
+
+#include "runtime/function/render/render_entity.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Polaris
+{
+    // planes point inwards, a point p is inside when dot(plane.xyz, p) + plane.w >= 0 for all of them
+    struct RenderFrustum
+    {
+        Vector4 m_planes[6];
+
+        // view_projection maps to vulkan clip space, depth in [0, 1]
+        static RenderFrustum fromViewProjection(const Matrix4x4& view_projection);
+    };
+
+    enum class RenderViewType : uint8_t
+    {
+        camera,
+        shadow
+    };
+
+    // one point of view the scene is drawn from, with the entities that survived culling for it
+    struct RenderView
+    {
+        RenderViewType        m_type {RenderViewType::camera};
+        Matrix4x4             m_view_projection_matrix {Matrix4x4::IDENTITY};
+        RenderFrustum         m_frustum;
+        std::vector<uint32_t> m_visible_entities;
+    };
+
+    /**
+     *  Frustum culling over RenderEntityBounds. Eight boxes are tested per iteration with AVX when
+     *  the cpu supports it, and large scenes are split into chunks culled on worker threads. The
+     *  visible entity indices come out in ascending order either way
+     */
+    class FrustumCulling
+    {
+    public:
+        static void cullView(const RenderEntityBounds& bounds, RenderView& view);
+        static void cull(const RenderEntityBounds& bounds, const RenderFrustum& frustum, std::vector<uint32_t>& out_visible);
+
+        static bool isAvxSupported();
+
+    private:
+        static void cullRange(const RenderEntityBounds& bounds,
+                              const RenderFrustum&      frustum,
+                              uint32_t                  begin,
+                              uint32_t                  end,
+                              std::vector<uint32_t>&    out_visible);
+        static void cullRangeScalar(const RenderEntityBounds& bounds,
+                                    const RenderFrustum&      frustum,
+                                    uint32_t                  begin,
+                                    uint32_t                  end,
+                                    std::vector<uint32_t>&    out_visible);
+        static void cullRangeAvx(const RenderEntityBounds& bounds,
+                                 const RenderFrustum&      frustum,
+                                 uint32_t                  begin,
+                                 uint32_t                  end,
+                                 std::vector<uint32_t>&    out_visible);
+    };
+} // namespace Polaris
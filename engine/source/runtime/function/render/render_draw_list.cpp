@@ -0,0 +1,237 @@
+#include "runtime/function/render/render_draw_list.h"
+
+#include "runtime/core/base/thread_pool.h"
+#include "runtime/core/profiler/profiler.h"
+
+#include "runtime/function/render/render_culling.h"
+#include "runtime/function/render/render_scene.h"
+
+#include <algorithm>
+#include <array>
+
+namespace Polaris
+{
+    namespace
+    {
+        // below this many items the sort runs on the calling thread
+        constexpr size_t k_parallel_sort_min_item_count = 65536;
+
+        uint64_t makeField(uint64_t value, uint32_t bits) { return value & ((1ull << bits) - 1); }
+    } // namespace
+
+    uint64_t DrawSortKey::make(RenderPassType     pass,
+                               RenderPipelineType pipeline,
+                               MaterialHandle     material,
+                               MeshHandle         mesh,
+                               float              depth)
+    {
+        const uint64_t depth_max   = (1ull << k_depth_bits) - 1;
+        const uint64_t depth_value = static_cast<uint64_t>(std::clamp(depth, 0.f, 1.f) * depth_max);
+
+        uint64_t key = makeField(static_cast<uint64_t>(pass), k_pass_bits);
+        key          = (key << k_pipeline_bits) | makeField(static_cast<uint64_t>(pipeline), k_pipeline_bits);
+        key          = (key << k_material_bits) | makeField(material, k_material_bits);
+        key          = (key << k_mesh_bits) | makeField(mesh, k_mesh_bits);
+        key          = (key << k_depth_bits) | depth_value;
+        return key;
+    }
+
+    void DrawList::build(const RenderScene& scene, const RenderView& view, RenderPassType pass, float max_depth)
+    {
+        PROFILE_SCOPE("DrawList::build");
+
+        clear();
+
+        const std::vector<RenderEntity>&         entities          = scene.getEntities();
+        const std::vector<RenderEntityLodState>& lod_states        = scene.getLodStates();
+        const RenderEntityBounds&                world_bounds      = scene.getWorldBounds();
+        const Matrix4x4&                         view_projection   = view.m_view_projection_matrix;
+        const float                              inverse_max_depth = max_depth > 0.f ? 1.f / max_depth : 0.f;
+
+        m_items.reserve(view.m_visible_entities.size());
+        for (uint32_t entity_index : view.m_visible_entities)
+        {
+            const RenderEntity&         entity    = entities[entity_index];
+            const RenderEntityLodState& lod_state = lod_states[entity_index];
+
+            // clip w of the bounds center is its view depth
+            const float depth = view_projection[3][0] * world_bounds.m_center_x[entity_index] +
+                                view_projection[3][1] * world_bounds.m_center_y[entity_index] +
+                                view_projection[3][2] * world_bounds.m_center_z[entity_index] + view_projection[3][3];
+
+            const RenderPipelineType pipeline =
+                entity.m_enable_vertex_blending ? RenderPipelineType::skinned_mesh : RenderPipelineType::static_mesh;
+
+            DrawItem item;
+            item.m_entity_index    = entity_index;
+            item.m_material_handle = entity.m_material_handle;
+            item.m_mesh_handle     = entity.m_lods.m_mesh_handles[lod_state.m_lod];
+            item.m_lod_fade        = lod_state.m_fade;
+            item.m_sort_key =
+                DrawSortKey::make(pass, pipeline, item.m_material_handle, item.m_mesh_handle, depth * inverse_max_depth);
+            m_items.push_back(item);
+
+            if (lod_state.m_fade < 1.f && lod_state.m_previous_lod != lod_state.m_lod)
+            {
+                item.m_mesh_handle = entity.m_lods.m_mesh_handles[lod_state.m_previous_lod];
+                item.m_lod_fade    = -lod_state.m_fade;
+                item.m_sort_key    = DrawSortKey::make(
+                    pass, pipeline, item.m_material_handle, item.m_mesh_handle, depth * inverse_max_depth);
+                m_items.push_back(item);
+            }
+        }
+
+        sortItems(m_items, m_sort_scratch);
+        buildBatches(scene, pass);
+    }
+
+    void DrawList::clear()
+    {
+        m_items.clear();
+        m_batches.clear();
+        m_instance_data.clear();
+        m_pipeline_change_count = 0;
+        m_material_change_count = 0;
+    }
+
+    /*
+    * Each pass scatters by one byte of the key. Workers histogram their own slice, the offsets are
+    * laid out bucket by bucket and within a bucket slice by slice, so every worker scatters into
+    * ranges of its own and equal keys keep their order
+    */
+    void DrawList::sortItems(std::vector<DrawItem>& items, std::vector<DrawItem>& scratch)
+    {
+        PROFILE_SCOPE("DrawList::sortItems");
+
+        const size_t item_count = items.size();
+        if (item_count < 2)
+        {
+            return;
+        }
+
+        uint64_t key_or  = 0;
+        uint64_t key_and = ~0ull;
+        for (const DrawItem& item : items)
+        {
+            key_or |= item.m_sort_key;
+            key_and &= item.m_sort_key;
+        }
+        const uint64_t varying_bits = key_or ^ key_and;
+
+        ThreadPool&    thread_pool  = ThreadPool::getInstance();
+        const uint32_t worker_count = thread_pool.getThreadCount();
+        const uint32_t chunk_count =
+            item_count < k_parallel_sort_min_item_count
+                ? 1u
+                : std::min(worker_count, static_cast<uint32_t>(item_count / (k_parallel_sort_min_item_count / 4)));
+        const size_t chunk_size = (item_count + chunk_count - 1) / chunk_count;
+
+        std::vector<std::array<uint32_t, 256>> chunk_offsets(chunk_count);
+
+        scratch.resize(item_count);
+        DrawItem* source = items.data();
+        DrawItem* target = scratch.data();
+        for (uint32_t shift = 0; shift < 64; shift += 8)
+        {
+            if (((varying_bits >> shift) & 0xff) == 0)
+            {
+                continue;
+            }
+
+            thread_pool.parallelFor(chunk_count, [&](uint32_t chunk_index) {
+                std::array<uint32_t, 256>& histogram = chunk_offsets[chunk_index];
+                histogram.fill(0);
+
+                const size_t end = std::min(item_count, (chunk_index + 1) * chunk_size);
+                for (size_t index = chunk_index * chunk_size; index < end; ++index)
+                {
+                    ++histogram[(source[index].m_sort_key >> shift) & 0xff];
+                }
+            });
+
+            uint32_t offset = 0;
+            for (uint32_t bucket = 0; bucket < 256; ++bucket)
+            {
+                for (std::array<uint32_t, 256>& histogram : chunk_offsets)
+                {
+                    const uint32_t count = histogram[bucket];
+                    histogram[bucket]    = offset;
+                    offset += count;
+                }
+            }
+
+            thread_pool.parallelFor(chunk_count, [&](uint32_t chunk_index) {
+                std::array<uint32_t, 256>& offsets = chunk_offsets[chunk_index];
+
+                const size_t end = std::min(item_count, (chunk_index + 1) * chunk_size);
+                for (size_t index = chunk_index * chunk_size; index < end; ++index)
+                {
+                    target[offsets[(source[index].m_sort_key >> shift) & 0xff]++] = source[index];
+                }
+            });
+
+            std::swap(source, target);
+        }
+
+        if (source != items.data())
+        {
+            items.swap(scratch);
+        }
+    }
+
+    void DrawList::buildBatches(const RenderScene& scene, RenderPassType pass)
+    {
+        PROFILE_SCOPE("DrawList::buildBatches");
+
+        const std::vector<Matrix4x4>& model_matrices = scene.getModelMatrices();
+        constexpr uint32_t            pipeline_shift =
+            DrawSortKey::k_material_bits + DrawSortKey::k_mesh_bits + DrawSortKey::k_depth_bits;
+
+        m_instance_data.resize(m_items.size());
+        for (size_t item_index = 0; item_index < m_items.size(); ++item_index)
+        {
+            const DrawItem&          item     = m_items[item_index];
+            const RenderPipelineType pipeline = static_cast<RenderPipelineType>(
+                (item.m_sort_key >> pipeline_shift) & ((1ull << DrawSortKey::k_pipeline_bits) - 1));
+
+            // the full handles are compared, keys of handles too wide for their field may collide
+            const bool is_new_batch = m_batches.empty() || m_batches.back().m_pipeline != pipeline ||
+                                      m_batches.back().m_material_handle != item.m_material_handle ||
+                                      m_batches.back().m_mesh_handle != item.m_mesh_handle;
+            if (is_new_batch)
+            {
+                if (m_batches.empty() || m_batches.back().m_pipeline != pipeline)
+                {
+                    ++m_pipeline_change_count;
+                }
+                if (m_batches.empty() || m_batches.back().m_material_handle != item.m_material_handle)
+                {
+                    ++m_material_change_count;
+                }
+
+                DrawBatch batch;
+                batch.m_pass            = pass;
+                batch.m_pipeline        = pipeline;
+                batch.m_material_handle = item.m_material_handle;
+                batch.m_mesh_handle     = item.m_mesh_handle;
+                batch.m_first_instance  = static_cast<uint32_t>(item_index);
+                m_batches.push_back(batch);
+            }
+            ++m_batches.back().m_instance_count;
+
+            const Matrix4x4&    model_matrix  = model_matrices[item.m_entity_index];
+            RenderInstanceData& instance_data = m_instance_data[item_index];
+            for (int row = 0; row < 3; ++row)
+            {
+                for (int column = 0; column < 4; ++column)
+                {
+                    instance_data.m_model_rows[row][column] = model_matrix[row][column];
+                }
+            }
+            instance_data.m_lod_fade     = item.m_lod_fade;
+            instance_data.m_entity_index = item.m_entity_index;
+            instance_data.m_padding[0]   = 0;
+            instance_data.m_padding[1]   = 0;
+        }
+    }
+} // namespace Polaris
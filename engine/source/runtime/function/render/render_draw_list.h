@@ -0,0 +1,120 @@
+#pragma once
+
+#include "runtime/function/render/render_entity.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Polaris
+{
+    class RenderScene;
+    struct RenderView;
+
+    enum class RenderPassType : uint8_t
+    {
+        shadow,
+        opaque
+    };
+
+    // the pipelines a mesh part can be drawn with, ordered by how they are bound
+    enum class RenderPipelineType : uint8_t
+    {
+        static_mesh,
+        skinned_mesh
+    };
+
+    // key of the pipeline the rhi compiles for a pass and pipeline type
+    inline uint32_t makePipelinePermutation(RenderPassType pass, RenderPipelineType pipeline)
+    {
+        return (static_cast<uint32_t>(pass) << 8) | static_cast<uint32_t>(pipeline);
+    }
+
+    /**
+     *  Sort key layout, most significant first: pass 4 bits, pipeline 8 bits, material 16 bits,
+     *  mesh 20 bits, depth 16 bits. Sorting the keys groups the draws by state with the most
+     *  expensive change on top, and orders the instances of one mesh front to back
+     */
+    struct DrawSortKey
+    {
+        static constexpr uint32_t k_pass_bits     = 4;
+        static constexpr uint32_t k_pipeline_bits = 8;
+        static constexpr uint32_t k_material_bits = 16;
+        static constexpr uint32_t k_mesh_bits     = 20;
+        static constexpr uint32_t k_depth_bits    = 16;
+
+        // depth in [0, 1], handles wider than their field are masked, which only affects the order
+        static uint64_t make(RenderPassType     pass,
+                             RenderPipelineType pipeline,
+                             MaterialHandle     material,
+                             MeshHandle         mesh,
+                             float              depth);
+    };
+
+    struct DrawItem
+    {
+        uint64_t       m_sort_key {0};
+        uint32_t       m_entity_index {0};
+        MeshHandle     m_mesh_handle {k_invalid_render_handle};
+        MaterialHandle m_material_handle {k_invalid_render_handle};
+        // 1 for a fully shown lod, below 1 while a lod fades in. The lod fading out at the same time
+        // gets the value negated, so the two are dithered with complementary patterns
+        float m_lod_fade {1.f};
+    };
+
+    // per instance data, laid out to be copied as is into one gpu buffer shared by all draws of a view
+    struct alignas(16) RenderInstanceData
+    {
+        // first three rows of the model matrix
+        float    m_model_rows[3][4];
+        float    m_lod_fade;
+        uint32_t m_entity_index;
+        uint32_t m_padding[2];
+    };
+
+    // one instanced draw: m_instance_count instances starting at m_first_instance of the instance buffer
+    struct DrawBatch
+    {
+        RenderPassType     m_pass {RenderPassType::opaque};
+        RenderPipelineType m_pipeline {RenderPipelineType::static_mesh};
+        MaterialHandle     m_material_handle {k_invalid_render_handle};
+        MeshHandle         m_mesh_handle {k_invalid_render_handle};
+        uint32_t           m_first_instance {0};
+        uint32_t           m_instance_count {0};
+    };
+
+    /**
+     *  Turns the visible entities of a view into instanced draws. One item with a 64 bit sort key is
+     *  emitted per entity, two while its lod fades; the items are radix sorted, in parallel for large
+     *  views, and consecutive items sharing pass, pipeline, material and mesh become one draw with
+     *  their instance data packed next to each other
+     */
+    class DrawList
+    {
+    public:
+        // max_depth maps view depth to the depth bits of the keys, farther entities share the last value
+        void build(const RenderScene& scene, const RenderView& view, RenderPassType pass, float max_depth);
+        void clear();
+
+        const std::vector<DrawItem>&           getItems() const { return m_items; }
+        const std::vector<DrawBatch>&          getBatches() const { return m_batches; }
+        const std::vector<RenderInstanceData>& getInstanceData() const { return m_instance_data; }
+
+        // binds needed to submit the batches in order, the first batch counts as one change of each
+        uint32_t getPipelineChangeCount() const { return m_pipeline_change_count; }
+        uint32_t getMaterialChangeCount() const { return m_material_change_count; }
+
+        // stable lsd radix sort by m_sort_key, skipping the bytes all keys agree on
+        static void sortItems(std::vector<DrawItem>& items, std::vector<DrawItem>& scratch);
+
+    private:
+        void buildBatches(const RenderScene& scene, RenderPassType pass);
+
+        std::vector<DrawItem>           m_items;
+        std::vector<DrawItem>           m_sort_scratch;
+        std::vector<DrawBatch>          m_batches;
+        std::vector<RenderInstanceData> m_instance_data;
+
+        uint32_t m_pipeline_change_count {0};
+        uint32_t m_material_change_count {0};
+    };
+} // namespace Polaris
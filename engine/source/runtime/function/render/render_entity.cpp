@@ -0,0 +1,53 @@
+#include "runtime/function/render/render_entity.h"
+
+namespace Polaris
+{
+    void RenderEntityBounds::pushBack(const AxisAlignedBox& bounds)
+    {
+        m_center_x.push_back(0.f);
+        m_center_y.push_back(0.f);
+        m_center_z.push_back(0.f);
+        m_half_extent_x.push_back(0.f);
+        m_half_extent_y.push_back(0.f);
+        m_half_extent_z.push_back(0.f);
+        set(static_cast<uint32_t>(size() - 1), bounds);
+    }
+
+    void RenderEntityBounds::set(uint32_t index, const AxisAlignedBox& bounds)
+    {
+        const Vector3& center      = bounds.getCenter();
+        const Vector3& half_extent = bounds.getHalfExtent();
+
+        m_center_x[index]      = center.x;
+        m_center_y[index]      = center.y;
+        m_center_z[index]      = center.z;
+        m_half_extent_x[index] = half_extent.x;
+        m_half_extent_y[index] = half_extent.y;
+        m_half_extent_z[index] = half_extent.z;
+    }
+
+    AxisAlignedBox RenderEntityBounds::get(uint32_t index) const
+    {
+        return AxisAlignedBox(Vector3(m_center_x[index], m_center_y[index], m_center_z[index]),
+                              Vector3(m_half_extent_x[index], m_half_extent_y[index], m_half_extent_z[index]));
+    }
+
+    void RenderEntityBounds::removeSwapBack(uint32_t index)
+    {
+        for (std::vector<float>* component :
+             {&m_center_x, &m_center_y, &m_center_z, &m_half_extent_x, &m_half_extent_y, &m_half_extent_z})
+        {
+            (*component)[index] = component->back();
+            component->pop_back();
+        }
+    }
+
+    void RenderEntityBounds::clear()
+    {
+        for (std::vector<float>* component :
+             {&m_center_x, &m_center_y, &m_center_z, &m_half_extent_x, &m_half_extent_y, &m_half_extent_z})
+        {
+            component->clear();
+        }
+    }
+} // namespace Polaris
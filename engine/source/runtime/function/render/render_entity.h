@@ -0,0 +1,75 @@
+#pragma once
+
+#include "runtime/core/math/axis_aligned.h"
+#include "runtime/core/math/matrix4.h"
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace Polaris
+{
+    using MeshHandle     = uint32_t;
+    using MaterialHandle = uint32_t;
+
+    constexpr uint32_t k_invalid_render_handle = std::numeric_limits<uint32_t>::max();
+    constexpr uint32_t k_max_mesh_lod_count    = 4;
+
+    // the meshes an entity can be drawn with, lod 0 is the full mesh and later ones get coarser
+    struct RenderEntityLods
+    {
+        uint32_t   m_count {1};
+        MeshHandle m_mesh_handles[k_max_mesh_lod_count] {
+            k_invalid_render_handle, k_invalid_render_handle, k_invalid_render_handle, k_invalid_render_handle};
+        // mesh space error of each lod against the full mesh, 0 for lod 0
+        float    m_geometric_errors[k_max_mesh_lod_count] {};
+        uint32_t m_triangle_counts[k_max_mesh_lod_count] {};
+    };
+
+    // lod currently drawn, while m_fade is below 1 the previous lod is faded out over a few frames
+    struct RenderEntityLodState
+    {
+        uint8_t  m_lod {0};
+        uint8_t  m_previous_lod {0};
+        float    m_fade {1.f};
+        uint64_t m_last_selected_frame {0};
+    };
+
+    // one mesh part of a game object as seen by the renderer, with every resource resolved to a handle
+    struct RenderEntity
+    {
+        MeshHandle     m_mesh_handle {k_invalid_render_handle};
+        MaterialHandle m_material_handle {k_invalid_render_handle};
+        bool           m_enable_vertex_blending {false};
+        bool           m_is_occluder {false};
+        // m_mesh_handle is the first of them
+        RenderEntityLods m_lods;
+        // transform of the part relative to its game object
+        Matrix4x4 m_local_transform {Matrix4x4::IDENTITY};
+        // mesh bounds in the space of the game object
+        AxisAlignedBox m_local_bounds;
+    };
+
+    /**
+     *  World space bounds of all render entities as center and half extent, one array per
+     *  component, so culling can load the same component of eight consecutive entities at once
+     */
+    struct RenderEntityBounds
+    {
+        std::vector<float> m_center_x;
+        std::vector<float> m_center_y;
+        std::vector<float> m_center_z;
+        std::vector<float> m_half_extent_x;
+        std::vector<float> m_half_extent_y;
+        std::vector<float> m_half_extent_z;
+
+        size_t size() const { return m_center_x.size(); }
+
+        void           pushBack(const AxisAlignedBox& bounds);
+        void           set(uint32_t index, const AxisAlignedBox& bounds);
+        AxisAlignedBox get(uint32_t index) const;
+        // moves the last bounds into index and drops the last slot
+        void removeSwapBack(uint32_t index);
+        void clear();
+    };
+} // namespace Polaris
@@ -0,0 +1,664 @@
+#include "runtime/function/render/render_graph.h"
+
+#include "runtime/core/base/macro.h"
+#include "runtime/core/profiler/profiler.h"
+
+#include <algorithm>
+#include <array>
+
+namespace Polaris
+{
+    namespace
+    {
+        constexpr VkPipelineStageFlags k_shader_stages = VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+                                                         VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
+                                                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+        constexpr VkPipelineStageFlags k_depth_stages =
+            VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+
+        // alignments assumed when no device is queried, conservative for common hardware
+        constexpr VkDeviceSize k_estimated_image_alignment  = 64 * 1024;
+        constexpr VkDeviceSize k_estimated_buffer_alignment = 256;
+
+        const std::array<RenderGraphAccessInfo, 11> k_access_infos = {{
+            // color_attachment
+            {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+             VK_ACCESS_COLOR_ATTACHMENT_READ_BIT,
+             VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+             VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+             VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,
+             0},
+            // depth_stencil_attachment
+            {k_depth_stages,
+             VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT,
+             VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+             VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+             VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
+             0},
+            // depth_stencil_read, depth test and sampling at the same time
+            {k_depth_stages | k_shader_stages,
+             VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_SHADER_READ_BIT,
+             0,
+             VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL,
+             VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+             0},
+            // sampled
+            {k_shader_stages,
+             VK_ACCESS_SHADER_READ_BIT,
+             0,
+             VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+             VK_IMAGE_USAGE_SAMPLED_BIT,
+             VK_BUFFER_USAGE_UNIFORM_TEXEL_BUFFER_BIT},
+            // storage
+            {k_shader_stages,
+             VK_ACCESS_SHADER_READ_BIT,
+             VK_ACCESS_SHADER_WRITE_BIT,
+             VK_IMAGE_LAYOUT_GENERAL,
+             VK_IMAGE_USAGE_STORAGE_BIT,
+             VK_BUFFER_USAGE_STORAGE_BUFFER_BIT},
+            // uniform_buffer
+            {k_shader_stages, VK_ACCESS_UNIFORM_READ_BIT, 0, VK_IMAGE_LAYOUT_UNDEFINED, 0, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT},
+            // vertex_buffer
+            {VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+             VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT,
+             0,
+             VK_IMAGE_LAYOUT_UNDEFINED,
+             0,
+             VK_BUFFER_USAGE_VERTEX_BUFFER_BIT},
+            // index_buffer
+            {VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_INDEX_READ_BIT, 0, VK_IMAGE_LAYOUT_UNDEFINED, 0, VK_BUFFER_USAGE_INDEX_BUFFER_BIT},
+            // indirect_buffer
+            {VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+             VK_ACCESS_INDIRECT_COMMAND_READ_BIT,
+             0,
+             VK_IMAGE_LAYOUT_UNDEFINED,
+             0,
+             VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT},
+            // transfer_source
+            {VK_PIPELINE_STAGE_TRANSFER_BIT,
+             VK_ACCESS_TRANSFER_READ_BIT,
+             0,
+             VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+             VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+             VK_BUFFER_USAGE_TRANSFER_SRC_BIT},
+            // transfer_destination
+            {VK_PIPELINE_STAGE_TRANSFER_BIT,
+             0,
+             VK_ACCESS_TRANSFER_WRITE_BIT,
+             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+             VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+             VK_BUFFER_USAGE_TRANSFER_DST_BIT},
+        }};
+
+        uint32_t getFormatTexelSize(VkFormat format)
+        {
+            switch (format)
+            {
+                case VK_FORMAT_R8_UNORM:
+                case VK_FORMAT_R8_UINT:
+                    return 1;
+                case VK_FORMAT_R16_SFLOAT:
+                case VK_FORMAT_R16_UNORM:
+                case VK_FORMAT_D16_UNORM:
+                    return 2;
+                case VK_FORMAT_R16G16B16A16_SFLOAT:
+                case VK_FORMAT_R32G32_SFLOAT:
+                case VK_FORMAT_D32_SFLOAT_S8_UINT:
+                    return 8;
+                case VK_FORMAT_R32G32B32A32_SFLOAT:
+                    return 16;
+                default:
+                    // 8 bit rgba, bgra, packed 10 and 11 bit, 32 bit single channel and 24/32 bit depth
+                    return 4;
+            }
+        }
+
+        VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment)
+        {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+
+        bool isLifetimeOverlapping(uint32_t first_a, uint32_t last_a, uint32_t first_b, uint32_t last_b)
+        {
+            return first_a <= last_b && first_b <= last_a;
+        }
+    } // namespace
+
+    const RenderGraphAccessInfo& RenderGraph::getAccessInfo(RenderGraphAccess access)
+    {
+        return k_access_infos[static_cast<size_t>(access)];
+    }
+
+    RenderGraphResource RenderGraph::createImage(const std::string& name, const RenderGraphImageDesc& desc)
+    {
+        ResourceNode resource;
+        resource.m_name       = name;
+        resource.m_type       = RenderGraphResourceType::image;
+        resource.m_image_desc = desc;
+        return addResource(std::move(resource));
+    }
+
+    RenderGraphResource RenderGraph::createBuffer(const std::string& name, const RenderGraphBufferDesc& desc)
+    {
+        ResourceNode resource;
+        resource.m_name        = name;
+        resource.m_type        = RenderGraphResourceType::buffer;
+        resource.m_buffer_desc = desc;
+        return addResource(std::move(resource));
+    }
+
+    RenderGraphResource RenderGraph::importImage(const std::string&          name,
+                                                 const RenderGraphImageDesc& desc,
+                                                 VkImage                     image,
+                                                 VkImageView                 image_view,
+                                                 VkImageLayout               initial_layout,
+                                                 VkImageLayout               final_layout,
+                                                 VkPipelineStageFlags        initial_stages)
+    {
+        ResourceNode resource;
+        resource.m_name                = name;
+        resource.m_type                = RenderGraphResourceType::image;
+        resource.m_image_desc          = desc;
+        resource.m_is_imported         = true;
+        resource.m_imported_image      = image;
+        resource.m_imported_image_view = image_view;
+        resource.m_initial_layout      = initial_layout;
+        resource.m_final_layout        = final_layout;
+        resource.m_initial_stages      = initial_stages;
+        return addResource(std::move(resource));
+    }
+
+    RenderGraphResource RenderGraph::importBuffer(const std::string&           name,
+                                                  const RenderGraphBufferDesc& desc,
+                                                  VkBuffer                     buffer,
+                                                  VkPipelineStageFlags         initial_stages)
+    {
+        ResourceNode resource;
+        resource.m_name            = name;
+        resource.m_type            = RenderGraphResourceType::buffer;
+        resource.m_buffer_desc     = desc;
+        resource.m_is_imported     = true;
+        resource.m_imported_buffer = buffer;
+        resource.m_initial_stages  = initial_stages;
+        return addResource(std::move(resource));
+    }
+
+    RenderGraphResource RenderGraph::addResource(ResourceNode&& resource)
+    {
+        m_resources.push_back(std::move(resource));
+        return static_cast<RenderGraphResource>(m_resources.size() - 1);
+    }
+
+    RenderGraphPass RenderGraph::addPass(const std::string& name, ExecuteCallback execute_callback)
+    {
+        PassNode pass;
+        pass.m_name             = name;
+        pass.m_execute_callback = std::move(execute_callback);
+        m_passes.push_back(std::move(pass));
+        return static_cast<RenderGraphPass>(m_passes.size() - 1);
+    }
+
+    void RenderGraph::read(RenderGraphPass pass, RenderGraphResource resource, RenderGraphAccess access)
+    {
+        m_passes[pass].m_uses.push_back({resource, access, false});
+        m_resources[resource].m_image_usage |= getAccessInfo(access).m_image_usage;
+        m_resources[resource].m_buffer_usage |= getAccessInfo(access).m_buffer_usage;
+    }
+
+    void RenderGraph::write(RenderGraphPass pass, RenderGraphResource resource, RenderGraphAccess access)
+    {
+        m_passes[pass].m_uses.push_back({resource, access, true});
+        m_resources[resource].m_image_usage |= getAccessInfo(access).m_image_usage;
+        m_resources[resource].m_buffer_usage |= getAccessInfo(access).m_buffer_usage;
+    }
+
+    void RenderGraph::setSideEffect(RenderGraphPass pass) { m_passes[pass].m_has_side_effect = true; }
+
+    void RenderGraph::markOutput(RenderGraphResource resource) { m_resources[resource].m_is_output = true; }
+
+    bool RenderGraph::compile(const MemoryRequirementsQuery& memory_query)
+    {
+        PROFILE_SCOPE("RenderGraph::compile");
+
+        m_execution_order.clear();
+        m_final_barriers.clear();
+        m_heaps.clear();
+        for (PassNode& pass : m_passes)
+        {
+            pass.m_is_culled = false;
+            pass.m_barriers.clear();
+        }
+        for (ResourceNode& resource : m_resources)
+        {
+            resource.m_first_pass  = k_invalid_render_graph_handle;
+            resource.m_last_pass   = k_invalid_render_graph_handle;
+            resource.m_heap        = k_invalid_render_graph_handle;
+            resource.m_heap_offset = 0;
+            resource.m_aliased_predecessors.clear();
+        }
+
+        cullPasses();
+        if (!computeLifetimes())
+        {
+            return false;
+        }
+        placeTransientResources(memory_query);
+        computeBarriers();
+        return true;
+    }
+
+    void RenderGraph::reset()
+    {
+        m_passes.clear();
+        m_resources.clear();
+        m_execution_order.clear();
+        m_final_barriers.clear();
+        m_heaps.clear();
+    }
+
+    /*
+    * Walks the passes backwards tracking which resources are still needed. A pass survives if it
+    * has side effects or writes a needed resource, and then needs everything it reads. A write
+    * without a read of the same resource replaces its content, so earlier writers are only needed
+    * again if some pass before it reads the resource
+    */
+    void RenderGraph::cullPasses()
+    {
+        std::vector<bool> is_needed(m_resources.size(), false);
+        for (size_t resource_index = 0; resource_index < m_resources.size(); ++resource_index)
+        {
+            is_needed[resource_index] = m_resources[resource_index].m_is_imported || m_resources[resource_index].m_is_output;
+        }
+
+        for (size_t pass_index = m_passes.size(); pass_index-- > 0;)
+        {
+            PassNode& pass     = m_passes[pass_index];
+            bool      is_alive = pass.m_has_side_effect;
+            for (const ResourceUse& use : pass.m_uses)
+            {
+                is_alive = is_alive || (use.m_is_write && is_needed[use.m_resource]);
+            }
+            pass.m_is_culled = !is_alive;
+            if (!is_alive)
+            {
+                continue;
+            }
+
+            for (const ResourceUse& use : pass.m_uses)
+            {
+                if (!use.m_is_write || m_resources[use.m_resource].m_is_imported || m_resources[use.m_resource].m_is_output)
+                {
+                    continue;
+                }
+                const bool is_read = std::any_of(pass.m_uses.begin(), pass.m_uses.end(), [&use](const ResourceUse& other) {
+                    return !other.m_is_write && other.m_resource == use.m_resource;
+                });
+                if (!is_read)
+                {
+                    is_needed[use.m_resource] = false;
+                }
+            }
+            for (const ResourceUse& use : pass.m_uses)
+            {
+                if (!use.m_is_write)
+                {
+                    is_needed[use.m_resource] = true;
+                }
+            }
+        }
+
+        for (size_t pass_index = 0; pass_index < m_passes.size(); ++pass_index)
+        {
+            if (!m_passes[pass_index].m_is_culled)
+            {
+                m_execution_order.push_back(static_cast<RenderGraphPass>(pass_index));
+            }
+        }
+    }
+
+    /*
+    * Passes run in declaration order, a pass can only read what an earlier pass wrote
+    */
+    bool RenderGraph::computeLifetimes()
+    {
+        for (uint32_t position = 0; position < m_execution_order.size(); ++position)
+        {
+            const PassNode& pass = m_passes[m_execution_order[position]];
+            for (const ResourceUse& use : pass.m_uses)
+            {
+                ResourceNode& resource = m_resources[use.m_resource];
+                if (resource.m_first_pass == k_invalid_render_graph_handle)
+                {
+                    const bool is_written = std::any_of(pass.m_uses.begin(), pass.m_uses.end(), [&use](const ResourceUse& other) {
+                        return other.m_is_write && other.m_resource == use.m_resource;
+                    });
+                    if (!resource.m_is_imported && !is_written)
+                    {
+                        LOG_ERROR("render graph pass {} reads {} before it is written", pass.m_name, resource.m_name);
+                        return false;
+                    }
+                    resource.m_first_pass = position;
+                }
+                resource.m_last_pass = position;
+            }
+        }
+        return true;
+    }
+
+    /*
+    * Largest resources are placed first, each at the lowest offset of a compatible heap where it
+    * does not overlap any resource alive at the same time; heaps grow when nothing fits. Images and
+    * buffers get separate heaps so linear and optimal tiling never share a granularity page
+    */
+    void RenderGraph::placeTransientResources(const MemoryRequirementsQuery& memory_query)
+    {
+        std::vector<RenderGraphResource> transient_resources;
+        for (uint32_t resource_index = 0; resource_index < m_resources.size(); ++resource_index)
+        {
+            ResourceNode& resource = m_resources[resource_index];
+            if (resource.m_is_imported || resource.m_first_pass == k_invalid_render_graph_handle)
+            {
+                continue;
+            }
+            resource.m_memory_requirements =
+                memory_query ? memory_query(resource_index) : estimateMemoryRequirements(*this, resource_index);
+            transient_resources.push_back(resource_index);
+        }
+
+        std::sort(transient_resources.begin(),
+                  transient_resources.end(),
+                  [this](RenderGraphResource lhs, RenderGraphResource rhs) {
+                      const ResourceNode& lhs_node = m_resources[lhs];
+                      const ResourceNode& rhs_node = m_resources[rhs];
+                      if (lhs_node.m_memory_requirements.m_size != rhs_node.m_memory_requirements.m_size)
+                      {
+                          return lhs_node.m_memory_requirements.m_size > rhs_node.m_memory_requirements.m_size;
+                      }
+                      return lhs < rhs;
+                  });
+
+        std::vector<std::vector<RenderGraphResource>> heap_residents;
+        std::vector<std::pair<VkDeviceSize, VkDeviceSize>> occupied_ranges;
+        for (RenderGraphResource resource_index : transient_resources)
+        {
+            ResourceNode&                        resource     = m_resources[resource_index];
+            const RenderGraphMemoryRequirements& requirements = resource.m_memory_requirements;
+
+            uint32_t heap_index = 0;
+            for (; heap_index < m_heaps.size(); ++heap_index)
+            {
+                if (m_heaps[heap_index].m_resource_type == resource.m_type &&
+                    (m_heaps[heap_index].m_memory_type_bits & requirements.m_memory_type_bits) != 0)
+                {
+                    break;
+                }
+            }
+            if (heap_index == m_heaps.size())
+            {
+                RenderGraphHeap heap;
+                heap.m_resource_type = resource.m_type;
+                m_heaps.push_back(heap);
+                heap_residents.emplace_back();
+            }
+
+            occupied_ranges.clear();
+            for (RenderGraphResource resident_index : heap_residents[heap_index])
+            {
+                const ResourceNode& resident = m_resources[resident_index];
+                if (isLifetimeOverlapping(
+                        resource.m_first_pass, resource.m_last_pass, resident.m_first_pass, resident.m_last_pass))
+                {
+                    occupied_ranges.emplace_back(resident.m_heap_offset,
+                                                 resident.m_heap_offset + resident.m_memory_requirements.m_size);
+                }
+            }
+            std::sort(occupied_ranges.begin(), occupied_ranges.end());
+
+            VkDeviceSize offset = 0;
+            for (const std::pair<VkDeviceSize, VkDeviceSize>& occupied_range : occupied_ranges)
+            {
+                if (alignUp(offset, requirements.m_alignment) + requirements.m_size <= occupied_range.first)
+                {
+                    break;
+                }
+                offset = std::max(offset, occupied_range.second);
+            }
+            offset = alignUp(offset, requirements.m_alignment);
+
+            RenderGraphHeap& heap = m_heaps[heap_index];
+            heap.m_size           = std::max(heap.m_size, offset + requirements.m_size);
+            heap.m_alignment      = std::max(heap.m_alignment, requirements.m_alignment);
+            heap.m_memory_type_bits &= requirements.m_memory_type_bits;
+
+            resource.m_heap        = heap_index;
+            resource.m_heap_offset = offset;
+            heap_residents[heap_index].push_back(resource_index);
+        }
+
+        // a resource reusing memory has to wait until the passes using the earlier occupants are done
+        for (const std::vector<RenderGraphResource>& residents : heap_residents)
+        {
+            for (RenderGraphResource resource_index : residents)
+            {
+                ResourceNode&      resource = m_resources[resource_index];
+                const VkDeviceSize end      = resource.m_heap_offset + resource.m_memory_requirements.m_size;
+                for (RenderGraphResource other_index : residents)
+                {
+                    const ResourceNode& other     = m_resources[other_index];
+                    const VkDeviceSize  other_end = other.m_heap_offset + other.m_memory_requirements.m_size;
+                    if (other.m_last_pass < resource.m_first_pass && other.m_heap_offset < end &&
+                        resource.m_heap_offset < other_end)
+                    {
+                        resource.m_aliased_predecessors.push_back(other_index);
+                    }
+                }
+            }
+        }
+    }
+
+    /*
+    * Replays the passes tracking per resource the last writer and the readers since, and emits a
+    * barrier only where a hazard or a layout change exists: reads after a write wait for the
+    * writer unless an earlier barrier already made the write visible to their stages, writes wait
+    * for the last writer and all readers since, where waiting for readers needs no memory dependency
+    */
+    void RenderGraph::computeBarriers()
+    {
+        struct PassUse
+        {
+            RenderGraphResource  m_resource {k_invalid_render_graph_handle};
+            VkPipelineStageFlags m_stages {0};
+            VkAccessFlags        m_read_access {0};
+            VkAccessFlags        m_write_access {0};
+            VkImageLayout        m_layout {VK_IMAGE_LAYOUT_UNDEFINED};
+        };
+
+        std::vector<ResourceState> states(m_resources.size());
+        for (size_t resource_index = 0; resource_index < m_resources.size(); ++resource_index)
+        {
+            const ResourceNode& resource = m_resources[resource_index];
+            if (resource.m_is_imported)
+            {
+                // whatever used the resource before the graph is treated as its last writer
+                states[resource_index].m_write_stages = resource.m_initial_stages;
+                states[resource_index].m_layout       = resource.m_initial_layout;
+            }
+        }
+
+        std::vector<PassUse> pass_uses;
+        for (uint32_t position = 0; position < m_execution_order.size(); ++position)
+        {
+            PassNode& pass = m_passes[m_execution_order[position]];
+
+            // several uses of one resource in a pass become one, conflicting layouts fall back to general
+            pass_uses.clear();
+            for (const ResourceUse& use : pass.m_uses)
+            {
+                const RenderGraphAccessInfo& access_info = getAccessInfo(use.m_access);
+
+                auto pass_use = std::find_if(pass_uses.begin(), pass_uses.end(), [&use](const PassUse& other) {
+                    return other.m_resource == use.m_resource;
+                });
+                if (pass_use == pass_uses.end())
+                {
+                    PassUse new_use;
+                    new_use.m_resource = use.m_resource;
+                    new_use.m_layout   = access_info.m_layout;
+                    pass_uses.push_back(new_use);
+                    pass_use = pass_uses.end() - 1;
+                }
+                else if (pass_use->m_layout != access_info.m_layout)
+                {
+                    pass_use->m_layout = VK_IMAGE_LAYOUT_GENERAL;
+                }
+                pass_use->m_stages |= access_info.m_stages;
+                if (use.m_is_write)
+                {
+                    pass_use->m_write_access |= access_info.m_write_access;
+                    // read-modify-write accesses like attachment loads come with the write
+                    pass_use->m_read_access |= access_info.m_read_access;
+                }
+                else
+                {
+                    pass_use->m_read_access |= access_info.m_read_access;
+                }
+            }
+
+            for (const PassUse& use : pass_uses)
+            {
+                const ResourceNode& resource = m_resources[use.m_resource];
+                ResourceState&      state    = states[use.m_resource];
+                const bool          is_image = resource.m_type == RenderGraphResourceType::image;
+
+                if (!resource.m_is_imported && resource.m_first_pass == position)
+                {
+                    // earlier occupants of the memory count as previous writers, the content is discarded
+                    for (RenderGraphResource predecessor : resource.m_aliased_predecessors)
+                    {
+                        const ResourceState& predecessor_state = states[predecessor];
+                        state.m_write_stages |= predecessor_state.m_write_stages | predecessor_state.m_read_stages;
+                        state.m_write_access |= predecessor_state.m_write_access;
+                    }
+                }
+
+                const bool is_layout_change = is_image && state.m_layout != use.m_layout;
+                const bool is_write         = use.m_write_access != 0;
+
+                RenderGraphBarrier barrier;
+                barrier.m_resource   = use.m_resource;
+                barrier.m_dst_stages = use.m_stages;
+                barrier.m_dst_access = use.m_read_access | use.m_write_access;
+                barrier.m_old_layout = state.m_layout;
+                barrier.m_new_layout = is_image ? use.m_layout : VK_IMAGE_LAYOUT_UNDEFINED;
+
+                if (is_write || is_layout_change)
+                {
+                    barrier.m_src_stages = state.m_write_stages | state.m_read_stages;
+                    barrier.m_src_access = state.m_write_access;
+                    if (barrier.m_src_stages != 0 || is_layout_change)
+                    {
+                        if (barrier.m_src_stages == 0)
+                        {
+                            barrier.m_src_stages = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+                        }
+                        pass.m_barriers.push_back(barrier);
+                    }
+
+                    // a layout transition counts as a write the barrier already made visible to this pass
+                    state.m_write_stages   = use.m_stages;
+                    state.m_write_access   = use.m_write_access;
+                    state.m_visible_stages = is_write ? 0 : use.m_stages;
+                    state.m_visible_access = is_write ? 0 : use.m_read_access;
+                    state.m_read_stages    = is_write ? 0 : use.m_stages;
+                    state.m_layout         = barrier.m_new_layout;
+                    continue;
+                }
+
+                const bool is_visible = (use.m_stages & ~state.m_visible_stages) == 0 &&
+                                        (use.m_read_access & ~state.m_visible_access) == 0;
+                if (state.m_write_stages != 0 && !is_visible)
+                {
+                    barrier.m_src_stages = state.m_write_stages;
+                    barrier.m_src_access = state.m_write_access;
+                    pass.m_barriers.push_back(barrier);
+
+                    state.m_visible_stages |= use.m_stages;
+                    state.m_visible_access |= use.m_read_access;
+                }
+                state.m_read_stages |= use.m_stages;
+            }
+        }
+
+        for (size_t resource_index = 0; resource_index < m_resources.size(); ++resource_index)
+        {
+            const ResourceNode&  resource = m_resources[resource_index];
+            const ResourceState& state    = states[resource_index];
+            if (!resource.m_is_imported || resource.m_type != RenderGraphResourceType::image ||
+                resource.m_final_layout == VK_IMAGE_LAYOUT_UNDEFINED || resource.m_final_layout == state.m_layout)
+            {
+                continue;
+            }
+
+            RenderGraphBarrier barrier;
+            barrier.m_resource   = static_cast<RenderGraphResource>(resource_index);
+            barrier.m_src_stages = state.m_write_stages | state.m_read_stages;
+            barrier.m_src_access = state.m_write_access;
+            barrier.m_dst_stages = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+            barrier.m_dst_access = 0;
+            barrier.m_old_layout = state.m_layout;
+            barrier.m_new_layout = resource.m_final_layout;
+            if (barrier.m_src_stages == 0)
+            {
+                barrier.m_src_stages = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+            }
+            m_final_barriers.push_back(barrier);
+        }
+    }
+
+    VkDeviceSize RenderGraph::getHeapMemorySize() const
+    {
+        VkDeviceSize size = 0;
+        for (const RenderGraphHeap& heap : m_heaps)
+        {
+            size += heap.m_size;
+        }
+        return size;
+    }
+
+    VkDeviceSize RenderGraph::getUnaliasedMemorySize() const
+    {
+        VkDeviceSize size = 0;
+        for (const ResourceNode& resource : m_resources)
+        {
+            if (resource.m_heap != k_invalid_render_graph_handle)
+            {
+                size += alignUp(resource.m_memory_requirements.m_size, resource.m_memory_requirements.m_alignment);
+            }
+        }
+        return size;
+    }
+
+    RenderGraphMemoryRequirements RenderGraph::estimateMemoryRequirements(const RenderGraph& graph, RenderGraphResource resource)
+    {
+        RenderGraphMemoryRequirements requirements;
+        if (graph.getResourceType(resource) == RenderGraphResourceType::buffer)
+        {
+            requirements.m_size      = alignUp(graph.getBufferDesc(resource).m_size, k_estimated_buffer_alignment);
+            requirements.m_alignment = k_estimated_buffer_alignment;
+            return requirements;
+        }
+
+        const RenderGraphImageDesc& desc       = graph.getImageDesc(resource);
+        VkDeviceSize                level_size = static_cast<VkDeviceSize>(desc.m_width) * desc.m_height *
+                                  getFormatTexelSize(desc.m_format) * desc.m_samples * desc.m_array_layers;
+        VkDeviceSize size = 0;
+        for (uint32_t mip_level = 0; mip_level < desc.m_mip_levels; ++mip_level)
+        {
+            size += level_size;
+            level_size = std::max<VkDeviceSize>(level_size / 4, 1);
+        }
+        requirements.m_size      = alignUp(size, k_estimated_image_alignment);
+        requirements.m_alignment = k_estimated_image_alignment;
+        return requirements;
+    }
+} // namespace Polaris
@@ -0,0 +1,259 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace Polaris
+{
+    class RenderGraphPassContext;
+
+    using RenderGraphResource = uint32_t;
+    using RenderGraphPass     = uint32_t;
+
+    constexpr uint32_t k_invalid_render_graph_handle = std::numeric_limits<uint32_t>::max();
+
+    // how a pass uses a resource, each maps to fixed stages, access masks, image layout and usage flags
+    enum class RenderGraphAccess : uint8_t
+    {
+        color_attachment,
+        depth_stencil_attachment,
+        depth_stencil_read,
+        sampled,
+        storage,
+        uniform_buffer,
+        vertex_buffer,
+        index_buffer,
+        indirect_buffer,
+        transfer_source,
+        transfer_destination
+    };
+
+    struct RenderGraphAccessInfo
+    {
+        VkPipelineStageFlags m_stages {0};
+        VkAccessFlags        m_read_access {0};
+        VkAccessFlags        m_write_access {0};
+        VkImageLayout        m_layout {VK_IMAGE_LAYOUT_UNDEFINED};
+        VkImageUsageFlags    m_image_usage {0};
+        VkBufferUsageFlags   m_buffer_usage {0};
+    };
+
+    enum class RenderGraphResourceType : uint8_t
+    {
+        image,
+        buffer
+    };
+
+    struct RenderGraphImageDesc
+    {
+        uint32_t              m_width {0};
+        uint32_t              m_height {0};
+        VkFormat              m_format {VK_FORMAT_UNDEFINED};
+        uint32_t              m_mip_levels {1};
+        uint32_t              m_array_layers {1};
+        VkSampleCountFlagBits m_samples {VK_SAMPLE_COUNT_1_BIT};
+    };
+
+    struct RenderGraphBufferDesc
+    {
+        VkDeviceSize m_size {0};
+    };
+
+    struct RenderGraphMemoryRequirements
+    {
+        VkDeviceSize m_size {0};
+        VkDeviceSize m_alignment {1};
+        uint32_t     m_memory_type_bits {~0u};
+    };
+
+    // one image or buffer memory barrier, recorded before the pass it belongs to
+    struct RenderGraphBarrier
+    {
+        RenderGraphResource  m_resource {k_invalid_render_graph_handle};
+        VkPipelineStageFlags m_src_stages {0};
+        VkPipelineStageFlags m_dst_stages {0};
+        VkAccessFlags        m_src_access {0};
+        VkAccessFlags        m_dst_access {0};
+        VkImageLayout        m_old_layout {VK_IMAGE_LAYOUT_UNDEFINED};
+        VkImageLayout        m_new_layout {VK_IMAGE_LAYOUT_UNDEFINED};
+    };
+
+    // block of device memory shared by transient resources whose lifetimes do not overlap
+    struct RenderGraphHeap
+    {
+        RenderGraphResourceType m_resource_type {RenderGraphResourceType::image};
+        VkDeviceSize            m_size {0};
+        VkDeviceSize            m_alignment {1};
+        uint32_t                m_memory_type_bits {~0u};
+    };
+
+    /**
+     *  Frame graph rebuilt every frame. Passes declare which virtual resources they read and write and
+     *  how; compile() then drops passes whose results nobody consumes, derives the barriers and layout
+     *  transitions between the remaining passes, and places transient resources into shared heaps so
+     *  resources that are never alive at the same time use the same memory. Compilation only looks at
+     *  the declarations and can run without a device; VulkanRenderGraphExecutor creates the resources
+     *  and records the passes
+     */
+    class RenderGraph
+    {
+    public:
+        using ExecuteCallback         = std::function<void(RenderGraphPassContext&)>;
+        using MemoryRequirementsQuery = std::function<RenderGraphMemoryRequirements(RenderGraphResource)>;
+
+        static const RenderGraphAccessInfo& getAccessInfo(RenderGraphAccess access);
+
+        // transient resources live from their first to their last use within the frame
+        RenderGraphResource createImage(const std::string& name, const RenderGraphImageDesc& desc);
+        RenderGraphResource createBuffer(const std::string& name, const RenderGraphBufferDesc& desc);
+
+        /**
+         *  External resources, like the swapchain image. initial_stages are the stages of the last
+         *  use before the graph, final_layout the layout the image is left in. Imported resources
+         *  are outputs, passes writing them are never culled
+         */
+        RenderGraphResource importImage(const std::string&          name,
+                                        const RenderGraphImageDesc& desc,
+                                        VkImage                     image,
+                                        VkImageView                 image_view,
+                                        VkImageLayout               initial_layout,
+                                        VkImageLayout               final_layout,
+                                        VkPipelineStageFlags        initial_stages = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+        RenderGraphResource importBuffer(const std::string&           name,
+                                         const RenderGraphBufferDesc& desc,
+                                         VkBuffer                     buffer,
+                                         VkPipelineStageFlags         initial_stages = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+
+        RenderGraphPass addPass(const std::string& name, ExecuteCallback execute_callback);
+        // a pass reading and writing the same resource, like an attachment that is loaded, declares both
+        void read(RenderGraphPass pass, RenderGraphResource resource, RenderGraphAccess access);
+        void write(RenderGraphPass pass, RenderGraphResource resource, RenderGraphAccess access);
+        // the pass does work outside the graph, like a readback, and is never culled
+        void setSideEffect(RenderGraphPass pass);
+        // keeps the writers of a transient resource alive without any pass reading it
+        void markOutput(RenderGraphResource resource);
+
+        /**
+         *  Culls, orders and synchronizes the passes. The memory query returns the requirements of
+         *  a transient resource; without one they are estimated from the descriptions. Returns false
+         *  when a pass reads a transient resource no earlier pass has written
+         */
+        bool compile(const MemoryRequirementsQuery& memory_query = {});
+        void reset();
+
+        // compile results
+        const std::vector<RenderGraphPass>&    getExecutionOrder() const { return m_execution_order; }
+        bool                                   isPassCulled(RenderGraphPass pass) const { return m_passes[pass].m_is_culled; }
+        const std::vector<RenderGraphBarrier>& getPassBarriers(RenderGraphPass pass) const { return m_passes[pass].m_barriers; }
+        // transitions of imported resources to their final layout after the last pass
+        const std::vector<RenderGraphBarrier>& getFinalBarriers() const { return m_final_barriers; }
+        const std::vector<RenderGraphHeap>&    getHeaps() const { return m_heaps; }
+        VkDeviceSize                           getHeapMemorySize() const;
+        // memory the transient resources would take without aliasing
+        VkDeviceSize getUnaliasedMemorySize() const;
+
+        // resource and pass declarations
+        uint32_t                     getPassCount() const { return static_cast<uint32_t>(m_passes.size()); }
+        const std::string&           getPassName(RenderGraphPass pass) const { return m_passes[pass].m_name; }
+        const ExecuteCallback&       getPassCallback(RenderGraphPass pass) const { return m_passes[pass].m_execute_callback; }
+        uint32_t                     getResourceCount() const { return static_cast<uint32_t>(m_resources.size()); }
+        const std::string&           getResourceName(RenderGraphResource resource) const { return m_resources[resource].m_name; }
+        RenderGraphResourceType      getResourceType(RenderGraphResource resource) const { return m_resources[resource].m_type; }
+        const RenderGraphImageDesc&  getImageDesc(RenderGraphResource resource) const { return m_resources[resource].m_image_desc; }
+        const RenderGraphBufferDesc& getBufferDesc(RenderGraphResource resource) const { return m_resources[resource].m_buffer_desc; }
+        bool                         isImported(RenderGraphResource resource) const { return m_resources[resource].m_is_imported; }
+        VkImage                      getImportedImage(RenderGraphResource resource) const { return m_resources[resource].m_imported_image; }
+        VkImageView                  getImportedImageView(RenderGraphResource resource) const { return m_resources[resource].m_imported_image_view; }
+        VkBuffer                     getImportedBuffer(RenderGraphResource resource) const { return m_resources[resource].m_imported_buffer; }
+        // usage flags collected from every declared access, for creating the transient resources
+        VkImageUsageFlags  getImageUsage(RenderGraphResource resource) const { return m_resources[resource].m_image_usage; }
+        VkBufferUsageFlags getBufferUsage(RenderGraphResource resource) const { return m_resources[resource].m_buffer_usage; }
+        // false for transient resources no surviving pass uses
+        bool isResourceUsed(RenderGraphResource resource) const { return m_resources[resource].m_first_pass != k_invalid_render_graph_handle; }
+        // heap and byte offset of a used transient resource
+        uint32_t     getResourceHeap(RenderGraphResource resource) const { return m_resources[resource].m_heap; }
+        VkDeviceSize getResourceOffset(RenderGraphResource resource) const { return m_resources[resource].m_heap_offset; }
+
+        static RenderGraphMemoryRequirements estimateMemoryRequirements(const RenderGraph& graph, RenderGraphResource resource);
+
+    private:
+        struct ResourceUse
+        {
+            RenderGraphResource m_resource {k_invalid_render_graph_handle};
+            RenderGraphAccess   m_access {RenderGraphAccess::sampled};
+            bool                m_is_write {false};
+        };
+
+        struct PassNode
+        {
+            std::string              m_name;
+            ExecuteCallback          m_execute_callback;
+            std::vector<ResourceUse> m_uses;
+            bool                     m_has_side_effect {false};
+            bool                     m_is_culled {false};
+
+            std::vector<RenderGraphBarrier> m_barriers;
+        };
+
+        struct ResourceNode
+        {
+            std::string             m_name;
+            RenderGraphResourceType m_type {RenderGraphResourceType::image};
+            RenderGraphImageDesc    m_image_desc;
+            RenderGraphBufferDesc   m_buffer_desc;
+            bool                    m_is_imported {false};
+            bool                    m_is_output {false};
+
+            VkImage              m_imported_image {VK_NULL_HANDLE};
+            VkImageView          m_imported_image_view {VK_NULL_HANDLE};
+            VkBuffer             m_imported_buffer {VK_NULL_HANDLE};
+            VkImageLayout        m_initial_layout {VK_IMAGE_LAYOUT_UNDEFINED};
+            VkImageLayout        m_final_layout {VK_IMAGE_LAYOUT_UNDEFINED};
+            VkPipelineStageFlags m_initial_stages {VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT};
+
+            VkImageUsageFlags  m_image_usage {0};
+            VkBufferUsageFlags m_buffer_usage {0};
+
+            // positions in the execution order, filled by compile
+            uint32_t                         m_first_pass {k_invalid_render_graph_handle};
+            uint32_t                         m_last_pass {k_invalid_render_graph_handle};
+            RenderGraphMemoryRequirements    m_memory_requirements;
+            uint32_t                         m_heap {k_invalid_render_graph_handle};
+            VkDeviceSize                     m_heap_offset {0};
+            // resources placed in overlapping memory whose lifetimes ended before this one starts
+            std::vector<RenderGraphResource> m_aliased_predecessors;
+        };
+
+        // state of a resource after its last use, what the next barrier has to wait for
+        struct ResourceState
+        {
+            VkPipelineStageFlags m_write_stages {0};
+            VkAccessFlags        m_write_access {0};
+            VkImageLayout        m_layout {VK_IMAGE_LAYOUT_UNDEFINED};
+            // stages and accesses a barrier already made the last write visible to
+            VkPipelineStageFlags m_visible_stages {0};
+            VkAccessFlags        m_visible_access {0};
+            // stages that read since the last write, a later write waits for them
+            VkPipelineStageFlags m_read_stages {0};
+        };
+
+        RenderGraphResource addResource(ResourceNode&& resource);
+
+        void cullPasses();
+        bool computeLifetimes();
+        void placeTransientResources(const MemoryRequirementsQuery& memory_query);
+        void computeBarriers();
+
+        std::vector<PassNode>     m_passes;
+        std::vector<ResourceNode> m_resources;
+
+        std::vector<RenderGraphPass>    m_execution_order;
+        std::vector<RenderGraphBarrier> m_final_barriers;
+        std::vector<RenderGraphHeap>    m_heaps;
+    };
+} // namespace Polaris
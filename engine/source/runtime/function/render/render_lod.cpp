@@ -0,0 +1,144 @@
+#include "runtime/function/render/render_lod.h"
+
+#include "runtime/core/math/matrix4.h"
+#include "runtime/core/profiler/profiler.h"
+
+#include "runtime/function/render/render_scene.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Polaris
+{
+    namespace
+    {
+        // the current lod is kept until its error is this much above the threshold, and a coarser
+        // one is only taken once its error is this much below
+        constexpr float k_lod_hysteresis = 0.2f;
+        // frames a lod change is faded over
+        constexpr float k_lod_fade_frame_count = 8.f;
+        // the threshold is doubled at most this many times to meet the triangle budget
+        constexpr uint32_t k_max_budget_pass_count = 6;
+        // closer distances are clamped, so the camera inside the bounds picks lod 0 without dividing by zero
+        constexpr float k_min_lod_distance = 1e-3f;
+
+        float getMaxAxisScale(const Matrix4x4& matrix)
+        {
+            Vector3 axis_x, axis_y, axis_z;
+            matrix.extractAxes(axis_x, axis_y, axis_z);
+            return std::sqrt(std::max({axis_x.squaredLength(), axis_y.squaredLength(), axis_z.squaredLength()}));
+        }
+    } // namespace
+
+    void LodSelection::select(RenderScene&                 scene,
+                              const std::vector<uint32_t>& visible_entities,
+                              const Vector3&               camera_position,
+                              float                        projection_scale)
+    {
+        PROFILE_SCOPE("LodSelection::select");
+
+        ++m_frame_index;
+
+        const std::vector<Matrix4x4>& model_matrices = scene.getModelMatrices();
+        const RenderEntityBounds&     world_bounds   = scene.getWorldBounds();
+
+        m_pixel_scales.resize(visible_entities.size());
+        for (size_t visible_index = 0; visible_index < visible_entities.size(); ++visible_index)
+        {
+            const uint32_t entity_index = visible_entities[visible_index];
+
+            // distance to the nearest point of the bounding sphere
+            const Vector3 center(world_bounds.m_center_x[entity_index],
+                                 world_bounds.m_center_y[entity_index],
+                                 world_bounds.m_center_z[entity_index]);
+            const Vector3 half_extent(world_bounds.m_half_extent_x[entity_index],
+                                      world_bounds.m_half_extent_y[entity_index],
+                                      world_bounds.m_half_extent_z[entity_index]);
+            const float   distance =
+                std::max(k_min_lod_distance, (center - camera_position).length() - half_extent.length());
+
+            m_pixel_scales[visible_index] = getMaxAxisScale(model_matrices[entity_index]) * projection_scale / distance;
+        }
+
+        float    max_screen_error = m_settings.m_max_screen_error;
+        uint32_t triangle_count   = pickLods(scene, visible_entities, max_screen_error);
+        for (uint32_t pass = 0; pass < k_max_budget_pass_count && m_settings.m_triangle_budget != 0 &&
+                                triangle_count > m_settings.m_triangle_budget;
+             ++pass)
+        {
+            max_screen_error *= 2.f;
+            triangle_count = pickLods(scene, visible_entities, max_screen_error);
+        }
+        m_selected_triangle_count = triangle_count;
+        m_screen_error_scale      = max_screen_error / m_settings.m_max_screen_error;
+
+        std::vector<RenderEntityLodState>& lod_states = scene.getLodStates();
+        for (size_t visible_index = 0; visible_index < visible_entities.size(); ++visible_index)
+        {
+            RenderEntityLodState& lod_state = lod_states[visible_entities[visible_index]];
+            const uint8_t         lod       = m_picked_lods[visible_index];
+
+            // nothing of the entity is on screen to fade from
+            if (lod_state.m_last_selected_frame == 0 || lod_state.m_last_selected_frame + 1 != m_frame_index)
+            {
+                lod_state.m_lod          = lod;
+                lod_state.m_previous_lod = lod;
+                lod_state.m_fade         = 1.f;
+            }
+            else
+            {
+                lod_state.m_fade = std::min(1.f, lod_state.m_fade + 1.f / k_lod_fade_frame_count);
+                // a running fade is finished before the next change
+                if (lod != lod_state.m_lod && lod_state.m_fade >= 1.f)
+                {
+                    lod_state.m_previous_lod = lod_state.m_lod;
+                    lod_state.m_lod          = lod;
+                    lod_state.m_fade         = 0.f;
+                }
+            }
+            lod_state.m_last_selected_frame = m_frame_index;
+        }
+    }
+
+    uint32_t LodSelection::pickLods(const RenderScene&           scene,
+                                    const std::vector<uint32_t>& visible_entities,
+                                    float                        max_screen_error)
+    {
+        const std::vector<RenderEntity>&         entities   = scene.getEntities();
+        const std::vector<RenderEntityLodState>& lod_states = scene.getLodStates();
+
+        m_picked_lods.resize(visible_entities.size());
+
+        uint32_t triangle_count = 0;
+        for (size_t visible_index = 0; visible_index < visible_entities.size(); ++visible_index)
+        {
+            const uint32_t          entity_index = visible_entities[visible_index];
+            const RenderEntityLods& lods         = entities[entity_index].m_lods;
+            const uint32_t          current_lod  = lod_states[entity_index].m_lod;
+
+            uint32_t lod = 0;
+            for (uint32_t candidate = lods.m_count - 1; candidate > 0; --candidate)
+            {
+                float limit = max_screen_error;
+                if (candidate > current_lod)
+                {
+                    limit *= 1.f - k_lod_hysteresis;
+                }
+                else if (candidate == current_lod)
+                {
+                    limit *= 1.f + k_lod_hysteresis;
+                }
+
+                if (lods.m_geometric_errors[candidate] * m_pixel_scales[visible_index] <= limit)
+                {
+                    lod = candidate;
+                    break;
+                }
+            }
+
+            m_picked_lods[visible_index] = static_cast<uint8_t>(lod);
+            triangle_count += lods.m_triangle_counts[lod];
+        }
+        return triangle_count;
+    }
+} // namespace Polaris
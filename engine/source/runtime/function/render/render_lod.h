@@ -0,0 +1,62 @@
+#pragma once
+
+#include "runtime/core/math/vector3.h"
+
+#include "runtime/function/render/render_entity.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Polaris
+{
+    class RenderScene;
+
+    struct LodSelectionSettings
+    {
+        // largest projected error in pixels a lod may have to be picked
+        float m_max_screen_error {1.f};
+        // triangles of the selected lods in one view, 0 for no limit
+        uint32_t m_triangle_budget {0};
+    };
+
+    /**
+     *  Picks the coarsest lod of every visible entity whose geometric error, projected at the distance
+     *  of the entity bounds, stays below a pixel threshold. The threshold is widened a little for the
+     *  current lod so entities near the switching distance do not flicker, and doubled until the
+     *  selection fits the triangle budget. A change of lod starts a fade from the previous one that
+     *  lasts a few frames, entities that were not visible last frame switch at once
+     */
+    class LodSelection
+    {
+    public:
+        void                        setSettings(const LodSelectionSettings& settings) { m_settings = settings; }
+        const LodSelectionSettings& getSettings() const { return m_settings; }
+
+        /**
+         *  Updates the lod states of the visible entities in the scene. projection_scale is the
+         *  viewport height divided by 2 * tan(fov_y / 2), the pixels covered by one unit at distance one
+         */
+        void select(RenderScene&                 scene,
+                    const std::vector<uint32_t>& visible_entities,
+                    const Vector3&               camera_position,
+                    float                        projection_scale);
+
+        // triangles of the lods picked by the last select
+        uint32_t getSelectedTriangleCount() const { return m_selected_triangle_count; }
+        // factor the error threshold had to be raised by to meet the budget, 1 when it was not needed
+        float getScreenErrorScale() const { return m_screen_error_scale; }
+
+    private:
+        uint32_t pickLods(const RenderScene& scene, const std::vector<uint32_t>& visible_entities, float max_screen_error);
+
+        LodSelectionSettings m_settings;
+
+        // pixels of projected error per mesh space unit, one per visible entity
+        std::vector<float>   m_pixel_scales;
+        std::vector<uint8_t> m_picked_lods;
+
+        uint64_t m_frame_index {0};
+        uint32_t m_selected_triangle_count {0};
+        float    m_screen_error_scale {1.f};
+    };
+} // namespace Polaris
@@ -1,8 +1,11 @@
 #pragma once
 
 #include "runtime/core/math/matrix4.h"
+#include "runtime/core/math/transform.h"
 #include "runtime/function/framework/object/object_id_allocator.h"
 
+#include <cstdint>
+#include <limits>
 #include <string>
 #include <vector>
 
@@ -15,6 +18,14 @@ namespace Polaris
         std::string m_mesh_file;
     };
 
+    REFLECTION_TYPE(GameObjectMeshLodDesc)
+    STRUCT(GameObjectMeshLodDesc, Fields)
+    {
+        REFLECTION_BODY(GameObjectMeshLodDesc)
+        GameObjectMeshDesc m_mesh_desc;
+        float              m_geometric_error {0.f};
+    };
+
     REFLECTION_TYPE(SkeletonBindingDesc)
     STRUCT(SkeletonBindingDesc, Fields)
     {
@@ -59,12 +70,15 @@ namespace Polaris
     STRUCT(GameObjectPartDesc, Fields)
     {
         REFLECTION_BODY(GameObjectPartDesc)
-        GameObjectMeshDesc      m_mesh_desc;
-        GameObjectMaterialDesc  m_material_desc;
-        GameObjectTransformDesc m_transform_desc;
-        bool                    m_with_animation {false};
-        SkeletonBindingDesc     m_skeleton_binding_desc;
-        SkeletonAnimationResult m_skeleton_animation_result;
+        GameObjectMeshDesc m_mesh_desc;
+        // coarser versions of m_mesh_desc, from fine to coarse
+        std::vector<GameObjectMeshLodDesc> m_mesh_lods;
+        GameObjectMaterialDesc             m_material_desc;
+        GameObjectTransformDesc            m_transform_desc;
+        bool                               m_with_animation {false};
+        bool                               m_is_occluder {false};
+        SkeletonBindingDesc                m_skeleton_binding_desc;
+        SkeletonAnimationResult            m_skeleton_animation_result;
     };
 
     constexpr size_t k_invalid_part_id = std::numeric_limits<size_t>::max();
@@ -75,10 +89,32 @@ namespace Polaris
         size_t    m_part_id {k_invalid_part_id};
 
         bool   operator==(const GameObjectPartId& rhs) const { return m_go_id == rhs.m_go_id && m_part_id == rhs.m_part_id; }
-        size_t getHashValue() const { return m_go_id ^ (m_part_id << 1); }
+        size_t getHashValue() const
+        {
+            // the ids are small sequential integers, mix them so neighbouring parts spread over the buckets
+            uint64_t hash = static_cast<uint64_t>(m_go_id) * 0x9e3779b97f4a7c15ull + static_cast<uint64_t>(m_part_id);
+            hash ^= hash >> 30;
+            hash *= 0xbf58476d1ce4e5b9ull;
+            hash ^= hash >> 27;
+            hash *= 0x94d049bb133111ebull;
+            hash ^= hash >> 31;
+            return static_cast<size_t>(hash);
+        }
         bool   isValid() const { return m_go_id != k_invalid_gobject_id && m_part_id != k_invalid_part_id; }
     };
 
+    /**
+     *  Per frame update of a game object already known to the render scene, the transforms at the
+     *  end of the previous and the current logic tick. The render side blends them with the
+     *  interpolation alpha of each frame until the next update arrives
+     */
+    struct GameObjectTransformDelta
+    {
+        GObjectID m_go_id {k_invalid_gobject_id};
+        Transform m_previous_transform;
+        Transform m_current_transform;
+    };
+
     class GameObjectDesc
     {
     public:
@@ -86,6 +122,9 @@ namespace Polaris
         GameObjectDesc(size_t go_id, const std::vector<GameObjectPartDesc>& parts) :
             m_go_id(go_id), m_object_parts(parts)
         {}
+        GameObjectDesc(size_t go_id, std::vector<GameObjectPartDesc>&& parts) :
+            m_go_id(go_id), m_object_parts(std::move(parts))
+        {}
 
         GObjectID                              getId() const { return m_go_id; }
         const std::vector<GameObjectPartDesc>& getObjectParts() const { return m_object_parts; }
@@ -0,0 +1,101 @@
+#include "runtime/function/render/render_resource.h"
+
+#include "runtime/core/base/macro.h"
+
+#include "runtime/function/render/mesh_bounds_cache.h"
+
+#include <tiny_obj_loader.h>
+
+namespace Polaris
+{
+    MeshHandle RenderResource::getOrCreateMeshHandle(const GameObjectMeshDesc& mesh_desc)
+    {
+        auto found = m_mesh_handles.find(mesh_desc.m_mesh_file);
+        if (found != m_mesh_handles.end())
+        {
+            return found->second;
+        }
+
+        const MeshHandle handle = static_cast<MeshHandle>(m_mesh_files.size());
+        m_mesh_files.push_back(mesh_desc.m_mesh_file);
+        m_mesh_bounds.push_back(MeshBoundsCache::getInstance().getBounds(mesh_desc.m_mesh_file));
+        m_mesh_triangle_counts.push_back(MeshBoundsCache::getInstance().getTriangleCount(mesh_desc.m_mesh_file));
+        m_occluder_meshes.emplace_back();
+        m_mesh_handles.emplace(mesh_desc.m_mesh_file, handle);
+        return handle;
+    }
+
+    MaterialHandle RenderResource::getOrCreateMaterialHandle(const GameObjectMaterialDesc& material_desc)
+    {
+        std::string key;
+        if (material_desc.m_with_texture)
+        {
+            key = material_desc.m_base_color_texture_file + '|' + material_desc.m_metallic_roughness_texture_file + '|' +
+                  material_desc.m_normal_texture_file + '|' + material_desc.m_occlusion_texture_file + '|' +
+                  material_desc.m_emissive_texture_file;
+        }
+
+        auto found = m_material_handles.find(key);
+        if (found != m_material_handles.end())
+        {
+            return found->second;
+        }
+
+        const MaterialHandle handle = static_cast<MaterialHandle>(m_material_descs.size());
+        m_material_descs.push_back(material_desc);
+        m_material_handles.emplace(std::move(key), handle);
+        return handle;
+    }
+
+    void RenderResource::loadOccluderMesh(MeshHandle handle)
+    {
+        if (m_occluder_meshes[handle])
+        {
+            return;
+        }
+
+        // an empty mesh is kept on failure, so a broken file is not read again
+        std::unique_ptr<OccluderMesh> occluder_mesh = std::make_unique<OccluderMesh>();
+
+        tinyobj::attrib_t                attrib;
+        std::vector<tinyobj::shape_t>    shapes;
+        std::vector<tinyobj::material_t> materials;
+        std::string                      warning;
+        std::string                      error;
+        if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warning, &error, m_mesh_files[handle].c_str()))
+        {
+            LOG_WARN("load occluder mesh {} failed: {}", m_mesh_files[handle], error);
+        }
+        else
+        {
+            occluder_mesh->m_positions.reserve(attrib.vertices.size() / 3);
+            for (size_t index = 0; index + 2 < attrib.vertices.size(); index += 3)
+            {
+                occluder_mesh->m_positions.emplace_back(
+                    attrib.vertices[index], attrib.vertices[index + 1], attrib.vertices[index + 2]);
+            }
+
+            // faces are triangulated by the loader
+            for (const tinyobj::shape_t& shape : shapes)
+            {
+                for (const tinyobj::index_t& index : shape.mesh.indices)
+                {
+                    occluder_mesh->m_indices.push_back(static_cast<uint32_t>(index.vertex_index));
+                }
+            }
+        }
+
+        m_occluder_meshes[handle] = std::move(occluder_mesh);
+    }
+
+    void RenderResource::clear()
+    {
+        m_mesh_handles.clear();
+        m_mesh_files.clear();
+        m_mesh_bounds.clear();
+        m_mesh_triangle_counts.clear();
+        m_occluder_meshes.clear();
+        m_material_handles.clear();
+        m_material_descs.clear();
+    }
+} // namespace Polaris
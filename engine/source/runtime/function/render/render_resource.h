@@ -0,0 +1,49 @@
+#pragma once
+
+#include "runtime/core/math/axis_aligned.h"
+
+#include "runtime/function/render/occlusion_culling.h"
+#include "runtime/function/render/render_entity.h"
+#include "runtime/function/render/render_object.h"
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Polaris
+{
+    /**
+     *  Turns mesh and material descriptions into small handles the first time they are seen, so the
+     *  render scene never stores or compares file paths. Handles stay valid for the lifetime of the
+     *  registry. Render thread only
+     */
+    class RenderResource
+    {
+    public:
+        MeshHandle     getOrCreateMeshHandle(const GameObjectMeshDesc& mesh_desc);
+        MaterialHandle getOrCreateMaterialHandle(const GameObjectMaterialDesc& material_desc);
+
+        const std::string&            getMeshFile(MeshHandle handle) const { return m_mesh_files[handle]; }
+        const AxisAlignedBox&         getMeshBounds(MeshHandle handle) const { return m_mesh_bounds[handle]; }
+        uint32_t                      getMeshTriangleCount(MeshHandle handle) const { return m_mesh_triangle_counts[handle]; }
+        const GameObjectMaterialDesc& getMaterialDesc(MaterialHandle handle) const { return m_material_descs[handle]; }
+
+        // reads the triangles of the mesh once, later calls are no-ops
+        void loadOccluderMesh(MeshHandle handle);
+        // nullptr when the mesh was never loaded as occluder
+        const OccluderMesh* getOccluderMesh(MeshHandle handle) const { return m_occluder_meshes[handle].get(); }
+
+        void clear();
+
+    private:
+        std::unordered_map<std::string, MeshHandle> m_mesh_handles;
+        std::vector<std::string>                    m_mesh_files;
+        std::vector<AxisAlignedBox>                 m_mesh_bounds;
+        std::vector<uint32_t>                       m_mesh_triangle_counts;
+        std::vector<std::unique_ptr<OccluderMesh>>  m_occluder_meshes;
+
+        std::unordered_map<std::string, MaterialHandle> m_material_handles;
+        std::vector<GameObjectMaterialDesc>             m_material_descs;
+    };
+} // namespace Polaris
@@ -0,0 +1,199 @@
+#include "runtime/function/render/render_scene.h"
+
+#include "runtime/function/render/render_resource.h"
+
+#include <algorithm>
+
+namespace Polaris
+{
+    void RenderScene::addObject(const GameObjectDesc& desc, RenderResource& resource)
+    {
+        removeObject(desc.getId());
+
+        const std::vector<GameObjectPartDesc>& parts = desc.getObjectParts();
+
+        RenderObjectRecord& record = m_objects[desc.getId()];
+        record.m_part_count        = static_cast<uint32_t>(parts.size());
+
+        for (size_t part_index = 0; part_index < parts.size(); ++part_index)
+        {
+            const GameObjectPartDesc& part = parts[part_index];
+
+            RenderEntity entity;
+            entity.m_mesh_handle            = resource.getOrCreateMeshHandle(part.m_mesh_desc);
+            entity.m_material_handle        = resource.getOrCreateMaterialHandle(part.m_material_desc);
+            entity.m_enable_vertex_blending = part.m_with_animation;
+            entity.m_is_occluder            = part.m_is_occluder;
+            entity.m_local_transform        = part.m_transform_desc.m_transform_matrix;
+            entity.m_local_bounds =
+                resource.getMeshBounds(entity.m_mesh_handle).getTransformed(entity.m_local_transform);
+
+            entity.m_lods.m_mesh_handles[0]    = entity.m_mesh_handle;
+            entity.m_lods.m_triangle_counts[0] = resource.getMeshTriangleCount(entity.m_mesh_handle);
+            for (const GameObjectMeshLodDesc& lod : part.m_mesh_lods)
+            {
+                if (entity.m_lods.m_count == k_max_mesh_lod_count)
+                {
+                    break;
+                }
+
+                const uint32_t lod_index                    = entity.m_lods.m_count++;
+                entity.m_lods.m_mesh_handles[lod_index]     = resource.getOrCreateMeshHandle(lod.m_mesh_desc);
+                entity.m_lods.m_geometric_errors[lod_index] = lod.m_geometric_error;
+                entity.m_lods.m_triangle_counts[lod_index] =
+                    resource.getMeshTriangleCount(entity.m_lods.m_mesh_handles[lod_index]);
+            }
+            if (entity.m_is_occluder)
+            {
+                resource.loadOccluderMesh(entity.m_mesh_handle);
+            }
+
+            const uint32_t         entity_index = static_cast<uint32_t>(m_entities.size());
+            const GameObjectPartId part_id {desc.getId(), part_index};
+
+            m_entities.push_back(entity);
+            m_entity_part_ids.push_back(part_id);
+            m_model_matrices.emplace_back();
+            m_world_bounds.pushBack(AxisAlignedBox());
+            m_lod_states.emplace_back();
+            m_entity_indices.emplace(part_id, entity_index);
+
+            updateEntityTransform(entity_index, record.m_transform_matrix);
+        }
+    }
+
+    void RenderScene::updateObjectTransform(const GameObjectTransformDelta& delta)
+    {
+        auto found = m_objects.find(delta.m_go_id);
+        if (found == m_objects.end())
+        {
+            return;
+        }
+
+        RenderObjectRecord& record  = found->second;
+        record.m_previous_transform = delta.m_previous_transform;
+        record.m_current_transform  = delta.m_current_transform;
+
+        const bool is_moving = record.m_previous_transform != record.m_current_transform;
+        if (is_moving && !record.m_is_moving)
+        {
+            m_moving_objects.push_back(delta.m_go_id);
+        }
+        record.m_is_moving = is_moving;
+
+        // a settled object is placed once here, moving ones every frame by interpolateTransforms
+        if (!is_moving)
+        {
+            record.m_transform_matrix = record.m_current_transform.getMatrix();
+            updateObjectEntities(delta.m_go_id, record);
+        }
+    }
+
+    void RenderScene::interpolateTransforms(float alpha)
+    {
+        for (size_t index = 0; index < m_moving_objects.size();)
+        {
+            auto found = m_objects.find(m_moving_objects[index]);
+            if (!found->second.m_is_moving)
+            {
+                m_moving_objects[index] = m_moving_objects.back();
+                m_moving_objects.pop_back();
+                continue;
+            }
+
+            RenderObjectRecord& record = found->second;
+            record.m_transform_matrix =
+                Transform::lerp(record.m_previous_transform, record.m_current_transform, alpha).getMatrix();
+            updateObjectEntities(found->first, record);
+            ++index;
+        }
+    }
+
+    void RenderScene::removeObject(GObjectID go_id)
+    {
+        auto found = m_objects.find(go_id);
+        if (found == m_objects.end())
+        {
+            return;
+        }
+
+        for (size_t part_index = 0; part_index < found->second.m_part_count; ++part_index)
+        {
+            removeEntity({go_id, part_index});
+        }
+        if (found->second.m_is_moving)
+        {
+            m_moving_objects.erase(std::remove(m_moving_objects.begin(), m_moving_objects.end(), go_id),
+                                   m_moving_objects.end());
+        }
+        m_objects.erase(found);
+    }
+
+    void RenderScene::clear()
+    {
+        m_entities.clear();
+        m_entity_part_ids.clear();
+        m_model_matrices.clear();
+        m_world_bounds.clear();
+        m_lod_states.clear();
+        m_entity_indices.clear();
+        m_objects.clear();
+        m_moving_objects.clear();
+    }
+
+    uint32_t RenderScene::findEntity(const GameObjectPartId& part_id) const
+    {
+        auto found = m_entity_indices.find(part_id);
+        return found != m_entity_indices.end() ? found->second : k_invalid_render_handle;
+    }
+
+    void RenderScene::removeEntity(const GameObjectPartId& part_id)
+    {
+        auto found = m_entity_indices.find(part_id);
+        if (found == m_entity_indices.end())
+        {
+            return;
+        }
+
+        const uint32_t entity_index = found->second;
+        const uint32_t last_index   = static_cast<uint32_t>(m_entities.size() - 1);
+        m_entity_indices.erase(found);
+
+        // fill the hole with the last entity to keep the arrays dense
+        if (entity_index != last_index)
+        {
+            m_entities[entity_index]        = m_entities[last_index];
+            m_entity_part_ids[entity_index] = m_entity_part_ids[last_index];
+            m_model_matrices[entity_index]  = m_model_matrices[last_index];
+            m_lod_states[entity_index]      = m_lod_states[last_index];
+
+            m_entity_indices[m_entity_part_ids[entity_index]] = entity_index;
+        }
+
+        m_entities.pop_back();
+        m_entity_part_ids.pop_back();
+        m_model_matrices.pop_back();
+        m_lod_states.pop_back();
+        m_world_bounds.removeSwapBack(entity_index);
+    }
+
+    void RenderScene::updateObjectEntities(GObjectID go_id, const RenderObjectRecord& record)
+    {
+        for (size_t part_index = 0; part_index < record.m_part_count; ++part_index)
+        {
+            const uint32_t entity_index = findEntity({go_id, part_index});
+            if (entity_index != k_invalid_render_handle)
+            {
+                updateEntityTransform(entity_index, record.m_transform_matrix);
+            }
+        }
+    }
+
+    void RenderScene::updateEntityTransform(uint32_t entity_index, const Matrix4x4& object_transform)
+    {
+        const RenderEntity& entity = m_entities[entity_index];
+
+        m_model_matrices[entity_index] = object_transform * entity.m_local_transform;
+        m_world_bounds.set(entity_index, entity.m_local_bounds.getTransformed(object_transform));
+    }
+} // namespace Polaris
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "runtime/core/math/axis_aligned.h"
+#include "runtime/core/math/matrix4.h"
+
+#include "runtime/function/render/render_entity.h"
+#include "runtime/function/render/render_object.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace Polaris
+{
+    class RenderResource;
+
+    /**
+     *  Flat table of every mesh part to render. Entities, model matrices and the SoA world bounds
+     *  live in parallel dense arrays that can be walked without chasing pointers; a part id maps to its slot
+     *  through a hash map and removal moves the last slot into the hole, so add, update and remove
+     *  are O(1) per part. Slot indices change on removal and must not be kept across updates
+     */
+    class RenderScene
+    {
+    public:
+        // adds the parts of a game object, replacing the parts it had before
+        void addObject(const GameObjectDesc& desc, RenderResource& resource);
+        void updateObjectTransform(const GameObjectTransformDelta& delta);
+        // places the objects still in motion between their previous and current transform
+        void interpolateTransforms(float alpha);
+        void removeObject(GObjectID go_id);
+        void clear();
+
+        // slot of the part, k_invalid_render_handle when the part is unknown
+        uint32_t findEntity(const GameObjectPartId& part_id) const;
+
+        size_t                                getEntityCount() const { return m_entities.size(); }
+        const std::vector<RenderEntity>&      getEntities() const { return m_entities; }
+        const std::vector<GameObjectPartId>&  getEntityPartIds() const { return m_entity_part_ids; }
+        const std::vector<Matrix4x4>&         getModelMatrices() const { return m_model_matrices; }
+        const RenderEntityBounds&             getWorldBounds() const { return m_world_bounds; }
+
+        // written by lod selection every frame, follows the entity when slots move
+        std::vector<RenderEntityLodState>&       getLodStates() { return m_lod_states; }
+        const std::vector<RenderEntityLodState>& getLodStates() const { return m_lod_states; }
+
+    private:
+        struct RenderObjectRecord
+        {
+            Transform m_previous_transform;
+            Transform m_current_transform;
+            Matrix4x4 m_transform_matrix {Matrix4x4::IDENTITY};
+            uint32_t  m_part_count {0};
+            // listed in m_moving_objects, the two transforms differ
+            bool      m_is_moving {false};
+        };
+
+        void removeEntity(const GameObjectPartId& part_id);
+        void updateObjectEntities(GObjectID go_id, const RenderObjectRecord& record);
+        void updateEntityTransform(uint32_t entity_index, const Matrix4x4& object_transform);
+
+        std::vector<RenderEntity>         m_entities;
+        std::vector<GameObjectPartId>     m_entity_part_ids;
+        std::vector<Matrix4x4>            m_model_matrices;
+        RenderEntityBounds                m_world_bounds;
+        std::vector<RenderEntityLodState> m_lod_states;
+
+        std::unordered_map<GameObjectPartId, uint32_t> m_entity_indices;
+        std::unordered_map<GObjectID, RenderObjectRecord> m_objects;
+        // objects blended every frame, entries of settled objects are dropped on the next blend
+        std::vector<GObjectID> m_moving_objects;
+    };
+} // namespace Polaris
@@ -0,0 +1,54 @@
+#include "runtime/function/render/render_swap_context.h"
+
+namespace Polaris
+{
+    void RenderSwapData::addGameObject(GameObjectDesc&& desc) { m_added_game_objects.push_back(std::move(desc)); }
+
+    void RenderSwapData::addTransformDelta(const GameObjectTransformDelta& delta) { m_transform_deltas.push_back(delta); }
+
+    void RenderSwapData::addDeleteGameObject(GObjectID go_id) { m_game_objects_to_delete.push_back(go_id); }
+
+    bool RenderSwapData::isEmpty() const
+    {
+        return m_added_game_objects.empty() && m_transform_deltas.empty() && m_game_objects_to_delete.empty() &&
+               !m_camera_swap_data.has_value();
+    }
+
+    void RenderSwapData::clear()
+    {
+        m_added_game_objects.clear();
+        m_transform_deltas.clear();
+        m_game_objects_to_delete.clear();
+        m_camera_swap_data.reset();
+    }
+
+    bool RenderSwapContext::submit()
+    {
+        // the render buffer is still owned by the render thread, keep accumulating
+        if (m_is_render_data_pending.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        const uint8_t logic_index = m_logic_index.load(std::memory_order_relaxed);
+        m_logic_index.store(logic_index ^ 1, std::memory_order_relaxed);
+
+        m_is_render_data_pending.store(true, std::memory_order_release);
+        return true;
+    }
+
+    RenderSwapData* RenderSwapContext::acquireRenderSwapData()
+    {
+        if (!m_is_render_data_pending.load(std::memory_order_acquire))
+        {
+            return nullptr;
+        }
+        return &m_swap_data[m_logic_index.load(std::memory_order_relaxed) ^ 1];
+    }
+
+    void RenderSwapContext::releaseRenderSwapData()
+    {
+        m_swap_data[m_logic_index.load(std::memory_order_relaxed) ^ 1].clear();
+        m_is_render_data_pending.store(false, std::memory_order_release);
+    }
+} // namespace Polaris
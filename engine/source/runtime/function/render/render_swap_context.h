@@ -0,0 +1,65 @@
+#pragma once
+
+#include "runtime/core/math/matrix4.h"
+
+#include "runtime/function/render/render_object.h"
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <vector>
+
+namespace Polaris
+{
+    struct CameraSwapData
+    {
+        Matrix4x4 m_view_matrix {Matrix4x4::IDENTITY};
+        // horizontal field of view in degrees
+        float m_fov_x {89.f};
+        float m_aspect_ratio {16.f / 9.f};
+        float m_z_near {0.1f};
+        float m_z_far {1000.f};
+    };
+
+    struct RenderSwapData
+    {
+        // full descriptions, sent once when an object first shows up or its parts change
+        std::deque<GameObjectDesc> m_added_game_objects;
+        // per frame transform changes, later entries of the same object win
+        std::vector<GameObjectTransformDelta> m_transform_deltas;
+        std::vector<GObjectID>                m_game_objects_to_delete;
+        std::optional<CameraSwapData>         m_camera_swap_data;
+        float                                 m_interpolation_alpha {1.f};
+
+        void addGameObject(GameObjectDesc&& desc);
+        void addTransformDelta(const GameObjectTransformDelta& delta);
+        void addDeleteGameObject(GObjectID go_id);
+
+        bool isEmpty() const;
+        void clear();
+    };
+
+    /**
+     *  Hands render updates from the logic thread to the render thread through two buffers.
+     *  Logic always writes the logic buffer; submit flips the buffers when the render thread has
+     *  released the other one, otherwise the updates keep accumulating and go with the next
+     *  submit. Neither side ever blocks or takes a lock here
+     */
+    class RenderSwapContext
+    {
+    public:
+        // logic thread only
+        RenderSwapData& getLogicSwapData() { return m_swap_data[m_logic_index.load(std::memory_order_relaxed)]; }
+        bool            submit();
+
+        // render thread only, nullptr when nothing was submitted since the last release
+        RenderSwapData* acquireRenderSwapData();
+        void            releaseRenderSwapData();
+
+    private:
+        RenderSwapData       m_swap_data[2];
+        std::atomic<uint8_t> m_logic_index {0};
+        std::atomic<bool>    m_is_render_data_pending {false};
+    };
+} // namespace Polaris
@@ -1,37 +1,304 @@
 #include "runtime/function/render/render_system.h"
 
+#include "runtime/core/math/math.h"
+#include "runtime/core/profiler/profiler.h"
+
 #include "runtime/function/render/rhi.h"
 #include "runtime/function/render/rhi/vulkan/vulkan_rhi.h"
+#include "runtime/function/render/window_system.h"
+
+#include <algorithm>
 
 
 
 
 namespace Polaris
 {
-	RenderSystem::~RenderSystem() {}
+	namespace
+	{
+		// resolution of the cpu occlusion depth buffer
+		constexpr uint32_t k_occlusion_buffer_width  = 256;
+		constexpr uint32_t k_occlusion_buffer_height = 144;
+	} // namespace
+
+	RenderSystem::~RenderSystem() { clear(); }
 
 	void RenderSystem::initialize(RenderSystemInitInfo init_info)
 	{
 		// render context initialize
 		RHIInitInfo rhi_init_info;
-		rhi_init_info.window_system = init_info.window_system;
+		rhi_init_info.window_system                  = init_info.window_system;
+		rhi_init_info.pipeline_cache_file            = init_info.pipeline_cache_file;
+		rhi_init_info.enable_gpu_pipeline_statistics = init_info.enable_gpu_pipeline_statistics;
+
+		std::shared_ptr<VulkanRHI> vulkan_rhi = std::make_shared<VulkanRHI>();
+		vulkan_rhi->initialize(rhi_init_info);
+		vulkan_rhi->setRenderGraphSetup([this](RenderGraph& render_graph, RenderGraphResource backbuffer) {
+			setupRenderGraph(render_graph, backbuffer);
+		});
+		m_rhi = vulkan_rhi;
+
+		m_viewport_height = static_cast<float>(init_info.window_system->getWindowSize()[1]);
+
+		LodSelectionSettings lod_settings;
+		lod_settings.m_max_screen_error = init_info.lod_screen_error;
+		lod_settings.m_triangle_budget  = init_info.lod_triangle_budget;
+		m_lod_selection.setSettings(lod_settings);
 
-		m_rhi = std::make_shared<VulkanRHI>();
-		m_rhi->initialize(rhi_init_info);
+		m_is_occlusion_culling_enabled = init_info.enable_occlusion_culling;
+		if (m_is_occlusion_culling_enabled)
+		{
+			m_occlusion_culling.initialize(k_occlusion_buffer_width, k_occlusion_buffer_height);
+		}
+
+		if (init_info.enable_render_thread)
+		{
+			m_is_render_thread_quit = false;
+			m_render_thread = std::thread(&RenderSystem::renderThreadLoop, this);
+		}
 	}
 
-	void RenderSystem::tick()
+	void RenderSystem::tick(float interpolation_alpha)
 	{
-		// prepare render command context
-		m_rhi->tick();
+		m_swap_context.getLogicSwapData().m_interpolation_alpha = interpolation_alpha;
+
+		if (!m_render_thread.joinable())
+		{
+			m_swap_context.submit();
+			renderFrame();
+			return;
+		}
+
+		{
+			// wait for the previous frame, so logic is never more than one frame ahead of rendering
+			std::unique_lock<std::mutex> lock(m_frame_mutex);
+			m_frame_condition.wait(lock, [this]() { return m_rendered_frame_count == m_submitted_frame_count; });
+
+			m_swap_context.submit();
+			++m_submitted_frame_count;
+		}
+		m_frame_condition.notify_all();
 	}
 
 	void RenderSystem::clear()
 	{
+		if (m_render_thread.joinable())
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_frame_mutex);
+				m_is_render_thread_quit = true;
+			}
+			m_frame_condition.notify_all();
+			m_render_thread.join();
+		}
+
 		if (m_rhi)
 		{
 			m_rhi->clear();
 		}
 		m_rhi.reset();
+
+		m_render_scene.clear();
+		m_render_resource.clear();
+	}
+
+	void RenderSystem::renderThreadLoop()
+	{
+		PROFILE_THREAD("render");
+
+		while (true)
+		{
+			{
+				std::unique_lock<std::mutex> lock(m_frame_mutex);
+				m_frame_condition.wait(lock, [this]() {
+					return m_is_render_thread_quit || m_rendered_frame_count < m_submitted_frame_count;
+				});
+				if (m_rendered_frame_count == m_submitted_frame_count)
+				{
+					break;
+				}
+			}
+
+			renderFrame();
+
+			{
+				std::lock_guard<std::mutex> lock(m_frame_mutex);
+				++m_rendered_frame_count;
+			}
+			m_frame_condition.notify_all();
+		}
+	}
+
+	void RenderSystem::renderFrame()
+	{
+		PROFILE_SCOPE("RenderSystem::renderFrame");
+
+		RenderSwapData* swap_data = m_swap_context.acquireRenderSwapData();
+		if (swap_data)
+		{
+			processSwapData(*swap_data);
+			m_swap_context.releaseRenderSwapData();
+		}
+
+		m_render_scene.interpolateTransforms(m_interpolation_alpha);
+
+		cullRenderViews();
+		selectLods();
+		buildDrawLists();
+
+		// prepare render command context
+		m_rhi->tick();
+	}
+
+	void RenderSystem::processSwapData(RenderSwapData& swap_data)
+	{
+		PROFILE_SCOPE("RenderSystem::processSwapData");
+
+		m_interpolation_alpha = swap_data.m_interpolation_alpha;
+
+		// deletes go last, an object may be created and destroyed within one frame
+		for (const GameObjectDesc& game_object : swap_data.m_added_game_objects)
+		{
+			m_render_scene.addObject(game_object, m_render_resource);
+		}
+		if (!swap_data.m_added_game_objects.empty())
+		{
+			prewarmScenePipelines();
+		}
+
+		for (const GameObjectTransformDelta& delta : swap_data.m_transform_deltas)
+		{
+			m_render_scene.updateObjectTransform(delta);
+		}
+
+		for (GObjectID go_id : swap_data.m_game_objects_to_delete)
+		{
+			m_render_scene.removeObject(go_id);
+		}
+
+		if (swap_data.m_camera_swap_data.has_value())
+		{
+			m_camera_swap_data = swap_data.m_camera_swap_data;
+		}
+	}
+
+	void RenderSystem::prewarmScenePipelines()
+	{
+		PROFILE_SCOPE("RenderSystem::prewarmScenePipelines");
+
+		std::vector<uint32_t> permutations;
+		for (const RenderEntity& entity : m_render_scene.getEntities())
+		{
+			const RenderPipelineType pipeline =
+				entity.m_enable_vertex_blending ? RenderPipelineType::skinned_mesh : RenderPipelineType::static_mesh;
+			for (RenderPassType pass : {RenderPassType::shadow, RenderPassType::opaque})
+			{
+				const uint32_t permutation = makePipelinePermutation(pass, pipeline);
+				if (m_prewarmed_pipeline_permutations.count(permutation) == 0 &&
+					std::find(permutations.begin(), permutations.end(), permutation) == permutations.end())
+				{
+					permutations.push_back(permutation);
+				}
+			}
+		}
+
+		if (!permutations.empty())
+		{
+			// only what was built counts as prewarmed, the rest is asked for again by the next load
+			for (uint32_t permutation : m_rhi->prewarmPipelines(permutations))
+			{
+				m_prewarmed_pipeline_permutations.insert(permutation);
+			}
+		}
+	}
+
+	void RenderSystem::cullRenderViews()
+	{
+		PROFILE_SCOPE("RenderSystem::cullRenderViews");
+
+		// without a camera nothing is drawn
+		if (!m_camera_swap_data.has_value())
+		{
+			m_camera_view.m_visible_entities.clear();
+			return;
+		}
+
+		const CameraSwapData& camera = *m_camera_swap_data;
+		const float  tan_half_fov_x = Math::tan(Radian(Degree(camera.m_fov_x)).valueRadians() * 0.5f);
+		const Radian fov_y(2.f * std::atan(tan_half_fov_x / camera.m_aspect_ratio));
+
+		m_camera_view.m_type = RenderViewType::camera;
+		m_camera_view.m_view_projection_matrix =
+			Math::makePerspectiveMatrix(fov_y, camera.m_aspect_ratio, camera.m_z_near, camera.m_z_far) * camera.m_view_matrix;
+		FrustumCulling::cullView(m_render_scene.getWorldBounds(), m_camera_view);
+
+		if (m_is_occlusion_culling_enabled)
+		{
+			// only occluders inside the frustum can hide anything
+			m_occlusion_culling.beginFrame(m_camera_view.m_view_projection_matrix);
+			for (uint32_t entity_index : m_camera_view.m_visible_entities)
+			{
+				const RenderEntity& entity = m_render_scene.getEntities()[entity_index];
+				if (!entity.m_is_occluder)
+				{
+					continue;
+				}
+
+				const OccluderMesh* occluder_mesh = m_render_resource.getOccluderMesh(entity.m_mesh_handle);
+				if (occluder_mesh)
+				{
+					m_occlusion_culling.addOccluder(*occluder_mesh, m_render_scene.getModelMatrices()[entity_index]);
+				}
+			}
+			m_occlusion_culling.rasterize();
+			m_occlusion_culling.cullVisibleEntities(m_render_scene.getWorldBounds(), m_camera_view.m_visible_entities);
+		}
+	}
+
+	void RenderSystem::selectLods()
+	{
+		if (!m_camera_swap_data.has_value())
+		{
+			return;
+		}
+
+		const CameraSwapData& camera = *m_camera_swap_data;
+		const float tan_half_fov_x = Math::tan(Radian(Degree(camera.m_fov_x)).valueRadians() * 0.5f);
+		const float tan_half_fov_y = tan_half_fov_x / camera.m_aspect_ratio;
+		const float projection_scale = m_viewport_height / (2.f * tan_half_fov_y);
+
+		m_lod_selection.select(m_render_scene,
+			m_camera_view.m_visible_entities,
+			camera.m_view_matrix.inverseAffine().getTrans(),
+			projection_scale);
+	}
+
+	void RenderSystem::buildDrawLists()
+	{
+		if (!m_camera_swap_data.has_value())
+		{
+			m_camera_draw_list.clear();
+			return;
+		}
+
+		m_camera_draw_list.build(m_render_scene, m_camera_view, RenderPassType::opaque, m_camera_swap_data->m_z_far);
+	}
+
+	/*
+	* Only clears the backbuffer for now, the draw list passes will be declared here as well
+	*/
+	void RenderSystem::setupRenderGraph(RenderGraph& render_graph, RenderGraphResource backbuffer)
+	{
+		RenderGraphPass clear_pass = render_graph.addPass("Clear Backbuffer", [backbuffer](RenderGraphPassContext& context) {
+			VkClearColorValue       clear_color = { { 0.f, 0.f, 0.f, 1.f } };
+			VkImageSubresourceRange range       = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+			vkCmdClearColorImage(context.getCommandBuffer(),
+				context.getImage(backbuffer),
+				VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+				&clear_color,
+				1,
+				&range);
+		});
+		render_graph.write(clear_pass, backbuffer, RenderGraphAccess::transfer_destination);
 	}
 }
\ No newline at end of file
@@ -1,6 +1,23 @@
+#pragma once
+
+#include "runtime/function/render/occlusion_culling.h"
+#include "runtime/function/render/render_culling.h"
+#include "runtime/function/render/render_draw_list.h"
+#include "runtime/function/render/render_graph.h"
+#include "runtime/function/render/render_lod.h"
+#include "runtime/function/render/render_resource.h"
+#include "runtime/function/render/render_scene.h"
+#include "runtime/function/render/render_swap_context.h"
+
 #include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <thread>
+#include <unordered_set>
 
 namespace Polaris
 {
@@ -10,8 +27,19 @@ namespace Polaris
 	struct RenderSystemInitInfo
 	{
 		std::shared_ptr<WindowSystem> window_system;
+		bool                          enable_render_thread{ true };
+		bool                          enable_occlusion_culling{ true };
+		float                         lod_screen_error{ 1.f };
+		uint32_t                      lod_triangle_budget{ 0 };
+		std::filesystem::path         pipeline_cache_file;
+		bool                          enable_gpu_pipeline_statistics{ false };
 	};
 
+    /**
+     *  Logic publishes render updates through the swap context once per frame. With the render
+     *  thread enabled, frame N is rendered while logic already runs frame N+1, and logic waits
+     *  before getting two frames ahead
+     */
     class RenderSystem
     {
     public:
@@ -19,11 +47,62 @@ namespace Polaris
         ~RenderSystem();
 
         void initialize(RenderSystemInitInfo init_info);
-        void tick();
+        // interpolation_alpha blends transforms between the previous and the current logic tick
+        void tick(float interpolation_alpha);
         void clear();
 
+        // logic thread side of the render updates
+        RenderSwapContext& getSwapContext() { return m_swap_context; }
+
+        // render thread state, valid while rendering a frame
+        float              getInterpolationAlpha() const { return m_interpolation_alpha; }
+        const RenderScene& getRenderScene() const { return m_render_scene; }
+        const RenderView&  getCameraView() const { return m_camera_view; }
+
+        const OcclusionCulling& getOcclusionCulling() const { return m_occlusion_culling; }
+        const LodSelection&     getLodSelection() const { return m_lod_selection; }
+        const DrawList&         getCameraDrawList() const { return m_camera_draw_list; }
+
+    private:
+        void renderThreadLoop();
+        void renderFrame();
+        void processSwapData(RenderSwapData& swap_data);
+        // compiles the pipelines the scene needs and no earlier load asked for
+        void prewarmScenePipelines();
+        void cullRenderViews();
+        void selectLods();
+        void buildDrawLists();
+        // declares the passes of the frame, called by the rhi once it acquired the backbuffer
+        void setupRenderGraph(RenderGraph& render_graph, RenderGraphResource backbuffer);
+
     private:
         std::shared_ptr<RHI> m_rhi;
 
+        RenderSwapContext m_swap_context;
+
+        RenderResource                m_render_resource;
+        RenderScene                   m_render_scene;
+        std::optional<CameraSwapData> m_camera_swap_data;
+        // shadow views will be culled next to the camera view
+        RenderView m_camera_view;
+
+        bool             m_is_occlusion_culling_enabled{ false };
+        OcclusionCulling m_occlusion_culling;
+
+        LodSelection m_lod_selection;
+        float        m_viewport_height{ 720.f };
+
+        DrawList m_camera_draw_list;
+
+        std::unordered_set<uint32_t> m_prewarmed_pipeline_permutations;
+
+        float m_interpolation_alpha{ 1.f };
+
+        std::thread             m_render_thread;
+        std::mutex              m_frame_mutex;
+        std::condition_variable m_frame_condition;
+        uint64_t                m_submitted_frame_count{ 0 };
+        uint64_t                m_rendered_frame_count{ 0 };
+        bool                    m_is_render_thread_quit{ false };
     };
 } // namespace Polaris
\ No newline at end of file
@@ -3,7 +3,10 @@
 #define GLFW_INCLUDE_VULKAN
 #include <GLFW/glfw3.h>
 
+#include <cstdint>
+#include <filesystem>
 #include <memory>
+#include <vector>
 
 namespace Polaris
 {
@@ -12,6 +15,10 @@ namespace Polaris
     struct RHIInitInfo
     {
         std::shared_ptr<WindowSystem> window_system;
+        // persisted pipeline cache, empty keeps it in memory only
+        std::filesystem::path pipeline_cache_file;
+        // pipeline statistics queries around every pass, when the device supports them
+        bool enable_gpu_pipeline_statistics{ false };
     };
 
     class RHI
@@ -22,6 +29,10 @@ namespace Polaris
         virtual void initialize(RHIInitInfo initialize_info) = 0;
         virtual void tick() = 0;
 
+        // compiles the pipelines of these permutations ahead of their first draw, returns the ones that now have a
+        // pipeline. Permutations without a known pipeline layout or whose compile failed are left out
+        virtual std::vector<uint32_t> prewarmPipelines(const std::vector<uint32_t>& permutations) = 0;
+
         // destory
         virtual void clear() = 0;
 
@@ -0,0 +1,333 @@
+#include "runtime/function/render/rhi/vulkan/vulkan_bindless_descriptors.h"
+
+#include "runtime/core/base/macro.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace Polaris
+{
+    namespace
+    {
+        constexpr uint32_t k_texture_binding  = 0;
+        constexpr uint32_t k_sampler_binding  = 1;
+        constexpr uint32_t k_material_binding = 2;
+    } // namespace
+
+    void VulkanBindlessDescriptors::initialize(const InitInfo& initInfo)
+    {
+        m_initInfo = initInfo;
+
+        VkPhysicalDeviceVulkan12Properties properties12{};
+        properties12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES;
+        VkPhysicalDeviceProperties2 properties{};
+        properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+        properties.pNext = &properties12;
+        vkGetPhysicalDeviceProperties2(initInfo.physicalDevice, &properties);
+
+        // a few sampled images stay for the non bindless sets bound next to this one
+        const uint32_t deviceLimit = std::min(properties12.maxPerStageDescriptorUpdateAfterBindSampledImages,
+                                              properties12.maxDescriptorSetUpdateAfterBindSampledImages);
+        m_textureCapacity          = std::min(initInfo.maxTextureCount, deviceLimit > 64 ? deviceLimit - 64 : deviceLimit);
+
+        createSamplers();
+
+        const VkShaderStageFlags stages = VK_SHADER_STAGE_ALL_GRAPHICS | VK_SHADER_STAGE_COMPUTE_BIT;
+
+        VkDescriptorSetLayoutBinding bindings[3]{};
+        bindings[0].binding         = k_texture_binding;
+        bindings[0].descriptorType  = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+        bindings[0].descriptorCount = m_textureCapacity;
+        bindings[0].stageFlags      = stages;
+
+        bindings[1].binding            = k_sampler_binding;
+        bindings[1].descriptorType     = VK_DESCRIPTOR_TYPE_SAMPLER;
+        bindings[1].descriptorCount    = static_cast<uint32_t>(m_samplers.size());
+        bindings[1].stageFlags         = stages;
+        bindings[1].pImmutableSamplers = m_samplers.data();
+
+        bindings[2].binding         = k_material_binding;
+        bindings[2].descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[2].descriptorCount = 1;
+        bindings[2].stageFlags      = stages;
+
+        // slots past the registered textures are never written, partially bound makes that legal
+        VkDescriptorBindingFlags bindingFlags[3] = {
+            VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT | VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
+                VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT,
+            0,
+            0,
+        };
+
+        VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo{};
+        bindingFlagsInfo.sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+        bindingFlagsInfo.bindingCount  = 3;
+        bindingFlagsInfo.pBindingFlags = bindingFlags;
+
+        VkDescriptorSetLayoutCreateInfo layoutInfo{};
+        layoutInfo.sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        layoutInfo.pNext        = &bindingFlagsInfo;
+        layoutInfo.flags        = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+        layoutInfo.bindingCount = 3;
+        layoutInfo.pBindings    = bindings;
+        if (vkCreateDescriptorSetLayout(initInfo.device, &layoutInfo, nullptr, &m_setLayout) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create bindless descriptor set layout!");
+        }
+
+        VkDescriptorPoolSize poolSizes[3];
+        poolSizes[0].type            = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+        poolSizes[0].descriptorCount = m_textureCapacity * initInfo.frameCount;
+        poolSizes[1].type            = VK_DESCRIPTOR_TYPE_SAMPLER;
+        poolSizes[1].descriptorCount = static_cast<uint32_t>(m_samplers.size()) * initInfo.frameCount;
+        poolSizes[2].type            = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        poolSizes[2].descriptorCount = initInfo.frameCount;
+
+        VkDescriptorPoolCreateInfo poolInfo{};
+        poolInfo.sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        poolInfo.flags         = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+        poolInfo.maxSets       = initInfo.frameCount;
+        poolInfo.poolSizeCount = 3;
+        poolInfo.pPoolSizes    = poolSizes;
+        if (vkCreateDescriptorPool(initInfo.device, &poolInfo, nullptr, &m_pool) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create bindless descriptor pool!");
+        }
+
+        const std::vector<VkDescriptorSetLayout> setLayouts(initInfo.frameCount, m_setLayout);
+
+        VkDescriptorSetAllocateInfo allocInfo{};
+        allocInfo.sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocInfo.descriptorPool     = m_pool;
+        allocInfo.descriptorSetCount = initInfo.frameCount;
+        allocInfo.pSetLayouts        = setLayouts.data();
+        m_sets.resize(initInfo.frameCount);
+        if (vkAllocateDescriptorSets(initInfo.device, &allocInfo, m_sets.data()) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to allocate bindless descriptor sets!");
+        }
+
+        // unset records point at no texture
+        m_materials.assign(std::max(1u, initInfo.initialMaterialCapacity), VulkanBindlessMaterial{});
+        m_frameMaterials.resize(initInfo.frameCount);
+        for (uint32_t frameIndex = 0; frameIndex < initInfo.frameCount; ++frameIndex)
+        {
+            createMaterialBuffer(frameIndex);
+        }
+    }
+
+    /*
+    * The device has to be idle
+    */
+    void VulkanBindlessDescriptors::clear()
+    {
+        m_retiredTextures.clear();
+        m_freeTextures.clear();
+        m_textureCount = 0;
+
+        for (const FrameMaterials& frameMaterials : m_frameMaterials)
+        {
+            m_initInfo.resourceManager->destroyBuffer(frameMaterials.buffer);
+        }
+        m_frameMaterials.clear();
+        m_materials.clear();
+
+        // destroying the pool frees the sets
+        vkDestroyDescriptorPool(m_initInfo.device, m_pool, nullptr);
+        vkDestroyDescriptorSetLayout(m_initInfo.device, m_setLayout, nullptr);
+        m_pool      = VK_NULL_HANDLE;
+        m_setLayout = VK_NULL_HANDLE;
+        m_sets.clear();
+
+        for (VkSampler& sampler : m_samplers)
+        {
+            vkDestroySampler(m_initInfo.device, sampler, nullptr);
+            sampler = VK_NULL_HANDLE;
+        }
+    }
+
+    /*
+    * The fence of the frame slot was waited for, so its material buffer is no longer read and can
+    * be written or replaced. Anything retired frameCount frames ago is no longer read by a frame
+    * in flight either
+    */
+    void VulkanBindlessDescriptors::beginFrame(uint32_t frameIndex)
+    {
+        m_currentFrameIndex = frameIndex;
+        if (m_frameMaterials[frameIndex].capacity < m_materials.size())
+        {
+            createMaterialBuffer(frameIndex);
+        }
+        else
+        {
+            updateMaterialBuffer(frameIndex);
+        }
+
+        ++m_frameCounter;
+        while (!m_retiredTextures.empty() && m_retiredTextures.front().frame + m_initInfo.frameCount <= m_frameCounter)
+        {
+            m_freeTextures.push_back(m_retiredTextures.front().textureIndex);
+            m_retiredTextures.pop_front();
+        }
+    }
+
+    uint32_t VulkanBindlessDescriptors::registerTexture(VkImageView imageView, VkImageLayout layout)
+    {
+        uint32_t textureIndex = k_invalid_bindless_index;
+        if (!m_freeTextures.empty())
+        {
+            textureIndex = m_freeTextures.back();
+            m_freeTextures.pop_back();
+        }
+        else if (m_textureCount < m_textureCapacity)
+        {
+            textureIndex = m_textureCount++;
+        }
+        else
+        {
+            LOG_ERROR("bindless texture array is full, {} textures registered", m_textureCapacity);
+            return k_invalid_bindless_index;
+        }
+
+        VkDescriptorImageInfo imageInfo{};
+        imageInfo.imageView   = imageView;
+        imageInfo.imageLayout = layout;
+
+        // the slot is unused by every frame in flight, so all sets can take it right away
+        std::vector<VkWriteDescriptorSet> writes(m_sets.size());
+        for (size_t setIndex = 0; setIndex < m_sets.size(); ++setIndex)
+        {
+            VkWriteDescriptorSet& write = writes[setIndex];
+            write.sType                 = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            write.dstSet                = m_sets[setIndex];
+            write.dstBinding            = k_texture_binding;
+            write.dstArrayElement       = textureIndex;
+            write.descriptorCount       = 1;
+            write.descriptorType        = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+            write.pImageInfo            = &imageInfo;
+        }
+        vkUpdateDescriptorSets(m_initInfo.device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+        return textureIndex;
+    }
+
+    void VulkanBindlessDescriptors::releaseTexture(uint32_t textureIndex)
+    {
+        if (textureIndex != k_invalid_bindless_index)
+        {
+            m_retiredTextures.push_back({ m_frameCounter, textureIndex });
+        }
+    }
+
+    void VulkanBindlessDescriptors::setMaterial(uint32_t materialIndex, const VulkanBindlessMaterial& material)
+    {
+        if (materialIndex >= m_materials.size())
+        {
+            m_materials.resize(std::max<size_t>(materialIndex + 1, m_materials.size() * 2), VulkanBindlessMaterial{});
+        }
+        m_materials[materialIndex] = material;
+
+        // frames in flight may read their buffers right now, each one is written when it begins again
+        for (FrameMaterials& frameMaterials : m_frameMaterials)
+        {
+            frameMaterials.dirtyMaterials.push_back(materialIndex);
+        }
+    }
+
+    void VulkanBindlessDescriptors::bind(VkCommandBuffer commandBuffer, VkPipelineBindPoint bindPoint, VkPipelineLayout layout, uint32_t setIndex) const
+    {
+        vkCmdBindDescriptorSets(commandBuffer, bindPoint, layout, setIndex, 1, &m_sets[m_currentFrameIndex], 0, nullptr);
+    }
+
+    void VulkanBindlessDescriptors::createSamplers()
+    {
+        VkSamplerCreateInfo samplerInfo{};
+        samplerInfo.sType        = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+        samplerInfo.maxLod       = VK_LOD_CLAMP_NONE;
+        samplerInfo.borderColor  = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
+        samplerInfo.compareOp    = VK_COMPARE_OP_ALWAYS;
+        samplerInfo.mipLodBias   = 0.0f;
+        samplerInfo.minLod       = 0.0f;
+
+        for (size_t samplerIndex = 0; samplerIndex < m_samplers.size(); ++samplerIndex)
+        {
+            const VulkanBindlessSampler sampler  = static_cast<VulkanBindlessSampler>(samplerIndex);
+            const bool                  isLinear = sampler != VulkanBindlessSampler::nearest_clamp;
+            const VkSamplerAddressMode  address  = sampler == VulkanBindlessSampler::linear_repeat ?
+                                                       VK_SAMPLER_ADDRESS_MODE_REPEAT :
+                                                       VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+
+            samplerInfo.magFilter        = isLinear ? VK_FILTER_LINEAR : VK_FILTER_NEAREST;
+            samplerInfo.minFilter        = samplerInfo.magFilter;
+            samplerInfo.mipmapMode       = isLinear ? VK_SAMPLER_MIPMAP_MODE_LINEAR : VK_SAMPLER_MIPMAP_MODE_NEAREST;
+            samplerInfo.addressModeU     = address;
+            samplerInfo.addressModeV     = address;
+            samplerInfo.addressModeW     = address;
+            samplerInfo.anisotropyEnable = isLinear ? VK_TRUE : VK_FALSE;
+            samplerInfo.maxAnisotropy    = isLinear ? 8.0f : 1.0f;
+            if (vkCreateSampler(m_initInfo.device, &samplerInfo, nullptr, &m_samplers[samplerIndex]) != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to create bindless sampler!");
+            }
+        }
+    }
+
+    /*
+    * Only called for a frame that is not in flight, so the old buffer can go right away
+    */
+    void VulkanBindlessDescriptors::createMaterialBuffer(uint32_t frameIndex)
+    {
+        VulkanResourceManager& resourceManager = *m_initInfo.resourceManager;
+        FrameMaterials&        frameMaterials  = m_frameMaterials[frameIndex];
+        if (frameMaterials.buffer != k_invalid_vulkan_resource_handle)
+        {
+            resourceManager.destroyBuffer(frameMaterials.buffer);
+        }
+
+        VkBufferCreateInfo bufferInfo{};
+        bufferInfo.sType       = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferInfo.size        = static_cast<VkDeviceSize>(m_materials.size()) * sizeof(VulkanBindlessMaterial);
+        bufferInfo.usage       = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+        frameMaterials.buffer   = resourceManager.createBuffer(bufferInfo, VulkanMemoryPool::per_frame);
+        frameMaterials.capacity = static_cast<uint32_t>(m_materials.size());
+        frameMaterials.dirtyMaterials.clear();
+
+        std::memcpy(resourceManager.getMappedData(frameMaterials.buffer), m_materials.data(), bufferInfo.size);
+        resourceManager.flushBuffer(frameMaterials.buffer, 0, VK_WHOLE_SIZE);
+
+        VkDescriptorBufferInfo materialInfo{};
+        materialInfo.buffer = resourceManager.getBuffer(frameMaterials.buffer);
+        materialInfo.offset = 0;
+        materialInfo.range  = VK_WHOLE_SIZE;
+
+        VkWriteDescriptorSet write{};
+        write.sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet          = m_sets[frameIndex];
+        write.dstBinding      = k_material_binding;
+        write.descriptorCount = 1;
+        write.descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        write.pBufferInfo     = &materialInfo;
+        vkUpdateDescriptorSets(m_initInfo.device, 1, &write, 0, nullptr);
+    }
+
+    void VulkanBindlessDescriptors::updateMaterialBuffer(uint32_t frameIndex)
+    {
+        FrameMaterials& frameMaterials = m_frameMaterials[frameIndex];
+        if (frameMaterials.dirtyMaterials.empty())
+        {
+            return;
+        }
+
+        VulkanResourceManager& resourceManager = *m_initInfo.resourceManager;
+        VulkanBindlessMaterial* records = static_cast<VulkanBindlessMaterial*>(resourceManager.getMappedData(frameMaterials.buffer));
+        for (uint32_t materialIndex : frameMaterials.dirtyMaterials)
+        {
+            records[materialIndex] = m_materials[materialIndex];
+        }
+        frameMaterials.dirtyMaterials.clear();
+        // one flush over the whole buffer, dirty records are usually spread out
+        resourceManager.flushBuffer(frameMaterials.buffer, 0, VK_WHOLE_SIZE);
+    }
+} // namespace Polaris
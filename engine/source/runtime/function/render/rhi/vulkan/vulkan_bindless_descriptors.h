@@ -0,0 +1,132 @@
+#pragma once
+
+#include "runtime/function/render/rhi/vulkan/vulkan_resource_manager.h"
+
+#include <vulkan/vulkan.h>
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <vector>
+
+namespace Polaris
+{
+    constexpr uint32_t k_invalid_bindless_index = std::numeric_limits<uint32_t>::max();
+
+    // immutable samplers of the bindless set, indexed the same way in shaders
+    enum class VulkanBindlessSampler : uint32_t
+    {
+        linear_repeat,
+        linear_clamp,
+        nearest_clamp,
+        count
+    };
+
+    // std430 mirror of the material record shaders read, unused textures are k_invalid_bindless_index
+    struct VulkanBindlessMaterial
+    {
+        uint32_t baseColorTexture{ k_invalid_bindless_index };
+        uint32_t metallicRoughnessTexture{ k_invalid_bindless_index };
+        uint32_t normalTexture{ k_invalid_bindless_index };
+        uint32_t occlusionTexture{ k_invalid_bindless_index };
+        uint32_t emissiveTexture{ k_invalid_bindless_index };
+        uint32_t sampler{ static_cast<uint32_t>(VulkanBindlessSampler::linear_repeat) };
+        uint32_t flags{ 0 };
+        uint32_t padding{ 0 };
+    };
+    static_assert(sizeof(VulkanBindlessMaterial) == 32, "VulkanBindlessMaterial has to match the shader layout");
+
+    /**
+     *  One descriptor set for every material and texture of the frame, bound once per pipeline
+     *  layout instead of once per draw. Textures are entries of a large update-after-bind sampled
+     *  image array and materials are records of a storage buffer indexed by material id, so their
+     *  count is only bounded by the device limits. The shader side declares
+     *
+     *      layout(set = S, binding = 0) uniform texture2D textures[];
+     *      layout(set = S, binding = 1) uniform sampler samplers[3];
+     *      layout(set = S, binding = 2) readonly buffer Materials { Material materials[]; };
+     *
+     *  and indexes textures with nonuniformEXT. Every frame in flight has its own copy of the set
+     *  and its own material buffer: texture slots are written into all sets while unused, and
+     *  material records are kept on the cpu and copied into a frame's buffer when that frame
+     *  begins, once the gpu is done with it. Released texture slots are kept until the frames that
+     *  may still read them have completed
+     */
+    class VulkanBindlessDescriptors
+    {
+    public:
+        struct InitInfo
+        {
+            VkPhysicalDevice       physicalDevice{ VK_NULL_HANDLE };
+            VkDevice               device{ VK_NULL_HANDLE };
+            VulkanResourceManager* resourceManager{ nullptr };
+            uint32_t               frameCount{ 3 };
+            // clamped to the update-after-bind limits of the device
+            uint32_t               maxTextureCount{ 1u << 16 };
+            uint32_t               initialMaterialCapacity{ 256 };
+        };
+
+        void initialize(const InitInfo& initInfo);
+        void clear();
+
+        // once per frame after the fence of the frame slot was waited for, before recording
+        void beginFrame(uint32_t frameIndex);
+
+        uint32_t registerTexture(VkImageView imageView, VkImageLayout layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        void     releaseTexture(uint32_t textureIndex);
+
+        // the record reaches the gpu with the next beginFrame, frames begun before never see it
+        void setMaterial(uint32_t materialIndex, const VulkanBindlessMaterial& material);
+
+        void bind(VkCommandBuffer commandBuffer, VkPipelineBindPoint bindPoint, VkPipelineLayout layout, uint32_t setIndex) const;
+
+        VkDescriptorSetLayout getDescriptorSetLayout() const { return m_setLayout; }
+        VkDescriptorSet       getDescriptorSet() const { return m_sets[m_currentFrameIndex]; }
+        uint32_t              getTextureCapacity() const { return m_textureCapacity; }
+        uint32_t              getMaterialCapacity() const { return static_cast<uint32_t>(m_materials.size()); }
+
+    private:
+        struct RetiredTexture
+        {
+            uint64_t frame{ 0 };
+            uint32_t textureIndex{ 0 };
+        };
+
+        // material buffer of one frame in flight, only touched while that frame is not in flight
+        struct FrameMaterials
+        {
+            VulkanBufferHandle    buffer{ k_invalid_vulkan_resource_handle };
+            uint32_t              capacity{ 0 };
+            // set since the frame last began, may repeat
+            std::vector<uint32_t> dirtyMaterials;
+        };
+
+        void createSamplers();
+        // recreates the buffer of the frame at the current capacity with every record
+        void createMaterialBuffer(uint32_t frameIndex);
+        void updateMaterialBuffer(uint32_t frameIndex);
+
+    private:
+        InitInfo m_initInfo;
+
+        std::array<VkSampler, static_cast<size_t>(VulkanBindlessSampler::count)> m_samplers{};
+
+        VkDescriptorSetLayout m_setLayout{ VK_NULL_HANDLE };
+        VkDescriptorPool      m_pool{ VK_NULL_HANDLE };
+        // per frame in flight
+        std::vector<VkDescriptorSet> m_sets;
+        std::vector<FrameMaterials>  m_frameMaterials;
+        uint32_t                     m_currentFrameIndex{ 0 };
+
+        uint32_t              m_textureCapacity{ 0 };
+        uint32_t              m_textureCount{ 0 };
+        std::vector<uint32_t> m_freeTextures;
+
+        // every record, the size is the capacity the frame buffers grow to
+        std::vector<VulkanBindlessMaterial> m_materials;
+
+        uint64_t                   m_frameCounter{ 0 };
+        std::deque<RetiredTexture> m_retiredTextures;
+    };
+} // namespace Polaris
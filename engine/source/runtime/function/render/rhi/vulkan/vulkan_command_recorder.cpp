@@ -0,0 +1,134 @@
+#include "runtime/function/render/rhi/vulkan/vulkan_command_recorder.h"
+
+#include "runtime/core/base/thread_pool.h"
+#include "runtime/core/profiler/profiler.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace Polaris
+{
+    void VulkanCommandRecorder::initialize(VkDevice device, uint32_t queueFamilyIndex, uint32_t frameCount, uint32_t workerCount)
+    {
+        m_device      = device;
+        m_workerCount = std::max(1u, workerCount);
+        m_workerPools.resize(static_cast<size_t>(frameCount) * m_workerCount);
+
+        // buffers are only recorded once per reset, so the pools can skip per buffer reset support
+        VkCommandPoolCreateInfo poolInfo{};
+        poolInfo.sType            = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolInfo.queueFamilyIndex = queueFamilyIndex;
+        poolInfo.flags            = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+        for (WorkerPool& workerPool : m_workerPools)
+        {
+            if (vkCreateCommandPool(m_device, &poolInfo, nullptr, &workerPool.commandPool) != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to create worker command pool!");
+            }
+        }
+    }
+
+    /*
+    * The device has to be idle
+    */
+    void VulkanCommandRecorder::clear()
+    {
+        for (WorkerPool& workerPool : m_workerPools)
+        {
+            // destroying the pool frees its buffers
+            vkDestroyCommandPool(m_device, workerPool.commandPool, nullptr);
+        }
+        m_workerPools.clear();
+    }
+
+    void VulkanCommandRecorder::beginFrame(uint32_t frameIndex)
+    {
+        PROFILE_SCOPE("VulkanCommandRecorder::beginFrame");
+
+        m_currentFrameIndex = frameIndex;
+        for (uint32_t workerIndex = 0; workerIndex < m_workerCount; ++workerIndex)
+        {
+            WorkerPool& workerPool = m_workerPools[frameIndex * m_workerCount + workerIndex];
+            if (workerPool.usedBufferCount > 0)
+            {
+                vkResetCommandPool(m_device, workerPool.commandPool, 0);
+                workerPool.usedBufferCount = 0;
+            }
+        }
+    }
+
+    /*
+    * Chunk i is recorded with command pool i on whichever thread of the pool claims it
+    */
+    void VulkanCommandRecorder::recordParallel(VkCommandBuffer                       primary,
+                                               const VkCommandBufferInheritanceInfo& inheritance,
+                                               uint32_t                              itemCount,
+                                               uint32_t                              minItemsPerChunk,
+                                               const RecordCallback&                 record)
+    {
+        PROFILE_SCOPE("VulkanCommandRecorder::recordParallel");
+
+        if (itemCount == 0)
+        {
+            return;
+        }
+
+        const uint32_t maxChunkCount = std::min(m_workerCount, std::max(1u, itemCount / std::max(1u, minItemsPerChunk)));
+        const uint32_t chunkSize     = (itemCount + maxChunkCount - 1) / maxChunkCount;
+        // rounding up the size can leave the last chunks empty, they are dropped
+        const uint32_t chunkCount = (itemCount + chunkSize - 1) / chunkSize;
+
+        VkCommandBufferInheritanceInfo chunkInheritance = inheritance;
+        chunkInheritance.pipelineStatistics |= m_inheritedPipelineStatistics;
+
+        m_chunkBuffers.assign(chunkCount, VK_NULL_HANDLE);
+        auto recordChunk = [&](uint32_t chunkIndex) {
+            VkCommandBuffer commandBuffer =
+                acquireSecondaryBuffer(m_workerPools[m_currentFrameIndex * m_workerCount + chunkIndex]);
+
+            VkCommandBufferBeginInfo beginInfo{};
+            beginInfo.sType            = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+            beginInfo.flags            = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+            beginInfo.pInheritanceInfo = &chunkInheritance;
+            if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to begin recording secondary command buffer!");
+            }
+
+            const uint32_t begin = chunkIndex * chunkSize;
+            const uint32_t end   = std::min(itemCount, begin + chunkSize);
+            record(commandBuffer, begin, end);
+
+            if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to record secondary command buffer!");
+            }
+            m_chunkBuffers[chunkIndex] = commandBuffer;
+        };
+
+        // rethrows recording failures of the workers
+        ThreadPool::getInstance().parallelFor(chunkCount, recordChunk);
+
+        vkCmdExecuteCommands(primary, chunkCount, m_chunkBuffers.data());
+    }
+
+    VkCommandBuffer VulkanCommandRecorder::acquireSecondaryBuffer(WorkerPool& workerPool)
+    {
+        if (workerPool.usedBufferCount == workerPool.secondaryBuffers.size())
+        {
+            VkCommandBufferAllocateInfo allocInfo{};
+            allocInfo.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            allocInfo.commandPool        = workerPool.commandPool;
+            allocInfo.level              = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+            allocInfo.commandBufferCount = 1;
+
+            VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+            if (vkAllocateCommandBuffers(m_device, &allocInfo, &commandBuffer) != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to allocate secondary command buffer!");
+            }
+            workerPool.secondaryBuffers.push_back(commandBuffer);
+        }
+        return workerPool.secondaryBuffers[workerPool.usedBufferCount++];
+    }
+} // namespace Polaris
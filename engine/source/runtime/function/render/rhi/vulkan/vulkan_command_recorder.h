@@ -0,0 +1,66 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace Polaris
+{
+    /**
+     *  Spreads command recording over worker threads. Every worker owns one command pool per frame in
+     *  flight, so no pool is touched by two threads, and a whole frame's pools are reset at once
+     *  instead of buffer by buffer. Work is split into contiguous chunks recorded into secondary
+     *  command buffers, which the primary then executes in chunk order
+     */
+    class VulkanCommandRecorder
+    {
+    public:
+        // records items [begin, end) into commandBuffer
+        using RecordCallback = std::function<void(VkCommandBuffer commandBuffer, uint32_t begin, uint32_t end)>;
+
+        void initialize(VkDevice device, uint32_t queueFamilyIndex, uint32_t frameCount, uint32_t workerCount);
+        void clear();
+
+        uint32_t getWorkerCount() const { return m_workerCount; }
+
+        // secondaries have to declare the statistics of a pipeline statistics query active in the primary
+        void setInheritedPipelineStatistics(VkQueryPipelineStatisticFlags statistics) { m_inheritedPipelineStatistics = statistics; }
+
+        // the fence of frameIndex has to be signaled, its secondary buffers are recycled
+        void beginFrame(uint32_t frameIndex);
+
+        /**
+         *  Records itemCount items with at least minItemsPerChunk per chunk, so small lists stay on the
+         *  calling thread. The secondaries continue the render pass and subpass of inheritance, which
+         *  primary has to have begun with VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS
+         */
+        void recordParallel(VkCommandBuffer                       primary,
+                            const VkCommandBufferInheritanceInfo& inheritance,
+                            uint32_t                              itemCount,
+                            uint32_t                              minItemsPerChunk,
+                            const RecordCallback&                 record);
+
+    private:
+        struct WorkerPool
+        {
+            VkCommandPool                commandPool{ VK_NULL_HANDLE };
+            std::vector<VkCommandBuffer> secondaryBuffers;
+            uint32_t                     usedBufferCount{ 0 };
+        };
+
+        VkCommandBuffer acquireSecondaryBuffer(WorkerPool& workerPool);
+
+    private:
+        VkDevice m_device{ VK_NULL_HANDLE };
+        uint32_t m_workerCount{ 1 };
+        uint32_t m_currentFrameIndex{ 0 };
+
+        VkQueryPipelineStatisticFlags m_inheritedPipelineStatistics{ 0 };
+
+        // frame major, m_workerCount pools per frame
+        std::vector<WorkerPool>      m_workerPools;
+        std::vector<VkCommandBuffer> m_chunkBuffers;
+    };
+} // namespace Polaris
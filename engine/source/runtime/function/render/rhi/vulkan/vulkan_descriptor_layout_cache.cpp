@@ -0,0 +1,277 @@
+#include "runtime/function/render/rhi/vulkan/vulkan_descriptor_layout_cache.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace Polaris
+{
+    namespace
+    {
+        void hashCombine(size_t& seed, uint64_t value)
+        {
+            seed ^= std::hash<uint64_t>()(value) + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+        }
+    } // namespace
+
+    bool VulkanDescriptorLayoutCache::SetLayoutDesc::operator==(const SetLayoutDesc& other) const
+    {
+        if (flags != other.flags || bindingFlags != other.bindingFlags || bindings.size() != other.bindings.size())
+        {
+            return false;
+        }
+        for (size_t i = 0; i < bindings.size(); ++i)
+        {
+            const VkDescriptorSetLayoutBinding& lhs = bindings[i];
+            const VkDescriptorSetLayoutBinding& rhs = other.bindings[i];
+            if (lhs.binding != rhs.binding || lhs.descriptorType != rhs.descriptorType || lhs.descriptorCount != rhs.descriptorCount ||
+                lhs.stageFlags != rhs.stageFlags || lhs.pImmutableSamplers != rhs.pImmutableSamplers)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool VulkanDescriptorLayoutCache::PipelineLayoutKey::operator==(const PipelineLayoutKey& other) const
+    {
+        if (setLayouts != other.setLayouts || pushConstantRanges.size() != other.pushConstantRanges.size())
+        {
+            return false;
+        }
+        for (size_t i = 0; i < pushConstantRanges.size(); ++i)
+        {
+            const VkPushConstantRange& lhs = pushConstantRanges[i];
+            const VkPushConstantRange& rhs = other.pushConstantRanges[i];
+            if (lhs.stageFlags != rhs.stageFlags || lhs.offset != rhs.offset || lhs.size != rhs.size)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    size_t VulkanDescriptorLayoutCache::KeyHash::operator()(const SetLayoutDesc& desc) const
+    {
+        size_t seed = desc.bindings.size();
+        hashCombine(seed, desc.flags);
+        for (const VkDescriptorSetLayoutBinding& binding : desc.bindings)
+        {
+            hashCombine(seed, (static_cast<uint64_t>(binding.binding) << 32) | binding.descriptorType);
+            hashCombine(seed, (static_cast<uint64_t>(binding.descriptorCount) << 32) | binding.stageFlags);
+            hashCombine(seed, reinterpret_cast<uintptr_t>(binding.pImmutableSamplers));
+        }
+        for (VkDescriptorBindingFlags bindingFlags : desc.bindingFlags)
+        {
+            hashCombine(seed, bindingFlags);
+        }
+        return seed;
+    }
+
+    size_t VulkanDescriptorLayoutCache::KeyHash::operator()(const PipelineLayoutKey& key) const
+    {
+        size_t seed = key.setLayouts.size();
+        for (VkDescriptorSetLayout setLayout : key.setLayouts)
+        {
+            hashCombine(seed, reinterpret_cast<uint64_t>(setLayout));
+        }
+        for (const VkPushConstantRange& range : key.pushConstantRanges)
+        {
+            hashCombine(seed, range.stageFlags);
+            hashCombine(seed, (static_cast<uint64_t>(range.offset) << 32) | range.size);
+        }
+        return seed;
+    }
+
+    void VulkanDescriptorLayoutCache::initialize(VkDevice device) { m_device = device; }
+
+    void VulkanDescriptorLayoutCache::clear()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const auto& [key, pipelineLayout] : m_pipelineLayouts)
+        {
+            vkDestroyPipelineLayout(m_device, pipelineLayout, nullptr);
+        }
+        for (const auto& [desc, setLayout] : m_setLayouts)
+        {
+            vkDestroyDescriptorSetLayout(m_device, setLayout, nullptr);
+        }
+        m_pipelineLayouts.clear();
+        m_setLayouts.clear();
+    }
+
+    VkDescriptorSetLayout VulkanDescriptorLayoutCache::getSetLayout(const SetLayoutDesc& desc)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return getSetLayoutLocked(desc);
+    }
+
+    VkPipelineLayout VulkanDescriptorLayoutCache::getPipelineLayout(const std::vector<VkDescriptorSetLayout>& setLayouts,
+                                                                    const std::vector<VkPushConstantRange>&   pushConstantRanges)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return getPipelineLayoutLocked({ setLayouts, pushConstantRanges });
+    }
+
+    VkPipelineLayout VulkanDescriptorLayoutCache::getPipelineLayout(std::initializer_list<const VulkanShaderStageLayout*> stages,
+                                                                    uint32_t runtimeArrayCount)
+    {
+        const std::vector<SetLayoutDesc> setDescs = mergeSetLayouts(stages, runtimeArrayCount);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        PipelineLayoutKey           key;
+        for (const SetLayoutDesc& setDesc : setDescs)
+        {
+            key.setLayouts.push_back(getSetLayoutLocked(setDesc));
+        }
+        key.pushConstantRanges = mergePushConstantRanges(stages);
+        return getPipelineLayoutLocked(key);
+    }
+
+    std::vector<VulkanDescriptorLayoutCache::SetLayoutDesc>
+    VulkanDescriptorLayoutCache::mergeSetLayouts(std::initializer_list<const VulkanShaderStageLayout*> stages, uint32_t runtimeArrayCount)
+    {
+        std::vector<SetLayoutDesc> setDescs;
+        for (const VulkanShaderStageLayout* stage : stages)
+        {
+            for (uint32_t i = 0; i < stage->descriptorBindingCount; ++i)
+            {
+                const VulkanShaderDescriptorBinding& shaderBinding = stage->descriptorBindings[i];
+                if (shaderBinding.set >= setDescs.size())
+                {
+                    setDescs.resize(shaderBinding.set + 1);
+                }
+                SetLayoutDesc& setDesc = setDescs[shaderBinding.set];
+
+                const bool     isRuntimeArray  = shaderBinding.descriptorCount == 0;
+                const uint32_t descriptorCount = isRuntimeArray ? runtimeArrayCount : shaderBinding.descriptorCount;
+
+                auto bindingIter = std::find_if(setDesc.bindings.begin(), setDesc.bindings.end(), [&](const VkDescriptorSetLayoutBinding& binding) {
+                    return binding.binding == shaderBinding.binding;
+                });
+                if (bindingIter != setDesc.bindings.end())
+                {
+                    if (bindingIter->descriptorType != shaderBinding.descriptorType || bindingIter->descriptorCount != descriptorCount)
+                    {
+                        throw std::runtime_error("failed to merge shader layouts, stages disagree on a binding!");
+                    }
+                    bindingIter->stageFlags |= stage->stage;
+                    continue;
+                }
+
+                VkDescriptorSetLayoutBinding binding{};
+                binding.binding         = shaderBinding.binding;
+                binding.descriptorType  = shaderBinding.descriptorType;
+                binding.descriptorCount = descriptorCount;
+                binding.stageFlags      = stage->stage;
+                setDesc.bindings.push_back(binding);
+                setDesc.bindingFlags.push_back(isRuntimeArray ? VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT : 0);
+            }
+        }
+
+        // sorted bindings make equal sets equal keys, flags are only kept when some binding needs them
+        for (SetLayoutDesc& setDesc : setDescs)
+        {
+            std::vector<size_t> order(setDesc.bindings.size());
+            for (size_t i = 0; i < order.size(); ++i)
+            {
+                order[i] = i;
+            }
+            std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return setDesc.bindings[a].binding < setDesc.bindings[b].binding; });
+
+            SetLayoutDesc sortedDesc;
+            for (size_t index : order)
+            {
+                sortedDesc.bindings.push_back(setDesc.bindings[index]);
+                sortedDesc.bindingFlags.push_back(setDesc.bindingFlags[index]);
+            }
+            if (std::all_of(sortedDesc.bindingFlags.begin(), sortedDesc.bindingFlags.end(), [](VkDescriptorBindingFlags flags) { return flags == 0; }))
+            {
+                sortedDesc.bindingFlags.clear();
+            }
+            setDesc = std::move(sortedDesc);
+        }
+        return setDescs;
+    }
+
+    std::vector<VkPushConstantRange> VulkanDescriptorLayoutCache::mergePushConstantRanges(std::initializer_list<const VulkanShaderStageLayout*> stages)
+    {
+        std::vector<VkPushConstantRange> ranges;
+        for (const VulkanShaderStageLayout* stage : stages)
+        {
+            for (uint32_t i = 0; i < stage->pushConstantRangeCount; ++i)
+            {
+                const VkPushConstantRange& stageRange = stage->pushConstantRanges[i];
+
+                auto rangeIter = std::find_if(ranges.begin(), ranges.end(), [&](const VkPushConstantRange& range) {
+                    return range.offset == stageRange.offset && range.size == stageRange.size;
+                });
+                if (rangeIter != ranges.end())
+                {
+                    rangeIter->stageFlags |= stage->stage;
+                }
+                else
+                {
+                    ranges.push_back({ static_cast<VkShaderStageFlags>(stage->stage), stageRange.offset, stageRange.size });
+                }
+            }
+        }
+        return ranges;
+    }
+
+    VkDescriptorSetLayout VulkanDescriptorLayoutCache::getSetLayoutLocked(const SetLayoutDesc& desc)
+    {
+        auto setLayoutIter = m_setLayouts.find(desc);
+        if (setLayoutIter != m_setLayouts.end())
+        {
+            ++m_hitCount;
+            return setLayoutIter->second;
+        }
+        ++m_missCount;
+
+        VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo{};
+        bindingFlagsInfo.sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+        bindingFlagsInfo.bindingCount  = static_cast<uint32_t>(desc.bindingFlags.size());
+        bindingFlagsInfo.pBindingFlags = desc.bindingFlags.data();
+
+        VkDescriptorSetLayoutCreateInfo createInfo{};
+        createInfo.sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        createInfo.pNext        = desc.bindingFlags.empty() ? nullptr : &bindingFlagsInfo;
+        createInfo.flags        = desc.flags;
+        createInfo.bindingCount = static_cast<uint32_t>(desc.bindings.size());
+        createInfo.pBindings    = desc.bindings.data();
+
+        VkDescriptorSetLayout setLayout = VK_NULL_HANDLE;
+        if (vkCreateDescriptorSetLayout(m_device, &createInfo, nullptr, &setLayout) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create descriptor set layout!");
+        }
+        m_setLayouts.emplace(desc, setLayout);
+        return setLayout;
+    }
+
+    VkPipelineLayout VulkanDescriptorLayoutCache::getPipelineLayoutLocked(const PipelineLayoutKey& key)
+    {
+        auto pipelineLayoutIter = m_pipelineLayouts.find(key);
+        if (pipelineLayoutIter != m_pipelineLayouts.end())
+        {
+            ++m_hitCount;
+            return pipelineLayoutIter->second;
+        }
+        ++m_missCount;
+
+        VkPipelineLayoutCreateInfo createInfo{};
+        createInfo.sType                  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        createInfo.setLayoutCount         = static_cast<uint32_t>(key.setLayouts.size());
+        createInfo.pSetLayouts            = key.setLayouts.data();
+        createInfo.pushConstantRangeCount = static_cast<uint32_t>(key.pushConstantRanges.size());
+        createInfo.pPushConstantRanges    = key.pushConstantRanges.data();
+
+        VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+        if (vkCreatePipelineLayout(m_device, &createInfo, nullptr, &pipelineLayout) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create pipeline layout!");
+        }
+        m_pipelineLayouts.emplace(key, pipelineLayout);
+        return pipelineLayout;
+    }
+} // namespace Polaris
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "runtime/function/render/rhi/vulkan/vulkan_shader_layout.h"
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <initializer_list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace Polaris
+{
+    /**
+     *  Descriptor set and pipeline layouts deduplicated by their contents, so shaders declaring the
+     *  same sets share one VkDescriptorSetLayout and pipelines with the same interface share one
+     *  VkPipelineLayout. Layouts can be built straight from the reflected stage layouts of a pipeline.
+     *  Thread safe, pipelines are created on worker threads during prewarms
+     */
+    class VulkanDescriptorLayoutCache
+    {
+    public:
+        struct SetLayoutDesc
+        {
+            VkDescriptorSetLayoutCreateFlags          flags{ 0 };
+            std::vector<VkDescriptorSetLayoutBinding> bindings;
+            // empty, or the flags of every binding
+            std::vector<VkDescriptorBindingFlags>     bindingFlags;
+
+            bool operator==(const SetLayoutDesc& other) const;
+        };
+
+        void initialize(VkDevice device);
+        void clear();
+
+        VkDescriptorSetLayout getSetLayout(const SetLayoutDesc& desc);
+        VkPipelineLayout      getPipelineLayout(const std::vector<VkDescriptorSetLayout>& setLayouts,
+                                                const std::vector<VkPushConstantRange>&   pushConstantRanges);
+
+        // runtime sized arrays get runtimeArrayCount descriptors and are partially bound
+        VkPipelineLayout getPipelineLayout(std::initializer_list<const VulkanShaderStageLayout*> stages,
+                                           uint32_t                                              runtimeArrayCount = 0);
+
+        // every set up to the highest one used, a binding used by several stages gets all their flags
+        static std::vector<SetLayoutDesc> mergeSetLayouts(std::initializer_list<const VulkanShaderStageLayout*> stages,
+                                                          uint32_t                                              runtimeArrayCount);
+        // stages with the same range share it, the others keep a range of their own
+        static std::vector<VkPushConstantRange> mergePushConstantRanges(std::initializer_list<const VulkanShaderStageLayout*> stages);
+
+        uint64_t getHitCount() const { return m_hitCount; }
+        uint64_t getMissCount() const { return m_missCount; }
+
+    private:
+        struct PipelineLayoutKey
+        {
+            std::vector<VkDescriptorSetLayout> setLayouts;
+            std::vector<VkPushConstantRange>   pushConstantRanges;
+
+            bool operator==(const PipelineLayoutKey& other) const;
+        };
+
+        struct KeyHash
+        {
+            size_t operator()(const SetLayoutDesc& desc) const;
+            size_t operator()(const PipelineLayoutKey& key) const;
+        };
+
+        VkDescriptorSetLayout getSetLayoutLocked(const SetLayoutDesc& desc);
+        VkPipelineLayout      getPipelineLayoutLocked(const PipelineLayoutKey& key);
+
+    private:
+        VkDevice m_device{ VK_NULL_HANDLE };
+
+        std::mutex                                                        m_mutex;
+        std::unordered_map<SetLayoutDesc, VkDescriptorSetLayout, KeyHash> m_setLayouts;
+        std::unordered_map<PipelineLayoutKey, VkPipelineLayout, KeyHash>  m_pipelineLayouts;
+        uint64_t                                                          m_hitCount{ 0 };
+        uint64_t                                                          m_missCount{ 0 };
+    };
+} // namespace Polaris
@@ -0,0 +1,370 @@
+#include "runtime/function/render/rhi/vulkan/vulkan_gpu_profiler.h"
+
+#include "runtime/core/profiler/profiler.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#endif
+
+namespace Polaris
+{
+    namespace
+    {
+        // std::chrono::steady_clock reads QueryPerformanceCounter on windows and CLOCK_MONOTONIC elsewhere
+#if defined(_WIN32)
+        constexpr VkTimeDomainEXT k_steadyClockTimeDomain = VK_TIME_DOMAIN_QUERY_PERFORMANCE_COUNTER_EXT;
+#else
+        constexpr VkTimeDomainEXT k_steadyClockTimeDomain = VK_TIME_DOMAIN_CLOCK_MONOTONIC_EXT;
+#endif
+
+        constexpr uint32_t k_pipelineStatisticCount = 6;
+    } // namespace
+
+    void VulkanGpuProfiler::initialize(const InitInfo& initInfo)
+    {
+        m_device       = initInfo.device;
+        m_maxZoneCount = initInfo.maxZoneCount;
+
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(initInfo.physicalDevice, &properties);
+
+        uint32_t queueFamilyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(initInfo.physicalDevice, &queueFamilyCount, nullptr);
+        std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(initInfo.physicalDevice, &queueFamilyCount, queueFamilies.data());
+
+        const uint32_t validBits = queueFamilies[initInfo.queueFamilyIndex].timestampValidBits;
+        if (validBits == 0 || properties.limits.timestampPeriod == 0.0f)
+        {
+            return;
+        }
+        m_timestampMask          = validBits >= 64 ? UINT64_MAX : (1ull << validBits) - 1;
+        m_timestampPeriod        = properties.limits.timestampPeriod;
+        m_statisticsPoolsEnabled = initInfo.enablePipelineStatistics;
+
+        if (initInfo.enableCalibratedTimestamps)
+        {
+            auto pfnGetTimeDomains = reinterpret_cast<PFN_vkGetPhysicalDeviceCalibrateableTimeDomainsEXT>(
+                vkGetInstanceProcAddr(initInfo.instance, "vkGetPhysicalDeviceCalibrateableTimeDomainsEXT"));
+            m_pfnGetCalibratedTimestamps =
+                reinterpret_cast<PFN_vkGetCalibratedTimestampsEXT>(vkGetDeviceProcAddr(m_device, "vkGetCalibratedTimestampsEXT"));
+
+            uint32_t timeDomainCount = 0;
+            if (pfnGetTimeDomains && m_pfnGetCalibratedTimestamps)
+            {
+                pfnGetTimeDomains(initInfo.physicalDevice, &timeDomainCount, nullptr);
+            }
+            std::vector<VkTimeDomainEXT> timeDomains(timeDomainCount);
+            if (timeDomainCount > 0)
+            {
+                pfnGetTimeDomains(initInfo.physicalDevice, &timeDomainCount, timeDomains.data());
+            }
+
+            const bool hasDevice = std::find(timeDomains.begin(), timeDomains.end(), VK_TIME_DOMAIN_DEVICE_EXT) != timeDomains.end();
+            const bool hasHost   = std::find(timeDomains.begin(), timeDomains.end(), k_steadyClockTimeDomain) != timeDomains.end();
+            if (hasDevice && hasHost)
+            {
+                m_hostTimeDomain = k_steadyClockTimeDomain;
+#if defined(_WIN32)
+                LARGE_INTEGER frequency;
+                QueryPerformanceFrequency(&frequency);
+                m_hostTicksPerSecond = static_cast<uint64_t>(frequency.QuadPart);
+#endif
+            }
+        }
+
+        m_frames.resize(initInfo.frameCount);
+        for (FrameQueries& frame : m_frames)
+        {
+            VkQueryPoolCreateInfo timestampInfo{};
+            timestampInfo.sType      = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+            timestampInfo.queryType  = VK_QUERY_TYPE_TIMESTAMP;
+            timestampInfo.queryCount = m_maxZoneCount * 2;
+            if (vkCreateQueryPool(m_device, &timestampInfo, nullptr, &frame.timestampPool) != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to create timestamp query pool!");
+            }
+
+            if (m_statisticsPoolsEnabled)
+            {
+                VkQueryPoolCreateInfo statisticsInfo{};
+                statisticsInfo.sType              = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+                statisticsInfo.queryType          = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+                statisticsInfo.queryCount         = m_maxZoneCount;
+                statisticsInfo.pipelineStatistics = k_pipelineStatisticFlags;
+                if (vkCreateQueryPool(m_device, &statisticsInfo, nullptr, &frame.statisticsPool) != VK_SUCCESS)
+                {
+                    throw std::runtime_error("failed to create pipeline statistics query pool!");
+                }
+            }
+        }
+
+        m_track = &Profiler::getInstance().createTrack(initInfo.trackName);
+    }
+
+    void VulkanGpuProfiler::clear()
+    {
+        for (FrameQueries& frame : m_frames)
+        {
+            vkDestroyQueryPool(m_device, frame.timestampPool, nullptr);
+            vkDestroyQueryPool(m_device, frame.statisticsPool, nullptr);
+        }
+        m_frames.clear();
+        m_currentFrame = nullptr;
+        m_lastFrameZones.clear();
+    }
+
+    void VulkanGpuProfiler::beginFrame(VkCommandBuffer commandBuffer, uint32_t frameIndex)
+    {
+        m_currentFrame = nullptr;
+        if (!isSupported())
+        {
+            return;
+        }
+
+        FrameQueries& frame = m_frames[frameIndex];
+        resolveFrame(frame);
+
+        frame.zones.clear();
+        frame.timestampCount  = 0;
+        frame.statisticsCount = 0;
+        m_openZones.clear();
+        m_statisticsActive = false;
+        if (!Profiler::getInstance().isEnabled())
+        {
+            return;
+        }
+
+        vkCmdResetQueryPool(commandBuffer, frame.timestampPool, 0, m_maxZoneCount * 2);
+        if (frame.statisticsPool != VK_NULL_HANDLE)
+        {
+            vkCmdResetQueryPool(commandBuffer, frame.statisticsPool, 0, m_maxZoneCount);
+        }
+
+        m_currentFrame = &frame;
+        beginZone(commandBuffer, "Frame", false);
+    }
+
+    void VulkanGpuProfiler::endFrame(VkCommandBuffer commandBuffer)
+    {
+        if (m_currentFrame == nullptr)
+        {
+            return;
+        }
+
+        // zones left open by the passes are closed with the frame
+        while (!m_openZones.empty())
+        {
+            endZone(commandBuffer);
+        }
+        m_currentFrame->submitNs = Profiler::getInstance().now();
+        m_currentFrame           = nullptr;
+    }
+
+    void VulkanGpuProfiler::beginZone(VkCommandBuffer commandBuffer, const std::string& name, bool withPipelineStatistics)
+    {
+        if (m_currentFrame == nullptr)
+        {
+            return;
+        }
+
+        FrameQueries& frame = *m_currentFrame;
+        if (frame.zones.size() == m_maxZoneCount)
+        {
+            m_openZones.push_back(UINT32_MAX);
+            return;
+        }
+
+        Zone zone;
+        zone.name       = getZoneName(name);
+        zone.depth      = static_cast<uint32_t>(m_openZones.size());
+        zone.beginQuery = frame.timestampCount++;
+        zone.endQuery   = frame.timestampCount++;
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, frame.timestampPool, zone.beginQuery);
+
+        if (withPipelineStatistics && frame.statisticsPool != VK_NULL_HANDLE && !m_statisticsActive)
+        {
+            zone.statisticsQuery = frame.statisticsCount++;
+            vkCmdBeginQuery(commandBuffer, frame.statisticsPool, zone.statisticsQuery, 0);
+            m_statisticsActive = true;
+        }
+
+        m_openZones.push_back(static_cast<uint32_t>(frame.zones.size()));
+        frame.zones.push_back(zone);
+    }
+
+    void VulkanGpuProfiler::endZone(VkCommandBuffer commandBuffer)
+    {
+        if (m_currentFrame == nullptr || m_openZones.empty())
+        {
+            return;
+        }
+
+        const uint32_t zoneIndex = m_openZones.back();
+        m_openZones.pop_back();
+        if (zoneIndex == UINT32_MAX)
+        {
+            return;
+        }
+
+        FrameQueries& frame = *m_currentFrame;
+        const Zone&   zone  = frame.zones[zoneIndex];
+        if (zone.statisticsQuery != UINT32_MAX)
+        {
+            vkCmdEndQuery(commandBuffer, frame.statisticsPool, zone.statisticsQuery);
+            m_statisticsActive = false;
+        }
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, frame.timestampPool, zone.endQuery);
+    }
+
+    /*
+    * Results are read without waiting, a query that is not available drops its zone
+    */
+    void VulkanGpuProfiler::resolveFrame(FrameQueries& frame)
+    {
+        if (frame.zones.empty())
+        {
+            return;
+        }
+
+        // value and availability of every query
+        std::vector<uint64_t> timestamps(frame.timestampCount * 2);
+        vkGetQueryPoolResults(m_device,
+                              frame.timestampPool,
+                              0,
+                              frame.timestampCount,
+                              timestamps.size() * sizeof(uint64_t),
+                              timestamps.data(),
+                              2 * sizeof(uint64_t),
+                              VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+
+        std::vector<uint64_t> statistics((k_pipelineStatisticCount + 1) * frame.statisticsCount);
+        if (frame.statisticsCount > 0)
+        {
+            vkGetQueryPoolResults(m_device,
+                                  frame.statisticsPool,
+                                  0,
+                                  frame.statisticsCount,
+                                  statistics.size() * sizeof(uint64_t),
+                                  statistics.data(),
+                                  (k_pipelineStatisticCount + 1) * sizeof(uint64_t),
+                                  VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+        }
+
+        // the frame zone opens first, the rest of the submission cannot be done without it
+        if (timestamps[1] == 0)
+        {
+            return;
+        }
+
+        // without calibration the frame zone is taken to start at the submission
+        uint64_t anchorTimestamp     = timestamps[0] & m_timestampMask;
+        uint64_t anchorNs            = frame.submitNs;
+        uint64_t calibratedTimestamp = 0;
+        uint64_t calibratedNs        = 0;
+        if (isCalibrated() && calibrate(calibratedTimestamp, calibratedNs))
+        {
+            anchorTimestamp = calibratedTimestamp;
+            anchorNs        = calibratedNs;
+        }
+        auto toProfilerTime = [&](uint64_t timestamp) -> uint64_t {
+            // the difference wraps with the valid bits and may be negative
+            uint64_t delta = (timestamp - anchorTimestamp) & m_timestampMask;
+            double   ticks = static_cast<double>(delta);
+            if (delta > (m_timestampMask >> 1))
+            {
+                ticks = -static_cast<double>((anchorTimestamp - timestamp) & m_timestampMask);
+            }
+            const double ns = static_cast<double>(anchorNs) + ticks * m_timestampPeriod;
+            return ns > 0.0 ? static_cast<uint64_t>(ns) : 0;
+        };
+
+        m_lastFrameZones.clear();
+        for (const Zone& zone : frame.zones)
+        {
+            const uint64_t* begin = &timestamps[zone.beginQuery * 2];
+            const uint64_t* end   = &timestamps[zone.endQuery * 2];
+            if (begin[1] == 0 || end[1] == 0)
+            {
+                continue;
+            }
+
+            ZoneResult result;
+            result.name    = zone.name;
+            result.depth   = zone.depth;
+            result.beginNs = toProfilerTime(begin[0] & m_timestampMask);
+            result.endNs   = std::max(result.beginNs, toProfilerTime(end[0] & m_timestampMask));
+
+            if (zone.statisticsQuery != UINT32_MAX)
+            {
+                const uint64_t* counters = &statistics[zone.statisticsQuery * (k_pipelineStatisticCount + 1)];
+                if (counters[k_pipelineStatisticCount] != 0)
+                {
+                    result.hasPipelineStatistics                        = true;
+                    result.pipelineStatistics.inputAssemblyVertices     = counters[0];
+                    result.pipelineStatistics.inputAssemblyPrimitives   = counters[1];
+                    result.pipelineStatistics.vertexShaderInvocations   = counters[2];
+                    result.pipelineStatistics.clippingPrimitives        = counters[3];
+                    result.pipelineStatistics.fragmentShaderInvocations = counters[4];
+                    result.pipelineStatistics.computeShaderInvocations  = counters[5];
+                }
+            }
+            m_lastFrameZones.push_back(result);
+
+            ProfileZoneEvent zoneEvent;
+            zoneEvent.m_name     = result.name;
+            zoneEvent.m_begin_ns = result.beginNs;
+            zoneEvent.m_end_ns   = result.endNs;
+            zoneEvent.m_depth    = result.depth;
+            m_track->push(zoneEvent);
+        }
+    }
+
+    bool VulkanGpuProfiler::calibrate(uint64_t& outDeviceTimestamp, uint64_t& outHostNs) const
+    {
+        VkCalibratedTimestampInfoEXT timestampInfos[2]{};
+        timestampInfos[0].sType      = VK_STRUCTURE_TYPE_CALIBRATED_TIMESTAMP_INFO_EXT;
+        timestampInfos[0].timeDomain = VK_TIME_DOMAIN_DEVICE_EXT;
+        timestampInfos[1].sType      = VK_STRUCTURE_TYPE_CALIBRATED_TIMESTAMP_INFO_EXT;
+        timestampInfos[1].timeDomain = m_hostTimeDomain;
+
+        uint64_t timestamps[2]{};
+        uint64_t maxDeviation = 0;
+        if (m_pfnGetCalibratedTimestamps(m_device, 2, timestampInfos, timestamps, &maxDeviation) != VK_SUCCESS)
+        {
+            return false;
+        }
+
+        outDeviceTimestamp = timestamps[0] & m_timestampMask;
+        outHostNs          = Profiler::getInstance().fromSteadyClock(hostTimestampToSteadyClock(timestamps[1]));
+        return true;
+    }
+
+    uint64_t VulkanGpuProfiler::hostTimestampToSteadyClock(uint64_t hostTimestamp) const
+    {
+        // split so the multiplication does not overflow for large tick counts
+        const uint64_t seconds = hostTimestamp / m_hostTicksPerSecond;
+        const uint64_t ticks   = hostTimestamp % m_hostTicksPerSecond;
+        return seconds * 1000000000ull + ticks * 1000000000ull / m_hostTicksPerSecond;
+    }
+
+    const char* VulkanGpuProfiler::getZoneName(const std::string& name)
+    {
+        // prefixed so gpu and cpu zones of the same name keep separate stats
+        auto nameIter = m_zoneNames.find(name);
+        if (nameIter == m_zoneNames.end())
+        {
+            nameIter = m_zoneNames.emplace(name, Profiler::getInstance().internName("GPU " + name)).first;
+        }
+        return nameIter->second;
+    }
+} // namespace Polaris
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Polaris
+{
+    class ProfileThreadBuffer;
+
+    /**
+     *  GPU zones of one queue measured with timestamp queries, and optionally pipeline statistics
+     *  queries. Every frame in flight owns its query pools, which are read back when the frame slot
+     *  comes around again, so results are a few frames old but never waited for. Resolved zones are
+     *  converted to profiler time and pushed to a track of their own, next to the CPU zones in
+     *  captures and zone stats. With VK_EXT_calibrated_timestamps the two clocks are sampled
+     *  together, without it a frame is aligned to the CPU time of its submission
+     */
+    class VulkanGpuProfiler
+    {
+    public:
+        struct InitInfo
+        {
+            VkInstance       instance{ VK_NULL_HANDLE };
+            VkPhysicalDevice physicalDevice{ VK_NULL_HANDLE };
+            VkDevice         device{ VK_NULL_HANDLE };
+            uint32_t         queueFamilyIndex{ 0 };
+            uint32_t         frameCount{ 1 };
+            uint32_t         maxZoneCount{ 256 };
+            // the device has to be created with pipelineStatisticsQuery
+            bool             enablePipelineStatistics{ false };
+            // the device has to be created with VK_EXT_calibrated_timestamps
+            bool             enableCalibratedTimestamps{ false };
+            std::string      trackName{ "GPU" };
+        };
+
+        // counters of the pipeline statistic flags, in the order of their bits
+        struct PipelineStatistics
+        {
+            uint64_t inputAssemblyVertices{ 0 };
+            uint64_t inputAssemblyPrimitives{ 0 };
+            uint64_t vertexShaderInvocations{ 0 };
+            uint64_t clippingPrimitives{ 0 };
+            uint64_t fragmentShaderInvocations{ 0 };
+            uint64_t computeShaderInvocations{ 0 };
+        };
+
+        struct ZoneResult
+        {
+            const char*        name{ nullptr };
+            uint32_t           depth{ 0 };
+            // profiler time
+            uint64_t           beginNs{ 0 };
+            uint64_t           endNs{ 0 };
+            bool               hasPipelineStatistics{ false };
+            PipelineStatistics pipelineStatistics;
+        };
+
+        static constexpr VkQueryPipelineStatisticFlags k_pipelineStatisticFlags =
+            VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_VERTICES_BIT | VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT |
+            VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT | VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT |
+            VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT | VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT;
+
+        void initialize(const InitInfo& initInfo);
+        void clear();
+
+        // false when the queue family has no timestamps, every call is a no op then
+        bool isSupported() const { return m_timestampMask != 0; }
+        bool isPipelineStatisticsEnabled() const { return m_statisticsPoolsEnabled; }
+        bool isCalibrated() const { return m_hostTimeDomain != VK_TIME_DOMAIN_DEVICE_EXT; }
+
+        /**
+         *  Resolves what frameIndex recorded last time, its submission has to be complete, then resets
+         *  its pools and opens the frame zone. Recorded at the start of the frame command buffer,
+         *  outside of any render pass
+         */
+        void beginFrame(VkCommandBuffer commandBuffer, uint32_t frameIndex);
+        // closes the frame zone, call right before the submission
+        void endFrame(VkCommandBuffer commandBuffer);
+
+        /**
+         *  Zones nest and have to be closed in the command buffer they were opened in. Pipeline
+         *  statistics queries of one type cannot nest, only the outermost zone asking for them gets
+         *  them. Both ends of a zone with statistics have to be outside of a render pass, or inside
+         *  the same subpass
+         */
+        void beginZone(VkCommandBuffer commandBuffer, const std::string& name, bool withPipelineStatistics = true);
+        void endZone(VkCommandBuffer commandBuffer);
+
+        // zones of the last resolved frame, outermost first
+        const std::vector<ZoneResult>& getLastFrameZones() const { return m_lastFrameZones; }
+
+    private:
+        struct Zone
+        {
+            const char* name{ nullptr };
+            uint32_t    depth{ 0 };
+            uint32_t    beginQuery{ 0 };
+            uint32_t    endQuery{ 0 };
+            // UINT32_MAX without statistics
+            uint32_t    statisticsQuery{ UINT32_MAX };
+        };
+
+        struct FrameQueries
+        {
+            VkQueryPool       timestampPool{ VK_NULL_HANDLE };
+            VkQueryPool       statisticsPool{ VK_NULL_HANDLE };
+            std::vector<Zone> zones;
+            uint32_t          timestampCount{ 0 };
+            uint32_t          statisticsCount{ 0 };
+            // profiler time of the submission, anchors the zones when the clocks are not calibrated
+            uint64_t          submitNs{ 0 };
+        };
+
+        void resolveFrame(FrameQueries& frame);
+        // a device timestamp and the profiler time it was taken at
+        bool calibrate(uint64_t& outDeviceTimestamp, uint64_t& outHostNs) const;
+        uint64_t hostTimestampToSteadyClock(uint64_t hostTimestamp) const;
+        const char* getZoneName(const std::string& name);
+
+    private:
+        VkDevice m_device{ VK_NULL_HANDLE };
+        uint32_t m_maxZoneCount{ 0 };
+        bool     m_statisticsPoolsEnabled{ false };
+
+        // nanoseconds per tick, and the bits of a timestamp that are valid
+        double   m_timestampPeriod{ 1.0 };
+        uint64_t m_timestampMask{ 0 };
+
+        // VK_TIME_DOMAIN_DEVICE_EXT when the host clock cannot be sampled with the device one
+        VkTimeDomainEXT                  m_hostTimeDomain{ VK_TIME_DOMAIN_DEVICE_EXT };
+        PFN_vkGetCalibratedTimestampsEXT m_pfnGetCalibratedTimestamps{ nullptr };
+        uint64_t                         m_hostTicksPerSecond{ 1000000000ull };
+
+        std::vector<FrameQueries> m_frames;
+        FrameQueries*             m_currentFrame{ nullptr };
+        // zones still open, UINT32_MAX for zones dropped because the pool was full
+        std::vector<uint32_t>     m_openZones;
+        bool                      m_statisticsActive{ false };
+
+        ProfileThreadBuffer*                         m_track{ nullptr };
+        std::unordered_map<std::string, const char*> m_zoneNames;
+        std::vector<ZoneResult>                      m_lastFrameZones;
+    };
+} // namespace Polaris
@@ -0,0 +1,216 @@
+#include "runtime/function/render/rhi/vulkan/vulkan_pipeline_cache.h"
+
+#include "runtime/core/base/macro.h"
+#include "runtime/core/base/thread_pool.h"
+#include "runtime/core/profiler/profiler.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+namespace Polaris
+{
+    namespace
+    {
+        constexpr uint32_t k_file_magic   = 0x43504C50; // "PLPC"
+        constexpr uint32_t k_file_version = 1;
+
+        struct FileHeader
+        {
+            uint32_t                    magic{ k_file_magic };
+            uint32_t                    version{ k_file_version };
+            VulkanPipelineCacheIdentity identity;
+            uint64_t                    dataSize{ 0 };
+            uint64_t                    dataHash{ 0 };
+        };
+
+        uint64_t hashData(const uint8_t* data, size_t size)
+        {
+            // FNV-1a, catches truncated and corrupted files
+            uint64_t hash = 14695981039346656037ull;
+            for (size_t i = 0; i < size; ++i)
+            {
+                hash = (hash ^ data[i]) * 1099511628211ull;
+            }
+            return hash;
+        }
+
+        bool isSameIdentity(const VulkanPipelineCacheIdentity& a, const VulkanPipelineCacheIdentity& b)
+        {
+            return a.vendorId == b.vendorId && a.deviceId == b.deviceId && a.driverVersion == b.driverVersion &&
+                   std::memcmp(a.deviceUuid, b.deviceUuid, VK_UUID_SIZE) == 0 &&
+                   std::memcmp(a.pipelineCacheUuid, b.pipelineCacheUuid, VK_UUID_SIZE) == 0;
+        }
+    } // namespace
+
+    void VulkanPipelineCache::initialize(VkPhysicalDevice physicalDevice, VkDevice device, const std::filesystem::path& filePath)
+    {
+        m_device   = device;
+        m_filePath = filePath;
+
+        VkPhysicalDeviceIDProperties idProperties{};
+        idProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ID_PROPERTIES;
+        VkPhysicalDeviceProperties2 properties{};
+        properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+        properties.pNext = &idProperties;
+        vkGetPhysicalDeviceProperties2(physicalDevice, &properties);
+
+        m_identity.vendorId      = properties.properties.vendorID;
+        m_identity.deviceId      = properties.properties.deviceID;
+        m_identity.driverVersion = properties.properties.driverVersion;
+        std::memcpy(m_identity.deviceUuid, idProperties.deviceUUID, VK_UUID_SIZE);
+        std::memcpy(m_identity.pipelineCacheUuid, properties.properties.pipelineCacheUUID, VK_UUID_SIZE);
+
+        std::vector<uint8_t> cacheData;
+        if (!m_filePath.empty())
+        {
+            std::ifstream file(m_filePath, std::ios::binary);
+            if (file)
+            {
+                const std::vector<uint8_t> fileData((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+                if (!parseFileData(m_identity, fileData, cacheData))
+                {
+                    LOG_INFO("pipeline cache {} was written for another device or driver, starting empty", m_filePath.generic_string());
+                }
+            }
+        }
+
+        VkPipelineCacheCreateInfo createInfo{};
+        createInfo.sType           = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+        createInfo.initialDataSize = cacheData.size();
+        createInfo.pInitialData    = cacheData.empty() ? nullptr : cacheData.data();
+        if (vkCreatePipelineCache(m_device, &createInfo, nullptr, &m_cache) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create pipeline cache!");
+        }
+    }
+
+    void VulkanPipelineCache::clear()
+    {
+        vkDestroyPipelineCache(m_device, m_cache, nullptr);
+        m_cache = VK_NULL_HANDLE;
+    }
+
+    bool VulkanPipelineCache::save() const
+    {
+        PROFILE_SCOPE("VulkanPipelineCache::save");
+
+        if (m_filePath.empty() || m_cache == VK_NULL_HANDLE)
+        {
+            return false;
+        }
+
+        size_t dataSize = 0;
+        vkGetPipelineCacheData(m_device, m_cache, &dataSize, nullptr);
+        std::vector<uint8_t> cacheData(dataSize);
+        if (vkGetPipelineCacheData(m_device, m_cache, &dataSize, cacheData.data()) != VK_SUCCESS)
+        {
+            return false;
+        }
+        cacheData.resize(dataSize);
+
+        const std::vector<uint8_t> fileData = makeFileData(m_identity, cacheData);
+
+        std::filesystem::path tempPath = m_filePath;
+        tempPath += ".tmp";
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            file.write(reinterpret_cast<const char*>(fileData.data()), static_cast<std::streamsize>(fileData.size()));
+            if (!file)
+            {
+                LOG_ERROR("failed to write pipeline cache {}", tempPath.generic_string());
+                return false;
+            }
+        }
+
+        std::error_code error;
+        std::filesystem::rename(tempPath, m_filePath, error);
+        return !error;
+    }
+
+    /*
+    * Share i builds every workerCount-th pipeline into cache i, the main cache is only
+    * touched by the merge after every share finished
+    */
+    std::vector<VkPipeline> VulkanPipelineCache::compileParallel(const std::vector<PipelineBuilder>& builders, uint32_t workerCount)
+    {
+        PROFILE_SCOPE("VulkanPipelineCache::compileParallel");
+
+        std::vector<VkPipeline> pipelines(builders.size(), VK_NULL_HANDLE);
+        if (builders.empty())
+        {
+            return pipelines;
+        }
+
+        const uint32_t actualWorkerCount = std::min(std::max(1u, workerCount), static_cast<uint32_t>(builders.size()));
+
+        VkPipelineCacheCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+
+        std::vector<VkPipelineCache> workerCaches(actualWorkerCount, VK_NULL_HANDLE);
+        for (VkPipelineCache& workerCache : workerCaches)
+        {
+            if (vkCreatePipelineCache(m_device, &createInfo, nullptr, &workerCache) != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to create worker pipeline cache!");
+            }
+        }
+
+        auto compileShare = [&](uint32_t workerIndex) {
+            for (size_t builderIndex = workerIndex; builderIndex < builders.size(); builderIndex += actualWorkerCount)
+            {
+                pipelines[builderIndex] = builders[builderIndex](workerCaches[workerIndex]);
+            }
+        };
+
+        ThreadPool::getInstance().parallelFor(actualWorkerCount, compileShare);
+
+        vkMergePipelineCaches(m_device, m_cache, actualWorkerCount, workerCaches.data());
+        for (VkPipelineCache workerCache : workerCaches)
+        {
+            vkDestroyPipelineCache(m_device, workerCache, nullptr);
+        }
+        return pipelines;
+    }
+
+    std::vector<uint8_t> VulkanPipelineCache::makeFileData(const VulkanPipelineCacheIdentity& identity, const std::vector<uint8_t>& cacheData)
+    {
+        FileHeader header;
+        header.identity = identity;
+        header.dataSize = cacheData.size();
+        header.dataHash = hashData(cacheData.data(), cacheData.size());
+
+        std::vector<uint8_t> fileData(sizeof(FileHeader) + cacheData.size());
+        std::memcpy(fileData.data(), &header, sizeof(FileHeader));
+        if (!cacheData.empty())
+        {
+            std::memcpy(fileData.data() + sizeof(FileHeader), cacheData.data(), cacheData.size());
+        }
+        return fileData;
+    }
+
+    bool VulkanPipelineCache::parseFileData(const VulkanPipelineCacheIdentity& identity,
+                                            const std::vector<uint8_t>&        fileData,
+                                            std::vector<uint8_t>&              outCacheData)
+    {
+        outCacheData.clear();
+        if (fileData.size() < sizeof(FileHeader))
+        {
+            return false;
+        }
+
+        FileHeader header;
+        std::memcpy(&header, fileData.data(), sizeof(FileHeader));
+        const uint8_t* data = fileData.data() + sizeof(FileHeader);
+        if (header.magic != k_file_magic || header.version != k_file_version || !isSameIdentity(header.identity, identity) ||
+            header.dataSize != fileData.size() - sizeof(FileHeader) || header.dataHash != hashData(data, header.dataSize))
+        {
+            return false;
+        }
+
+        outCacheData.assign(data, data + header.dataSize);
+        return true;
+    }
+} // namespace Polaris
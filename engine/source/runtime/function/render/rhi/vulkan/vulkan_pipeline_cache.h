@@ -0,0 +1,60 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <vector>
+
+namespace Polaris
+{
+    // what a cache file has to match to be handed to the driver
+    struct VulkanPipelineCacheIdentity
+    {
+        uint32_t vendorId{ 0 };
+        uint32_t deviceId{ 0 };
+        uint32_t driverVersion{ 0 };
+        uint8_t  deviceUuid[VK_UUID_SIZE]{};
+        uint8_t  pipelineCacheUuid[VK_UUID_SIZE]{};
+    };
+
+    /**
+     *  VkPipelineCache persisted between runs. The file starts with a header of its own holding the
+     *  device identity, driver version and a hash of the data, so a cache written by another GPU or
+     *  driver, or a truncated one, is dropped instead of being passed to the driver. Parallel
+     *  compiles go through one cache per worker, merged into the main cache once they are done
+     */
+    class VulkanPipelineCache
+    {
+    public:
+        using PipelineBuilder = std::function<VkPipeline(VkPipelineCache cache)>;
+
+        // an empty path keeps the cache in memory only
+        void initialize(VkPhysicalDevice physicalDevice, VkDevice device, const std::filesystem::path& filePath);
+        void clear();
+
+        // writes the cache next to the file and renames it over, so a crash never leaves half a file
+        bool save() const;
+
+        VkPipelineCache getCache() const { return m_cache; }
+
+        /**
+         *  Runs the builders on up to workerCount threads, the first share on the calling thread,
+         *  and returns the pipelines in builder order. Not thread safe against other uses of the cache
+         */
+        std::vector<VkPipeline> compileParallel(const std::vector<PipelineBuilder>& builders, uint32_t workerCount);
+
+        static std::vector<uint8_t> makeFileData(const VulkanPipelineCacheIdentity& identity, const std::vector<uint8_t>& cacheData);
+        // false when the file was written for another device or driver, or is damaged
+        static bool parseFileData(const VulkanPipelineCacheIdentity& identity,
+                                  const std::vector<uint8_t>&        fileData,
+                                  std::vector<uint8_t>&              outCacheData);
+
+    private:
+        VkDevice                    m_device{ VK_NULL_HANDLE };
+        VkPipelineCache             m_cache{ VK_NULL_HANDLE };
+        VulkanPipelineCacheIdentity m_identity;
+        std::filesystem::path       m_filePath;
+    };
+} // namespace Polaris
@@ -0,0 +1,383 @@
+#include "runtime/function/render/rhi/vulkan/vulkan_render_graph.h"
+
+#include "runtime/core/profiler/profiler.h"
+
+#include <stdexcept>
+
+namespace Polaris
+{
+    namespace
+    {
+        uint64_t mixHash(uint64_t hash, uint64_t value)
+        {
+            // fnv-1a over the 8 bytes of value
+            for (uint32_t byteIndex = 0; byteIndex < 8; ++byteIndex)
+            {
+                hash ^= (value >> (byteIndex * 8)) & 0xff;
+                hash *= 1099511628211ull;
+            }
+            return hash;
+        }
+
+        constexpr uint64_t k_hashSeed = 14695981039346656037ull;
+
+        VkImageAspectFlags getImageAspect(VkFormat format)
+        {
+            switch (format)
+            {
+                case VK_FORMAT_D16_UNORM:
+                case VK_FORMAT_D32_SFLOAT:
+                case VK_FORMAT_X8_D24_UNORM_PACK32:
+                    return VK_IMAGE_ASPECT_DEPTH_BIT;
+                case VK_FORMAT_D16_UNORM_S8_UINT:
+                case VK_FORMAT_D24_UNORM_S8_UINT:
+                case VK_FORMAT_D32_SFLOAT_S8_UINT:
+                    return VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+                default:
+                    return VK_IMAGE_ASPECT_COLOR_BIT;
+            }
+        }
+    } // namespace
+
+    void VulkanRenderGraphExecutor::initialize(VkDevice device, VmaAllocator allocator, uint32_t frameCount)
+    {
+        m_device    = device;
+        m_allocator = allocator;
+        m_frames.resize(frameCount);
+    }
+
+    /*
+    * The device has to be idle
+    */
+    void VulkanRenderGraphExecutor::clear()
+    {
+        for (FrameResources& frame : m_frames)
+        {
+            releaseResources(frame);
+        }
+        m_frames.clear();
+        m_memoryRequirementCache.clear();
+    }
+
+    /*
+    * Memory requirements only depend on the create info, so a throwaway object is created once per
+    * distinct description and usage
+    */
+    RenderGraphMemoryRequirements VulkanRenderGraphExecutor::getMemoryRequirements(const RenderGraph& graph, RenderGraphResource resource)
+    {
+        const uint64_t descriptionHash = computeDescriptionHash(graph, resource);
+        auto cachedRequirements = m_memoryRequirementCache.find(descriptionHash);
+        if (cachedRequirements != m_memoryRequirementCache.end())
+        {
+            return cachedRequirements->second;
+        }
+
+        VkMemoryRequirements memoryRequirements{};
+        if (graph.getResourceType(resource) == RenderGraphResourceType::image)
+        {
+            const VkImageCreateInfo imageInfo = makeImageCreateInfo(graph, resource);
+            VkImage image = VK_NULL_HANDLE;
+            if (vkCreateImage(m_device, &imageInfo, nullptr, &image) != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to create render graph image!");
+            }
+            vkGetImageMemoryRequirements(m_device, image, &memoryRequirements);
+            vkDestroyImage(m_device, image, nullptr);
+        }
+        else
+        {
+            const VkBufferCreateInfo bufferInfo = makeBufferCreateInfo(graph, resource);
+            VkBuffer buffer = VK_NULL_HANDLE;
+            if (vkCreateBuffer(m_device, &bufferInfo, nullptr, &buffer) != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to create render graph buffer!");
+            }
+            vkGetBufferMemoryRequirements(m_device, buffer, &memoryRequirements);
+            vkDestroyBuffer(m_device, buffer, nullptr);
+        }
+
+        RenderGraphMemoryRequirements requirements;
+        requirements.m_size             = memoryRequirements.size;
+        requirements.m_alignment        = memoryRequirements.alignment;
+        requirements.m_memory_type_bits = memoryRequirements.memoryTypeBits;
+        m_memoryRequirementCache.emplace(descriptionHash, requirements);
+        return requirements;
+    }
+
+    void VulkanRenderGraphExecutor::execute(const RenderGraph& graph, VkCommandBuffer commandBuffer, VulkanCommandRecorder& recorder,
+                                            VulkanGpuProfiler& gpuProfiler, uint32_t frameIndex)
+    {
+        PROFILE_SCOPE("VulkanRenderGraphExecutor::execute");
+
+        FrameResources& frame      = m_frames[frameIndex];
+        const uint64_t  layoutHash = computeLayoutHash(graph);
+        if (frame.layoutHash != layoutHash || frame.images.size() != graph.getResourceCount())
+        {
+            releaseResources(frame);
+            realizeResources(graph, frame);
+            frame.layoutHash = layoutHash;
+        }
+
+        // imported handles change every frame, the swapchain image for one
+        for (RenderGraphResource resource = 0; resource < graph.getResourceCount(); ++resource)
+        {
+            if (graph.isImported(resource))
+            {
+                frame.images[resource]     = graph.getImportedImage(resource);
+                frame.imageViews[resource] = graph.getImportedImageView(resource);
+                frame.buffers[resource]    = graph.getImportedBuffer(resource);
+            }
+        }
+
+        RenderGraphPassContext context(graph, commandBuffer, recorder, frame.images, frame.imageViews, frame.buffers);
+        for (RenderGraphPass pass : graph.getExecutionOrder())
+        {
+            recordBarriers(graph, frame, commandBuffer, graph.getPassBarriers(pass));
+            if (graph.getPassCallback(pass))
+            {
+                gpuProfiler.beginZone(commandBuffer, graph.getPassName(pass));
+                graph.getPassCallback(pass)(context);
+                gpuProfiler.endZone(commandBuffer);
+            }
+        }
+        recordBarriers(graph, frame, commandBuffer, graph.getFinalBarriers());
+    }
+
+    /*
+    * Barriers of one pass go into a single vkCmdPipelineBarrier with the union of their stages
+    */
+    void VulkanRenderGraphExecutor::recordBarriers(const RenderGraph& graph, const FrameResources& frame, VkCommandBuffer commandBuffer,
+                                                   const std::vector<RenderGraphBarrier>& barriers)
+    {
+        if (barriers.empty())
+        {
+            return;
+        }
+
+        m_imageBarriers.clear();
+        m_bufferBarriers.clear();
+        VkPipelineStageFlags srcStages = 0;
+        VkPipelineStageFlags dstStages = 0;
+        for (const RenderGraphBarrier& barrier : barriers)
+        {
+            srcStages |= barrier.m_src_stages;
+            dstStages |= barrier.m_dst_stages;
+
+            if (graph.getResourceType(barrier.m_resource) == RenderGraphResourceType::image)
+            {
+                const RenderGraphImageDesc& desc = graph.getImageDesc(barrier.m_resource);
+
+                VkImageMemoryBarrier imageBarrier{ VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER };
+                imageBarrier.srcAccessMask                   = barrier.m_src_access;
+                imageBarrier.dstAccessMask                   = barrier.m_dst_access;
+                imageBarrier.oldLayout                       = barrier.m_old_layout;
+                imageBarrier.newLayout                       = barrier.m_new_layout;
+                imageBarrier.srcQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
+                imageBarrier.dstQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
+                imageBarrier.image                           = frame.images[barrier.m_resource];
+                imageBarrier.subresourceRange.aspectMask     = getImageAspect(desc.m_format);
+                imageBarrier.subresourceRange.baseMipLevel   = 0;
+                imageBarrier.subresourceRange.levelCount     = VK_REMAINING_MIP_LEVELS;
+                imageBarrier.subresourceRange.baseArrayLayer = 0;
+                imageBarrier.subresourceRange.layerCount     = VK_REMAINING_ARRAY_LAYERS;
+                m_imageBarriers.push_back(imageBarrier);
+            }
+            else
+            {
+                VkBufferMemoryBarrier bufferBarrier{ VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER };
+                bufferBarrier.srcAccessMask       = barrier.m_src_access;
+                bufferBarrier.dstAccessMask       = barrier.m_dst_access;
+                bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                bufferBarrier.buffer              = frame.buffers[barrier.m_resource];
+                bufferBarrier.offset              = 0;
+                bufferBarrier.size                = VK_WHOLE_SIZE;
+                m_bufferBarriers.push_back(bufferBarrier);
+            }
+        }
+
+        vkCmdPipelineBarrier(commandBuffer,
+                             srcStages,
+                             dstStages,
+                             0,
+                             0,
+                             nullptr,
+                             static_cast<uint32_t>(m_bufferBarriers.size()),
+                             m_bufferBarriers.data(),
+                             static_cast<uint32_t>(m_imageBarriers.size()),
+                             m_imageBarriers.data());
+    }
+
+    void VulkanRenderGraphExecutor::realizeResources(const RenderGraph& graph, FrameResources& frame)
+    {
+        PROFILE_SCOPE("VulkanRenderGraphExecutor::realizeResources");
+
+        frame.images.assign(graph.getResourceCount(), VK_NULL_HANDLE);
+        frame.imageViews.assign(graph.getResourceCount(), VK_NULL_HANDLE);
+        frame.buffers.assign(graph.getResourceCount(), VK_NULL_HANDLE);
+
+        for (const RenderGraphHeap& heap : graph.getHeaps())
+        {
+            VkMemoryRequirements memoryRequirements{};
+            memoryRequirements.size           = heap.m_size;
+            memoryRequirements.alignment      = heap.m_alignment;
+            memoryRequirements.memoryTypeBits = heap.m_memory_type_bits;
+
+            VmaAllocationCreateInfo allocationInfo{};
+            allocationInfo.usage         = VMA_MEMORY_USAGE_GPU_ONLY;
+            allocationInfo.requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+
+            VmaAllocation allocation = VK_NULL_HANDLE;
+            if (vmaAllocateMemory(m_allocator, &memoryRequirements, &allocationInfo, &allocation, nullptr) != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to allocate render graph heap!");
+            }
+            frame.heaps.push_back(allocation);
+        }
+
+        for (RenderGraphResource resource = 0; resource < graph.getResourceCount(); ++resource)
+        {
+            if (graph.isImported(resource) || !graph.isResourceUsed(resource))
+            {
+                continue;
+            }
+
+            VmaAllocation heap   = frame.heaps[graph.getResourceHeap(resource)];
+            VkDeviceSize  offset = graph.getResourceOffset(resource);
+            if (graph.getResourceType(resource) == RenderGraphResourceType::image)
+            {
+                const VkImageCreateInfo imageInfo = makeImageCreateInfo(graph, resource);
+                VkImage image = VK_NULL_HANDLE;
+                if (vkCreateImage(m_device, &imageInfo, nullptr, &image) != VK_SUCCESS ||
+                    vmaBindImageMemory2(m_allocator, heap, offset, image, nullptr) != VK_SUCCESS)
+                {
+                    throw std::runtime_error("failed to create render graph image!");
+                }
+
+                VkImageViewCreateInfo viewInfo{ VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO };
+                viewInfo.image                           = image;
+                viewInfo.viewType                        = imageInfo.arrayLayers > 1 ? VK_IMAGE_VIEW_TYPE_2D_ARRAY : VK_IMAGE_VIEW_TYPE_2D;
+                viewInfo.format                          = imageInfo.format;
+                viewInfo.subresourceRange.aspectMask     = getImageAspect(imageInfo.format);
+                viewInfo.subresourceRange.baseMipLevel   = 0;
+                viewInfo.subresourceRange.levelCount     = imageInfo.mipLevels;
+                viewInfo.subresourceRange.baseArrayLayer = 0;
+                viewInfo.subresourceRange.layerCount     = imageInfo.arrayLayers;
+
+                VkImageView imageView = VK_NULL_HANDLE;
+                if (vkCreateImageView(m_device, &viewInfo, nullptr, &imageView) != VK_SUCCESS)
+                {
+                    throw std::runtime_error("failed to create render graph image view!");
+                }
+
+                frame.images[resource]     = image;
+                frame.imageViews[resource] = imageView;
+                frame.ownedImages.push_back(image);
+                frame.ownedImageViews.push_back(imageView);
+            }
+            else
+            {
+                const VkBufferCreateInfo bufferInfo = makeBufferCreateInfo(graph, resource);
+                VkBuffer buffer = VK_NULL_HANDLE;
+                if (vkCreateBuffer(m_device, &bufferInfo, nullptr, &buffer) != VK_SUCCESS ||
+                    vmaBindBufferMemory2(m_allocator, heap, offset, buffer, nullptr) != VK_SUCCESS)
+                {
+                    throw std::runtime_error("failed to create render graph buffer!");
+                }
+
+                frame.buffers[resource] = buffer;
+                frame.ownedBuffers.push_back(buffer);
+            }
+        }
+    }
+
+    void VulkanRenderGraphExecutor::releaseResources(FrameResources& frame)
+    {
+        for (VkImageView imageView : frame.ownedImageViews)
+        {
+            vkDestroyImageView(m_device, imageView, nullptr);
+        }
+        for (VkImage image : frame.ownedImages)
+        {
+            vkDestroyImage(m_device, image, nullptr);
+        }
+        for (VkBuffer buffer : frame.ownedBuffers)
+        {
+            vkDestroyBuffer(m_device, buffer, nullptr);
+        }
+        for (VmaAllocation heap : frame.heaps)
+        {
+            vmaFreeMemory(m_allocator, heap);
+        }
+
+        frame = FrameResources{};
+    }
+
+    VkImageCreateInfo VulkanRenderGraphExecutor::makeImageCreateInfo(const RenderGraph& graph, RenderGraphResource resource) const
+    {
+        const RenderGraphImageDesc& desc = graph.getImageDesc(resource);
+
+        VkImageCreateInfo imageInfo{ VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO };
+        imageInfo.imageType     = VK_IMAGE_TYPE_2D;
+        imageInfo.format        = desc.m_format;
+        imageInfo.extent        = { desc.m_width, desc.m_height, 1 };
+        imageInfo.mipLevels     = desc.m_mip_levels;
+        imageInfo.arrayLayers   = desc.m_array_layers;
+        imageInfo.samples       = desc.m_samples;
+        imageInfo.tiling        = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.usage         = graph.getImageUsage(resource);
+        imageInfo.sharingMode   = VK_SHARING_MODE_EXCLUSIVE;
+        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        return imageInfo;
+    }
+
+    VkBufferCreateInfo VulkanRenderGraphExecutor::makeBufferCreateInfo(const RenderGraph& graph, RenderGraphResource resource) const
+    {
+        VkBufferCreateInfo bufferInfo{ VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+        bufferInfo.size        = graph.getBufferDesc(resource).m_size;
+        bufferInfo.usage       = graph.getBufferUsage(resource);
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        return bufferInfo;
+    }
+
+    uint64_t VulkanRenderGraphExecutor::computeDescriptionHash(const RenderGraph& graph, RenderGraphResource resource)
+    {
+        uint64_t hash = mixHash(k_hashSeed, static_cast<uint64_t>(graph.getResourceType(resource)));
+        if (graph.getResourceType(resource) == RenderGraphResourceType::image)
+        {
+            const RenderGraphImageDesc& desc = graph.getImageDesc(resource);
+            hash = mixHash(hash, (static_cast<uint64_t>(desc.m_width) << 32) | desc.m_height);
+            hash = mixHash(hash, static_cast<uint64_t>(desc.m_format));
+            hash = mixHash(hash, (static_cast<uint64_t>(desc.m_mip_levels) << 32) | desc.m_array_layers);
+            hash = mixHash(hash, static_cast<uint64_t>(desc.m_samples));
+            return mixHash(hash, graph.getImageUsage(resource));
+        }
+        hash = mixHash(hash, graph.getBufferDesc(resource).m_size);
+        return mixHash(hash, graph.getBufferUsage(resource));
+    }
+
+    /*
+    * Covers everything the physical resources depend on: the heaps and each used transient resource
+    * with its description and placement
+    */
+    uint64_t VulkanRenderGraphExecutor::computeLayoutHash(const RenderGraph& graph)
+    {
+        uint64_t hash = mixHash(k_hashSeed, graph.getResourceCount());
+        for (const RenderGraphHeap& heap : graph.getHeaps())
+        {
+            hash = mixHash(hash, heap.m_size);
+            hash = mixHash(hash, heap.m_memory_type_bits);
+        }
+        for (RenderGraphResource resource = 0; resource < graph.getResourceCount(); ++resource)
+        {
+            if (graph.isImported(resource) || !graph.isResourceUsed(resource))
+            {
+                hash = mixHash(hash, 0);
+                continue;
+            }
+            hash = mixHash(hash, computeDescriptionHash(graph, resource));
+            hash = mixHash(hash, (static_cast<uint64_t>(graph.getResourceHeap(resource)) << 40) ^ graph.getResourceOffset(resource));
+        }
+        return hash;
+    }
+} // namespace Polaris
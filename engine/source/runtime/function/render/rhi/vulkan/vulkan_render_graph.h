@@ -0,0 +1,112 @@
+#pragma once
+
+#include "runtime/function/render/render_graph.h"
+#include "runtime/function/render/rhi/vulkan/vulkan_command_recorder.h"
+#include "runtime/function/render/rhi/vulkan/vulkan_gpu_profiler.h"
+
+#include <vk_mem_alloc.h>
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace Polaris
+{
+    /**
+     *  What a pass callback records with: the frame command buffer, the physical resources
+     *  behind the virtual ones the pass declared, and the worker pools for splitting long
+     *  draw lists across threads
+     */
+    class RenderGraphPassContext
+    {
+    public:
+        RenderGraphPassContext(const RenderGraph& graph, VkCommandBuffer commandBuffer, VulkanCommandRecorder& recorder,
+                               const std::vector<VkImage>& images, const std::vector<VkImageView>& imageViews,
+                               const std::vector<VkBuffer>& buffers)
+            : m_graph(graph), m_commandBuffer(commandBuffer), m_recorder(recorder), m_images(images), m_imageViews(imageViews),
+              m_buffers(buffers)
+        {}
+
+        VkCommandBuffer getCommandBuffer() const { return m_commandBuffer; }
+        VkImage         getImage(RenderGraphResource resource) const { return m_images[resource]; }
+        VkImageView     getImageView(RenderGraphResource resource) const { return m_imageViews[resource]; }
+        VkBuffer        getBuffer(RenderGraphResource resource) const { return m_buffers[resource]; }
+
+        const RenderGraphImageDesc&  getImageDesc(RenderGraphResource resource) const { return m_graph.getImageDesc(resource); }
+        const RenderGraphBufferDesc& getBufferDesc(RenderGraphResource resource) const { return m_graph.getBufferDesc(resource); }
+
+        // inside a render pass begun with secondary command buffer contents, see VulkanCommandRecorder
+        void recordParallel(const VkCommandBufferInheritanceInfo&        inheritance,
+                            uint32_t                                     itemCount,
+                            uint32_t                                     minItemsPerChunk,
+                            const VulkanCommandRecorder::RecordCallback& record)
+        {
+            m_recorder.recordParallel(m_commandBuffer, inheritance, itemCount, minItemsPerChunk, record);
+        }
+
+    private:
+        const RenderGraph&              m_graph;
+        VkCommandBuffer                 m_commandBuffer;
+        VulkanCommandRecorder&          m_recorder;
+        const std::vector<VkImage>&     m_images;
+        const std::vector<VkImageView>& m_imageViews;
+        const std::vector<VkBuffer>&    m_buffers;
+    };
+
+    /**
+     *  Records a compiled render graph. Every frame in flight owns a set of heaps allocated through
+     *  VMA with the transient images and buffers bound into them at the offsets the graph chose, so
+     *  resources with disjoint lifetimes share memory. A set is kept as long as the graph compiles
+     *  to the same resources and placements, and rebuilt otherwise
+     */
+    class VulkanRenderGraphExecutor
+    {
+    public:
+        void initialize(VkDevice device, VmaAllocator allocator, uint32_t frameCount);
+        void clear();
+
+        // memory query for RenderGraph::compile, asks the driver once per distinct description
+        RenderGraphMemoryRequirements getMemoryRequirements(const RenderGraph& graph, RenderGraphResource resource);
+
+        // the fence of frameIndex has to be signaled, its transient resources may be recreated.
+        // Each pass is recorded inside a gpu profiler zone named after it
+        void execute(const RenderGraph& graph, VkCommandBuffer commandBuffer, VulkanCommandRecorder& recorder,
+                     VulkanGpuProfiler& gpuProfiler, uint32_t frameIndex);
+
+    private:
+        struct FrameResources
+        {
+            uint64_t                   layoutHash{ 0 };
+            std::vector<VmaAllocation> heaps;
+            std::vector<VkImage>       images;
+            std::vector<VkImageView>   imageViews;
+            std::vector<VkBuffer>      buffers;
+            // transient objects owned by this frame, the vectors above also hold imported handles
+            std::vector<VkImage>       ownedImages;
+            std::vector<VkImageView>   ownedImageViews;
+            std::vector<VkBuffer>      ownedBuffers;
+        };
+
+        static uint64_t computeLayoutHash(const RenderGraph& graph);
+        static uint64_t computeDescriptionHash(const RenderGraph& graph, RenderGraphResource resource);
+
+        VkImageCreateInfo  makeImageCreateInfo(const RenderGraph& graph, RenderGraphResource resource) const;
+        VkBufferCreateInfo makeBufferCreateInfo(const RenderGraph& graph, RenderGraphResource resource) const;
+
+        void realizeResources(const RenderGraph& graph, FrameResources& frame);
+        void releaseResources(FrameResources& frame);
+        void recordBarriers(const RenderGraph& graph, const FrameResources& frame, VkCommandBuffer commandBuffer,
+                            const std::vector<RenderGraphBarrier>& barriers);
+
+    private:
+        VkDevice     m_device{ VK_NULL_HANDLE };
+        VmaAllocator m_allocator{ VK_NULL_HANDLE };
+
+        std::vector<FrameResources>                                 m_frames;
+        std::unordered_map<uint64_t, RenderGraphMemoryRequirements> m_memoryRequirementCache;
+
+        std::vector<VkImageMemoryBarrier>  m_imageBarriers;
+        std::vector<VkBufferMemoryBarrier> m_bufferBarriers;
+    };
+} // namespace Polaris
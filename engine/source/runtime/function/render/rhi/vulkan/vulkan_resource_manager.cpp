@@ -0,0 +1,446 @@
+#include "runtime/function/render/rhi/vulkan/vulkan_resource_manager.h"
+
+#include "runtime/core/base/macro.h"
+#include "runtime/core/profiler/profiler.h"
+
+#include <stdexcept>
+
+namespace Polaris
+{
+    namespace
+    {
+        struct PoolInfo
+        {
+            const char*              name;
+            VmaMemoryUsage           usage;
+            VmaAllocationCreateFlags flags;
+        };
+
+        constexpr PoolInfo k_pool_infos[] = {
+            { "Static Mesh Pool", VMA_MEMORY_USAGE_GPU_ONLY, 0 },
+            { "Render Target Pool", VMA_MEMORY_USAGE_GPU_ONLY, 0 },
+            { "Staging Pool", VMA_MEMORY_USAGE_CPU_ONLY, VMA_ALLOCATION_CREATE_MAPPED_BIT },
+            { "Per Frame Pool", VMA_MEMORY_USAGE_CPU_TO_GPU, VMA_ALLOCATION_CREATE_MAPPED_BIT },
+        };
+        static_assert(sizeof(k_pool_infos) / sizeof(k_pool_infos[0]) == static_cast<size_t>(VulkanMemoryPool::count),
+                      "every memory pool needs an entry");
+
+        // static mesh buffers are copied when defragmentation moves them
+        constexpr VkBufferUsageFlags k_static_mesh_buffer_usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+
+        const PoolInfo& getPoolInfo(VulkanMemoryPool pool) { return k_pool_infos[static_cast<size_t>(pool)]; }
+
+        void* toUserData(uint32_t slot) { return reinterpret_cast<void*>(static_cast<uintptr_t>(slot)); }
+        uint32_t fromUserData(void* userData) { return static_cast<uint32_t>(reinterpret_cast<uintptr_t>(userData)); }
+
+        template<typename Slot>
+        uint32_t acquireSlot(std::vector<Slot>& slots, std::vector<uint32_t>& freeSlots)
+        {
+            if (freeSlots.empty())
+            {
+                slots.emplace_back();
+                return static_cast<uint32_t>(slots.size() - 1);
+            }
+            const uint32_t slot = freeSlots.back();
+            freeSlots.pop_back();
+            return slot;
+        }
+    } // namespace
+
+    /*
+    * The memory type of each pool is the one VMA picks for a typical resource of that usage
+    */
+    void VulkanResourceManager::initialize(const InitInfo& initInfo)
+    {
+        m_initInfo = initInfo;
+
+        VkBufferCreateInfo sampleBuffer{};
+        sampleBuffer.sType       = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        sampleBuffer.size        = 1024;
+        sampleBuffer.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+        VkImageCreateInfo sampleImage{};
+        sampleImage.sType         = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        sampleImage.imageType     = VK_IMAGE_TYPE_2D;
+        sampleImage.format        = VK_FORMAT_R8G8B8A8_UNORM;
+        sampleImage.extent        = { 1024, 1024, 1 };
+        sampleImage.mipLevels     = 1;
+        sampleImage.arrayLayers   = 1;
+        sampleImage.samples       = VK_SAMPLE_COUNT_1_BIT;
+        sampleImage.tiling        = VK_IMAGE_TILING_OPTIMAL;
+        sampleImage.usage         = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+        sampleImage.sharingMode   = VK_SHARING_MODE_EXCLUSIVE;
+        sampleImage.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+        for (size_t poolIndex = 0; poolIndex < m_pools.size(); ++poolIndex)
+        {
+            const VulkanMemoryPool pool     = static_cast<VulkanMemoryPool>(poolIndex);
+            const PoolInfo&        poolInfo = getPoolInfo(pool);
+
+            VmaAllocationCreateInfo allocationInfo{};
+            allocationInfo.usage = poolInfo.usage;
+
+            uint32_t memoryTypeIndex = 0;
+            VkResult result          = VK_SUCCESS;
+            switch (pool)
+            {
+                case VulkanMemoryPool::static_mesh:
+                    sampleBuffer.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT |
+                                         VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | k_static_mesh_buffer_usage;
+                    result = vmaFindMemoryTypeIndexForBufferInfo(m_initInfo.allocator, &sampleBuffer, &allocationInfo, &memoryTypeIndex);
+                    break;
+                case VulkanMemoryPool::render_target:
+                    result = vmaFindMemoryTypeIndexForImageInfo(m_initInfo.allocator, &sampleImage, &allocationInfo, &memoryTypeIndex);
+                    break;
+                case VulkanMemoryPool::staging:
+                    sampleBuffer.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+                    result = vmaFindMemoryTypeIndexForBufferInfo(m_initInfo.allocator, &sampleBuffer, &allocationInfo, &memoryTypeIndex);
+                    break;
+                default:
+                    sampleBuffer.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                                         VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT |
+                                         VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT;
+                    result = vmaFindMemoryTypeIndexForBufferInfo(m_initInfo.allocator, &sampleBuffer, &allocationInfo, &memoryTypeIndex);
+                    break;
+            }
+            if (result != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to find memory type for memory pool!");
+            }
+
+            m_poolMemoryTypes[poolIndex] = memoryTypeIndex;
+
+            VmaPoolCreateInfo poolCreateInfo{};
+            poolCreateInfo.memoryTypeIndex = memoryTypeIndex;
+            poolCreateInfo.blockSize       = m_initInfo.blockSizes[poolIndex];
+            if (vmaCreatePool(m_initInfo.allocator, &poolCreateInfo, &m_pools[poolIndex]) != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to create memory pool!");
+            }
+            vmaSetPoolName(m_initInfo.allocator, m_pools[poolIndex], poolInfo.name);
+        }
+    }
+
+    /*
+    * The device has to be idle
+    */
+    void VulkanResourceManager::clear()
+    {
+        for (BufferSlot& slot : m_buffers)
+        {
+            if (slot.buffer != VK_NULL_HANDLE)
+            {
+                vkDestroyBuffer(m_initInfo.device, slot.buffer, nullptr);
+                vmaFreeMemory(m_initInfo.allocator, slot.allocation);
+            }
+        }
+        for (ImageSlot& slot : m_images)
+        {
+            if (slot.image != VK_NULL_HANDLE)
+            {
+                vkDestroyImage(m_initInfo.device, slot.image, nullptr);
+                vmaFreeMemory(m_initInfo.allocator, slot.allocation);
+            }
+        }
+        m_buffers.clear();
+        m_freeBufferSlots.clear();
+        m_images.clear();
+        m_freeImageSlots.clear();
+
+        for (VmaPool& pool : m_pools)
+        {
+            vmaDestroyPool(m_initInfo.allocator, pool);
+            pool = VK_NULL_HANDLE;
+        }
+    }
+
+    void VulkanResourceManager::beginFrame(uint32_t frameIndex)
+    {
+        vmaSetCurrentFrameIndex(m_initInfo.allocator, frameIndex);
+
+        bool isOverBudget = false;
+        for (const VulkanHeapBudget& heapBudget : getHeapBudgets())
+        {
+            isOverBudget |= heapBudget.usage > heapBudget.budget;
+        }
+        if (isOverBudget && !m_isOverBudget)
+        {
+            LOG_WARN("device memory usage exceeds the budget, allocations may fail or be paged out");
+        }
+        m_isOverBudget = isOverBudget;
+    }
+
+    /*
+    * Large resources get a dedicated allocation, resources the pool's memory type cannot back fall
+    * back to the default VMA pools
+    */
+    VmaAllocationCreateInfo VulkanResourceManager::makeAllocationCreateInfo(VulkanMemoryPool pool, const VkMemoryRequirements& requirements) const
+    {
+        const size_t    poolIndex = static_cast<size_t>(pool);
+        const PoolInfo& poolInfo  = getPoolInfo(pool);
+
+        VmaAllocationCreateInfo allocationInfo{};
+        allocationInfo.flags = poolInfo.flags;
+
+        const bool isLarge = requirements.size >= m_initInfo.dedicatedThreshold || requirements.size > m_initInfo.blockSizes[poolIndex] / 2;
+        if (isLarge || (requirements.memoryTypeBits & (1u << m_poolMemoryTypes[poolIndex])) == 0)
+        {
+            allocationInfo.usage = poolInfo.usage;
+            if (isLarge)
+            {
+                allocationInfo.flags |= VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
+            }
+            return allocationInfo;
+        }
+
+        allocationInfo.pool = m_pools[poolIndex];
+        return allocationInfo;
+    }
+
+    VulkanBufferHandle VulkanResourceManager::createBuffer(const VkBufferCreateInfo& createInfo, VulkanMemoryPool pool)
+    {
+        if (pool == VulkanMemoryPool::static_mesh && createInfo.pNext != nullptr)
+        {
+            throw std::runtime_error("static mesh buffers can not have a pNext chain!");
+        }
+
+        const uint32_t slotIndex = acquireSlot(m_buffers, m_freeBufferSlots);
+        BufferSlot&    slot      = m_buffers[slotIndex];
+
+        VkBufferCreateInfo bufferInfo = createInfo;
+        if (pool == VulkanMemoryPool::static_mesh)
+        {
+            bufferInfo.usage |= k_static_mesh_buffer_usage;
+        }
+        if (vkCreateBuffer(m_initInfo.device, &bufferInfo, nullptr, &slot.buffer) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create buffer!");
+        }
+
+        slot.createInfo       = bufferInfo;
+        slot.createInfo.pNext = nullptr;
+        slot.queueFamilyIndices.clear();
+        if (bufferInfo.sharingMode == VK_SHARING_MODE_CONCURRENT)
+        {
+            slot.queueFamilyIndices.assign(bufferInfo.pQueueFamilyIndices,
+                                           bufferInfo.pQueueFamilyIndices + bufferInfo.queueFamilyIndexCount);
+        }
+        slot.createInfo.pQueueFamilyIndices = nullptr;
+
+        VkMemoryRequirements requirements;
+        vkGetBufferMemoryRequirements(m_initInfo.device, slot.buffer, &requirements);
+
+        const VmaAllocationCreateInfo allocationInfo = makeAllocationCreateInfo(pool, requirements);
+        VmaAllocationInfo             info{};
+        if (vmaAllocateMemoryForBuffer(m_initInfo.allocator, slot.buffer, &allocationInfo, &slot.allocation, &info) != VK_SUCCESS ||
+            vmaBindBufferMemory(m_initInfo.allocator, slot.allocation, slot.buffer) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to allocate buffer memory!");
+        }
+        vmaSetAllocationUserData(m_initInfo.allocator, slot.allocation, toUserData(slotIndex));
+        slot.mappedData = info.pMappedData;
+        return slotIndex;
+    }
+
+    void VulkanResourceManager::destroyBuffer(VulkanBufferHandle handle)
+    {
+        BufferSlot& slot = m_buffers[handle];
+        vkDestroyBuffer(m_initInfo.device, slot.buffer, nullptr);
+        vmaFreeMemory(m_initInfo.allocator, slot.allocation);
+        slot = BufferSlot{};
+        m_freeBufferSlots.push_back(handle);
+    }
+
+    void VulkanResourceManager::flushBuffer(VulkanBufferHandle handle, VkDeviceSize offset, VkDeviceSize size)
+    {
+        vmaFlushAllocation(m_initInfo.allocator, m_buffers[handle].allocation, offset, size);
+    }
+
+    VulkanImageHandle VulkanResourceManager::createImage(const VkImageCreateInfo& createInfo, VulkanMemoryPool pool)
+    {
+        // defragment treats every allocation of the static mesh pool as a buffer
+        if (pool == VulkanMemoryPool::static_mesh)
+        {
+            throw std::runtime_error("failed to create image, the static mesh pool only holds buffers!");
+        }
+
+        const uint32_t slotIndex = acquireSlot(m_images, m_freeImageSlots);
+        ImageSlot&     slot      = m_images[slotIndex];
+
+        if (vkCreateImage(m_initInfo.device, &createInfo, nullptr, &slot.image) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create image!");
+        }
+
+        VkMemoryRequirements requirements;
+        vkGetImageMemoryRequirements(m_initInfo.device, slot.image, &requirements);
+
+        const VmaAllocationCreateInfo allocationInfo = makeAllocationCreateInfo(pool, requirements);
+        if (vmaAllocateMemoryForImage(m_initInfo.allocator, slot.image, &allocationInfo, &slot.allocation, nullptr) != VK_SUCCESS ||
+            vmaBindImageMemory(m_initInfo.allocator, slot.allocation, slot.image) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to allocate image memory!");
+        }
+        vmaSetAllocationUserData(m_initInfo.allocator, slot.allocation, toUserData(slotIndex));
+        return slotIndex;
+    }
+
+    void VulkanResourceManager::destroyImage(VulkanImageHandle handle)
+    {
+        ImageSlot& slot = m_images[handle];
+        vkDestroyImage(m_initInfo.device, slot.image, nullptr);
+        vmaFreeMemory(m_initInfo.allocator, slot.allocation);
+        slot = ImageSlot{};
+        m_freeImageSlots.push_back(handle);
+    }
+
+    std::vector<VulkanHeapBudget> VulkanResourceManager::getHeapBudgets() const
+    {
+        const VkPhysicalDeviceMemoryProperties* memoryProperties = nullptr;
+        vmaGetMemoryProperties(m_initInfo.allocator, &memoryProperties);
+
+        std::vector<VmaBudget> budgets(memoryProperties->memoryHeapCount);
+        vmaGetHeapBudgets(m_initInfo.allocator, budgets.data());
+
+        std::vector<VulkanHeapBudget> heapBudgets(budgets.size());
+        for (size_t heapIndex = 0; heapIndex < budgets.size(); ++heapIndex)
+        {
+            heapBudgets[heapIndex].flags           = memoryProperties->memoryHeaps[heapIndex].flags;
+            heapBudgets[heapIndex].usage           = budgets[heapIndex].usage;
+            heapBudgets[heapIndex].budget          = budgets[heapIndex].budget;
+            heapBudgets[heapIndex].blockBytes      = budgets[heapIndex].statistics.blockBytes;
+            heapBudgets[heapIndex].allocationBytes = budgets[heapIndex].statistics.allocationBytes;
+        }
+        return heapBudgets;
+    }
+
+    VmaDetailedStatistics VulkanResourceManager::getPoolStatistics(VulkanMemoryPool pool) const
+    {
+        VmaDetailedStatistics statistics{};
+        vmaCalculatePoolStatistics(m_initInfo.allocator, m_pools[static_cast<size_t>(pool)], &statistics);
+        return statistics;
+    }
+
+    /*
+    * Each pass creates the moved buffers in their new place, copies them in one submission and
+    * destroys the old ones once it completed
+    */
+    VulkanDefragmentationStats VulkanResourceManager::defragment(VkQueue queue, uint32_t queueFamilyIndex)
+    {
+        PROFILE_SCOPE("VulkanResourceManager::defragment");
+
+        VulkanDefragmentationStats stats;
+
+        VmaDefragmentationInfo defragmentationInfo{};
+        defragmentationInfo.flags = VMA_DEFRAGMENTATION_FLAG_ALGORITHM_BALANCED_BIT;
+        defragmentationInfo.pool  = m_pools[static_cast<size_t>(VulkanMemoryPool::static_mesh)];
+
+        VmaDefragmentationContext context = VK_NULL_HANDLE;
+        if (vmaBeginDefragmentation(m_initInfo.allocator, &defragmentationInfo, &context) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to begin defragmentation!");
+        }
+
+        VkCommandPoolCreateInfo poolInfo{};
+        poolInfo.sType            = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolInfo.flags            = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+        poolInfo.queueFamilyIndex = queueFamilyIndex;
+
+        VkCommandPool commandPool = VK_NULL_HANDLE;
+        if (vkCreateCommandPool(m_initInfo.device, &poolInfo, nullptr, &commandPool) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create defragmentation command pool!");
+        }
+
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool        = commandPool;
+        allocInfo.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandBufferCount = 1;
+
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+        if (vkAllocateCommandBuffers(m_initInfo.device, &allocInfo, &commandBuffer) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to allocate defragmentation command buffer!");
+        }
+
+        std::vector<VkBuffer> oldBuffers;
+        for (;;)
+        {
+            VmaDefragmentationPassMoveInfo pass{};
+            if (vmaBeginDefragmentationPass(m_initInfo.allocator, context, &pass) == VK_SUCCESS)
+            {
+                break;
+            }
+
+            vkResetCommandPool(m_initInfo.device, commandPool, 0);
+
+            VkCommandBufferBeginInfo beginInfo{};
+            beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+            beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+            vkBeginCommandBuffer(commandBuffer, &beginInfo);
+
+            oldBuffers.clear();
+            for (uint32_t moveIndex = 0; moveIndex < pass.moveCount; ++moveIndex)
+            {
+                VmaDefragmentationMove& move = pass.pMoves[moveIndex];
+
+                VmaAllocationInfo info{};
+                vmaGetAllocationInfo(m_initInfo.allocator, move.srcAllocation, &info);
+                BufferSlot& slot = m_buffers[fromUserData(info.pUserData)];
+
+                VkBufferCreateInfo bufferInfo  = slot.createInfo;
+                bufferInfo.pQueueFamilyIndices = slot.queueFamilyIndices.empty() ? nullptr : slot.queueFamilyIndices.data();
+
+                VkBuffer newBuffer = VK_NULL_HANDLE;
+                if (vkCreateBuffer(m_initInfo.device, &bufferInfo, nullptr, &newBuffer) != VK_SUCCESS ||
+                    vmaBindBufferMemory(m_initInfo.allocator, move.dstTmpAllocation, newBuffer) != VK_SUCCESS)
+                {
+                    // keep this one where it is
+                    vkDestroyBuffer(m_initInfo.device, newBuffer, nullptr);
+                    move.operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+                    continue;
+                }
+
+                VkBufferCopy region{};
+                region.size = slot.createInfo.size;
+                vkCmdCopyBuffer(commandBuffer, slot.buffer, newBuffer, 1, &region);
+
+                oldBuffers.push_back(slot.buffer);
+                slot.buffer = newBuffer;
+                stats.movedBuffers.push_back(fromUserData(info.pUserData));
+            }
+
+            vkEndCommandBuffer(commandBuffer);
+
+            VkSubmitInfo submitInfo{};
+            submitInfo.sType              = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+            submitInfo.commandBufferCount = 1;
+            submitInfo.pCommandBuffers    = &commandBuffer;
+            if (vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to submit defragmentation copies!");
+            }
+            vkQueueWaitIdle(queue);
+
+            for (VkBuffer oldBuffer : oldBuffers)
+            {
+                vkDestroyBuffer(m_initInfo.device, oldBuffer, nullptr);
+            }
+
+            ++stats.passCount;
+            if (vmaEndDefragmentationPass(m_initInfo.allocator, context, &pass) == VK_SUCCESS)
+            {
+                break;
+            }
+        }
+
+        vkDestroyCommandPool(m_initInfo.device, commandPool, nullptr);
+
+        VmaDefragmentationStats vmaStats{};
+        vmaEndDefragmentation(m_initInfo.allocator, context, &vmaStats);
+        stats.bytesMoved = vmaStats.bytesMoved;
+        stats.bytesFreed = vmaStats.bytesFreed;
+        return stats;
+    }
+} // namespace Polaris
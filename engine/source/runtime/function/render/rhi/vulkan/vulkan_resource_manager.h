@@ -0,0 +1,129 @@
+#pragma once
+
+#include <vk_mem_alloc.h>
+#include <vulkan/vulkan.h>
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace Polaris
+{
+    using VulkanBufferHandle = uint32_t;
+    using VulkanImageHandle  = uint32_t;
+
+    constexpr uint32_t k_invalid_vulkan_resource_handle = std::numeric_limits<uint32_t>::max();
+
+    // what a resource is used for, each usage suballocates from its own VMA pool
+    enum class VulkanMemoryPool : uint8_t
+    {
+        static_mesh,   // device local vertex, index and storage buffers, compacted by defragment, no images
+        render_target, // device local attachments and sampled images
+        staging,       // host visible transfer sources
+        per_frame,     // host visible, device read buffers rewritten every frame, persistently mapped
+        count
+    };
+
+    struct VulkanHeapBudget
+    {
+        VkMemoryHeapFlags flags{ 0 };
+        // bytes this process uses and may use, from VK_EXT_memory_budget when it is enabled and
+        // estimated from the heap size otherwise
+        VkDeviceSize usage{ 0 };
+        VkDeviceSize budget{ 0 };
+        // bytes in VkDeviceMemory blocks of this allocator, and how many of them are suballocated
+        VkDeviceSize blockBytes{ 0 };
+        VkDeviceSize allocationBytes{ 0 };
+    };
+
+    struct VulkanDefragmentationStats
+    {
+        uint32_t                        passCount{ 0 };
+        VkDeviceSize                    bytesMoved{ 0 };
+        VkDeviceSize                    bytesFreed{ 0 };
+        // buffers that were recreated, descriptors referencing them have to be rewritten
+        std::vector<VulkanBufferHandle> movedBuffers;
+    };
+
+    /**
+     *  Owns the buffers and images of the renderer. Memory is suballocated through VMA from one
+     *  custom pool per usage, so the number of VkDeviceMemory objects stays far below
+     *  maxMemoryAllocationCount. Only images and buffers at or above the dedicated threshold get
+     *  their own allocation. Resources are referred to by handles, which keep working when
+     *  defragmentation moves a buffer
+     */
+    class VulkanResourceManager
+    {
+    public:
+        struct InitInfo
+        {
+            VkDevice     device{ VK_NULL_HANDLE };
+            VmaAllocator allocator{ VK_NULL_HANDLE };
+            VkDeviceSize dedicatedThreshold{ 32ull << 20 };
+
+            std::array<VkDeviceSize, static_cast<size_t>(VulkanMemoryPool::count)> blockSizes{
+                64ull << 20, 128ull << 20, 32ull << 20, 16ull << 20 };
+        };
+
+        void initialize(const InitInfo& initInfo);
+        void clear();
+
+        // once per frame, advances the budget queries and warns when a heap goes over its budget
+        void beginFrame(uint32_t frameIndex);
+
+        // buffers of the static mesh pool are recreated by defragment and can not have a pNext chain
+        VulkanBufferHandle createBuffer(const VkBufferCreateInfo& createInfo, VulkanMemoryPool pool);
+        void               destroyBuffer(VulkanBufferHandle handle);
+        VkBuffer           getBuffer(VulkanBufferHandle handle) const { return m_buffers[handle].buffer; }
+        // nullptr unless the buffer lives in a host visible pool
+        void*              getMappedData(VulkanBufferHandle handle) const { return m_buffers[handle].mappedData; }
+        // makes host writes through the mapped pointer visible, a no-op on coherent memory
+        void               flushBuffer(VulkanBufferHandle handle, VkDeviceSize offset, VkDeviceSize size);
+
+        VulkanImageHandle createImage(const VkImageCreateInfo& createInfo, VulkanMemoryPool pool);
+        void              destroyImage(VulkanImageHandle handle);
+        VkImage           getImage(VulkanImageHandle handle) const { return m_images[handle].image; }
+
+        std::vector<VulkanHeapBudget> getHeapBudgets() const;
+        VmaDetailedStatistics         getPoolStatistics(VulkanMemoryPool pool) const;
+
+        /**
+         *  Compacts the static mesh pool by copying its buffers on the given queue and frees the
+         *  blocks left empty. Blocks until done, the device has to be idle
+         */
+        VulkanDefragmentationStats defragment(VkQueue queue, uint32_t queueFamilyIndex);
+
+    private:
+        struct BufferSlot
+        {
+            VkBuffer           buffer{ VK_NULL_HANDLE };
+            VmaAllocation      allocation{ VK_NULL_HANDLE };
+            // without pNext and pQueueFamilyIndices, which point into memory of the caller
+            VkBufferCreateInfo    createInfo{};
+            std::vector<uint32_t> queueFamilyIndices;
+            void*                 mappedData{ nullptr };
+        };
+
+        struct ImageSlot
+        {
+            VkImage       image{ VK_NULL_HANDLE };
+            VmaAllocation allocation{ VK_NULL_HANDLE };
+        };
+
+        VmaAllocationCreateInfo makeAllocationCreateInfo(VulkanMemoryPool pool, const VkMemoryRequirements& requirements) const;
+
+    private:
+        InitInfo m_initInfo;
+
+        std::array<VmaPool, static_cast<size_t>(VulkanMemoryPool::count)>  m_pools{};
+        std::array<uint32_t, static_cast<size_t>(VulkanMemoryPool::count)> m_poolMemoryTypes{};
+
+        std::vector<BufferSlot> m_buffers;
+        std::vector<uint32_t>   m_freeBufferSlots;
+        std::vector<ImageSlot>  m_images;
+        std::vector<uint32_t>   m_freeImageSlots;
+
+        bool m_isOverBudget{ false };
+    };
+} // namespace Polaris
@@ -5,12 +5,14 @@
 #include "runtime/function/render/window_system.h"
 
 #include "runtime/core/base/templates.h"
+#include "runtime/core/profiler/profiler.h"
 
 #include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <set>
 #include <stdexcept>
+#include <thread>
 
 
 namespace Polaris
@@ -20,17 +22,40 @@ namespace Polaris
     */
     VulkanRHI::~VulkanRHI()
     {
+        vkDeviceWaitIdle(m_device);
+        m_deletionQueue.flush();
+        m_renderGraphExecutor.clear();
+        m_commandRecorder.clear();
+        m_gpuProfiler.clear();
+        m_uploadQueue.clear();
+        m_bindlessDescriptors.clear();
+
+        for (const auto& [permutation, pipeline] : m_pipelines)
+        {
+            vkDestroyPipeline(m_device, pipeline, m_defaultAllocator);
+        }
+        m_pipelineCache.save();
+        m_pipelineCache.clear();
+        m_descriptorLayoutCache.clear();
+
         cleanupFramebufferImageResources();
         cleanupSwapchain();
 
+        m_resourceManager.clear();
+        vmaDestroyAllocator(m_assetAllocator);
+
         vkDestroyDescriptorPool(m_device, m_descriptorPool, m_defaultAllocator);
 
         for (size_t i = 0; i < m_maxFrameInFlight; i++) {
             vkDestroySemaphore(m_device, m_imageAvaliableForRenderSemaphore[i], m_defaultAllocator);
             vkDestroySemaphore(m_device, m_imageRenderFinishedForPresentSemaphores[i], m_defaultAllocator);
-            vkDestroyFence(m_device, m_imageInFlightFences[i], m_defaultAllocator);
         }
+        m_frameTimeline.clear();
 
+        for (VkCommandPool frameCommandPool : m_frameCommandPools)
+        {
+            vkDestroyCommandPool(m_device, frameCommandPool, m_defaultAllocator);
+        }
         vkDestroyCommandPool(m_device, m_commandPool, m_defaultAllocator);
 
         vkDestroyDevice(m_device, m_defaultAllocator);
@@ -41,7 +66,8 @@ namespace Polaris
 
     void VulkanRHI::initialize(RHIInitInfo initInfo)
     {
-        
+        PROFILE_SCOPE("VulkanRHI::initialize");
+
         setup(initInfo);
         createInstance();
         createDebugMessenger();
@@ -54,8 +80,47 @@ namespace Polaris
         createDescriptorPools();
         createSwapchain();
         createSwapchainImageViews();
-        createFramebufferImageResources();
         createAssetAllocator();
+        createFramebufferImageResources();
+
+        m_renderGraphExecutor.initialize(m_device, m_assetAllocator, m_maxFrameInFlight);
+
+        VulkanUploadQueue::InitInfo uploadInfo;
+        uploadInfo.device          = m_device;
+        uploadInfo.allocator       = m_assetAllocator;
+        uploadInfo.transferQueue   = m_transferQueue;
+        uploadInfo.transferFamily  = m_queueFamilyIndices.transferFamily.value();
+        uploadInfo.graphicsFamily  = m_queueFamilyIndices.graphicsFamily.value();
+        uploadInfo.ringSize        = m_stagingRingSize;
+        uploadInfo.frameByteBudget = m_uploadBytesPerFrame;
+        m_uploadQueue.initialize(uploadInfo);
+
+        VulkanBindlessDescriptors::InitInfo bindlessInfo;
+        bindlessInfo.physicalDevice          = m_physicalDevice;
+        bindlessInfo.device                  = m_device;
+        bindlessInfo.resourceManager         = &m_resourceManager;
+        bindlessInfo.frameCount              = m_maxFrameInFlight;
+        bindlessInfo.maxTextureCount         = m_maxBindlessTextureCount;
+        bindlessInfo.initialMaterialCapacity = m_initialMaterialCapacity;
+        m_bindlessDescriptors.initialize(bindlessInfo);
+
+        m_pipelineCache.initialize(m_physicalDevice, m_device, initInfo.pipeline_cache_file);
+        m_descriptorLayoutCache.initialize(m_device);
+
+        VulkanGpuProfiler::InitInfo gpuProfilerInfo;
+        gpuProfilerInfo.instance                   = m_instance;
+        gpuProfilerInfo.physicalDevice             = m_physicalDevice;
+        gpuProfilerInfo.device                     = m_device;
+        gpuProfilerInfo.queueFamilyIndex           = m_queueFamilyIndices.graphicsFamily.value();
+        gpuProfilerInfo.frameCount                 = m_maxFrameInFlight;
+        gpuProfilerInfo.enablePipelineStatistics   = m_enableGpuPipelineStatistics && m_isPipelineStatisticsSupported;
+        gpuProfilerInfo.enableCalibratedTimestamps = m_isCalibratedTimestampsSupported;
+        gpuProfilerInfo.trackName                  = "GPU Graphics Queue";
+        m_gpuProfiler.initialize(gpuProfilerInfo);
+        if (m_gpuProfiler.isPipelineStatisticsEnabled())
+        {
+            m_commandRecorder.setInheritedPipelineStatistics(VulkanGpuProfiler::k_pipelineStatisticFlags);
+        }
     }
 
     void VulkanRHI::clear()
@@ -63,18 +128,240 @@ namespace Polaris
 
     }
 
+    void VulkanRHI::registerPipelineBuilder(uint32_t permutation, PipelineBuilder builder)
+    {
+        m_pipelineBuilders[permutation] = std::move(builder);
+    }
+
+    void VulkanRHI::deferDestroy(std::function<void()> deleter)
+    {
+        // the frame being recorded signals the value after the last submitted one
+        m_deletionQueue.push(m_frameTimeline.getSubmittedValue() + 1, std::move(deleter));
+    }
+
+    VkPipeline VulkanRHI::getPipeline(uint32_t permutation)
+    {
+        auto pipelineIter = m_pipelines.find(permutation);
+        if (pipelineIter != m_pipelines.end())
+        {
+            return pipelineIter->second;
+        }
+
+        auto builderIter = m_pipelineBuilders.find(permutation);
+        if (builderIter == m_pipelineBuilders.end())
+        {
+            return VK_NULL_HANDLE;
+        }
+
+        // missed by the prewarm, compiled in the middle of the frame
+        PROFILE_SCOPE("VulkanRHI::compilePipeline");
+        VkPipeline pipeline = builderIter->second(m_pipelineCache.getCache());
+        m_pipelines.emplace(permutation, pipeline);
+        return pipeline;
+    }
+
     /*
-    * Run every frame
+    * Compile the registered permutations that have no pipeline yet on worker threads, so the
+    * frames after a load do not stall on pipeline creation
+    */
+    std::vector<uint32_t> VulkanRHI::prewarmPipelines(const std::vector<uint32_t>& permutations)
+    {
+        PROFILE_SCOPE("VulkanRHI::prewarmPipelines");
+
+        std::vector<uint32_t>        readyPermutations;
+        std::vector<uint32_t>        compilePermutations;
+        std::vector<PipelineBuilder> compileBuilders;
+        for (uint32_t permutation : permutations)
+        {
+            if (m_pipelines.count(permutation) != 0)
+            {
+                readyPermutations.push_back(permutation);
+                continue;
+            }
+            auto builderIter = m_pipelineBuilders.find(permutation);
+            if (builderIter == m_pipelineBuilders.end() ||
+                std::find(compilePermutations.begin(), compilePermutations.end(), permutation) != compilePermutations.end())
+            {
+                continue;
+            }
+            compilePermutations.push_back(permutation);
+            compileBuilders.push_back(builderIter->second);
+        }
+
+        const uint32_t workerCount = std::clamp(std::thread::hardware_concurrency(), 1u, m_maxPipelineCompileWorkerCount);
+        const std::vector<VkPipeline> pipelines = m_pipelineCache.compileParallel(compileBuilders, workerCount);
+        for (size_t i = 0; i < pipelines.size(); ++i)
+        {
+            // a failed compile is tried again by the next prewarm or at the first draw
+            if (pipelines[i] == VK_NULL_HANDLE)
+            {
+                continue;
+            }
+            m_pipelines.emplace(compilePermutations[i], pipelines[i]);
+            readyPermutations.push_back(compilePermutations[i]);
+        }
+        return readyPermutations;
+    }
+
+    /*
+    * Run every frame: acquire a swapchain image, let the setup callback declare the frame as a render
+    * graph around it, then compile, record, submit and present
     */
     void VulkanRHI::tick()
     {
+        PROFILE_SCOPE("VulkanRHI::tick");
+
+        if (!m_renderGraphSetup)
+        {
+            return;
+        }
+
+        // nothing is presented while minimized, the frame is dropped instead of blocking the caller
+        const std::array<int, 2> framebufferSize = m_windowSystem->getFramebufferSize();
+        if (framebufferSize[0] == 0 || framebufferSize[1] == 0)
+        {
+            return;
+        }
+        if (framebufferSize != m_swapchainFramebufferSize)
+        {
+            recreateSwapchain();
+        }
 
+        // the frame that last used this slot has to be done with its command buffers and descriptors
+        m_frameTimeline.wait(m_frameSlotValues[m_currentFrameIndex]);
+        m_deletionQueue.collect(m_frameTimeline.getCompletedValue());
+
+        uint32_t imageIndex = 0;
+        VkResult resAcquire = vkAcquireNextImageKHR(m_device,
+                                                    m_swapchain,
+                                                    UINT64_MAX,
+                                                    m_imageAvaliableForRenderSemaphore[m_currentFrameIndex],
+                                                    VK_NULL_HANDLE,
+                                                    &imageIndex);
+        if (resAcquire == VK_ERROR_OUT_OF_DATE_KHR)
+        {
+            recreateSwapchain();
+            return;
+        }
+        if (resAcquire != VK_SUCCESS && resAcquire != VK_SUBOPTIMAL_KHR)
+        {
+            throw std::runtime_error("failed to acquire swapchain image!");
+        }
+
+        // the acquire semaphore is waited on at color attachment output, the first barrier chains from there
+        RenderGraphImageDesc backbufferDesc;
+        backbufferDesc.m_width  = m_swapchainExtent.width;
+        backbufferDesc.m_height = m_swapchainExtent.height;
+        backbufferDesc.m_format = m_swapchainImageFormat;
+
+        m_renderGraph.reset();
+        RenderGraphResource backbuffer = m_renderGraph.importImage("Backbuffer",
+                                                                   backbufferDesc,
+                                                                   m_swapchainImages[imageIndex],
+                                                                   m_swapchainImageViews[imageIndex],
+                                                                   VK_IMAGE_LAYOUT_UNDEFINED,
+                                                                   VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+                                                                   VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+        m_renderGraphSetup(m_renderGraph, backbuffer);
+        if (!m_renderGraph.compile([this](RenderGraphResource resource) {
+                return m_renderGraphExecutor.getMemoryRequirements(m_renderGraph, resource);
+            }))
+        {
+            throw std::runtime_error("failed to compile render graph!");
+        }
+
+        // everything recorded for this frame slot last time is recycled with one reset per pool
+        vkResetCommandPool(m_device, m_frameCommandPools[m_currentFrameIndex], 0);
+        m_commandRecorder.beginFrame(m_currentFrameIndex);
+        m_resourceManager.beginFrame(m_currentFrameIndex);
+        m_bindlessDescriptors.beginFrame(m_currentFrameIndex);
+
+        VkCommandBuffer commandBuffer = m_commandBuffers[m_currentFrameIndex];
+
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to begin recording command buffer!");
+        }
+
+        // the slot's previous frame is complete, its queries are read back before they are reset
+        m_gpuProfiler.beginFrame(commandBuffer, m_currentFrameIndex);
+
+        // uploads staged now are picked up by a later frame once the transfer queue is done with them
+        m_uploadQueue.flush();
+        const uint64_t uploadWaitValue = m_uploadQueue.recordAcquireBarriers(commandBuffer);
+
+        m_renderGraphExecutor.execute(m_renderGraph, commandBuffer, m_commandRecorder, m_gpuProfiler, m_currentFrameIndex);
+
+        m_gpuProfiler.endFrame(commandBuffer);
+        if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to record command buffer!");
+        }
+
+        // the value of the binary acquire semaphore is ignored
+        VkSemaphore          waitSemaphores[] = { m_imageAvaliableForRenderSemaphore[m_currentFrameIndex],
+                                                  m_uploadQueue.getTimelineSemaphore() };
+        VkPipelineStageFlags waitStages[]     = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT };
+        uint64_t             waitValues[]     = { 0, uploadWaitValue };
+
+        const uint64_t frameValue = m_frameTimeline.nextValue();
+        m_frameSlotValues[m_currentFrameIndex] = frameValue;
+
+        VkSemaphore signalSemaphores[] = { m_imageRenderFinishedForPresentSemaphores[m_currentFrameIndex],
+                                           m_frameTimeline.getSemaphore() };
+        uint64_t    signalValues[]     = { 0, frameValue };
+
+        VkTimelineSemaphoreSubmitInfo timelineInfo{};
+        timelineInfo.sType                     = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+        timelineInfo.waitSemaphoreValueCount   = uploadWaitValue > 0 ? 2 : 1;
+        timelineInfo.pWaitSemaphoreValues      = waitValues;
+        timelineInfo.signalSemaphoreValueCount = 2;
+        timelineInfo.pSignalSemaphoreValues    = signalValues;
+
+        VkSubmitInfo submitInfo{};
+        submitInfo.sType                = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.pNext                = &timelineInfo;
+        submitInfo.waitSemaphoreCount   = uploadWaitValue > 0 ? 2 : 1;
+        submitInfo.pWaitSemaphores      = waitSemaphores;
+        submitInfo.pWaitDstStageMask    = waitStages;
+        submitInfo.commandBufferCount   = 1;
+        submitInfo.pCommandBuffers      = &commandBuffer;
+        submitInfo.signalSemaphoreCount = 2;
+        submitInfo.pSignalSemaphores    = signalSemaphores;
+        if (vkQueueSubmit(m_graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to submit draw command buffer!");
+        }
+
+        VkPresentInfoKHR presentInfo{};
+        presentInfo.sType              = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+        presentInfo.waitSemaphoreCount = 1;
+        presentInfo.pWaitSemaphores    = &m_imageRenderFinishedForPresentSemaphores[m_currentFrameIndex];
+        presentInfo.swapchainCount     = 1;
+        presentInfo.pSwapchains        = &m_swapchain;
+        presentInfo.pImageIndices      = &imageIndex;
+
+        VkResult resPresent = vkQueuePresentKHR(m_presentQueue, &presentInfo);
+        m_currentFrameIndex = (m_currentFrameIndex + 1) % m_maxFrameInFlight;
+        if (resPresent == VK_ERROR_OUT_OF_DATE_KHR || resPresent == VK_SUBOPTIMAL_KHR)
+        {
+            recreateSwapchain();
+        }
+        else if (resPresent != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to present swapchain image!");
+        }
     }
 
     void VulkanRHI::setup(RHIInitInfo initInfo)
     {
         //Specify vulkan api settings
         m_window = initInfo.window_system->getWindow();
+        m_windowSystem = initInfo.window_system;
+        m_enableGpuPipelineStatistics = initInfo.enable_gpu_pipeline_statistics;
         m_apiMajor = 1;
         m_apiMinor = 2;
         m_apiVersion = VK_MAKE_API_VERSION(0, m_apiMajor, m_apiMinor, 0);
@@ -113,6 +400,12 @@ namespace Polaris
         addPhysicalDeviceFeatureRequirement(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2, "geometryShader");            // support geometry shader
         addPhysicalDeviceFeatureRequirement(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES, "multiviewGeometryShader"); // Test struct chain
         addPhysicalDeviceFeatureRequirement(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES, "imagelessFramebuffer");    // Test struct chain
+        addPhysicalDeviceFeatureRequirement(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES, "timelineSemaphore");       // upload queue completion
+        addPhysicalDeviceFeatureRequirement(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES, "runtimeDescriptorArray");  // bindless textures and materials
+        addPhysicalDeviceFeatureRequirement(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES, "shaderSampledImageArrayNonUniformIndexing");
+        addPhysicalDeviceFeatureRequirement(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES, "descriptorBindingSampledImageUpdateAfterBind");
+        addPhysicalDeviceFeatureRequirement(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES, "descriptorBindingUpdateUnusedWhilePending");
+        addPhysicalDeviceFeatureRequirement(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES, "descriptorBindingPartiallyBound");
         constructStructChain(); // Construct the struct chain for physical device features  
 
         // Command buffer setting
@@ -121,7 +414,6 @@ namespace Polaris
 
         // Descriptor pool settings
         m_maxVertexBlendingMeshCount = 256;
-        m_maxMaterialCount = 256;
     }
 
     /*
@@ -265,6 +557,21 @@ namespace Polaris
         createInfo.pQueueCreateInfos = queueCreateInfos.data(); // Add queue create infos
         createInfo.pEnabledFeatures = nullptr;
         createInfo.pNext = &m_physicalFeaturesStructChain; // When version >= vulkan1.1 we use pNext to add physical device features
+        // Budget queries are optional, VMA estimates the budget from the heap sizes without them
+        m_isMemoryBudgetSupported = checkDeviceExtensionSupport(m_physicalDevice, { VK_EXT_MEMORY_BUDGET_EXTENSION_NAME });
+        if (m_isMemoryBudgetSupported)
+        {
+            add_unique(m_deviceExtensions, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+        }
+        // Gpu profiling puts its zones on the cpu timeline without calibration too, only less precisely
+        m_isCalibratedTimestampsSupported = checkDeviceExtensionSupport(m_physicalDevice, { VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME });
+        if (m_isCalibratedTimestampsSupported)
+        {
+            add_unique(m_deviceExtensions, VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME);
+        }
+        // The struct chain holds every feature the device supports, secondaries inside a statistics query need inherited queries
+        m_isPipelineStatisticsSupported = m_physicalFeaturesStructChain.features.pipelineStatisticsQuery == VK_TRUE &&
+                                          m_physicalFeaturesStructChain.features.inheritedQueries == VK_TRUE;
         createInfo.enabledExtensionCount = static_cast<uint32_t>(m_deviceExtensions.size());
         createInfo.ppEnabledExtensionNames = m_deviceExtensions.data(); // Add device extensions
         createInfo.enabledLayerCount = 0;
@@ -306,6 +613,21 @@ namespace Polaris
         }
 
         setObjectName(m_commandPool, "Default Graphics CommandPool");
+
+        // Frame pools only hold buffers recorded once per frame, they are reset as a whole
+        poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+        m_frameCommandPools.resize(m_maxFrameInFlight);
+        for (size_t i = 0; i < m_frameCommandPools.size(); ++i)
+        {
+            if (vkCreateCommandPool(m_device, &poolInfo, nullptr, &m_frameCommandPools[i]) != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to create frame command pool!");
+            }
+            setObjectName(m_frameCommandPools[i], "Frame Graphics CommandPool [" + std::to_string(i) + "]");
+        }
+
+        const uint32_t workerCount = std::clamp(std::thread::hardware_concurrency(), 1u, m_maxRecordingWorkerCount);
+        m_commandRecorder.initialize(m_device, m_queueFamilyIndices.graphicsFamily.value(), m_maxFrameInFlight, workerCount);
     }
 
     /*
@@ -313,21 +635,20 @@ namespace Polaris
     */
     void VulkanRHI::initializeCommandBuffers()
     {   
-        // Create graphics command buffers
+        // Create graphics command buffers, each from the pool of its frame
         m_commandBuffers.resize(m_maxFrameInFlight);
         VkCommandBufferAllocateInfo allocInfo{};
         allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-        allocInfo.commandPool = m_commandPool;
         allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-        allocInfo.commandBufferCount = (uint32_t)m_commandBuffers.size();
-
-        if (vkAllocateCommandBuffers(m_device, &allocInfo, m_commandBuffers.data()) != VK_SUCCESS) 
-        {
-            throw std::runtime_error("failed to allocate command buffers!");
-        }
+        allocInfo.commandBufferCount = 1;
 
         for (int i = 0; i < m_commandBuffers.size(); ++i)
         {
+            allocInfo.commandPool = m_frameCommandPools[i];
+            if (vkAllocateCommandBuffers(m_device, &allocInfo, &m_commandBuffers[i]) != VK_SUCCESS) 
+            {
+                throw std::runtime_error("failed to allocate command buffers!");
+            }
             setObjectName(m_commandBuffers[i], "Default Command Buffer [" + std::to_string(i) + "]");
         }
     }
@@ -337,24 +658,23 @@ namespace Polaris
     */
     void VulkanRHI::createDescriptorPools()
     {
-        VkDescriptorPoolSize pool_sizes[5];
+        // Materials and their textures live in the bindless set, see VulkanBindlessDescriptors
+        VkDescriptorPoolSize pool_sizes[4];
         pool_sizes[0].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
         pool_sizes[0].descriptorCount = 3 + 2 + 2 + 2 + 1 + 1 + 3 + 3;
         pool_sizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
         pool_sizes[1].descriptorCount = 1 + 1 + 1 * m_maxVertexBlendingMeshCount;
-        pool_sizes[2].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-        pool_sizes[2].descriptorCount = 1 * m_maxMaterialCount;
-        pool_sizes[3].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-        pool_sizes[3].descriptorCount = 3 + 5 * m_maxMaterialCount + 1 + 1; // ImGui_ImplVulkan_CreateDeviceObjects
-        pool_sizes[4].type = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
-        pool_sizes[4].descriptorCount = 4 + 1 + 1 + 2;
+        pool_sizes[2].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        pool_sizes[2].descriptorCount = 3 + 1 + 1; // ImGui_ImplVulkan_CreateDeviceObjects
+        pool_sizes[3].type = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+        pool_sizes[3].descriptorCount = 4 + 1 + 1 + 2;
 
         VkDescriptorPoolCreateInfo pool_info{};
         pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
         pool_info.poolSizeCount = sizeof(pool_sizes) / sizeof(pool_sizes[0]);
         pool_info.pPoolSizes = pool_sizes;
         pool_info.maxSets =
-            1 + 1 + 1 + m_maxMaterialCount + m_maxVertexBlendingMeshCount + 1 + 1; // +skybox + axis descriptor set
+            1 + 1 + 1 + m_maxVertexBlendingMeshCount + 1 + 1; // +skybox + axis descriptor set
         pool_info.flags = 0U;
 
         if (vkCreateDescriptorPool(m_device, &pool_info, nullptr, &m_descriptorPool) != VK_SUCCESS)
@@ -366,37 +686,35 @@ namespace Polaris
     }
 
     /*
-    * Create the image available and render finished semaphores and image in flight fences
+    * Create the image available and render finished semaphores of every frame slot and the frame
+    * timeline semaphore the slots are paced with
     */
     void VulkanRHI::createSyncObjects()
     {
         m_imageAvaliableForRenderSemaphore.resize(m_maxFrameInFlight);
         m_imageRenderFinishedForPresentSemaphores.resize(m_maxFrameInFlight);
-        m_imageInFlightFences.resize(m_maxFrameInFlight);
+        m_frameSlotValues.assign(m_maxFrameInFlight, 0);
 
         VkSemaphoreCreateInfo semaphore_create_info{};
         semaphore_create_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
 
-        VkFenceCreateInfo fence_create_info{};
-        fence_create_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-        fence_create_info.flags = VK_FENCE_CREATE_SIGNALED_BIT; // the fence is initialized as signaled
-
         for (uint32_t i = 0; i < m_maxFrameInFlight; i++)
         {
             if (vkCreateSemaphore(m_device, &semaphore_create_info, nullptr, &m_imageAvaliableForRenderSemaphore[i]) != VK_SUCCESS ||
-                vkCreateSemaphore(m_device, &semaphore_create_info, nullptr, &m_imageRenderFinishedForPresentSemaphores[i]) != VK_SUCCESS ||
-                vkCreateFence(m_device, &fence_create_info, nullptr, &m_imageInFlightFences[i]) != VK_SUCCESS)
+                vkCreateSemaphore(m_device, &semaphore_create_info, nullptr, &m_imageRenderFinishedForPresentSemaphores[i]) != VK_SUCCESS)
             {
-                throw std::runtime_error("vk create semaphore & fence");
+                throw std::runtime_error("vk create semaphore");
             }
 
             setObjectName(m_imageAvaliableForRenderSemaphore[i], "Image Available For Render Semaphore [" + std::to_string(i) + "]");
             setObjectName(m_imageRenderFinishedForPresentSemaphores[i], "Image Render Finished For Present Semaphore [" + std::to_string(i) + "]");
-            setObjectName(m_imageInFlightFences[i], "Image In Flight Fence [" + std::to_string(i) + "]");
         }
+
+        m_frameTimeline.initialize(m_device);
+        setObjectName(m_frameTimeline.getSemaphore(), "Frame Timeline Semaphore");
     }
 
-    void VulkanRHI::createSwapchain()
+    void VulkanRHI::createSwapchain(VkSwapchainKHR oldSwapchain)
     {
         uint32_t imageCount;
         // Query supports of this physical device and surface and choose format, present mode and extent
@@ -420,6 +738,11 @@ namespace Polaris
         createInfo.imageExtent      = extent;
         createInfo.imageArrayLayers = 1;
         createInfo.imageUsage       = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+        // lets render graph passes clear or blit into the backbuffer
+        if (swapchainSupport.capabilities.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_DST_BIT)
+        {
+            createInfo.imageUsage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+        }
 
         uint32_t queueFamilyIndices[] = { m_queueFamilyIndices.graphicsFamily.value(), m_queueFamilyIndices.presentFamily.value() };
 
@@ -438,6 +761,7 @@ namespace Polaris
         createInfo.compositeAlpha   = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
         createInfo.presentMode      = presentMode;
         createInfo.clipped          = VK_TRUE;
+        createInfo.oldSwapchain     = oldSwapchain;
 
         if (vkCreateSwapchainKHR(m_device, &createInfo, nullptr, &m_swapchain) != VK_SUCCESS) 
         {
@@ -455,6 +779,7 @@ namespace Polaris
 
         m_swapchainImageFormat = surfaceFormat.format;
         m_swapchainExtent = extent;
+        m_swapchainFramebufferSize = m_windowSystem->getFramebufferSize();
 
         m_scissor = { {0, 0}, {m_swapchainExtent.width, m_swapchainExtent.height} };
     }
@@ -484,20 +809,22 @@ namespace Polaris
         // Set depth format
         m_depthFormat = findDepthFormat(m_physicalDevice);
 
-        VulkanUtil::createImage(m_physicalDevice,
-                                m_device,
-                                m_swapchainExtent.width,
-                                m_swapchainExtent.height,
-                                m_depthFormat,
-                                VK_IMAGE_TILING_OPTIMAL,
-                                VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT |
-                                VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT,
-                                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                                m_depthImage,
-                                m_depthImageMemory,
-                                0,
-                                1,
-                                1);
+        VkImageCreateInfo depthImageInfo{};
+        depthImageInfo.sType         = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        depthImageInfo.imageType     = VK_IMAGE_TYPE_2D;
+        depthImageInfo.extent        = { m_swapchainExtent.width, m_swapchainExtent.height, 1 };
+        depthImageInfo.mipLevels     = 1;
+        depthImageInfo.arrayLayers   = 1;
+        depthImageInfo.format        = m_depthFormat;
+        depthImageInfo.tiling        = VK_IMAGE_TILING_OPTIMAL;
+        depthImageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        depthImageInfo.usage         = VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT |
+                                       VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+        depthImageInfo.samples       = VK_SAMPLE_COUNT_1_BIT;
+        depthImageInfo.sharingMode   = VK_SHARING_MODE_EXCLUSIVE;
+
+        m_depthImageHandle = m_resourceManager.createImage(depthImageInfo, VulkanMemoryPool::render_target);
+        m_depthImage       = m_resourceManager.getImage(m_depthImageHandle);
 
         m_depthImageView = VulkanUtil::createImageView(m_device, 
                                                        m_depthImage,
@@ -507,7 +834,6 @@ namespace Polaris
                                                        1, 
                                                        1);
         setObjectName(m_depthImage, "Depth Image");
-        setObjectName(m_depthImageMemory, "Depth Image Memory");
         setObjectName(m_depthImageView, "Depth Image View");
     }
 
@@ -526,8 +852,20 @@ namespace Polaris
         allocatorCreateInfo.device = m_device;
         allocatorCreateInfo.instance = m_instance;
         allocatorCreateInfo.pVulkanFunctions = &vulkanFunctions;
+        if (m_isMemoryBudgetSupported)
+        {
+            allocatorCreateInfo.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+        }
+
+        if (vmaCreateAllocator(&allocatorCreateInfo, &m_assetAllocator) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create asset allocator!");
+        }
 
-        vmaCreateAllocator(&allocatorCreateInfo, &m_assetAllocator);
+        VulkanResourceManager::InitInfo resourceInfo;
+        resourceInfo.device    = m_device;
+        resourceInfo.allocator = m_assetAllocator;
+        m_resourceManager.initialize(resourceInfo);
     }
 
 
@@ -544,34 +882,44 @@ namespace Polaris
     void VulkanRHI::cleanupFramebufferImageResources()
     {
         vkDestroyImageView(m_device, m_depthImageView, m_defaultAllocator);
-        vkDestroyImage(m_device, m_depthImage, m_defaultAllocator);
-        vkFreeMemory(m_device, m_depthImageMemory, m_defaultAllocator);
+        m_resourceManager.destroyImage(m_depthImageHandle);
     }
 
     /*
-    * Recreate the swapchain and its images and imageviews when the present extent changes
+    * Recreate the swapchain and its images and imageviews when the present extent changes. The new
+    * swapchain is created from the old one without waiting for the device, the old one and the
+    * resources sized for it are retired through the deletion queue
     */
     void VulkanRHI::recreateSwapchain()
     {
-        int width = 0;
-        int height = 0;
-        glfwGetFramebufferSize(m_window, &width, &height);
-        while (width == 0 || height == 0) // minimized 0,0, pause for now
+        PROFILE_SCOPE("VulkanRHI::recreateSwapchain");
+
+        if (m_windowSystem->isMinimized())
         {
-            glfwGetFramebufferSize(m_window, &width, &height);
-            glfwWaitEvents();
+            return;
         }
 
-        VkResult res_wait_for_fences =
-            vkWaitForFences(m_device, m_maxFrameInFlight, m_imageInFlightFences.data(), VK_TRUE, UINT64_MAX);
-        assert(VK_SUCCESS == res_wait_for_fences);
-
-        cleanupFramebufferImageResources();
-        cleanupSwapchain();
+        VkSwapchainKHR           oldSwapchain        = m_swapchain;
+        std::vector<VkImageView> oldImageViews       = std::move(m_swapchainImageViews);
+        VkImageView              oldDepthImageView   = m_depthImageView;
+        VulkanImageHandle        oldDepthImageHandle = m_depthImageHandle;
 
-        createSwapchain();
+        createSwapchain(oldSwapchain);
         createSwapchainImageViews();
         createFramebufferImageResources();
+
+        // frames in flight still render into the old images, and their presents are only known to be
+        // consumed once as many frames of the new swapchain have completed
+        m_deletionQueue.push(m_frameTimeline.getSubmittedValue() + m_maxFrameInFlight,
+                             [this, oldSwapchain, oldImageViews, oldDepthImageView, oldDepthImageHandle]() {
+                                 for (VkImageView imageView : oldImageViews)
+                                 {
+                                     vkDestroyImageView(m_device, imageView, m_defaultAllocator);
+                                 }
+                                 vkDestroySwapchainKHR(m_device, oldSwapchain, m_defaultAllocator);
+                                 vkDestroyImageView(m_device, oldDepthImageView, m_defaultAllocator);
+                                 m_resourceManager.destroyImage(oldDepthImageHandle);
+                             });
     }
 
     /*
@@ -724,6 +1072,15 @@ namespace Polaris
             i++;
         }
 
+        // A transfer only family maps to the copy engines, uploads there overlap with rendering
+        for (uint32_t j = 0; j < queueFamilyCount; ++j) {
+            const VkQueueFlags flags = queueFamilies[j].queueFlags;
+            if ((flags & VK_QUEUE_TRANSFER_BIT) && !(flags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT))) {
+                m_queueFamilyIndices.transferFamily = j;
+                break;
+            }
+        }
+
         return m_queueFamilyIndices;
     }
 
@@ -845,9 +1202,9 @@ namespace Polaris
         }
         else 
         {
-            int width, height;
-            glfwGetFramebufferSize(m_window, &width, &height);
-            VkExtent2D actualExtent = { static_cast<uint32_t>(width), static_cast<uint32_t>(height) };
+            // glfw may only be asked from the main thread, rendering can run on its own
+            const std::array<int, 2> framebufferSize = m_windowSystem->getFramebufferSize();
+            VkExtent2D actualExtent = { static_cast<uint32_t>(framebufferSize[0]), static_cast<uint32_t>(framebufferSize[1]) };
 
             actualExtent.width = std::clamp(actualExtent.width, capabilities.minImageExtent.width, capabilities.maxImageExtent.width);
             actualExtent.height = std::clamp(actualExtent.height, capabilities.minImageExtent.height, capabilities.maxImageExtent.height);
@@ -1,15 +1,26 @@
 #pragma once
 
 #include "runtime/function/render/rhi.h"
+#include "runtime/function/render/rhi/vulkan/vulkan_bindless_descriptors.h"
+#include "runtime/function/render/rhi/vulkan/vulkan_descriptor_layout_cache.h"
+#include "runtime/function/render/rhi/vulkan/vulkan_gpu_profiler.h"
+#include "runtime/function/render/rhi/vulkan/vulkan_pipeline_cache.h"
+#include "runtime/function/render/rhi/vulkan/vulkan_render_graph.h"
+#include "runtime/function/render/rhi/vulkan/vulkan_resource_manager.h"
+#include "runtime/function/render/rhi/vulkan/vulkan_timeline.h"
+#include "runtime/function/render/rhi/vulkan/vulkan_upload_queue.h"
 
 #include <vk_mem_alloc.h>
 #include <vulkan/vulkan.h>
 
+#include <array>
+#include <memory>
 #include <string>
 #include <functional>
 #include <optional>
 #include <vector>
 #include <map>
+#include <unordered_map>
 
 namespace Polaris
 {
@@ -34,9 +45,36 @@ namespace Polaris
 	class VulkanRHI final : public RHI
 	{
 	public:
+		// declares the passes of a frame, backbuffer is the imported swapchain image to present
+		using RenderGraphSetup = std::function<void(RenderGraph& renderGraph, RenderGraphResource backbuffer)>;
+		// creates the pipeline of one permutation through the given cache, may run on a worker thread
+		using PipelineBuilder = VulkanPipelineCache::PipelineBuilder;
+
 		// override functions
 		virtual void initialize(RHIInitInfo initInfo) override final;
 		virtual void tick() override final;
+		virtual std::vector<uint32_t> prewarmPipelines(const std::vector<uint32_t>& permutations) override final;
+
+		void setRenderGraphSetup(RenderGraphSetup setup) { m_renderGraphSetup = std::move(setup); }
+		// thread safe uploads to device local buffers and images
+		VulkanUploadQueue& getUploadQueue() { return m_uploadQueue; }
+		// pooled buffers and images, everything the renderer allocates goes through it
+		VulkanResourceManager& getResourceManager() { return m_resourceManager; }
+		// the set every material and texture is reached through, indexed by material id
+		VulkanBindlessDescriptors& getBindlessDescriptors() { return m_bindlessDescriptors; }
+
+		// pipelines are compiled once per permutation, by a prewarm or on their first use
+		void registerPipelineBuilder(uint32_t permutation, PipelineBuilder builder);
+		VkPipeline getPipeline(uint32_t permutation);
+		// set and pipeline layouts shared by every pipeline with the same interface
+		VulkanDescriptorLayoutCache& getDescriptorLayoutCache() { return m_descriptorLayoutCache; }
+
+		// runs the deleter once the GPU is done with every frame recorded so far
+		void deferDestroy(std::function<void()> deleter);
+		// signaled with the number of each frame when the GPU finished it
+		const VulkanTimelineSemaphore& getFrameTimeline() const { return m_frameTimeline; }
+		// GPU time and pipeline statistics of every pass, resolved a few frames late
+		const VulkanGpuProfiler& getGpuProfiler() const { return m_gpuProfiler; }
 
 		// destory
 		virtual ~VulkanRHI() override final;
@@ -56,7 +94,8 @@ namespace Polaris
 		void createAssetAllocator();
 
 		//Swapchain
-		void createSwapchain();
+		// the old swapchain keeps its queued presents while the new one takes over
+		void createSwapchain(VkSwapchainKHR oldSwapchain = VK_NULL_HANDLE);
 		void createSwapchainImageViews();
 		void createFramebufferImageResources();
 
@@ -113,6 +152,7 @@ namespace Polaris
 	public:
 		// Components
 		GLFWwindow*			m_window{ nullptr };
+		std::shared_ptr<WindowSystem> m_windowSystem;
 		VkInstance			m_instance{ VK_NULL_HANDLE };
 		VkSurfaceKHR		m_surface{ VK_NULL_HANDLE };
 		VkPhysicalDevice	m_physicalDevice{ VK_NULL_HANDLE };
@@ -134,10 +174,15 @@ namespace Polaris
 
 		// Command pools, command buffers and sychronization objects
 		VkCommandPool					m_commandPool{ VK_NULL_HANDLE };
+		// one pool per frame in flight holding its primary buffer, reset as a whole each frame
+		std::vector<VkCommandPool>		m_frameCommandPools{};
 		std::vector<VkCommandBuffer>	m_commandBuffers{};
+		VulkanCommandRecorder			m_commandRecorder;
 		std::vector<VkSemaphore>		m_imageAvaliableForRenderSemaphore{};
 		std::vector<VkSemaphore>		m_imageRenderFinishedForPresentSemaphores{};
-		std::vector<VkFence>			m_imageInFlightFences{};
+		VulkanTimelineSemaphore			m_frameTimeline;
+		std::vector<uint64_t>			m_frameSlotValues{};
+		VulkanDeletionQueue				m_deletionQueue;
 		uint8_t							m_maxFrameInFlight{ 3 };
 		uint8_t							m_currentFrameIndex{ 0 };
 
@@ -148,19 +193,44 @@ namespace Polaris
 		VkSwapchainKHR           m_swapchain{ VK_NULL_HANDLE };
 		VkFormat                 m_swapchainImageFormat{ VK_FORMAT_UNDEFINED };
 		VkExtent2D               m_swapchainExtent;
+		// framebuffer size the swapchain was created for, a different one means a resize
+		std::array<int, 2>       m_swapchainFramebufferSize{ 0, 0 };
 		std::vector<VkImage>     m_swapchainImages;
 		std::vector<VkImageView> m_swapchainImageViews;
 		VkRect2D				 m_scissor;
 
-		VkFormat		m_depthFormat{ VK_FORMAT_UNDEFINED };
-		VkImage			m_depthImage{ VK_NULL_HANDLE };
-		VkDeviceMemory	m_depthImageMemory{ VK_NULL_HANDLE };
-		VkImageView		m_depthImageView{ VK_NULL_HANDLE };
+		VkFormat			m_depthFormat{ VK_FORMAT_UNDEFINED };
+		VkImage				m_depthImage{ VK_NULL_HANDLE };
+		VulkanImageHandle	m_depthImageHandle{ k_invalid_vulkan_resource_handle };
+		VkImageView			m_depthImageView{ VK_NULL_HANDLE };
 
 		std::vector<VkFramebuffer> m_swapchain_framebuffers;
 
 		// asset allocator use VMA library
-		VmaAllocator m_assetAllocator{ VK_NULL_HANDLE };
+		VmaAllocator				m_assetAllocator{ VK_NULL_HANDLE };
+		VulkanResourceManager		m_resourceManager;
+		VulkanBindlessDescriptors	m_bindlessDescriptors;
+		bool						m_isMemoryBudgetSupported{ false };
+
+		// Frame render graph, rebuilt by the setup callback every tick
+		RenderGraph					m_renderGraph;
+		VulkanRenderGraphExecutor	m_renderGraphExecutor;
+		RenderGraphSetup			m_renderGraphSetup;
+
+		// Staging uploads on the transfer queue
+		VulkanUploadQueue			m_uploadQueue;
+
+		// Pipelines by permutation, compiled through the cache persisted between runs
+		VulkanPipelineCache								m_pipelineCache;
+		std::unordered_map<uint32_t, PipelineBuilder>	m_pipelineBuilders;
+		std::unordered_map<uint32_t, VkPipeline>		m_pipelines;
+		VulkanDescriptorLayoutCache						m_descriptorLayoutCache;
+
+		// GPU zones of the graphics queue, merged into the profiler captures
+		VulkanGpuProfiler	m_gpuProfiler;
+		bool				m_isCalibratedTimestampsSupported{ false };
+		bool				m_isPipelineStatisticsSupported{ false };
+		bool				m_enableGpuPipelineStatistics{ false };
 
 	public:
 		// API settings
@@ -187,7 +257,19 @@ namespace Polaris
 
 		// Descriptor pool settings
 		uint32_t m_maxVertexBlendingMeshCount{ 256 };
-		uint32_t m_maxMaterialCount{ 256 };
+
+		// Bindless settings, the material buffer grows past its initial capacity on demand
+		uint32_t m_maxBindlessTextureCount{ 1u << 16 };
+		uint32_t m_initialMaterialCapacity{ 256 };
+
+		// Threads recording secondary command buffers, capped by the hardware concurrency
+		uint32_t m_maxRecordingWorkerCount{ 8 };
+		// Threads compiling pipelines during a prewarm, capped the same way
+		uint32_t m_maxPipelineCompileWorkerCount{ 8 };
+
+		// Upload settings, bytes staged per frame bound the transfer time spent on streaming
+		VkDeviceSize m_stagingRingSize{ 64ull << 20 };
+		VkDeviceSize m_uploadBytesPerFrame{ 16ull << 20 };
 		
 	};
 } // namespace Polaris
\ No newline at end of file
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+
+namespace Polaris
+{
+    // descriptorCount 0 is a runtime sized array, the layout cache gives it the count asked for
+    struct VulkanShaderDescriptorBinding
+    {
+        uint32_t         set{ 0 };
+        uint32_t         binding{ 0 };
+        VkDescriptorType descriptorType{ VK_DESCRIPTOR_TYPE_MAX_ENUM };
+        uint32_t         descriptorCount{ 1 };
+    };
+
+    struct VulkanShaderVertexInput
+    {
+        uint32_t location{ 0 };
+        VkFormat format{ VK_FORMAT_UNDEFINED };
+    };
+
+    /**
+     *  Interface of one shader stage as reflected from its SPIR-V. The *_layout.h headers generated
+     *  next to the embedded shaders define one of these per shader, along with the offsets of the
+     *  members of every uniform, storage and push constant block for static_asserts on the structs
+     *  the cpu fills
+     */
+    struct VulkanShaderStageLayout
+    {
+        VkShaderStageFlagBits                stage{ VK_SHADER_STAGE_ALL };
+        const VulkanShaderDescriptorBinding* descriptorBindings{ nullptr };
+        uint32_t                             descriptorBindingCount{ 0 };
+        const VkPushConstantRange*           pushConstantRanges{ nullptr };
+        uint32_t                             pushConstantRangeCount{ 0 };
+        const VulkanShaderVertexInput*       vertexInputs{ nullptr };
+        uint32_t                             vertexInputCount{ 0 };
+    };
+} // namespace Polaris
@@ -0,0 +1,698 @@
+#include "runtime/function/render/rhi/vulkan/vulkan_shader_reflection.h"
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace Polaris
+{
+    namespace
+    {
+        constexpr uint32_t k_spirv_magic = 0x07230203;
+
+        // the subset of the SPIR-V grammar the reflection reads
+        enum SpirvOp : uint32_t
+        {
+            op_name                 = 5,
+            op_member_name          = 6,
+            op_entry_point          = 15,
+            op_type_bool            = 20,
+            op_type_int             = 21,
+            op_type_float           = 22,
+            op_type_vector          = 23,
+            op_type_matrix          = 24,
+            op_type_image           = 25,
+            op_type_sampler         = 26,
+            op_type_sampled_image   = 27,
+            op_type_array           = 28,
+            op_type_runtime_array   = 29,
+            op_type_struct          = 30,
+            op_type_pointer         = 32,
+            op_constant             = 43,
+            op_spec_constant        = 50,
+            op_function             = 54,
+            op_variable             = 59,
+            op_decorate             = 71,
+            op_member_decorate      = 72,
+            op_type_accel_structure = 5341
+        };
+
+        enum SpirvDecoration : uint32_t
+        {
+            decoration_block          = 2,
+            decoration_buffer_block   = 3,
+            decoration_row_major      = 4,
+            decoration_array_stride   = 6,
+            decoration_matrix_stride  = 7,
+            decoration_built_in       = 11,
+            decoration_location       = 30,
+            decoration_binding        = 33,
+            decoration_descriptor_set = 34,
+            decoration_offset         = 35
+        };
+
+        enum SpirvStorageClass : uint32_t
+        {
+            storage_uniform_constant = 0,
+            storage_input            = 1,
+            storage_uniform          = 2,
+            storage_push_constant    = 9,
+            storage_storage_buffer   = 12
+        };
+
+        constexpr uint32_t k_image_dim_buffer       = 5;
+        constexpr uint32_t k_image_dim_subpass_data = 6;
+
+        struct SpirvDecorations
+        {
+            uint32_t set{ 0 };
+            uint32_t binding{ 0 };
+            uint32_t location{ 0 };
+            uint32_t offset{ 0 };
+            uint32_t arrayStride{ 0 };
+            uint32_t matrixStride{ 0 };
+            bool     hasBinding{ false };
+            bool     hasLocation{ false };
+            bool     isBlock{ false };
+            bool     isBufferBlock{ false };
+            bool     isBuiltIn{ false };
+            bool     isRowMajor{ false };
+        };
+
+        struct SpirvType
+        {
+            uint32_t              opcode{ 0 };
+            // operands after the result id
+            std::vector<uint32_t> operands;
+        };
+
+        struct SpirvVariable
+        {
+            uint32_t id{ 0 };
+            uint32_t pointerType{ 0 };
+            uint32_t storageClass{ 0 };
+        };
+
+        class SpirvModule
+        {
+        public:
+            SpirvModule(const uint32_t* code, size_t wordCount)
+            {
+                if (wordCount < 5 || code[0] != k_spirv_magic)
+                {
+                    throw std::runtime_error("failed to reflect shader, code is no SPIR-V!");
+                }
+
+                size_t wordIndex = 5;
+                while (wordIndex < wordCount)
+                {
+                    const uint32_t instructionWordCount = code[wordIndex] >> 16;
+                    const uint32_t opcode               = code[wordIndex] & 0xffff;
+                    if (instructionWordCount == 0 || wordIndex + instructionWordCount > wordCount)
+                    {
+                        throw std::runtime_error("failed to reflect shader, truncated instruction!");
+                    }
+                    // declarations all come before the first function
+                    if (opcode == op_function)
+                    {
+                        break;
+                    }
+                    parseInstruction(opcode, code + wordIndex + 1, instructionWordCount - 1);
+                    wordIndex += instructionWordCount;
+                }
+
+                if (!m_hasEntryPoint)
+                {
+                    throw std::runtime_error("failed to reflect shader, no entry point!");
+                }
+            }
+
+            const SpirvType& getType(uint32_t id) const
+            {
+                auto iter = m_types.find(id);
+                if (iter == m_types.end())
+                {
+                    throw std::runtime_error("failed to reflect shader, unknown type!");
+                }
+                return iter->second;
+            }
+
+            const SpirvDecorations& getDecorations(uint32_t id) const
+            {
+                static const SpirvDecorations k_none;
+                auto iter = m_decorations.find(id);
+                return iter != m_decorations.end() ? iter->second : k_none;
+            }
+
+            const SpirvDecorations& getMemberDecorations(uint32_t structId, uint32_t member) const
+            {
+                static const SpirvDecorations k_none;
+                auto iter = m_memberDecorations.find(structId);
+                return iter != m_memberDecorations.end() && member < iter->second.size() ? iter->second[member] : k_none;
+            }
+
+            std::string getName(uint32_t id) const
+            {
+                auto iter = m_names.find(id);
+                return iter != m_names.end() ? iter->second : std::string();
+            }
+
+            std::string getMemberName(uint32_t structId, uint32_t member) const
+            {
+                auto iter = m_memberNames.find(structId);
+                if (iter != m_memberNames.end() && member < iter->second.size() && !iter->second[member].empty())
+                {
+                    return iter->second[member];
+                }
+                return "member" + std::to_string(member);
+            }
+
+            uint32_t getConstant(uint32_t id) const
+            {
+                auto iter = m_constants.find(id);
+                if (iter == m_constants.end())
+                {
+                    throw std::runtime_error("failed to reflect shader, array length is no constant!");
+                }
+                return iter->second;
+            }
+
+            // size in bytes as laid out in a block, strides come from the decorations
+            uint32_t getTypeSize(uint32_t typeId, const SpirvDecorations& memberDecorations) const
+            {
+                const SpirvType& type = getType(typeId);
+                switch (type.opcode)
+                {
+                    case op_type_bool:
+                        return 4;
+                    case op_type_int:
+                    case op_type_float:
+                        return type.operands[0] / 8;
+                    case op_type_vector:
+                        return type.operands[1] * getTypeSize(type.operands[0], SpirvDecorations());
+                    case op_type_matrix:
+                    {
+                        const uint32_t columnCount = type.operands[1];
+                        const uint32_t rowCount    = getType(type.operands[0]).operands[1];
+                        if (memberDecorations.matrixStride == 0)
+                        {
+                            return columnCount * getTypeSize(type.operands[0], SpirvDecorations());
+                        }
+                        return (memberDecorations.isRowMajor ? rowCount : columnCount) * memberDecorations.matrixStride;
+                    }
+                    case op_type_array:
+                    {
+                        const uint32_t length = getConstant(type.operands[1]);
+                        const uint32_t stride = getDecorations(typeId).arrayStride;
+                        return length * (stride != 0 ? stride : getTypeSize(type.operands[0], memberDecorations));
+                    }
+                    case op_type_runtime_array:
+                        return 0;
+                    case op_type_struct:
+                        return getStructSize(typeId);
+                    default:
+                        return 0;
+                }
+            }
+
+            uint32_t getStructSize(uint32_t structId) const
+            {
+                const SpirvType& type = getType(structId);
+                uint32_t         size = 0;
+                for (uint32_t member = 0; member < type.operands.size(); ++member)
+                {
+                    const SpirvDecorations& decorations = getMemberDecorations(structId, member);
+                    size = std::max(size, decorations.offset + getTypeSize(type.operands[member], decorations));
+                }
+                return size;
+            }
+
+        public:
+            uint32_t                   m_executionModel{ 0 };
+            std::string                m_entryPoint;
+            bool                       m_hasEntryPoint{ false };
+            std::vector<SpirvVariable> m_variables;
+
+        private:
+            static std::string readString(const uint32_t* words, size_t wordCount)
+            {
+                const char* chars  = reinterpret_cast<const char*>(words);
+                size_t      length = 0;
+                while (length < wordCount * 4 && chars[length] != '\0')
+                {
+                    ++length;
+                }
+                return std::string(chars, length);
+            }
+
+            void parseInstruction(uint32_t opcode, const uint32_t* operands, uint32_t operandCount)
+            {
+                switch (opcode)
+                {
+                    case op_entry_point:
+                        // the first entry point is the one the pipeline uses
+                        if (!m_hasEntryPoint && operandCount >= 3)
+                        {
+                            m_executionModel = operands[0];
+                            m_entryPoint     = readString(operands + 2, operandCount - 2);
+                            m_hasEntryPoint  = true;
+                        }
+                        break;
+                    case op_name:
+                        if (operandCount >= 2)
+                        {
+                            m_names[operands[0]] = readString(operands + 1, operandCount - 1);
+                        }
+                        break;
+                    case op_member_name:
+                        if (operandCount >= 3)
+                        {
+                            std::vector<std::string>& names = m_memberNames[operands[0]];
+                            names.resize(std::max<size_t>(names.size(), operands[1] + 1));
+                            names[operands[1]] = readString(operands + 2, operandCount - 2);
+                        }
+                        break;
+                    case op_decorate:
+                        if (operandCount >= 2)
+                        {
+                            applyDecoration(m_decorations[operands[0]], operands + 1, operandCount - 1);
+                        }
+                        break;
+                    case op_member_decorate:
+                        if (operandCount >= 3)
+                        {
+                            std::vector<SpirvDecorations>& members = m_memberDecorations[operands[0]];
+                            members.resize(std::max<size_t>(members.size(), operands[1] + 1));
+                            applyDecoration(members[operands[1]], operands + 2, operandCount - 2);
+                        }
+                        break;
+                    case op_constant:
+                    case op_spec_constant:
+                        if (operandCount >= 3)
+                        {
+                            m_constants[operands[1]] = operands[2];
+                        }
+                        break;
+                    case op_variable:
+                        if (operandCount >= 3)
+                        {
+                            m_variables.push_back({ operands[1], operands[0], operands[2] });
+                        }
+                        break;
+                    case op_type_bool:
+                    case op_type_int:
+                    case op_type_float:
+                    case op_type_vector:
+                    case op_type_matrix:
+                    case op_type_image:
+                    case op_type_sampler:
+                    case op_type_sampled_image:
+                    case op_type_array:
+                    case op_type_runtime_array:
+                    case op_type_struct:
+                    case op_type_pointer:
+                    case op_type_accel_structure:
+                        if (operandCount >= 1)
+                        {
+                            SpirvType& type = m_types[operands[0]];
+                            type.opcode     = opcode;
+                            type.operands.assign(operands + 1, operands + operandCount);
+                        }
+                        break;
+                    default:
+                        break;
+                }
+            }
+
+            static void applyDecoration(SpirvDecorations& decorations, const uint32_t* operands, uint32_t operandCount)
+            {
+                const uint32_t value = operandCount >= 2 ? operands[1] : 0;
+                switch (operands[0])
+                {
+                    case decoration_block:
+                        decorations.isBlock = true;
+                        break;
+                    case decoration_buffer_block:
+                        decorations.isBufferBlock = true;
+                        break;
+                    case decoration_row_major:
+                        decorations.isRowMajor = true;
+                        break;
+                    case decoration_array_stride:
+                        decorations.arrayStride = value;
+                        break;
+                    case decoration_matrix_stride:
+                        decorations.matrixStride = value;
+                        break;
+                    case decoration_built_in:
+                        decorations.isBuiltIn = true;
+                        break;
+                    case decoration_location:
+                        decorations.location    = value;
+                        decorations.hasLocation = true;
+                        break;
+                    case decoration_binding:
+                        decorations.binding    = value;
+                        decorations.hasBinding = true;
+                        break;
+                    case decoration_descriptor_set:
+                        decorations.set = value;
+                        break;
+                    case decoration_offset:
+                        decorations.offset = value;
+                        break;
+                    default:
+                        break;
+                }
+            }
+
+        private:
+            std::unordered_map<uint32_t, std::string>                   m_names;
+            std::unordered_map<uint32_t, std::vector<std::string>>      m_memberNames;
+            std::unordered_map<uint32_t, SpirvDecorations>              m_decorations;
+            std::unordered_map<uint32_t, std::vector<SpirvDecorations>> m_memberDecorations;
+            std::unordered_map<uint32_t, SpirvType>                     m_types;
+            std::unordered_map<uint32_t, uint32_t>                      m_constants;
+        };
+
+        VkShaderStageFlagBits getStage(uint32_t executionModel)
+        {
+            switch (executionModel)
+            {
+                case 0:
+                    return VK_SHADER_STAGE_VERTEX_BIT;
+                case 1:
+                    return VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT;
+                case 2:
+                    return VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
+                case 3:
+                    return VK_SHADER_STAGE_GEOMETRY_BIT;
+                case 4:
+                    return VK_SHADER_STAGE_FRAGMENT_BIT;
+                case 5:
+                    return VK_SHADER_STAGE_COMPUTE_BIT;
+                case 5267:
+                    return VK_SHADER_STAGE_TASK_BIT_NV;
+                case 5268:
+                    return VK_SHADER_STAGE_MESH_BIT_NV;
+                case 5313:
+                    return VK_SHADER_STAGE_RAYGEN_BIT_KHR;
+                case 5314:
+                    return VK_SHADER_STAGE_INTERSECTION_BIT_KHR;
+                case 5315:
+                    return VK_SHADER_STAGE_ANY_HIT_BIT_KHR;
+                case 5316:
+                    return VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR;
+                case 5317:
+                    return VK_SHADER_STAGE_MISS_BIT_KHR;
+                case 5318:
+                    return VK_SHADER_STAGE_CALLABLE_BIT_KHR;
+                default:
+                    throw std::runtime_error("failed to reflect shader, unsupported execution model!");
+            }
+        }
+
+        VkDescriptorType getDescriptorType(const SpirvModule& module, uint32_t typeId, uint32_t storageClass)
+        {
+            const SpirvType& type = module.getType(typeId);
+            if (storageClass == storage_storage_buffer)
+            {
+                return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            }
+            if (storageClass == storage_uniform)
+            {
+                return module.getDecorations(typeId).isBufferBlock ? VK_DESCRIPTOR_TYPE_STORAGE_BUFFER
+                                                                   : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+            }
+
+            switch (type.opcode)
+            {
+                case op_type_sampler:
+                    return VK_DESCRIPTOR_TYPE_SAMPLER;
+                case op_type_sampled_image:
+                    return VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+                case op_type_accel_structure:
+                    return VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR;
+                case op_type_image:
+                {
+                    const uint32_t dim     = type.operands[1];
+                    const uint32_t sampled = type.operands[5];
+                    if (dim == k_image_dim_buffer)
+                    {
+                        return sampled == 2 ? VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER : VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+                    }
+                    if (dim == k_image_dim_subpass_data)
+                    {
+                        return VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+                    }
+                    return sampled == 2 ? VK_DESCRIPTOR_TYPE_STORAGE_IMAGE : VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+                }
+                default:
+                    return VK_DESCRIPTOR_TYPE_MAX_ENUM;
+            }
+        }
+
+        VkFormat getVertexFormat(const SpirvModule& module, uint32_t typeId)
+        {
+            const SpirvType& type           = module.getType(typeId);
+            uint32_t         componentCount = 1;
+            const SpirvType* componentType  = &type;
+            if (type.opcode == op_type_vector)
+            {
+                componentCount = type.operands[1];
+                componentType  = &module.getType(type.operands[0]);
+            }
+            if (componentCount < 1 || componentCount > 4)
+            {
+                return VK_FORMAT_UNDEFINED;
+            }
+
+            static const VkFormat k_float_formats[] = {
+                VK_FORMAT_R32_SFLOAT, VK_FORMAT_R32G32_SFLOAT, VK_FORMAT_R32G32B32_SFLOAT, VK_FORMAT_R32G32B32A32_SFLOAT};
+            static const VkFormat k_double_formats[] = {
+                VK_FORMAT_R64_SFLOAT, VK_FORMAT_R64G64_SFLOAT, VK_FORMAT_R64G64B64_SFLOAT, VK_FORMAT_R64G64B64A64_SFLOAT};
+            static const VkFormat k_int_formats[] = {
+                VK_FORMAT_R32_SINT, VK_FORMAT_R32G32_SINT, VK_FORMAT_R32G32B32_SINT, VK_FORMAT_R32G32B32A32_SINT};
+            static const VkFormat k_uint_formats[] = {
+                VK_FORMAT_R32_UINT, VK_FORMAT_R32G32_UINT, VK_FORMAT_R32G32B32_UINT, VK_FORMAT_R32G32B32A32_UINT};
+
+            const uint32_t width = componentType->operands.empty() ? 0 : componentType->operands[0];
+            if (componentType->opcode == op_type_float)
+            {
+                return width == 64 ? k_double_formats[componentCount - 1] : width == 32 ? k_float_formats[componentCount - 1] : VK_FORMAT_UNDEFINED;
+            }
+            if (componentType->opcode == op_type_int && width == 32)
+            {
+                return componentType->operands[1] != 0 ? k_int_formats[componentCount - 1] : k_uint_formats[componentCount - 1];
+            }
+            return VK_FORMAT_UNDEFINED;
+        }
+
+        VulkanShaderBlock reflectBlock(const SpirvModule& module, uint32_t structId, const std::string& fallbackName)
+        {
+            VulkanShaderBlock block;
+            block.name = module.getName(structId);
+            if (block.name.empty())
+            {
+                block.name = fallbackName;
+            }
+            block.size = module.getStructSize(structId);
+
+            const SpirvType& type = module.getType(structId);
+            for (uint32_t member = 0; member < type.operands.size(); ++member)
+            {
+                const SpirvDecorations& decorations = module.getMemberDecorations(structId, member);
+
+                VulkanShaderBlockMember blockMember;
+                blockMember.name   = module.getMemberName(structId, member);
+                blockMember.offset = decorations.offset;
+                blockMember.size   = module.getTypeSize(type.operands[member], decorations);
+                block.members.push_back(blockMember);
+            }
+            return block;
+        }
+    } // namespace
+
+    VulkanShaderReflection VulkanShaderReflection::reflect(const std::vector<unsigned char>& code)
+    {
+        if (code.size() % sizeof(uint32_t) != 0)
+        {
+            throw std::runtime_error("failed to reflect shader, code size is no multiple of 4!");
+        }
+        std::vector<uint32_t> words(code.size() / sizeof(uint32_t));
+        std::memcpy(words.data(), code.data(), code.size());
+        return reflect(words.data(), words.size());
+    }
+
+    VulkanShaderReflection VulkanShaderReflection::reflect(const uint32_t* code, size_t wordCount)
+    {
+        const SpirvModule module(code, wordCount);
+
+        VulkanShaderReflection reflection;
+        reflection.stage      = getStage(module.m_executionModel);
+        reflection.entryPoint = module.m_entryPoint;
+
+        for (const SpirvVariable& variable : module.m_variables)
+        {
+            const SpirvType& pointerType = module.getType(variable.pointerType);
+            if (pointerType.opcode != op_type_pointer)
+            {
+                continue;
+            }
+            const uint32_t          pointeeId   = pointerType.operands[1];
+            const SpirvDecorations& decorations = module.getDecorations(variable.id);
+            std::string             name        = module.getName(variable.id);
+
+            switch (variable.storageClass)
+            {
+                case storage_uniform_constant:
+                case storage_uniform:
+                case storage_storage_buffer:
+                {
+                    if (!decorations.hasBinding)
+                    {
+                        break;
+                    }
+
+                    // arrays of descriptors, a runtime array anywhere makes the count unbounded
+                    uint32_t descriptorCount = 1;
+                    uint32_t elementId       = pointeeId;
+                    while (true)
+                    {
+                        const SpirvType& elementType = module.getType(elementId);
+                        if (elementType.opcode == op_type_array)
+                        {
+                            descriptorCount *= module.getConstant(elementType.operands[1]);
+                        }
+                        else if (elementType.opcode == op_type_runtime_array)
+                        {
+                            descriptorCount = 0;
+                        }
+                        else
+                        {
+                            break;
+                        }
+                        elementId = elementType.operands[0];
+                    }
+
+                    const VkDescriptorType descriptorType = getDescriptorType(module, elementId, variable.storageClass);
+                    if (descriptorType == VK_DESCRIPTOR_TYPE_MAX_ENUM)
+                    {
+                        break;
+                    }
+                    if (module.getType(elementId).opcode == op_type_struct)
+                    {
+                        reflection.blocks.push_back(reflectBlock(module, elementId, name));
+                        if (name.empty())
+                        {
+                            name = reflection.blocks.back().name;
+                        }
+                    }
+
+                    reflection.descriptorBindings.push_back({ decorations.set, decorations.binding, descriptorType, descriptorCount });
+                    reflection.descriptorNames.push_back(name);
+                    break;
+                }
+                case storage_push_constant:
+                {
+                    const VulkanShaderBlock block = reflectBlock(module, pointeeId, name);
+
+                    uint32_t offset = block.size;
+                    for (const VulkanShaderBlockMember& member : block.members)
+                    {
+                        offset = std::min(offset, member.offset);
+                    }
+                    if (block.size > offset)
+                    {
+                        reflection.pushConstantRanges.push_back({ static_cast<VkShaderStageFlags>(reflection.stage), offset, block.size - offset });
+                    }
+                    reflection.blocks.push_back(block);
+                    break;
+                }
+                case storage_input:
+                {
+                    if (reflection.stage != VK_SHADER_STAGE_VERTEX_BIT || decorations.isBuiltIn || !decorations.hasLocation)
+                    {
+                        break;
+                    }
+
+                    // matrices and arrays take one location per column or element
+                    uint32_t         locationCount = 1;
+                    uint32_t         elementId     = pointeeId;
+                    const SpirvType* elementType   = &module.getType(elementId);
+                    if (elementType->opcode == op_type_array)
+                    {
+                        locationCount = module.getConstant(elementType->operands[1]);
+                        elementId     = elementType->operands[0];
+                        elementType   = &module.getType(elementId);
+                    }
+                    if (elementType->opcode == op_type_matrix)
+                    {
+                        locationCount *= elementType->operands[1];
+                        elementId = elementType->operands[0];
+                    }
+
+                    const VkFormat format = getVertexFormat(module, elementId);
+                    for (uint32_t i = 0; i < locationCount; ++i)
+                    {
+                        reflection.vertexInputs.push_back({ decorations.location + i, format });
+                        reflection.vertexInputNames.push_back(locationCount > 1 ? name + std::to_string(i) : name);
+                    }
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+
+        // keep the names next to what they describe while sorting
+        std::vector<size_t> order(reflection.descriptorBindings.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            const VulkanShaderDescriptorBinding& lhs = reflection.descriptorBindings[a];
+            const VulkanShaderDescriptorBinding& rhs = reflection.descriptorBindings[b];
+            return lhs.set != rhs.set ? lhs.set < rhs.set : lhs.binding < rhs.binding;
+        });
+        std::vector<VulkanShaderDescriptorBinding> sortedBindings;
+        std::vector<std::string>                   sortedNames;
+        for (size_t index : order)
+        {
+            sortedBindings.push_back(reflection.descriptorBindings[index]);
+            sortedNames.push_back(reflection.descriptorNames[index]);
+        }
+        reflection.descriptorBindings = std::move(sortedBindings);
+        reflection.descriptorNames    = std::move(sortedNames);
+
+        order.resize(reflection.vertexInputs.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return reflection.vertexInputs[a].location < reflection.vertexInputs[b].location;
+        });
+        std::vector<VulkanShaderVertexInput> sortedInputs;
+        std::vector<std::string>             sortedInputNames;
+        for (size_t index : order)
+        {
+            sortedInputs.push_back(reflection.vertexInputs[index]);
+            sortedInputNames.push_back(reflection.vertexInputNames[index]);
+        }
+        reflection.vertexInputs     = std::move(sortedInputs);
+        reflection.vertexInputNames = std::move(sortedInputNames);
+
+        return reflection;
+    }
+
+    VulkanShaderStageLayout VulkanShaderReflection::getStageLayout() const
+    {
+        VulkanShaderStageLayout layout;
+        layout.stage                  = stage;
+        layout.descriptorBindings     = descriptorBindings.data();
+        layout.descriptorBindingCount = static_cast<uint32_t>(descriptorBindings.size());
+        layout.pushConstantRanges     = pushConstantRanges.data();
+        layout.pushConstantRangeCount = static_cast<uint32_t>(pushConstantRanges.size());
+        layout.vertexInputs           = vertexInputs.data();
+        layout.vertexInputCount       = static_cast<uint32_t>(vertexInputs.size());
+        return layout;
+    }
+} // namespace Polaris
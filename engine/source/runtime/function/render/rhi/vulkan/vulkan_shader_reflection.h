@@ -0,0 +1,56 @@
+#pragma once
+
+#include "runtime/function/render/rhi/vulkan/vulkan_shader_layout.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Polaris
+{
+    struct VulkanShaderBlockMember
+    {
+        std::string name;
+        uint32_t    offset{ 0 };
+        // 0 for a runtime sized array at the end of a storage block
+        uint32_t    size{ 0 };
+    };
+
+    // layout of a uniform, storage or push constant block as the shader sees it
+    struct VulkanShaderBlock
+    {
+        std::string                          name;
+        uint32_t                             size{ 0 };
+        std::vector<VulkanShaderBlockMember> members;
+    };
+
+    /**
+     *  Interface of a SPIR-V module: the descriptors of its resources, its push constant range, the
+     *  vertex inputs of a vertex shader and the member layout of every block. Only reads what layouts
+     *  need, it does not validate the module. Runs at build time to generate the layout headers of
+     *  the engine shaders and at runtime for shaders loaded from files
+     */
+    class VulkanShaderReflection
+    {
+    public:
+        // throws on code that is no SPIR-V or has no entry point
+        static VulkanShaderReflection reflect(const uint32_t* code, size_t wordCount);
+        static VulkanShaderReflection reflect(const std::vector<unsigned char>& code);
+
+        // points into this object, valid while it lives unchanged
+        VulkanShaderStageLayout getStageLayout() const;
+
+    public:
+        VkShaderStageFlagBits stage{ VK_SHADER_STAGE_ALL };
+        std::string           entryPoint;
+
+        // sorted by set and binding
+        std::vector<VulkanShaderDescriptorBinding> descriptorBindings;
+        std::vector<std::string>                   descriptorNames;
+        std::vector<VkPushConstantRange>           pushConstantRanges;
+        // sorted by location, vertex shaders only
+        std::vector<VulkanShaderVertexInput> vertexInputs;
+        std::vector<std::string>             vertexInputNames;
+        std::vector<VulkanShaderBlock>       blocks;
+    };
+} // namespace Polaris
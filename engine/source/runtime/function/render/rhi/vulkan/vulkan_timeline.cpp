@@ -0,0 +1,96 @@
+#include "runtime/function/render/rhi/vulkan/vulkan_timeline.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+namespace Polaris
+{
+    void VulkanTimelineSemaphore::initialize(VkDevice device)
+    {
+        m_device         = device;
+        m_submittedValue = 0;
+
+        VkSemaphoreTypeCreateInfo timelineInfo{};
+        timelineInfo.sType         = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+        timelineInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+        timelineInfo.initialValue  = 0;
+
+        VkSemaphoreCreateInfo semaphoreInfo{};
+        semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        semaphoreInfo.pNext = &timelineInfo;
+        if (vkCreateSemaphore(m_device, &semaphoreInfo, nullptr, &m_semaphore) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create timeline semaphore!");
+        }
+    }
+
+    void VulkanTimelineSemaphore::clear()
+    {
+        vkDestroySemaphore(m_device, m_semaphore, nullptr);
+        m_semaphore = VK_NULL_HANDLE;
+    }
+
+    uint64_t VulkanTimelineSemaphore::getCompletedValue() const
+    {
+        uint64_t completedValue = 0;
+        vkGetSemaphoreCounterValue(m_device, m_semaphore, &completedValue);
+        return completedValue;
+    }
+
+    bool VulkanTimelineSemaphore::wait(uint64_t value, uint64_t timeout) const
+    {
+        if (value == 0)
+        {
+            return true;
+        }
+
+        VkSemaphoreWaitInfo waitInfo{};
+        waitInfo.sType          = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+        waitInfo.semaphoreCount = 1;
+        waitInfo.pSemaphores    = &m_semaphore;
+        waitInfo.pValues        = &value;
+        const VkResult result   = vkWaitSemaphores(m_device, &waitInfo, timeout);
+        if (result != VK_SUCCESS && result != VK_TIMEOUT)
+        {
+            throw std::runtime_error("failed to wait for timeline semaphore!");
+        }
+        return result == VK_SUCCESS;
+    }
+
+    void VulkanDeletionQueue::push(uint64_t timelineValue, std::function<void()> deleter)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        // kept sorted so collect only looks at the front
+        auto position = std::upper_bound(m_entries.begin(), m_entries.end(), timelineValue, [](uint64_t value, const Entry& entry) {
+            return value < entry.timelineValue;
+        });
+        m_entries.insert(position, { timelineValue, std::move(deleter) });
+    }
+
+    void VulkanDeletionQueue::collect(uint64_t completedValue)
+    {
+        // deleters run outside the lock, they may push again
+        std::vector<std::function<void()>> deleters;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            while (!m_entries.empty() && m_entries.front().timelineValue <= completedValue)
+            {
+                deleters.push_back(std::move(m_entries.front().deleter));
+                m_entries.pop_front();
+            }
+        }
+        for (std::function<void()>& deleter : deleters)
+        {
+            deleter();
+        }
+    }
+
+    void VulkanDeletionQueue::flush() { collect(UINT64_MAX); }
+
+    size_t VulkanDeletionQueue::size() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_entries.size();
+    }
+} // namespace Polaris
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+
+namespace Polaris
+{
+    /**
+     *  Timeline semaphore of one queue. Every submission signals the next value, so a single
+     *  counter tells which submissions the GPU has finished, and the CPU waits for a value instead
+     *  of a fence per frame. Queues keep timelines of their own, signals from different queues
+     *  are not ordered against each other
+     */
+    class VulkanTimelineSemaphore
+    {
+    public:
+        void initialize(VkDevice device);
+        void clear();
+
+        // value to signal with the next submission, submissions have to happen in the order of these calls
+        uint64_t nextValue() { return ++m_submittedValue; }
+
+        uint64_t getSubmittedValue() const { return m_submittedValue; }
+        uint64_t getCompletedValue() const;
+        // true once the value is reached, false when the timeout ran out first
+        bool     wait(uint64_t value, uint64_t timeout = UINT64_MAX) const;
+
+        VkSemaphore getSemaphore() const { return m_semaphore; }
+
+    private:
+        VkDevice    m_device{ VK_NULL_HANDLE };
+        VkSemaphore m_semaphore{ VK_NULL_HANDLE };
+        uint64_t    m_submittedValue{ 0 };
+    };
+
+    /**
+     *  Destruction of GPU objects deferred until a timeline value is reached, instead of waiting for
+     *  the device to go idle. Deleters may be pushed from any thread, they run on the thread that
+     *  collects
+     */
+    class VulkanDeletionQueue
+    {
+    public:
+        void push(uint64_t timelineValue, std::function<void()> deleter);
+        // runs the deleters whose value is completed
+        void collect(uint64_t completedValue);
+        // runs every deleter, the device has to be idle
+        void flush();
+
+        size_t size() const;
+
+    private:
+        struct Entry
+        {
+            uint64_t              timelineValue{ 0 };
+            std::function<void()> deleter;
+        };
+
+        mutable std::mutex m_mutex;
+        // ordered by timeline value
+        std::deque<Entry> m_entries;
+    };
+} // namespace Polaris
@@ -0,0 +1,473 @@
+#include "runtime/function/render/rhi/vulkan/vulkan_upload_queue.h"
+
+#include "runtime/core/base/macro.h"
+#include "runtime/core/profiler/profiler.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace Polaris
+{
+    namespace
+    {
+        // covers the texel size of every format and optimalBufferCopyOffsetAlignment on common hardware
+        constexpr VkDeviceSize k_stagingAlignment = 16;
+
+        VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment)
+        {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+    } // namespace
+
+    void StagingRingAllocator::reset(VkDeviceSize capacity)
+    {
+        m_capacity = capacity;
+        m_head     = 0;
+        m_tail     = 0;
+        m_usedSize = 0;
+        m_allocations.clear();
+    }
+
+    /*
+    * Free space is [head, tail) when the head is behind the tail, and [head, capacity) plus
+    * [0, tail) otherwise
+    */
+    bool StagingRingAllocator::allocate(VkDeviceSize size, VkDeviceSize alignment, uint64_t timelineValue, VkDeviceSize& outOffset)
+    {
+        if (size > m_capacity || (m_usedSize > 0 && m_head == m_tail))
+        {
+            return false;
+        }
+
+        VkDeviceSize offset = alignUp(m_head, alignment);
+        VkDeviceSize end    = offset + size;
+        if (m_head < m_tail)
+        {
+            if (end > m_tail)
+            {
+                return false;
+            }
+        }
+        else if (end > m_capacity)
+        {
+            // wrap, the tail of the ring stays unused until this allocation is released
+            offset = 0;
+            end    = size;
+            if (end > m_tail)
+            {
+                return false;
+            }
+        }
+
+        const VkDeviceSize consumedSize = end >= m_head ? end - m_head : m_capacity - m_head + end;
+        m_allocations.push_back({ end, consumedSize, timelineValue });
+        m_usedSize += consumedSize;
+        m_head = end == m_capacity ? 0 : end;
+        outOffset = offset;
+        return true;
+    }
+
+    void StagingRingAllocator::release(uint64_t completedTimelineValue)
+    {
+        while (!m_allocations.empty() && m_allocations.front().timelineValue <= completedTimelineValue)
+        {
+            m_tail = m_allocations.front().end == m_capacity ? 0 : m_allocations.front().end;
+            m_usedSize -= m_allocations.front().consumedSize;
+            m_allocations.pop_front();
+        }
+        if (m_usedSize == 0)
+        {
+            m_head = 0;
+            m_tail = 0;
+        }
+    }
+
+    void VulkanUploadQueue::initialize(const InitInfo& initInfo)
+    {
+        m_initInfo               = initInfo;
+        m_isOwnershipTransferred = initInfo.transferFamily != initInfo.graphicsFamily;
+        m_ring.reset(initInfo.ringSize);
+
+        VkBufferCreateInfo bufferInfo{};
+        bufferInfo.sType       = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferInfo.size        = initInfo.ringSize;
+        bufferInfo.usage       = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+        VmaAllocationCreateInfo allocationInfo{};
+        allocationInfo.usage = VMA_MEMORY_USAGE_CPU_ONLY;
+        allocationInfo.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+        VmaAllocationInfo mappedInfo{};
+        if (vmaCreateBuffer(initInfo.allocator, &bufferInfo, &allocationInfo, &m_stagingBuffer, &m_stagingAllocation, &mappedInfo) !=
+            VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create staging ring buffer!");
+        }
+        m_stagingData = static_cast<uint8_t*>(mappedInfo.pMappedData);
+
+        VkCommandPoolCreateInfo poolInfo{};
+        poolInfo.sType            = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolInfo.queueFamilyIndex = initInfo.transferFamily;
+        poolInfo.flags            = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+        if (vkCreateCommandPool(initInfo.device, &poolInfo, nullptr, &m_commandPool) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create transfer command pool!");
+        }
+
+        m_timeline.initialize(initInfo.device);
+    }
+
+    /*
+    * The device has to be idle
+    */
+    void VulkanUploadQueue::clear()
+    {
+        m_timeline.clear();
+        vkDestroyCommandPool(m_initInfo.device, m_commandPool, nullptr);
+        vmaDestroyBuffer(m_initInfo.allocator, m_stagingBuffer, m_stagingAllocation);
+
+        m_commandPool       = VK_NULL_HANDLE;
+        m_stagingBuffer     = VK_NULL_HANDLE;
+        m_stagingAllocation = VK_NULL_HANDLE;
+        m_stagingData       = nullptr;
+        m_freeCommandBuffers.clear();
+        m_inFlightBatches.clear();
+
+        std::lock_guard<std::mutex> lock(m_requestMutex);
+        m_pendingRequests.clear();
+    }
+
+    uint64_t VulkanUploadQueue::uploadBuffer(VkBuffer dstBuffer, VkDeviceSize dstOffset, std::vector<uint8_t>&& data)
+    {
+        // pieces of at most half the ring, so one piece always fits once the ring drains
+        const VkDeviceSize maxPieceSize = std::max<VkDeviceSize>(k_stagingAlignment, m_initInfo.ringSize / 2);
+
+        std::lock_guard<std::mutex> lock(m_requestMutex);
+        if (data.size() <= maxPieceSize)
+        {
+            UploadRequest request;
+            request.ticket    = m_nextTicket++;
+            request.dstBuffer = dstBuffer;
+            request.dstOffset = dstOffset;
+            request.data      = std::move(data);
+            m_pendingRequests.push_back(std::move(request));
+            return m_nextTicket - 1;
+        }
+
+        for (VkDeviceSize pieceOffset = 0; pieceOffset < data.size(); pieceOffset += maxPieceSize)
+        {
+            const VkDeviceSize pieceEnd = std::min<VkDeviceSize>(data.size(), pieceOffset + maxPieceSize);
+
+            UploadRequest request;
+            request.ticket    = m_nextTicket++;
+            request.dstBuffer = dstBuffer;
+            request.dstOffset = dstOffset + pieceOffset;
+            request.data.assign(data.begin() + pieceOffset, data.begin() + pieceEnd);
+            m_pendingRequests.push_back(std::move(request));
+        }
+        return m_nextTicket - 1;
+    }
+
+    uint64_t VulkanUploadQueue::uploadImage(VkImage               dstImage,
+                                            VkExtent3D            extent,
+                                            VkImageAspectFlags    aspect,
+                                            VkImageLayout         finalLayout,
+                                            std::vector<uint8_t>&& data)
+    {
+        if (data.size() > m_initInfo.ringSize)
+        {
+            LOG_ERROR("image upload of {} bytes does not fit the {} byte staging ring", data.size(), m_initInfo.ringSize);
+            return 0;
+        }
+
+        UploadRequest request;
+        request.dstImage    = dstImage;
+        request.extent      = extent;
+        request.aspect      = aspect;
+        request.finalLayout = finalLayout;
+        request.data        = std::move(data);
+
+        std::lock_guard<std::mutex> lock(m_requestMutex);
+        const uint64_t              ticket = m_nextTicket++;
+        request.ticket                     = ticket;
+        m_pendingRequests.push_back(std::move(request));
+        return ticket;
+    }
+
+    VkDeviceSize VulkanUploadQueue::getPendingByteCount() const
+    {
+        std::lock_guard<std::mutex> lock(m_requestMutex);
+        VkDeviceSize byteCount = 0;
+        for (const UploadRequest& request : m_pendingRequests)
+        {
+            byteCount += request.data.size();
+        }
+        return byteCount;
+    }
+
+    /*
+    * A request larger than the budget still goes out alone, so nothing is starved
+    */
+    void VulkanUploadQueue::flush()
+    {
+        PROFILE_SCOPE("VulkanUploadQueue::flush");
+
+        m_ring.release(m_timeline.getCompletedValue());
+
+        const uint64_t timelineValue = m_timeline.getSubmittedValue() + 1;
+
+        // requests are taken out under the lock, the copies into the ring happen after
+        std::vector<std::pair<UploadRequest, VkDeviceSize>> stagedRequests;
+        VkDeviceSize                                        stagedByteCount = 0;
+        {
+            std::lock_guard<std::mutex> lock(m_requestMutex);
+            while (!m_pendingRequests.empty())
+            {
+                const VkDeviceSize size = m_pendingRequests.front().data.size();
+                if (stagedByteCount > 0 && stagedByteCount + size > m_initInfo.frameByteBudget)
+                {
+                    break;
+                }
+
+                VkDeviceSize stagingOffset = 0;
+                if (!m_ring.allocate(size, k_stagingAlignment, timelineValue, stagingOffset))
+                {
+                    break;
+                }
+                stagedRequests.emplace_back(std::move(m_pendingRequests.front()), stagingOffset);
+                m_pendingRequests.pop_front();
+                stagedByteCount += size;
+            }
+        }
+
+        m_lastFrameByteCount = stagedByteCount;
+        if (stagedRequests.empty())
+        {
+            return;
+        }
+
+        VkCommandBuffer commandBuffer = acquireCommandBuffer();
+
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to begin recording transfer command buffer!");
+        }
+
+        UploadBatch batch;
+        batch.timelineValue = timelineValue;
+        batch.commandBuffer = commandBuffer;
+        for (const std::pair<UploadRequest, VkDeviceSize>& stagedRequest : stagedRequests)
+        {
+            const UploadRequest& request = stagedRequest.first;
+            std::memcpy(m_stagingData + stagedRequest.second, request.data.data(), request.data.size());
+            recordRequest(commandBuffer, request, stagedRequest.second, batch);
+            batch.lastTicket = request.ticket;
+        }
+
+        if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to record transfer command buffer!");
+        }
+
+        VkTimelineSemaphoreSubmitInfo timelineInfo{};
+        timelineInfo.sType                     = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+        timelineInfo.signalSemaphoreValueCount = 1;
+        timelineInfo.pSignalSemaphoreValues    = &timelineValue;
+
+        const VkSemaphore timelineSemaphore = m_timeline.getSemaphore();
+
+        VkSubmitInfo submitInfo{};
+        submitInfo.sType                = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.pNext                = &timelineInfo;
+        submitInfo.commandBufferCount   = 1;
+        submitInfo.pCommandBuffers      = &commandBuffer;
+        submitInfo.signalSemaphoreCount = 1;
+        submitInfo.pSignalSemaphores    = &timelineSemaphore;
+        if (vkQueueSubmit(m_initInfo.transferQueue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to submit transfer command buffer!");
+        }
+
+        m_timeline.nextValue();
+        m_inFlightBatches.push_back(std::move(batch));
+    }
+
+    /*
+    * Copies into the destination, then releases it to the graphics family. Without a dedicated
+    * transfer family the release is a plain barrier that moves images to their final layout
+    */
+    void VulkanUploadQueue::recordRequest(VkCommandBuffer      commandBuffer,
+                                          const UploadRequest& request,
+                                          VkDeviceSize         stagingOffset,
+                                          UploadBatch&         batch)
+    {
+        const uint32_t srcFamily = m_isOwnershipTransferred ? m_initInfo.transferFamily : VK_QUEUE_FAMILY_IGNORED;
+        const uint32_t dstFamily = m_isOwnershipTransferred ? m_initInfo.graphicsFamily : VK_QUEUE_FAMILY_IGNORED;
+
+        if (request.dstBuffer != VK_NULL_HANDLE)
+        {
+            if (request.data.empty())
+            {
+                return;
+            }
+
+            VkBufferCopy region{};
+            region.srcOffset = stagingOffset;
+            region.dstOffset = request.dstOffset;
+            region.size      = request.data.size();
+            vkCmdCopyBuffer(commandBuffer, m_stagingBuffer, request.dstBuffer, 1, &region);
+
+            VkBufferMemoryBarrier releaseBarrier{};
+            releaseBarrier.sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+            releaseBarrier.srcAccessMask       = VK_ACCESS_TRANSFER_WRITE_BIT;
+            releaseBarrier.dstAccessMask       = 0;
+            releaseBarrier.srcQueueFamilyIndex = srcFamily;
+            releaseBarrier.dstQueueFamilyIndex = dstFamily;
+            releaseBarrier.buffer              = request.dstBuffer;
+            releaseBarrier.offset              = request.dstOffset;
+            releaseBarrier.size                = request.data.size();
+            vkCmdPipelineBarrier(commandBuffer,
+                                 VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                 VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                                 0,
+                                 0,
+                                 nullptr,
+                                 1,
+                                 &releaseBarrier,
+                                 0,
+                                 nullptr);
+
+            if (m_isOwnershipTransferred)
+            {
+                VkBufferMemoryBarrier acquireBarrier = releaseBarrier;
+                acquireBarrier.srcAccessMask         = 0;
+                acquireBarrier.dstAccessMask         = VK_ACCESS_MEMORY_READ_BIT;
+                batch.bufferAcquireBarriers.push_back(acquireBarrier);
+            }
+            return;
+        }
+
+        VkImageMemoryBarrier copyBarrier{};
+        copyBarrier.sType                           = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        copyBarrier.srcAccessMask                   = 0;
+        copyBarrier.dstAccessMask                   = VK_ACCESS_TRANSFER_WRITE_BIT;
+        copyBarrier.oldLayout                       = VK_IMAGE_LAYOUT_UNDEFINED;
+        copyBarrier.newLayout                       = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        copyBarrier.srcQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
+        copyBarrier.dstQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
+        copyBarrier.image                           = request.dstImage;
+        copyBarrier.subresourceRange.aspectMask     = request.aspect;
+        copyBarrier.subresourceRange.baseMipLevel   = 0;
+        copyBarrier.subresourceRange.levelCount     = 1;
+        copyBarrier.subresourceRange.baseArrayLayer = 0;
+        copyBarrier.subresourceRange.layerCount     = 1;
+        vkCmdPipelineBarrier(commandBuffer,
+                             VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                             VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             0,
+                             0,
+                             nullptr,
+                             0,
+                             nullptr,
+                             1,
+                             &copyBarrier);
+
+        VkBufferImageCopy region{};
+        region.bufferOffset                    = stagingOffset;
+        region.imageSubresource.aspectMask     = request.aspect;
+        region.imageSubresource.mipLevel       = 0;
+        region.imageSubresource.baseArrayLayer = 0;
+        region.imageSubresource.layerCount     = 1;
+        region.imageExtent                     = request.extent;
+        vkCmdCopyBufferToImage(commandBuffer, m_stagingBuffer, request.dstImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+        VkImageMemoryBarrier releaseBarrier = copyBarrier;
+        releaseBarrier.srcAccessMask        = VK_ACCESS_TRANSFER_WRITE_BIT;
+        releaseBarrier.dstAccessMask        = 0;
+        releaseBarrier.oldLayout            = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        releaseBarrier.newLayout            = request.finalLayout;
+        releaseBarrier.srcQueueFamilyIndex  = srcFamily;
+        releaseBarrier.dstQueueFamilyIndex  = dstFamily;
+        vkCmdPipelineBarrier(commandBuffer,
+                             VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                             0,
+                             0,
+                             nullptr,
+                             0,
+                             nullptr,
+                             1,
+                             &releaseBarrier);
+
+        if (m_isOwnershipTransferred)
+        {
+            VkImageMemoryBarrier acquireBarrier = releaseBarrier;
+            acquireBarrier.srcAccessMask        = 0;
+            acquireBarrier.dstAccessMask        = VK_ACCESS_MEMORY_READ_BIT;
+            batch.imageAcquireBarriers.push_back(acquireBarrier);
+        }
+    }
+
+    uint64_t VulkanUploadQueue::recordAcquireBarriers(VkCommandBuffer commandBuffer)
+    {
+        const uint64_t completedValue = m_timeline.getCompletedValue();
+
+        uint64_t                           waitValue = 0;
+        std::vector<VkBufferMemoryBarrier> bufferBarriers;
+        std::vector<VkImageMemoryBarrier>  imageBarriers;
+        while (!m_inFlightBatches.empty() && m_inFlightBatches.front().timelineValue <= completedValue)
+        {
+            UploadBatch& batch = m_inFlightBatches.front();
+            bufferBarriers.insert(bufferBarriers.end(), batch.bufferAcquireBarriers.begin(), batch.bufferAcquireBarriers.end());
+            imageBarriers.insert(imageBarriers.end(), batch.imageAcquireBarriers.begin(), batch.imageAcquireBarriers.end());
+            waitValue        = batch.timelineValue;
+            m_acquiredTicket = batch.lastTicket;
+            m_freeCommandBuffers.push_back(batch.commandBuffer);
+            m_inFlightBatches.pop_front();
+        }
+
+        if (!bufferBarriers.empty() || !imageBarriers.empty())
+        {
+            vkCmdPipelineBarrier(commandBuffer,
+                                 VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                                 VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                                 0,
+                                 0,
+                                 nullptr,
+                                 static_cast<uint32_t>(bufferBarriers.size()),
+                                 bufferBarriers.data(),
+                                 static_cast<uint32_t>(imageBarriers.size()),
+                                 imageBarriers.data());
+        }
+        return waitValue;
+    }
+
+    VkCommandBuffer VulkanUploadQueue::acquireCommandBuffer()
+    {
+        if (!m_freeCommandBuffers.empty())
+        {
+            VkCommandBuffer commandBuffer = m_freeCommandBuffers.back();
+            m_freeCommandBuffers.pop_back();
+            vkResetCommandBuffer(commandBuffer, 0);
+            return commandBuffer;
+        }
+
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool        = m_commandPool;
+        allocInfo.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandBufferCount = 1;
+
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+        if (vkAllocateCommandBuffers(m_initInfo.device, &allocInfo, &commandBuffer) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to allocate transfer command buffer!");
+        }
+        return commandBuffer;
+    }
+} // namespace Polaris
@@ -0,0 +1,149 @@
+#pragma once
+
+#include "runtime/function/render/rhi/vulkan/vulkan_timeline.h"
+
+#include <vk_mem_alloc.h>
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+namespace Polaris
+{
+    /**
+     *  Byte ring over a fixed capacity. Allocations are tagged with the timeline value of the
+     *  submission reading them and come back in order once that value has completed. An allocation
+     *  that does not fit before the end wraps to the start, wasting the tail
+     */
+    class StagingRingAllocator
+    {
+    public:
+        explicit StagingRingAllocator(VkDeviceSize capacity = 0) { reset(capacity); }
+
+        void reset(VkDeviceSize capacity);
+
+        // false when the space still in flight leaves no room
+        bool allocate(VkDeviceSize size, VkDeviceSize alignment, uint64_t timelineValue, VkDeviceSize& outOffset);
+        void release(uint64_t completedTimelineValue);
+
+        VkDeviceSize getCapacity() const { return m_capacity; }
+        // bytes in flight, padding and wrapped tails included
+        VkDeviceSize getUsedSize() const { return m_usedSize; }
+
+    private:
+        struct Allocation
+        {
+            VkDeviceSize end{ 0 };
+            VkDeviceSize consumedSize{ 0 };
+            uint64_t     timelineValue{ 0 };
+        };
+
+        VkDeviceSize           m_capacity{ 0 };
+        VkDeviceSize           m_head{ 0 };
+        VkDeviceSize           m_tail{ 0 };
+        VkDeviceSize           m_usedSize{ 0 };
+        std::deque<Allocation> m_allocations;
+    };
+
+    /**
+     *  Streams buffer and image data to device local memory on the transfer queue. Data is copied
+     *  into a persistently mapped staging ring and the copies of a frame go out in one submission
+     *  signaling a timeline semaphore, which also tells when ring space can be reused. At most the
+     *  per frame byte budget is staged each frame, the rest waits in order for the next frames.
+     *  With a dedicated transfer family, ownership is released after the copy and acquired on the
+     *  graphics queue only once the copy has completed, so the graphics queue never waits for it
+     */
+    class VulkanUploadQueue
+    {
+    public:
+        struct InitInfo
+        {
+            VkDevice     device{ VK_NULL_HANDLE };
+            VmaAllocator allocator{ VK_NULL_HANDLE };
+            VkQueue      transferQueue{ VK_NULL_HANDLE };
+            uint32_t     transferFamily{ 0 };
+            uint32_t     graphicsFamily{ 0 };
+            VkDeviceSize ringSize{ 64ull << 20 };
+            VkDeviceSize frameByteBudget{ 16ull << 20 };
+        };
+
+        void initialize(const InitInfo& initInfo);
+        void clear();
+
+        /**
+         *  Requests are thread safe and return a ticket, they are uploaded in request order.
+         *  Buffer data larger than half the ring is split, image data has to fit into it
+         */
+        uint64_t uploadBuffer(VkBuffer dstBuffer, VkDeviceSize dstOffset, std::vector<uint8_t>&& data);
+        uint64_t uploadImage(VkImage               dstImage,
+                             VkExtent3D            extent,
+                             VkImageAspectFlags    aspect,
+                             VkImageLayout         finalLayout,
+                             std::vector<uint8_t>&& data);
+
+        // render thread, once per frame: stages and submits requests within the byte budget
+        void flush();
+        /**
+         *  Render thread, into the frame's graphics command buffer before any pass: takes over
+         *  finished uploads. Returns the timeline value the graphics submission has to wait for,
+         *  0 if none. The value has already completed, the wait only orders the two queues
+         */
+        uint64_t recordAcquireBarriers(VkCommandBuffer commandBuffer);
+
+        VkSemaphore getTimelineSemaphore() const { return m_timeline.getSemaphore(); }
+        // the uploaded data is visible to graphics commands recorded after the acquire
+        bool isUploadComplete(uint64_t ticket) const { return ticket <= m_acquiredTicket; }
+
+        VkDeviceSize getPendingByteCount() const;
+        VkDeviceSize getLastFrameByteCount() const { return m_lastFrameByteCount; }
+
+    private:
+        struct UploadRequest
+        {
+            uint64_t             ticket{ 0 };
+            VkBuffer             dstBuffer{ VK_NULL_HANDLE };
+            VkDeviceSize         dstOffset{ 0 };
+            VkImage              dstImage{ VK_NULL_HANDLE };
+            VkExtent3D           extent{};
+            VkImageAspectFlags   aspect{ 0 };
+            VkImageLayout        finalLayout{ VK_IMAGE_LAYOUT_UNDEFINED };
+            std::vector<uint8_t> data;
+        };
+
+        // copies submitted together, kept until the graphics queue took them over
+        struct UploadBatch
+        {
+            uint64_t                           timelineValue{ 0 };
+            uint64_t                           lastTicket{ 0 };
+            VkCommandBuffer                    commandBuffer{ VK_NULL_HANDLE };
+            std::vector<VkBufferMemoryBarrier> bufferAcquireBarriers;
+            std::vector<VkImageMemoryBarrier>  imageAcquireBarriers;
+        };
+
+        void recordRequest(VkCommandBuffer commandBuffer, const UploadRequest& request, VkDeviceSize stagingOffset, UploadBatch& batch);
+        VkCommandBuffer acquireCommandBuffer();
+
+    private:
+        InitInfo m_initInfo;
+        bool     m_isOwnershipTransferred{ false };
+
+        VkBuffer             m_stagingBuffer{ VK_NULL_HANDLE };
+        VmaAllocation        m_stagingAllocation{ VK_NULL_HANDLE };
+        uint8_t*             m_stagingData{ nullptr };
+        StagingRingAllocator m_ring;
+
+        VkCommandPool                m_commandPool{ VK_NULL_HANDLE };
+        std::vector<VkCommandBuffer> m_freeCommandBuffers;
+        VulkanTimelineSemaphore      m_timeline;
+
+        mutable std::mutex        m_requestMutex;
+        std::deque<UploadRequest> m_pendingRequests;
+        uint64_t                  m_nextTicket{ 1 };
+
+        std::deque<UploadBatch> m_inFlightBatches;
+        uint64_t                m_acquiredTicket{ 0 };
+        VkDeviceSize            m_lastFrameByteCount{ 0 };
+    };
+} // namespace Polaris
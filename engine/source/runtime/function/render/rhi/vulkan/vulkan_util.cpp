@@ -87,57 +87,6 @@ namespace Polaris
         throw std::runtime_error("Failed to find memory type");
     }
 
-    void VulkanUtil::createImage(VkPhysicalDevice      physical_device,
-                                 VkDevice              device,
-                                 uint32_t              image_width,
-                                 uint32_t              image_height,
-                                 VkFormat              format,
-                                 VkImageTiling         image_tiling,
-                                 VkImageUsageFlags     image_usage_flags,
-                                 VkMemoryPropertyFlags memory_property_flags,
-                                 VkImage& image,
-                                 VkDeviceMemory& memory,
-                                 VkImageCreateFlags    image_create_flags,
-                                 uint32_t              array_layers,
-                                 uint32_t              miplevels)
-    {
-        VkImageCreateInfo image_create_info{};
-        image_create_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
-        image_create_info.flags = image_create_flags;
-        image_create_info.imageType = VK_IMAGE_TYPE_2D;
-        image_create_info.extent.width = image_width;
-        image_create_info.extent.height = image_height;
-        image_create_info.extent.depth = 1;
-        image_create_info.mipLevels = miplevels;
-        image_create_info.arrayLayers = array_layers;
-        image_create_info.format = format;
-        image_create_info.tiling = image_tiling;
-        image_create_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-        image_create_info.usage = image_usage_flags;
-        image_create_info.samples = VK_SAMPLE_COUNT_1_BIT;
-        image_create_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-
-        if (vkCreateImage(device, &image_create_info, nullptr, &image) != VK_SUCCESS)
-        {
-            throw std::runtime_error("failed to create image!");
-        }
-
-        VkMemoryRequirements memRequirements;
-        vkGetImageMemoryRequirements(device, image, &memRequirements);
-
-        VkMemoryAllocateInfo allocInfo{};
-        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-        allocInfo.allocationSize = memRequirements.size;
-        allocInfo.memoryTypeIndex = findMemoryType(physical_device, memRequirements.memoryTypeBits, memory_property_flags);
-
-        if (vkAllocateMemory(device, &allocInfo, nullptr, &memory) != VK_SUCCESS)
-        {
-            throw std::runtime_error("failed to allocate image memory!");
-        }
-
-        vkBindImageMemory(device, image, memory, 0);
-    }
-
     VkImageView VulkanUtil::createImageView(VkDevice           device,
                                             VkImage& image,
                                             VkFormat           format,
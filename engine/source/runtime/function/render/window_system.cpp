@@ -14,7 +14,7 @@ namespace Polaris
     {
         if (!glfwInit())
         {
-            LOG_FATAL(__FUNCTION__, "failed to initialize GLFW");
+            LOG_FATAL("failed to initialize GLFW");
             return;
         }
 
@@ -25,12 +25,20 @@ namespace Polaris
         m_window = glfwCreateWindow(create_info.width, create_info.height, create_info.title, nullptr, nullptr);
         if (!m_window)
         {
-            LOG_FATAL(__FUNCTION__, "failed to create window");
+            LOG_FATAL("failed to create window");
             glfwTerminate();
             return;
         }
 
         glfwSetInputMode(m_window, GLFW_RAW_MOUSE_MOTION, GLFW_FALSE);
+
+        glfwSetWindowUserPointer(m_window, this);
+
+        int framebuffer_width  = 0;
+        int framebuffer_height = 0;
+        glfwGetFramebufferSize(m_window, &framebuffer_width, &framebuffer_height);
+        onFramebufferSize(m_window, framebuffer_width, framebuffer_height);
+        glfwSetFramebufferSizeCallback(m_window, &WindowSystem::onFramebufferSize);
     }
 
     void WindowSystem::pollEvents() const { glfwPollEvents(); }
@@ -38,4 +46,29 @@ namespace Polaris
     bool WindowSystem::shouldClose() const { return glfwWindowShouldClose(m_window); }
 
     GLFWwindow* WindowSystem::getWindow() const { return m_window; }
+
+    std::array<int, 2> WindowSystem::getWindowSize() const { return {m_width, m_height}; }
+
+    std::array<int, 2> WindowSystem::getFramebufferSize() const
+    {
+        const uint64_t size = m_framebuffer_size.load(std::memory_order_acquire);
+        return {static_cast<int>(size >> 32), static_cast<int>(size & 0xffffffff)};
+    }
+
+    bool WindowSystem::isMinimized() const
+    {
+        const std::array<int, 2> size = getFramebufferSize();
+        return size[0] == 0 || size[1] == 0;
+    }
+
+    void WindowSystem::onFramebufferSize(GLFWwindow* window, int width, int height)
+    {
+        WindowSystem* window_system = static_cast<WindowSystem*>(glfwGetWindowUserPointer(window));
+        if (window_system == nullptr)
+        {
+            return;
+        }
+        const uint64_t size = (static_cast<uint64_t>(static_cast<uint32_t>(width)) << 32) | static_cast<uint32_t>(height);
+        window_system->m_framebuffer_size.store(size, std::memory_order_release);
+    }
 }
\ No newline at end of file
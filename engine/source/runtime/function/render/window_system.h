@@ -4,6 +4,8 @@
 #include <GLFW/glfw3.h>
 
 #include <array>
+#include <atomic>
+#include <cstdint>
 #include <functional>
 #include <vector>
 
@@ -27,10 +29,19 @@ namespace Polaris
         void pollEvents() const;
         bool shouldClose() const;
         GLFWwindow* getWindow() const;
+        std::array<int, 2> getWindowSize() const;
+        // size in pixels, kept up to date by the event loop and safe to read from the render thread
+        std::array<int, 2> getFramebufferSize() const;
+        bool               isMinimized() const;
+
+    private:
+        static void onFramebufferSize(GLFWwindow* window, int width, int height);
 
     private:
         GLFWwindow* m_window{ nullptr };
         int         m_width{ 0 };
         int         m_height{ 0 };
+        // width in the high and height in the low half, so both are read together
+        std::atomic<uint64_t> m_framebuffer_size{ 0 };
     };
 } // namespace Polaris
\ No newline at end of file
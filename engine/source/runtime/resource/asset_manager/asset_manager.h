@@ -2,6 +2,7 @@
 
 #include "runtime/core/base/macro.h"
 #include "runtime/core/meta/serializer/serializer.h"
+#include "runtime/core/profiler/profiler.h"
 
 
 #include <filesystem>
@@ -22,6 +23,8 @@ namespace Polaris
         template<typename AssetType>
         bool loadAsset(const std::string& asset_url, AssetType& out_asset) const
         {
+            PROFILE_SCOPE("AssetManager::loadAsset");
+
             // read json file to string
             std::filesystem::path asset_path = getFullPath(asset_url);
             std::ifstream asset_json_file(asset_path);
@@ -51,6 +54,8 @@ namespace Polaris
         template<typename AssetType>
         bool saveAsset(const AssetType& out_asset, const std::string& asset_url) const
         {
+            PROFILE_SCOPE("AssetManager::saveAsset");
+
             std::ofstream asset_json_file(getFullPath(asset_url));
             if (!asset_json_file)
             {
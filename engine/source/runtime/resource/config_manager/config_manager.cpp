@@ -26,6 +26,70 @@ namespace Polaris
                 {
                     m_default_world_url = value;
                 }
+                else if (name == "LogToStderr")
+                {
+                    m_is_log_to_stderr = std::stoi(value) != 0;
+                }
+                else if (name == "LogicTickRate")
+                {
+                    m_logic_tick_rate = std::stof(value);
+                }
+                else if (name == "MaxLogicStepsPerFrame")
+                {
+                    m_max_logic_steps_per_frame = static_cast<uint32_t>(std::stoul(value));
+                }
+                else if (name == "FrameRateLimit")
+                {
+                    m_frame_rate_limit = std::stof(value);
+                }
+                else if (name == "RenderThread")
+                {
+                    m_is_render_thread_enabled = std::stoi(value) != 0;
+                }
+                else if (name == "OcclusionCulling")
+                {
+                    m_is_occlusion_culling_enabled = std::stoi(value) != 0;
+                }
+                else if (name == "LodScreenError")
+                {
+                    m_lod_screen_error = std::stof(value);
+                }
+                else if (name == "LodTriangleBudget")
+                {
+                    m_lod_triangle_budget = static_cast<uint32_t>(std::stoul(value));
+                }
+                else if (name == "FrameStallThreshold")
+                {
+                    m_frame_stall_threshold = std::stof(value);
+                }
+                else if (name == "FrameStatsFile")
+                {
+                    m_frame_stats_file = m_root_folder / value;
+                }
+                else if (name == "PipelineCacheFile")
+                {
+                    m_pipeline_cache_file = m_root_folder / value;
+                }
+                else if (name == "GpuPipelineStatistics")
+                {
+                    m_is_gpu_pipeline_statistics_enabled = std::stoi(value) != 0;
+                }
+                else if (name == "Headless")
+                {
+                    m_is_headless = std::stoi(value) != 0;
+                }
+                else if (name == "HeadlessTickRate")
+                {
+                    m_headless_tick_rate = std::stof(value);
+                }
+                else if (name == "HeadlessRealtime")
+                {
+                    m_is_headless_realtime = std::stoi(value) != 0;
+                }
+                else if (name == "HeadlessMaxTicks")
+                {
+                    m_headless_max_ticks = std::stoull(value);
+                }
             }
         }
     }
@@ -33,4 +97,36 @@ namespace Polaris
 	const std::filesystem::path& ConfigManager::getRootFolder() const { return m_root_folder; }
 
     const std::string& ConfigManager::getDefaultWorldUrl() const { return m_default_world_url; }
+
+    bool ConfigManager::isLogToStderr() const { return m_is_log_to_stderr; }
+
+    float ConfigManager::getLogicTickRate() const { return m_logic_tick_rate; }
+
+    uint32_t ConfigManager::getMaxLogicStepsPerFrame() const { return m_max_logic_steps_per_frame; }
+
+    float ConfigManager::getFrameRateLimit() const { return m_frame_rate_limit; }
+
+    bool ConfigManager::isRenderThreadEnabled() const { return m_is_render_thread_enabled; }
+
+    bool ConfigManager::isOcclusionCullingEnabled() const { return m_is_occlusion_culling_enabled; }
+
+    float ConfigManager::getLodScreenError() const { return m_lod_screen_error; }
+
+    uint32_t ConfigManager::getLodTriangleBudget() const { return m_lod_triangle_budget; }
+
+    float ConfigManager::getFrameStallThreshold() const { return m_frame_stall_threshold; }
+
+    const std::filesystem::path& ConfigManager::getFrameStatsFile() const { return m_frame_stats_file; }
+
+    const std::filesystem::path& ConfigManager::getPipelineCacheFile() const { return m_pipeline_cache_file; }
+
+    bool ConfigManager::isGpuPipelineStatisticsEnabled() const { return m_is_gpu_pipeline_statistics_enabled; }
+
+    bool ConfigManager::isHeadless() const { return m_is_headless; }
+
+    float ConfigManager::getHeadlessTickRate() const { return m_headless_tick_rate; }
+
+    bool ConfigManager::isHeadlessRealtime() const { return m_is_headless_realtime; }
+
+    uint64_t ConfigManager::getHeadlessMaxTicks() const { return m_headless_max_ticks; }
 } // namespace Polaris
\ No newline at end of file
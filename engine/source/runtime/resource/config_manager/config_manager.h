@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <filesystem>
 
 namespace Polaris
@@ -15,9 +16,70 @@ namespace Polaris
 
         const std::string& getDefaultWorldUrl() const;
 
+        bool isLogToStderr() const;
+
+        float    getLogicTickRate() const;
+        uint32_t getMaxLogicStepsPerFrame() const;
+        float    getFrameRateLimit() const;
+
+        bool isRenderThreadEnabled() const;
+        bool isOcclusionCullingEnabled() const;
+
+        float    getLodScreenError() const;
+        uint32_t getLodTriangleBudget() const;
+
+        float                        getFrameStallThreshold() const;
+        const std::filesystem::path& getFrameStatsFile() const;
+
+        const std::filesystem::path& getPipelineCacheFile() const;
+        bool                         isGpuPipelineStatisticsEnabled() const;
+
+        bool     isHeadless() const;
+        float    getHeadlessTickRate() const;
+        bool     isHeadlessRealtime() const;
+        uint64_t getHeadlessMaxTicks() const;
+
     private:
         std::filesystem::path m_root_folder;
 
         std::string m_default_world_url;
+
+        // console logging on stderr, keeps stdout free for tool output such as benchmark results
+        bool m_is_log_to_stderr {false};
+
+        // fixed logic ticks per second
+        float m_logic_tick_rate {60.f};
+        // a slow frame runs at most this many logic ticks and drops the remaining time
+        uint32_t m_max_logic_steps_per_frame {5};
+        // frames per second the main loop is limited to, 0 leaves it to vsync
+        float m_frame_rate_limit {0.f};
+
+        // render on a dedicated thread that runs one frame behind logic
+        bool m_is_render_thread_enabled {true};
+        // test entities against occluder meshes rasterized on the cpu after frustum culling
+        bool m_is_occlusion_culling_enabled {true};
+        // lods whose projected error stays below this many pixels are drawn
+        float m_lod_screen_error {1.f};
+        // triangles drawn in the camera view before lods get coarser than the error allows, 0 for no limit
+        uint32_t m_lod_triangle_budget {0};
+
+        // frames slower than this many milliseconds are logged, 0 disables the check
+        float m_frame_stall_threshold {0.f};
+        // csv of the recorded frame times written at shutdown, nothing is written when empty
+        std::filesystem::path m_frame_stats_file;
+
+        // driver pipeline cache kept between runs, pipelines are rebuilt from scratch when empty
+        std::filesystem::path m_pipeline_cache_file;
+        // count vertices, primitives and shader invocations of every pass next to its gpu time
+        bool m_is_gpu_pipeline_statistics_enabled {false};
+
+        // run the simulation only, without window and rhi
+        bool m_is_headless {false};
+        // fixed logic ticks per simulated second
+        float m_headless_tick_rate {60.f};
+        // pace ticks to the tick rate instead of running as fast as possible
+        bool m_is_headless_realtime {false};
+        // stop after this many ticks, 0 runs until quit
+        uint64_t m_headless_max_ticks {0};
     };
 } // namespace Polaris
\ No newline at end of file
@@ -0,0 +1,274 @@
+#include "runtime/resource/mesh_cooker/mesh_cooker.h"
+
+#include "runtime/core/base/macro.h"
+#include "runtime/core/math/axis_aligned.h"
+
+#include "runtime/resource/asset_manager/asset_manager.h"
+#include "runtime/resource/res_type/components/mesh.h"
+
+#include <tiny_obj_loader.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <unordered_map>
+
+namespace Polaris
+{
+    namespace
+    {
+        // finest grid tried by the resolution search, cells along the largest axis
+        constexpr uint32_t k_max_cluster_resolution = 1024;
+        // a lod saving less than this share of the triangles of the previous one is not worth keeping
+        constexpr float k_min_lod_reduction = 0.1f;
+    } // namespace
+
+    bool MeshCooker::cookLods(const AssetManager& asset_manager, SubMeshRes& sub_mesh, const MeshCookSettings& settings)
+    {
+        const std::filesystem::path source_path = asset_manager.getFullPath(sub_mesh.m_obj_file_ref);
+
+        CookedMesh source_mesh;
+        if (!loadObj(source_path.generic_string(), source_mesh))
+        {
+            return false;
+        }
+
+        sub_mesh.m_lods.clear();
+
+        const std::filesystem::path source_ref(sub_mesh.m_obj_file_ref);
+        const CookedMesh*           previous_mesh = &source_mesh;
+        std::vector<CookedMesh>     lod_meshes(settings.m_lod_count);
+        for (uint32_t lod_index = 0; lod_index < settings.m_lod_count; ++lod_index)
+        {
+            const uint32_t previous_triangle_count = static_cast<uint32_t>(previous_mesh->m_indices.size() / 3);
+            const uint32_t target_triangle_count =
+                static_cast<uint32_t>(previous_triangle_count * settings.m_triangle_ratio);
+            if (target_triangle_count == 0)
+            {
+                break;
+            }
+
+            // lods are simplified from the full mesh, so the errors do not add up
+            CookedMesh&    lod_mesh       = lod_meshes[lod_index];
+            const float    error          = simplify(source_mesh, target_triangle_count, lod_mesh);
+            const uint32_t triangle_count = static_cast<uint32_t>(lod_mesh.m_indices.size() / 3);
+            if (triangle_count == 0 || triangle_count > previous_triangle_count * (1.f - k_min_lod_reduction))
+            {
+                break;
+            }
+
+            std::filesystem::path lod_ref = source_ref;
+            lod_ref.replace_filename(source_ref.stem().string() + "_lod" + std::to_string(lod_index + 1) +
+                                     source_ref.extension().string());
+            if (!saveObj(asset_manager.getFullPath(lod_ref.generic_string()).generic_string(), lod_mesh))
+            {
+                return false;
+            }
+
+            MeshLodRes lod_res;
+            lod_res.m_obj_file_ref    = lod_ref.generic_string();
+            lod_res.m_geometric_error = error;
+            sub_mesh.m_lods.push_back(std::move(lod_res));
+
+            previous_mesh = &lod_mesh;
+        }
+
+        LOG_INFO("cooked {} lods for mesh {}", sub_mesh.m_lods.size(), sub_mesh.m_obj_file_ref);
+        return true;
+    }
+
+    /*
+    * The triangle count after clustering shrinks as the grid gets coarser, so the finest resolution
+    * meeting the target is found by bisection
+    */
+    float MeshCooker::simplify(const CookedMesh& mesh, uint32_t target_triangle_count, CookedMesh& out_mesh)
+    {
+        if (mesh.m_indices.size() / 3 <= target_triangle_count)
+        {
+            out_mesh = mesh;
+            return 0.f;
+        }
+
+        uint32_t   low_resolution  = 1;
+        uint32_t   high_resolution = k_max_cluster_resolution;
+        CookedMesh candidate_mesh;
+
+        float error = clusterVertices(mesh, low_resolution, out_mesh);
+        while (low_resolution + 1 < high_resolution)
+        {
+            const uint32_t resolution      = (low_resolution + high_resolution) / 2;
+            const float    candidate_error = clusterVertices(mesh, resolution, candidate_mesh);
+            if (candidate_mesh.m_indices.size() / 3 <= target_triangle_count)
+            {
+                low_resolution = resolution;
+                error          = candidate_error;
+                std::swap(out_mesh, candidate_mesh);
+            }
+            else
+            {
+                high_resolution = resolution;
+            }
+        }
+        return error;
+    }
+
+    float MeshCooker::clusterVertices(const CookedMesh& mesh, uint32_t resolution, CookedMesh& out_mesh)
+    {
+        out_mesh.m_positions.clear();
+        out_mesh.m_indices.clear();
+
+        AxisAlignedBox bounds;
+        for (const Vector3& position : mesh.m_positions)
+        {
+            bounds.merge(position);
+        }
+
+        const Vector3& min_corner = bounds.getMinCorner();
+        const Vector3  extent     = bounds.getMaxCorner() - min_corner;
+        const float    cell_size  = std::max({extent.x, extent.y, extent.z, 1e-6f}) / resolution;
+
+        auto cell_coordinate = [cell_size, resolution](float offset) {
+            return static_cast<uint64_t>(std::min(static_cast<float>(resolution - 1), std::floor(offset / cell_size)));
+        };
+
+        // grid cell to cluster index, clusters numbered in order of first use
+        std::unordered_map<uint64_t, uint32_t> cluster_indices;
+        std::vector<uint32_t>                  vertex_clusters(mesh.m_positions.size());
+        std::vector<uint32_t>                  cluster_sizes;
+        for (size_t vertex_index = 0; vertex_index < mesh.m_positions.size(); ++vertex_index)
+        {
+            const Vector3  offset = mesh.m_positions[vertex_index] - min_corner;
+            const uint64_t cell   = cell_coordinate(offset.x) | (cell_coordinate(offset.y) << 20) |
+                                  (cell_coordinate(offset.z) << 40);
+
+            auto inserted = cluster_indices.emplace(cell, static_cast<uint32_t>(out_mesh.m_positions.size()));
+            if (inserted.second)
+            {
+                out_mesh.m_positions.push_back(Vector3::ZERO);
+                cluster_sizes.push_back(0);
+            }
+
+            const uint32_t cluster_index = inserted.first->second;
+            out_mesh.m_positions[cluster_index] += mesh.m_positions[vertex_index];
+            ++cluster_sizes[cluster_index];
+            vertex_clusters[vertex_index] = cluster_index;
+        }
+
+        for (size_t cluster_index = 0; cluster_index < out_mesh.m_positions.size(); ++cluster_index)
+        {
+            out_mesh.m_positions[cluster_index] /= static_cast<float>(cluster_sizes[cluster_index]);
+        }
+
+        float max_squared_error = 0.f;
+        for (size_t vertex_index = 0; vertex_index < mesh.m_positions.size(); ++vertex_index)
+        {
+            max_squared_error = std::max(
+                max_squared_error,
+                (mesh.m_positions[vertex_index] - out_mesh.m_positions[vertex_clusters[vertex_index]]).squaredLength());
+        }
+
+        // triangles collapsed to a line or point are dropped, and so are duplicates, keeping the winding
+        std::vector<std::array<uint32_t, 3>> triangles;
+        triangles.reserve(mesh.m_indices.size() / 3);
+        for (size_t index = 0; index + 2 < mesh.m_indices.size(); index += 3)
+        {
+            std::array<uint32_t, 3> triangle = {vertex_clusters[mesh.m_indices[index]],
+                                                vertex_clusters[mesh.m_indices[index + 1]],
+                                                vertex_clusters[mesh.m_indices[index + 2]]};
+            if (triangle[0] == triangle[1] || triangle[1] == triangle[2] || triangle[0] == triangle[2])
+            {
+                continue;
+            }
+
+            std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+            triangles.push_back(triangle);
+        }
+        std::sort(triangles.begin(), triangles.end());
+        triangles.erase(std::unique(triangles.begin(), triangles.end()), triangles.end());
+
+        out_mesh.m_indices.reserve(triangles.size() * 3);
+        for (const std::array<uint32_t, 3>& triangle : triangles)
+        {
+            out_mesh.m_indices.insert(out_mesh.m_indices.end(), triangle.begin(), triangle.end());
+        }
+        return std::sqrt(max_squared_error);
+    }
+
+    bool MeshCooker::loadObj(const std::string& file_path, CookedMesh& out_mesh)
+    {
+        tinyobj::attrib_t                attrib;
+        std::vector<tinyobj::shape_t>    shapes;
+        std::vector<tinyobj::material_t> materials;
+        std::string                      warning;
+        std::string                      error;
+        if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warning, &error, file_path.c_str()))
+        {
+            LOG_ERROR("load mesh {} failed: {}", file_path, error);
+            return false;
+        }
+
+        out_mesh.m_positions.clear();
+        out_mesh.m_indices.clear();
+        out_mesh.m_positions.reserve(attrib.vertices.size() / 3);
+        for (size_t index = 0; index + 2 < attrib.vertices.size(); index += 3)
+        {
+            out_mesh.m_positions.emplace_back(attrib.vertices[index], attrib.vertices[index + 1], attrib.vertices[index + 2]);
+        }
+
+        // faces are triangulated by the loader
+        for (const tinyobj::shape_t& shape : shapes)
+        {
+            for (const tinyobj::index_t& index : shape.mesh.indices)
+            {
+                out_mesh.m_indices.push_back(static_cast<uint32_t>(index.vertex_index));
+            }
+        }
+        return true;
+    }
+
+    bool MeshCooker::saveObj(const std::string& file_path, const CookedMesh& mesh)
+    {
+        std::ofstream obj_file(file_path);
+        if (!obj_file)
+        {
+            LOG_ERROR("open file {} failed!", file_path);
+            return false;
+        }
+
+        // area weighted, the cross product of two edges is twice the triangle area
+        std::vector<Vector3> normals(mesh.m_positions.size(), Vector3::ZERO);
+        for (size_t index = 0; index + 2 < mesh.m_indices.size(); index += 3)
+        {
+            const Vector3& position0 = mesh.m_positions[mesh.m_indices[index]];
+            const Vector3 face_normal =
+                (mesh.m_positions[mesh.m_indices[index + 1]] - position0).crossProduct(mesh.m_positions[mesh.m_indices[index + 2]] - position0);
+            for (size_t corner = 0; corner < 3; ++corner)
+            {
+                normals[mesh.m_indices[index + corner]] += face_normal;
+            }
+        }
+
+        for (const Vector3& position : mesh.m_positions)
+        {
+            obj_file << "v " << position.x << ' ' << position.y << ' ' << position.z << '\n';
+        }
+        for (Vector3 normal : normals)
+        {
+            normal.normalise();
+            obj_file << "vn " << normal.x << ' ' << normal.y << ' ' << normal.z << '\n';
+        }
+        for (size_t index = 0; index + 2 < mesh.m_indices.size(); index += 3)
+        {
+            obj_file << 'f';
+            for (size_t corner = 0; corner < 3; ++corner)
+            {
+                const uint32_t vertex = mesh.m_indices[index + corner] + 1;
+                obj_file << ' ' << vertex << "//" << vertex;
+            }
+            obj_file << '\n';
+        }
+        return static_cast<bool>(obj_file);
+    }
+} // namespace Polaris
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "runtime/core/math/vector3.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Polaris
+{
+    class AssetManager;
+    class SubMeshRes;
+
+    struct MeshCookSettings
+    {
+        // lods generated after the full mesh, the renderer uses at most three
+        uint32_t m_lod_count {3};
+        // triangle count of each lod relative to the previous one
+        float m_triangle_ratio {0.5f};
+    };
+
+    struct CookedMesh
+    {
+        std::vector<Vector3>  m_positions;
+        std::vector<uint32_t> m_indices;
+    };
+
+    /**
+     *  Offline mesh processing. Lods are made by vertex clustering: vertices falling in the same cell
+     *  of a uniform grid are merged at their average, and the grid resolution is searched for the
+     *  finest one that reaches the target triangle count. The error stored with a lod is the largest
+     *  distance a vertex of the full mesh moved, so it bounds the deviation in mesh space
+     */
+    class MeshCooker
+    {
+    public:
+        /**
+         *  Simplifies the obj file of sub_mesh into coarser meshes written next to it as
+         *  <name>_lod<n>.obj and replaces sub_mesh.m_lods with them. Stops early when the mesh
+         *  can not be reduced further
+         */
+        static bool cookLods(const AssetManager& asset_manager, SubMeshRes& sub_mesh, const MeshCookSettings& settings = {});
+
+        // returns the geometric error of the simplified mesh
+        static float simplify(const CookedMesh& mesh, uint32_t target_triangle_count, CookedMesh& out_mesh);
+
+        static bool loadObj(const std::string& file_path, CookedMesh& out_mesh);
+        // positions and vertex normals averaged from the faces, other attributes are not kept
+        static bool saveObj(const std::string& file_path, const CookedMesh& mesh);
+
+    private:
+        static float clusterVertices(const CookedMesh& mesh, uint32_t resolution, CookedMesh& out_mesh);
+    };
+} // namespace Polaris
@@ -0,0 +1,35 @@
+#include "runtime/resource/mesh_cooker/mesh_lod_cache.h"
+
+#include "runtime/core/base/macro.h"
+
+#include "runtime/resource/mesh_cooker/mesh_cooker.h"
+
+namespace Polaris
+{
+    std::vector<MeshLodRes> MeshLodCache::getLods(const AssetManager& asset_manager, const std::string& obj_file_ref)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto found = m_cooked_lods.find(obj_file_ref);
+        if (found != m_cooked_lods.end())
+        {
+            return found->second;
+        }
+
+        // a failed cook is remembered too, so a broken file is not read again
+        SubMeshRes sub_mesh;
+        sub_mesh.m_obj_file_ref = obj_file_ref;
+        if (!MeshCooker::cookLods(asset_manager, sub_mesh))
+        {
+            LOG_WARN("cook lods of mesh {} failed, it is drawn without lods", obj_file_ref);
+            sub_mesh.m_lods.clear();
+        }
+        return m_cooked_lods.emplace(obj_file_ref, std::move(sub_mesh.m_lods)).first->second;
+    }
+
+    void MeshLodCache::clear()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_cooked_lods.clear();
+    }
+} // namespace Polaris
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "runtime/core/base/public_singleton.h"
+
+#include "runtime/resource/res_type/components/mesh.h"
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Polaris
+{
+    class AssetManager;
+
+    /**
+     *  Lods of meshes imported without any. The first request for an obj file cooks it with
+     *  MeshCooker, writing the lod files next to it, and every later sub mesh referencing the same
+     *  file reuses the result. Safe to call from any thread
+     */
+    class MeshLodCache : public PublicSingleton<MeshLodCache>
+    {
+    public:
+        // empty when the mesh can not be read or reduced
+        std::vector<MeshLodRes> getLods(const AssetManager& asset_manager, const std::string& obj_file_ref);
+        void                    clear();
+
+    private:
+        // cooking holds the lock, so two loads of one mesh never write its lod files at the same time
+        std::mutex                                               m_mutex;
+        std::unordered_map<std::string, std::vector<MeshLodRes>> m_cooked_lods;
+    };
+} // namespace Polaris
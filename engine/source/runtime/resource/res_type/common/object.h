@@ -19,6 +19,17 @@ namespace Polaris
         std::string m_component;
     };
 
+    REFLECTION_TYPE(ComponentDeltaRes)
+    CLASS(ComponentDeltaRes, Fields)
+    {
+        REFLECTION_BODY(ComponentDeltaRes);
+
+    public:
+        std::string m_type_name;
+        // only the fields that differ from the component of the object definition
+        Json        m_component;
+    };
+
     REFLECTION_TYPE(ObjectDefinitionRes)
     CLASS(ObjectDefinitionRes, Fields)
     {
@@ -38,5 +49,6 @@ namespace Polaris
         std::string              m_definition;
 
         std::vector<Reflection::ReflectionPtr<Component>> m_instanced_components;
+        std::vector<ComponentDeltaRes>                    m_instanced_component_deltas;
     };
 } // namespace Polaris
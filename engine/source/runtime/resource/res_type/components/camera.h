@@ -0,0 +1,17 @@
+#pragma once
+#include "runtime/core/meta/reflection/reflection.h"
+
+namespace Polaris
+{
+    REFLECTION_TYPE(CameraComponentRes)
+    CLASS(CameraComponentRes, Fields)
+    {
+        REFLECTION_BODY(CameraComponentRes);
+
+    public:
+        // horizontal field of view in degrees
+        float m_fov_x {89.f};
+        float m_z_near {0.1f};
+        float m_z_far {1000.f};
+    };
+} // namespace Polaris
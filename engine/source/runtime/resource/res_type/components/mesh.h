@@ -4,6 +4,17 @@
 
 namespace Polaris
 {
+    REFLECTION_TYPE(MeshLodRes)
+    CLASS(MeshLodRes, Fields)
+    {
+        REFLECTION_BODY(MeshLodRes);
+
+    public:
+        std::string m_obj_file_ref;
+        // largest distance between a vertex of the full mesh and its simplified position, in mesh space
+        float m_geometric_error {0.f};
+    };
+
     REFLECTION_TYPE(SubMeshRes)
     CLASS(SubMeshRes, Fields)
     {
@@ -13,6 +24,10 @@ namespace Polaris
         std::string m_obj_file_ref;
         Transform   m_transform;
         std::string m_material;
+        // rasterized into the cpu occlusion buffer, meant for large simple meshes like walls
+        bool m_is_occluder {false};
+        // simplified versions of m_obj_file_ref from fine to coarse, written by MeshCooker
+        std::vector<MeshLodRes> m_lods;
     };
 
     REFLECTION_TYPE(MeshComponentRes)
@@ -0,0 +1,135 @@
+#include "runtime/function/render/rhi/vulkan/vulkan_shader_reflection.h"
+
+#include <vulkan/vk_enum_string_helper.h>
+
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using namespace Polaris;
+
+    // layout header of one shader, consumed by VulkanDescriptorLayoutCache and by static_asserts on cpu structs
+    std::string generateLayoutHeader(const VulkanShaderReflection& reflection, const std::string& header_name, const std::string& shader_name)
+    {
+        std::ostringstream out;
+        out << "/**\n * @file " << header_name << "\n * @brief Auto generated file.\n */\n"
+            << "#pragma once\n"
+            << "#include \"runtime/function/render/rhi/vulkan/vulkan_shader_layout.h\"\n\n"
+            << "namespace Polaris::ShaderLayout::" << shader_name << "\n{\n";
+
+        const char* stage = string_VkShaderStageFlagBits(reflection.stage);
+
+        if (!reflection.descriptorBindings.empty())
+        {
+            out << "    inline constexpr VulkanShaderDescriptorBinding k_descriptor_bindings[] = {\n";
+            for (size_t i = 0; i < reflection.descriptorBindings.size(); ++i)
+            {
+                const VulkanShaderDescriptorBinding& binding = reflection.descriptorBindings[i];
+                out << "        {" << binding.set << ", " << binding.binding << ", " << string_VkDescriptorType(binding.descriptorType)
+                    << ", " << binding.descriptorCount << "}, // " << reflection.descriptorNames[i] << "\n";
+            }
+            out << "    };\n";
+        }
+
+        if (!reflection.pushConstantRanges.empty())
+        {
+            out << "    inline constexpr VkPushConstantRange k_push_constant_ranges[] = {\n";
+            for (const VkPushConstantRange& range : reflection.pushConstantRanges)
+            {
+                out << "        {" << stage << ", " << range.offset << ", " << range.size << "},\n";
+            }
+            out << "    };\n";
+        }
+
+        if (!reflection.vertexInputs.empty())
+        {
+            out << "    inline constexpr VulkanShaderVertexInput k_vertex_inputs[] = {\n";
+            for (size_t i = 0; i < reflection.vertexInputs.size(); ++i)
+            {
+                const VulkanShaderVertexInput& input = reflection.vertexInputs[i];
+                out << "        {" << input.location << ", " << string_VkFormat(input.format) << "}, // "
+                    << reflection.vertexInputNames[i] << "\n";
+            }
+            out << "    };\n";
+        }
+
+        const bool has_arrays = !reflection.descriptorBindings.empty() || !reflection.pushConstantRanges.empty() || !reflection.vertexInputs.empty();
+        auto arrayOrNull = [](bool has_items, const char* name) { return has_items ? std::string(name) : std::string("nullptr"); };
+        out << (has_arrays ? "\n" : "") << "    inline constexpr VulkanShaderStageLayout k_stage_layout = {\n"
+            << "        " << stage << ",\n"
+            << "        " << arrayOrNull(!reflection.descriptorBindings.empty(), "k_descriptor_bindings") << ", "
+            << reflection.descriptorBindings.size() << ",\n"
+            << "        " << arrayOrNull(!reflection.pushConstantRanges.empty(), "k_push_constant_ranges") << ", "
+            << reflection.pushConstantRanges.size() << ",\n"
+            << "        " << arrayOrNull(!reflection.vertexInputs.empty(), "k_vertex_inputs") << ", "
+            << reflection.vertexInputs.size() << "};\n";
+
+        // the same block may be bound more than once
+        std::set<std::string> written_blocks;
+        for (const VulkanShaderBlock& block : reflection.blocks)
+        {
+            if (block.name.empty() || !written_blocks.insert(block.name).second)
+            {
+                continue;
+            }
+            out << "\n    struct " << block.name << "\n    {\n"
+                << "        static constexpr uint32_t k_size = " << block.size << ";\n";
+            for (const VulkanShaderBlockMember& member : block.members)
+            {
+                out << "        static constexpr uint32_t " << member.name << "_offset = " << member.offset << ";\n"
+                    << "        static constexpr uint32_t " << member.name << "_size = " << member.size << ";\n";
+            }
+            out << "    };\n";
+        }
+
+        out << "} // namespace Polaris::ShaderLayout::" << shader_name << "\n";
+        return out.str();
+    }
+} // namespace
+
+// PolarisShaderReflect <spirv file> <layout header> <shader name>
+int main(int argc, char** argv)
+{
+    if (argc != 4)
+    {
+        std::cerr << "usage: PolarisShaderReflect <spirv file> <layout header> <shader name>\n";
+        return EXIT_FAILURE;
+    }
+
+    const std::filesystem::path spirv_path  = argv[1];
+    const std::filesystem::path header_path = argv[2];
+    const std::string           shader_name = argv[3];
+
+    std::ifstream spirv_file(spirv_path, std::ios::binary);
+    if (!spirv_file)
+    {
+        std::cerr << "failed to open " << spirv_path.generic_string() << "\n";
+        return EXIT_FAILURE;
+    }
+    const std::vector<unsigned char> code((std::istreambuf_iterator<char>(spirv_file)), std::istreambuf_iterator<char>());
+
+    std::string header;
+    try
+    {
+        const VulkanShaderReflection reflection = VulkanShaderReflection::reflect(code);
+        header = generateLayoutHeader(reflection, header_path.filename().generic_string(), shader_name);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << spirv_path.generic_string() << ": " << e.what() << "\n";
+        return EXIT_FAILURE;
+    }
+
+    std::ofstream header_file(header_path, std::ios::binary | std::ios::trunc);
+    header_file << header;
+    return header_file ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,134 @@
+#include "runtime/core/math/math.h"
+
+#include "runtime/function/render/occlusion_culling.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+
+namespace
+{
+    using namespace Polaris;
+
+    int g_failure_count = 0;
+
+    void check(bool condition, const char* expression, int line)
+    {
+        if (!condition)
+        {
+            std::cerr << "occlusion_culling_test.cpp(" << line << "): check failed: " << expression << '\n';
+            ++g_failure_count;
+        }
+    }
+
+#define CHECK(condition) check((condition), #condition, __LINE__)
+
+    // camera at the origin looking down -z with a 90 degree square view
+    Matrix4x4 makeViewProjection()
+    {
+        return Math::makePerspectiveMatrix(Radian(Math_PI * 0.5f), 1.f, 0.1f, 100.f) *
+               Math::makeViewMatrix(Vector3::ZERO, Quaternion::IDENTITY);
+    }
+
+    OccluderMesh makeQuad(const Vector3& corner0, const Vector3& corner1, const Vector3& corner2, const Vector3& corner3)
+    {
+        OccluderMesh mesh;
+        mesh.m_positions = {corner0, corner1, corner2, corner3};
+        mesh.m_indices   = {0, 1, 2, 0, 2, 3};
+        return mesh;
+    }
+
+    /*
+    * A wall of 10 by 10 units 10 units in front of the camera hides what is straight behind it, but
+    * neither what sticks out at its side nor what stands between it and the camera
+    */
+    void testWallOccluder()
+    {
+        OcclusionCulling occlusion_culling;
+        occlusion_culling.initialize(128, 128);
+        occlusion_culling.beginFrame(makeViewProjection());
+
+        // nothing rasterized yet, nothing can be hidden
+        CHECK(occlusion_culling.isVisible(AxisAlignedBox(Vector3(0.f, 0.f, -20.f), Vector3(1.f, 1.f, 1.f))));
+
+        occlusion_culling.addOccluder(makeQuad(Vector3(-5.f, -5.f, -10.f),
+                                               Vector3(5.f, -5.f, -10.f),
+                                               Vector3(5.f, 5.f, -10.f),
+                                               Vector3(-5.f, 5.f, -10.f)),
+                                      Matrix4x4::IDENTITY);
+        occlusion_culling.rasterize();
+        CHECK(occlusion_culling.getOccluderTriangleCount() == 2);
+
+        // the wall covers x and y within 10 units at this distance
+        CHECK(!occlusion_culling.isVisible(AxisAlignedBox(Vector3(0.f, 0.f, -20.f), Vector3(1.f, 1.f, 1.f))));
+        CHECK(occlusion_culling.isVisible(AxisAlignedBox(Vector3(15.f, 0.f, -20.f), Vector3(1.f, 1.f, 1.f))));
+        CHECK(occlusion_culling.isVisible(AxisAlignedBox(Vector3(0.f, 0.f, -5.f), Vector3(1.f, 1.f, 1.f))));
+        // partly behind the wall is still visible
+        CHECK(occlusion_culling.isVisible(AxisAlignedBox(Vector3(9.f, 0.f, -20.f), Vector3(2.f, 1.f, 1.f))));
+
+        // cullVisibleEntities keeps the order of what stays
+        RenderEntityBounds bounds;
+        bounds.pushBack(AxisAlignedBox(Vector3(0.f, 0.f, -5.f), Vector3(1.f, 1.f, 1.f)));
+        bounds.pushBack(AxisAlignedBox(Vector3(0.f, 0.f, -20.f), Vector3(1.f, 1.f, 1.f)));
+        bounds.pushBack(AxisAlignedBox(Vector3(15.f, 0.f, -20.f), Vector3(1.f, 1.f, 1.f)));
+        std::vector<uint32_t> visible_entities {2, 1, 0};
+        occlusion_culling.cullVisibleEntities(bounds, visible_entities);
+        CHECK((visible_entities == std::vector<uint32_t> {2, 0}));
+
+        // the next frame starts without occluders
+        occlusion_culling.beginFrame(makeViewProjection());
+        occlusion_culling.rasterize();
+        CHECK(occlusion_culling.isVisible(AxisAlignedBox(Vector3(0.f, 0.f, -20.f), Vector3(1.f, 1.f, 1.f))));
+    }
+
+    /*
+    * A floor reaching from behind the camera into the distance. The triangle with two corners behind
+    * the near plane is clipped to one triangle, the one with a single corner behind it to a quad of
+    * two, and triangles completely behind it are dropped
+    */
+    void testNearPlaneClipping()
+    {
+        OcclusionCulling occlusion_culling;
+        occlusion_culling.initialize(128, 128);
+        occlusion_culling.beginFrame(makeViewProjection());
+
+        occlusion_culling.addOccluder(makeQuad(Vector3(-10.f, -2.f, -40.f),
+                                               Vector3(-10.f, -2.f, 5.f),
+                                               Vector3(10.f, -2.f, 5.f),
+                                               Vector3(10.f, -2.f, -40.f)),
+                                      Matrix4x4::IDENTITY);
+        CHECK(occlusion_culling.getOccluderTriangleCount() == 3);
+
+        occlusion_culling.addOccluder(makeQuad(Vector3(-10.f, -2.f, 5.f),
+                                               Vector3(-10.f, -2.f, 1.f),
+                                               Vector3(10.f, -2.f, 1.f),
+                                               Vector3(10.f, -2.f, 5.f)),
+                                      Matrix4x4::IDENTITY);
+        CHECK(occlusion_culling.getOccluderTriangleCount() == 3);
+
+        occlusion_culling.rasterize();
+
+        // projecting the corners behind the camera would have produced depths outside of [0, 1]
+        const std::vector<float>& depth_buffer = occlusion_culling.getDepthBuffer();
+        CHECK(std::all_of(depth_buffer.begin(), depth_buffer.end(), [](float depth) { return depth >= 0.f && depth <= 1.f; }));
+        CHECK(std::any_of(depth_buffer.begin(), depth_buffer.end(), [](float depth) { return depth < 1.f; }));
+
+        CHECK(!occlusion_culling.isVisible(AxisAlignedBox(Vector3(0.f, -4.f, -15.f), Vector3(0.5f, 0.5f, 0.5f))));
+        CHECK(occlusion_culling.isVisible(AxisAlignedBox(Vector3(0.f, 2.f, -15.f), Vector3(0.5f, 0.5f, 0.5f))));
+        // boxes reaching behind the camera are never hidden
+        CHECK(occlusion_culling.isVisible(AxisAlignedBox(Vector3(0.f, -4.f, 0.f), Vector3(1.f, 1.f, 1.f))));
+    }
+} // namespace
+
+int main()
+{
+    testWallOccluder();
+    testNearPlaneClipping();
+
+    if (g_failure_count != 0)
+    {
+        std::cerr << g_failure_count << " checks failed\n";
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,184 @@
+#include "runtime/core/math/math.h"
+
+#include "runtime/function/render/render_culling.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+namespace
+{
+    using namespace Polaris;
+
+    int g_failure_count = 0;
+
+    void check(bool condition, const char* expression, int line)
+    {
+        if (!condition)
+        {
+            std::cerr << "render_culling_test.cpp(" << line << "): check failed: " << expression << '\n';
+            ++g_failure_count;
+        }
+    }
+
+#define CHECK(condition) check((condition), #condition, __LINE__)
+
+    // a camera away from the origin and turned, so no plane normal is axis aligned
+    const Vector3 k_camera_position(3.f, -2.f, 1.f);
+
+    Quaternion makeCameraOrientation()
+    {
+        return Quaternion(Radian(0.7f), Vector3::UNIT_Z) * Quaternion(Radian(0.3f), Vector3::UNIT_X);
+    }
+
+    RenderFrustum makeFrustum()
+    {
+        const Matrix4x4 view_projection = Math::makePerspectiveMatrix(Radian(1.2f), 1.5f, 0.5f, 50.f) *
+                                          Math::makeViewMatrix(k_camera_position, makeCameraOrientation());
+        return RenderFrustum::fromViewProjection(view_projection);
+    }
+
+    float planeDistance(const Vector4& plane, const Vector3& point)
+    {
+        return plane.x * point.x + plane.y * point.y + plane.z * point.z + plane.w;
+    }
+
+    // distance of the corner farthest along the plane normal, the box is outside when it is negative
+    float farthestCornerDistance(const Vector4& plane, const AxisAlignedBox& box)
+    {
+        const Vector3& min_corner = box.getMinCorner();
+        const Vector3& max_corner = box.getMaxCorner();
+        const Vector3  corner(plane.x >= 0.f ? max_corner.x : min_corner.x,
+                             plane.y >= 0.f ? max_corner.y : min_corner.y,
+                             plane.z >= 0.f ? max_corner.z : min_corner.z);
+        return planeDistance(plane, corner);
+    }
+
+    bool isVisibleReference(const RenderFrustum& frustum, const AxisAlignedBox& box)
+    {
+        for (const Vector4& plane : frustum.m_planes)
+        {
+            if (farthestCornerDistance(plane, box) < 0.f)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // boxes whose farthest corner sits almost on a plane could go either way after rounding
+    bool isAmbiguous(const RenderFrustum& frustum, const AxisAlignedBox& box)
+    {
+        for (const Vector4& plane : frustum.m_planes)
+        {
+            if (std::fabs(farthestCornerDistance(plane, box)) < 1e-3f)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::vector<uint32_t> cullReference(const RenderFrustum& frustum, const RenderEntityBounds& bounds)
+    {
+        std::vector<uint32_t> visible;
+        for (uint32_t index = 0; index < bounds.size(); ++index)
+        {
+            if (isVisibleReference(frustum, bounds.get(index)))
+            {
+                visible.push_back(index);
+            }
+        }
+        return visible;
+    }
+
+    /*
+    * Boxes moved across every plane, from completely behind it over straddling it to completely in
+    * front of it. Straddling boxes stay visible, boxes behind any single plane are culled
+    */
+    void testStraddlingBoxes()
+    {
+        const RenderFrustum frustum = makeFrustum();
+        const Vector3       half_extent(1.f, 0.5f, 0.75f);
+
+        // a point 10 units down the view direction, each plane gets a point on its face by projecting it
+        const Vector3 inside_point = k_camera_position + makeCameraOrientation() * Vector3(0.f, 0.f, -10.f);
+        CHECK(isVisibleReference(frustum, AxisAlignedBox(inside_point, half_extent)));
+
+        RenderEntityBounds    bounds;
+        std::vector<uint32_t> expected_visible;
+        for (const Vector4& plane : frustum.m_planes)
+        {
+            const Vector3 normal(plane.x, plane.y, plane.z);
+            const Vector3 on_plane = inside_point - normal * planeDistance(plane, inside_point);
+            const float   radius   = std::fabs(normal.x) * half_extent.x + std::fabs(normal.y) * half_extent.y +
+                                 std::fabs(normal.z) * half_extent.z;
+
+            // offsets along the normal in units of the projected extent, only the first is outside
+            for (float offset : {-1.5f, -0.9f, -0.5f, 0.f, 0.5f, 0.9f, 1.5f})
+            {
+                const AxisAlignedBox box(on_plane + normal * (offset * radius), half_extent);
+                if (offset > -1.f)
+                {
+                    expected_visible.push_back(static_cast<uint32_t>(bounds.size()));
+                }
+                CHECK(isVisibleReference(frustum, box) == (offset > -1.f));
+                bounds.pushBack(box);
+            }
+        }
+
+        std::vector<uint32_t> visible;
+        FrustumCulling::cull(bounds, frustum, visible);
+        CHECK(visible == expected_visible);
+        CHECK(visible == cullReference(frustum, bounds));
+    }
+
+    /*
+    * Random boxes around the frustum, more than the parallel threshold and not a multiple of eight
+    * so the simd loop, the scalar tail and the chunk merge all take part
+    */
+    void testRandomBoxes()
+    {
+        const RenderFrustum frustum = makeFrustum();
+
+        std::mt19937                          random_engine(7);
+        std::uniform_real_distribution<float> position_distribution(-60.f, 60.f);
+        std::uniform_real_distribution<float> extent_distribution(0.01f, 8.f);
+
+        RenderEntityBounds bounds;
+        while (bounds.size() < 50003)
+        {
+            const AxisAlignedBox box(
+                Vector3(position_distribution(random_engine), position_distribution(random_engine), position_distribution(random_engine)),
+                Vector3(extent_distribution(random_engine), extent_distribution(random_engine), extent_distribution(random_engine)));
+            if (!isAmbiguous(frustum, box))
+            {
+                bounds.pushBack(box);
+            }
+        }
+
+        const std::vector<uint32_t> expected_visible = cullReference(frustum, bounds);
+        // the volume should neither swallow nor miss everything
+        CHECK(!expected_visible.empty());
+        CHECK(expected_visible.size() < bounds.size());
+
+        std::vector<uint32_t> visible {1, 2, 3};
+        FrustumCulling::cull(bounds, frustum, visible);
+        CHECK(visible == expected_visible);
+    }
+} // namespace
+
+int main()
+{
+    std::cout << "avx culling " << (FrustumCulling::isAvxSupported() ? "enabled" : "not supported") << '\n';
+
+    testStraddlingBoxes();
+    testRandomBoxes();
+
+    if (g_failure_count != 0)
+    {
+        std::cerr << g_failure_count << " checks failed\n";
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,263 @@
+#include "runtime/core/log/log_system.h"
+#include "runtime/core/math/math.h"
+
+#include "runtime/function/global/global_context.h"
+#include "runtime/function/render/render_culling.h"
+#include "runtime/function/render/render_draw_list.h"
+#include "runtime/function/render/render_resource.h"
+#include "runtime/function/render/render_scene.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+
+namespace
+{
+    using namespace Polaris;
+
+    int g_failure_count = 0;
+
+    void check(bool condition, const char* expression, int line)
+    {
+        if (!condition)
+        {
+            std::cerr << "render_draw_list_test.cpp(" << line << "): check failed: " << expression << '\n';
+            ++g_failure_count;
+        }
+    }
+
+#define CHECK(condition) check((condition), #condition, __LINE__)
+
+    bool isSameOrder(const std::vector<DrawItem>& items, const std::vector<DrawItem>& expected_items)
+    {
+        return std::equal(items.begin(),
+                          items.end(),
+                          expected_items.begin(),
+                          expected_items.end(),
+                          [](const DrawItem& item, const DrawItem& expected_item) {
+                              return item.m_sort_key == expected_item.m_sort_key &&
+                                     item.m_entity_index == expected_item.m_entity_index;
+                          });
+    }
+
+    // sorts a copy of items with the radix sort and with std::stable_sort, the entity index records the input order
+    void checkSort(const std::vector<DrawItem>& items, int line)
+    {
+        std::vector<DrawItem> expected_items = items;
+        std::stable_sort(expected_items.begin(), expected_items.end(), [](const DrawItem& left, const DrawItem& right) {
+            return left.m_sort_key < right.m_sort_key;
+        });
+
+        std::vector<DrawItem> sorted_items = items;
+        std::vector<DrawItem> scratch;
+        DrawList::sortItems(sorted_items, scratch);
+        check(isSameOrder(sorted_items, expected_items), "isSameOrder(sorted_items, expected_items)", line);
+    }
+
+    /*
+    * Keys varying in a few scattered bytes with many duplicates, so some passes are skipped and equal
+    * keys have to keep their input order. The large case goes past the parallel sort threshold
+    */
+    void testSortItems()
+    {
+        std::mt19937 random_engine(3);
+
+        for (size_t item_count : {0u, 1u, 7u, 1000u, 70001u})
+        {
+            std::vector<DrawItem> items(item_count);
+            for (size_t index = 0; index < item_count; ++index)
+            {
+                items[index].m_entity_index = static_cast<uint32_t>(index);
+                items[index].m_sort_key     = (static_cast<uint64_t>(random_engine() % 3) << 60) |
+                                          (static_cast<uint64_t>(random_engine() % 5) << 33) | (random_engine() % 4);
+            }
+            checkSort(items, __LINE__);
+        }
+
+        // all keys equal, nothing moves
+        std::vector<DrawItem> equal_items(100);
+        for (size_t index = 0; index < equal_items.size(); ++index)
+        {
+            equal_items[index].m_entity_index = static_cast<uint32_t>(index);
+            equal_items[index].m_sort_key     = 42;
+        }
+        checkSort(equal_items, __LINE__);
+
+        // full width keys
+        std::vector<DrawItem> wide_items(5000);
+        for (size_t index = 0; index < wide_items.size(); ++index)
+        {
+            wide_items[index].m_entity_index = static_cast<uint32_t>(index);
+            wide_items[index].m_sort_key     = (static_cast<uint64_t>(random_engine()) << 32) | random_engine();
+        }
+        checkSort(wide_items, __LINE__);
+
+        // the fields keep their priority, depth only breaks ties within one mesh
+        const uint64_t near_key = DrawSortKey::make(RenderPassType::opaque, RenderPipelineType::static_mesh, 1, 2, 0.1f);
+        const uint64_t far_key  = DrawSortKey::make(RenderPassType::opaque, RenderPipelineType::static_mesh, 1, 2, 0.9f);
+        CHECK(near_key < far_key);
+        CHECK(far_key < DrawSortKey::make(RenderPassType::opaque, RenderPipelineType::static_mesh, 1, 3, 0.f));
+        CHECK(DrawSortKey::make(RenderPassType::opaque, RenderPipelineType::static_mesh, 9, 9, 1.f) <
+              DrawSortKey::make(RenderPassType::opaque, RenderPipelineType::skinned_mesh, 0, 0, 0.f));
+        CHECK(DrawSortKey::make(RenderPassType::shadow, RenderPipelineType::skinned_mesh, 9, 9, 1.f) <
+              DrawSortKey::make(RenderPassType::opaque, RenderPipelineType::static_mesh, 0, 0, 0.f));
+    }
+
+    GameObjectPartDesc makePart(const std::string& mesh_file, const std::string& material_name)
+    {
+        GameObjectPartDesc part;
+        part.m_mesh_desc.m_mesh_file                   = mesh_file;
+        part.m_material_desc.m_with_texture            = true;
+        part.m_material_desc.m_base_color_texture_file = material_name;
+        part.m_transform_desc.m_transform_matrix       = Matrix4x4::IDENTITY;
+        return part;
+    }
+
+    // one single part object view_depth units in front of a camera at the origin looking down -z
+    void addObject(RenderScene& scene, RenderResource& resource, GObjectID go_id, const GameObjectPartDesc& part, float view_depth)
+    {
+        scene.addObject(GameObjectDesc(go_id, std::vector<GameObjectPartDesc> {part}), resource);
+
+        Transform transform;
+        transform.m_position = Vector3(0.f, 0.f, -view_depth);
+        scene.updateObjectTransform({go_id, transform, transform});
+    }
+
+    RenderView makeView(const RenderScene& scene)
+    {
+        RenderView view;
+        view.m_view_projection_matrix = Math::makePerspectiveMatrix(Radian(1.f), 1.f, 0.1f, 100.f);
+        for (uint32_t entity_index = 0; entity_index < scene.getEntityCount(); ++entity_index)
+        {
+            view.m_visible_entities.push_back(entity_index);
+        }
+        return view;
+    }
+
+    /*
+    * Twelve objects over two materials and three meshes become one batch per pair, each batch holding
+    * consecutive instances ordered front to back
+    */
+    void testBatches()
+    {
+        RenderScene    scene;
+        RenderResource resource;
+        for (uint32_t object_index = 0; object_index < 12; ++object_index)
+        {
+            const GameObjectPartDesc part = makePart("mesh_" + std::to_string((object_index / 2) % 3) + ".obj",
+                                                     "material_" + std::to_string(object_index % 2));
+            // later objects are nearer, the opposite of the entity order
+            addObject(scene, resource, object_index + 1, part, 50.f - object_index);
+        }
+
+        DrawList draw_list;
+        draw_list.build(scene, makeView(scene), RenderPassType::opaque, 100.f);
+
+        const std::vector<DrawItem>&  items   = draw_list.getItems();
+        const std::vector<DrawBatch>& batches = draw_list.getBatches();
+        CHECK(items.size() == 12);
+        CHECK(std::is_sorted(items.begin(), items.end(), [](const DrawItem& left, const DrawItem& right) {
+            return left.m_sort_key < right.m_sort_key;
+        }));
+
+        CHECK(batches.size() == 6);
+        CHECK(draw_list.getPipelineChangeCount() == 1);
+        CHECK(draw_list.getMaterialChangeCount() == 2);
+
+        uint32_t next_instance = 0;
+        for (size_t batch_index = 0; batch_index < batches.size(); ++batch_index)
+        {
+            const DrawBatch& batch = batches[batch_index];
+            CHECK(batch.m_first_instance == next_instance);
+            CHECK(batch.m_instance_count == 2);
+            next_instance += batch.m_instance_count;
+
+            for (uint32_t instance = batch.m_first_instance; instance < next_instance; ++instance)
+            {
+                CHECK(items[instance].m_material_handle == batch.m_material_handle);
+                CHECK(items[instance].m_mesh_handle == batch.m_mesh_handle);
+                // front to back, nearer objects were added later
+                if (instance > batch.m_first_instance)
+                {
+                    CHECK(items[instance].m_entity_index < items[instance - 1].m_entity_index);
+                }
+            }
+
+            // batches are as long as possible
+            if (batch_index > 0)
+            {
+                CHECK(batch.m_material_handle != batches[batch_index - 1].m_material_handle ||
+                      batch.m_mesh_handle != batches[batch_index - 1].m_mesh_handle);
+            }
+        }
+        CHECK(next_instance == items.size());
+
+        // instance data follows the item order
+        const std::vector<RenderInstanceData>& instance_data = draw_list.getInstanceData();
+        CHECK(instance_data.size() == items.size());
+        for (size_t item_index = 0; item_index < items.size() && item_index < instance_data.size(); ++item_index)
+        {
+            const uint32_t entity_index = items[item_index].m_entity_index;
+            CHECK(instance_data[item_index].m_entity_index == entity_index);
+            CHECK(instance_data[item_index].m_model_rows[2][3] == scene.getModelMatrices()[entity_index][2][3]);
+        }
+    }
+
+    /*
+    * Material handles 0 and 65536 share the material bits of the key. Drawn at depths that put the
+    * other material between them, the two draws of material 0 are not adjacent and stay apart
+    */
+    void testBatchesOnlyMergeAdjacentDraws()
+    {
+        RenderScene    scene;
+        RenderResource resource;
+        for (uint32_t material_index = 0; material_index <= (1u << DrawSortKey::k_material_bits); ++material_index)
+        {
+            GameObjectMaterialDesc material_desc;
+            material_desc.m_with_texture            = true;
+            material_desc.m_base_color_texture_file = "material_" + std::to_string(material_index);
+            resource.getOrCreateMaterialHandle(material_desc);
+        }
+
+        const std::string wide_material = "material_" + std::to_string(1u << DrawSortKey::k_material_bits);
+        addObject(scene, resource, 1, makePart("mesh.obj", "material_0"), 10.f);
+        addObject(scene, resource, 2, makePart("mesh.obj", wide_material), 20.f);
+        addObject(scene, resource, 3, makePart("mesh.obj", "material_0"), 30.f);
+        CHECK(scene.getEntities()[1].m_material_handle == (1u << DrawSortKey::k_material_bits));
+
+        DrawList draw_list;
+        draw_list.build(scene, makeView(scene), RenderPassType::opaque, 100.f);
+
+        const std::vector<DrawBatch>& batches = draw_list.getBatches();
+        CHECK(batches.size() == 3);
+        if (batches.size() == 3)
+        {
+            CHECK(batches[0].m_material_handle == 0);
+            CHECK(batches[1].m_material_handle == (1u << DrawSortKey::k_material_bits));
+            CHECK(batches[2].m_material_handle == 0);
+        }
+        CHECK(draw_list.getMaterialChangeCount() == 3);
+    }
+} // namespace
+
+int main()
+{
+    // the mesh files do not exist, their bounds are read as unit boxes with a warning
+    g_runtime_global_context.m_logger_system = std::make_shared<LogSystem>(true);
+
+    testSortItems();
+    testBatches();
+    testBatchesOnlyMergeAdjacentDraws();
+
+    g_runtime_global_context.m_logger_system.reset();
+
+    if (g_failure_count != 0)
+    {
+        std::cerr << g_failure_count << " checks failed\n";
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,253 @@
+#include "runtime/core/log/log_system.h"
+
+#include "runtime/function/global/global_context.h"
+#include "runtime/function/render/render_graph.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+
+namespace
+{
+    using namespace Polaris;
+
+    int g_failure_count = 0;
+
+    void check(bool condition, const char* expression, int line)
+    {
+        if (!condition)
+        {
+            std::cerr << "render_graph_test.cpp(" << line << "): check failed: " << expression << '\n';
+            ++g_failure_count;
+        }
+    }
+
+#define CHECK(condition) check((condition), #condition, __LINE__)
+
+    const RenderGraphImageDesc k_color_desc {256, 256, VK_FORMAT_R8G8B8A8_UNORM};
+
+    RenderGraphResource importBackbuffer(RenderGraph& graph)
+    {
+        return graph.importImage("backbuffer",
+                                 k_color_desc,
+                                 VK_NULL_HANDLE,
+                                 VK_NULL_HANDLE,
+                                 VK_IMAGE_LAYOUT_UNDEFINED,
+                                 VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+                                 VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+    }
+
+    const RenderGraphBarrier* findBarrier(const std::vector<RenderGraphBarrier>& barriers, RenderGraphResource resource)
+    {
+        auto found = std::find_if(barriers.begin(), barriers.end(), [resource](const RenderGraphBarrier& barrier) {
+            return barrier.m_resource == resource;
+        });
+        return found != barriers.end() ? &*found : nullptr;
+    }
+
+    /*
+    * Passes whose writes nobody reads are dropped, and so is a writer whose content a later pass
+    * replaces. Passes writing imported resources or with side effects always stay
+    */
+    void testPassCulling()
+    {
+        RenderGraph               graph;
+        const RenderGraphResource backbuffer = importBackbuffer(graph);
+        const RenderGraphResource scene      = graph.createImage("scene", k_color_desc);
+        const RenderGraphResource debug      = graph.createImage("debug", k_color_desc);
+
+        const RenderGraphPass stale_pass = graph.addPass("stale", {});
+        graph.write(stale_pass, scene, RenderGraphAccess::color_attachment);
+
+        const RenderGraphPass debug_pass = graph.addPass("debug", {});
+        graph.write(debug_pass, debug, RenderGraphAccess::color_attachment);
+
+        const RenderGraphPass scene_pass = graph.addPass("scene", {});
+        graph.write(scene_pass, scene, RenderGraphAccess::color_attachment);
+
+        const RenderGraphPass composite_pass = graph.addPass("composite", {});
+        graph.read(composite_pass, scene, RenderGraphAccess::sampled);
+        graph.write(composite_pass, backbuffer, RenderGraphAccess::color_attachment);
+
+        const RenderGraphPass readback_pass = graph.addPass("readback", {});
+        graph.read(readback_pass, backbuffer, RenderGraphAccess::transfer_source);
+        graph.setSideEffect(readback_pass);
+
+        CHECK(graph.compile());
+
+        CHECK(graph.isPassCulled(stale_pass));
+        CHECK(graph.isPassCulled(debug_pass));
+        CHECK(!graph.isPassCulled(scene_pass));
+        CHECK(!graph.isPassCulled(composite_pass));
+        CHECK(!graph.isPassCulled(readback_pass));
+        CHECK((graph.getExecutionOrder() == std::vector<RenderGraphPass> {scene_pass, composite_pass, readback_pass}));
+
+        CHECK(graph.isResourceUsed(scene));
+        CHECK(!graph.isResourceUsed(debug));
+
+        // an output keeps its writer without any reader
+        graph.markOutput(debug);
+        CHECK(graph.compile());
+        CHECK(!graph.isPassCulled(debug_pass));
+    }
+
+    /*
+    * Layout transitions happen on first use and on every change of access, reads after a write wait
+    * for the writer once, and imported images end in their final layout
+    */
+    void testBarriers()
+    {
+        RenderGraph               graph;
+        const RenderGraphResource backbuffer = importBackbuffer(graph);
+        const RenderGraphResource scene      = graph.createImage("scene", k_color_desc);
+        const RenderGraphResource bloom      = graph.createImage("bloom", k_color_desc);
+
+        const RenderGraphPass scene_pass = graph.addPass("scene", {});
+        graph.write(scene_pass, scene, RenderGraphAccess::color_attachment);
+
+        const RenderGraphPass bloom_pass = graph.addPass("bloom", {});
+        graph.read(bloom_pass, scene, RenderGraphAccess::sampled);
+        graph.write(bloom_pass, bloom, RenderGraphAccess::color_attachment);
+
+        const RenderGraphPass composite_pass = graph.addPass("composite", {});
+        graph.read(composite_pass, scene, RenderGraphAccess::sampled);
+        graph.read(composite_pass, bloom, RenderGraphAccess::sampled);
+        graph.write(composite_pass, backbuffer, RenderGraphAccess::color_attachment);
+
+        CHECK(graph.compile());
+
+        // first use of a transient image discards its content
+        const RenderGraphBarrier* scene_init = findBarrier(graph.getPassBarriers(scene_pass), scene);
+        CHECK(scene_init != nullptr);
+        if (scene_init)
+        {
+            CHECK(scene_init->m_old_layout == VK_IMAGE_LAYOUT_UNDEFINED);
+            CHECK(scene_init->m_new_layout == VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+            CHECK(scene_init->m_src_stages == VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+            CHECK((scene_init->m_dst_access & VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT) != 0);
+        }
+
+        // attachment write to sampled read
+        const RenderGraphBarrier* scene_read = findBarrier(graph.getPassBarriers(bloom_pass), scene);
+        CHECK(scene_read != nullptr);
+        if (scene_read)
+        {
+            CHECK(scene_read->m_old_layout == VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+            CHECK(scene_read->m_new_layout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+            CHECK(scene_read->m_src_stages == VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+            CHECK(scene_read->m_src_access == VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT);
+            CHECK((scene_read->m_dst_access & VK_ACCESS_SHADER_READ_BIT) != 0);
+        }
+
+        // the second read in the same layout is already visible
+        CHECK(findBarrier(graph.getPassBarriers(composite_pass), scene) == nullptr);
+        CHECK(findBarrier(graph.getPassBarriers(composite_pass), bloom) != nullptr);
+
+        // the backbuffer waits for its presentation before it is written
+        const RenderGraphBarrier* backbuffer_write = findBarrier(graph.getPassBarriers(composite_pass), backbuffer);
+        CHECK(backbuffer_write != nullptr);
+        if (backbuffer_write)
+        {
+            CHECK(backbuffer_write->m_src_stages == VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+            CHECK(backbuffer_write->m_new_layout == VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+        }
+
+        const RenderGraphBarrier* backbuffer_present = findBarrier(graph.getFinalBarriers(), backbuffer);
+        CHECK(graph.getFinalBarriers().size() == 1);
+        CHECK(backbuffer_present != nullptr);
+        if (backbuffer_present)
+        {
+            CHECK(backbuffer_present->m_old_layout == VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+            CHECK(backbuffer_present->m_new_layout == VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+            CHECK(backbuffer_present->m_src_access == VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT);
+        }
+
+        // reading a transient resource nobody wrote is an error
+        RenderGraph               invalid_graph;
+        const RenderGraphResource invalid_backbuffer = importBackbuffer(invalid_graph);
+        const RenderGraphResource unwritten          = invalid_graph.createImage("unwritten", k_color_desc);
+        const RenderGraphPass     invalid_pass       = invalid_graph.addPass("invalid", {});
+        invalid_graph.read(invalid_pass, unwritten, RenderGraphAccess::sampled);
+        invalid_graph.write(invalid_pass, invalid_backbuffer, RenderGraphAccess::color_attachment);
+        CHECK(!invalid_graph.compile());
+    }
+
+    /*
+    * A chain of passes each reading the image of the one before, so the first and the third image
+    * are never alive together and share memory, while images and buffers never share a heap
+    */
+    void testTransientAliasing()
+    {
+        RenderGraph               graph;
+        const RenderGraphResource backbuffer = importBackbuffer(graph);
+        const RenderGraphResource images[3]  = {graph.createImage("image0", k_color_desc),
+                                                graph.createImage("image1", k_color_desc),
+                                                graph.createImage("image2", k_color_desc)};
+        const RenderGraphResource buffer     = graph.createBuffer("buffer", {4096});
+
+        RenderGraphPass passes[4];
+        for (uint32_t pass_index = 0; pass_index < 4; ++pass_index)
+        {
+            passes[pass_index] = graph.addPass("pass" + std::to_string(pass_index), {});
+            if (pass_index > 0)
+            {
+                graph.read(passes[pass_index], images[pass_index - 1], RenderGraphAccess::sampled);
+            }
+            graph.write(passes[pass_index], pass_index < 3 ? images[pass_index] : backbuffer, RenderGraphAccess::color_attachment);
+        }
+        graph.write(passes[0], buffer, RenderGraphAccess::storage);
+        graph.read(passes[3], buffer, RenderGraphAccess::storage);
+
+        CHECK(graph.compile());
+
+        CHECK(graph.getResourceHeap(images[0]) == graph.getResourceHeap(images[2]));
+        CHECK(graph.getResourceOffset(images[0]) == graph.getResourceOffset(images[2]));
+        CHECK(graph.getResourceHeap(images[0]) == graph.getResourceHeap(images[1]));
+        CHECK(graph.getResourceOffset(images[0]) != graph.getResourceOffset(images[1]));
+        CHECK(graph.getResourceHeap(buffer) != graph.getResourceHeap(images[0]));
+
+        CHECK(graph.getHeaps().size() == 2);
+        CHECK(graph.getHeapMemorySize() < graph.getUnaliasedMemorySize());
+
+        // the third image waits for the reads of the first before reusing its memory
+        const RenderGraphBarrier* reuse = findBarrier(graph.getPassBarriers(passes[2]), images[2]);
+        CHECK(reuse != nullptr);
+        if (reuse)
+        {
+            CHECK(reuse->m_old_layout == VK_IMAGE_LAYOUT_UNDEFINED);
+            CHECK((reuse->m_src_stages & VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT) != 0);
+        }
+
+        // a memory query overrides the estimate, a resource larger than the others gets its own range
+        CHECK(graph.compile([&graph, &images](RenderGraphResource resource) {
+            RenderGraphMemoryRequirements requirements = RenderGraph::estimateMemoryRequirements(graph, resource);
+            if (resource == images[1])
+            {
+                requirements.m_size *= 4;
+            }
+            return requirements;
+        }));
+        CHECK(graph.getResourceOffset(images[0]) == graph.getResourceOffset(images[2]));
+        CHECK(graph.getResourceOffset(images[1]) == 0);
+    }
+} // namespace
+
+int main()
+{
+    // compile reports invalid graphs through the log
+    g_runtime_global_context.m_logger_system = std::make_shared<LogSystem>(true);
+
+    testPassCulling();
+    testBarriers();
+    testTransientAliasing();
+
+    g_runtime_global_context.m_logger_system.reset();
+
+    if (g_failure_count != 0)
+    {
+        std::cerr << g_failure_count << " checks failed\n";
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,155 @@
+#include "runtime/core/log/log_system.h"
+
+#include "runtime/function/global/global_context.h"
+#include "runtime/function/render/render_lod.h"
+#include "runtime/function/render/render_resource.h"
+#include "runtime/function/render/render_scene.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+
+namespace
+{
+    using namespace Polaris;
+
+    int g_failure_count = 0;
+
+    void check(bool condition, const char* expression, int line)
+    {
+        if (!condition)
+        {
+            std::cerr << "render_lod_test.cpp(" << line << "): check failed: " << expression << '\n';
+            ++g_failure_count;
+        }
+    }
+
+#define CHECK(condition) check((condition), #condition, __LINE__)
+
+    // pixels covered by one unit at distance one, with a one pixel threshold an error of 1 reaches it at distance 100
+    constexpr float k_projection_scale = 100.f;
+
+    // one entity with a lod of mesh space error 1, the mesh files do not exist and read as unit boxes
+    void addLodObject(RenderScene& scene, RenderResource& resource)
+    {
+        GameObjectPartDesc part;
+        part.m_mesh_desc.m_mesh_file             = "mesh.obj";
+        part.m_transform_desc.m_transform_matrix = Matrix4x4::IDENTITY;
+
+        GameObjectMeshLodDesc lod;
+        lod.m_mesh_desc.m_mesh_file = "mesh_lod1.obj";
+        lod.m_geometric_error       = 1.f;
+        part.m_mesh_lods.push_back(lod);
+
+        scene.addObject(GameObjectDesc(1, std::vector<GameObjectPartDesc> {part}), resource);
+    }
+
+    // selects with the camera distance units away from the bounds of entity 0
+    void selectAt(LodSelection& lod_selection, RenderScene& scene, float distance)
+    {
+        const AxisAlignedBox entity_bounds = scene.getWorldBounds().get(0);
+        const Vector3        camera_position =
+            entity_bounds.getCenter() + Vector3(distance + entity_bounds.getHalfExtent().length(), 0.f, 0.f);
+        lod_selection.select(scene, {0}, camera_position, k_projection_scale);
+    }
+
+    /*
+    * The lod switches to the coarse mesh only once its projected error is 20% below the threshold,
+    * and back only once it is 20% above. Between the two the current lod is kept
+    */
+    void testHysteresis()
+    {
+        RenderScene    scene;
+        RenderResource resource;
+        addLodObject(scene, resource);
+
+        LodSelection lod_selection;
+        const RenderEntityLodState& lod_state = scene.getLodStates()[0];
+
+        // 0.91 pixels is below the threshold but not below 0.8
+        selectAt(lod_selection, scene, 110.f);
+        CHECK(lod_state.m_lod == 0);
+
+        // 0.77 pixels
+        selectAt(lod_selection, scene, 130.f);
+        CHECK(lod_state.m_lod == 1);
+
+        // 1.11 pixels is above the threshold but not above 1.2, the coarse lod stays after its fade
+        for (int frame = 0; frame < 10; ++frame)
+        {
+            selectAt(lod_selection, scene, 90.f);
+        }
+        CHECK(lod_state.m_lod == 1);
+
+        // 1.25 pixels
+        selectAt(lod_selection, scene, 80.f);
+        CHECK(lod_state.m_lod == 0);
+    }
+
+    /*
+    * A change of lod fades over 8 frames from the previous one, and a change wanted meanwhile waits
+    * for the running fade. An entity that was not selected last frame switches at once
+    */
+    void testFade()
+    {
+        RenderScene    scene;
+        RenderResource resource;
+        addLodObject(scene, resource);
+
+        LodSelection lod_selection;
+        const RenderEntityLodState& lod_state = scene.getLodStates()[0];
+
+        // first seen, nothing to fade from
+        selectAt(lod_selection, scene, 50.f);
+        CHECK(lod_state.m_lod == 0);
+        CHECK(lod_state.m_fade == 1.f);
+
+        selectAt(lod_selection, scene, 200.f);
+        CHECK(lod_state.m_lod == 1);
+        CHECK(lod_state.m_previous_lod == 0);
+        CHECK(lod_state.m_fade == 0.f);
+
+        for (int frame = 1; frame < 8; ++frame)
+        {
+            // wants lod 0 again, which has to wait for the fade
+            selectAt(lod_selection, scene, 50.f);
+            CHECK(lod_state.m_lod == 1);
+            CHECK(lod_state.m_previous_lod == 0);
+            CHECK(lod_state.m_fade == frame / 8.f);
+        }
+
+        // the eighth frame completes the fade, the next change starts another one
+        selectAt(lod_selection, scene, 200.f);
+        CHECK(lod_state.m_lod == 1);
+        CHECK(lod_state.m_fade == 1.f);
+        selectAt(lod_selection, scene, 50.f);
+        CHECK(lod_state.m_lod == 0);
+        CHECK(lod_state.m_previous_lod == 1);
+        CHECK(lod_state.m_fade == 0.f);
+
+        // not visible for a frame, then back far away
+        lod_selection.select(scene, {}, Vector3::ZERO, k_projection_scale);
+        selectAt(lod_selection, scene, 200.f);
+        CHECK(lod_state.m_lod == 1);
+        CHECK(lod_state.m_previous_lod == 1);
+        CHECK(lod_state.m_fade == 1.f);
+    }
+} // namespace
+
+int main()
+{
+    // the mesh files do not exist, their bounds are read as unit boxes with a warning
+    g_runtime_global_context.m_logger_system = std::make_shared<LogSystem>(true);
+
+    testHysteresis();
+    testFade();
+
+    g_runtime_global_context.m_logger_system.reset();
+
+    if (g_failure_count != 0)
+    {
+        std::cerr << g_failure_count << " checks failed\n";
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
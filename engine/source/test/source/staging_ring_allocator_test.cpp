@@ -0,0 +1,179 @@
+#include "runtime/function/render/rhi/vulkan/vulkan_upload_queue.h"
+
+#include <cstdlib>
+#include <iostream>
+
+namespace
+{
+    using namespace Polaris;
+
+    int g_failure_count = 0;
+
+    void check(bool condition, const char* expression, int line)
+    {
+        if (!condition)
+        {
+            std::cerr << "staging_ring_allocator_test.cpp(" << line << "): check failed: " << expression << '\n';
+            ++g_failure_count;
+        }
+    }
+
+#define CHECK(condition) check((condition), #condition, __LINE__)
+
+    constexpr VkDeviceSize k_capacity = 1024;
+
+    /*
+    * Offsets are aligned and the padding in front of an allocation counts as used until it is released
+    */
+    void testAlignment()
+    {
+        StagingRingAllocator ring(k_capacity);
+        VkDeviceSize         offset = ~0ull;
+
+        CHECK(ring.allocate(100, 1, 1, offset));
+        CHECK(offset == 0);
+        CHECK(ring.allocate(50, 64, 1, offset));
+        CHECK(offset == 128);
+        CHECK(ring.getUsedSize() == 178);
+
+        ring.release(1);
+        CHECK(ring.getUsedSize() == 0);
+        // an empty ring starts over at the front
+        CHECK(ring.allocate(8, 16, 2, offset));
+        CHECK(offset == 0);
+    }
+
+    /*
+    * An allocation that does not fit before the end goes to the front once enough of the front was
+    * released, the skipped tail is used until that allocation comes back
+    */
+    void testWrapAround()
+    {
+        StagingRingAllocator ring(k_capacity);
+        VkDeviceSize         offset = ~0ull;
+
+        CHECK(ring.allocate(400, 1, 1, offset));
+        CHECK(ring.allocate(400, 1, 2, offset));
+        CHECK(offset == 400);
+
+        // nothing released yet, the front is still in flight
+        CHECK(!ring.allocate(300, 1, 3, offset));
+
+        ring.release(1);
+        CHECK(ring.getUsedSize() == 400);
+        CHECK(ring.allocate(300, 1, 3, offset));
+        CHECK(offset == 0);
+        // 224 bytes of tail skipped plus the allocation itself
+        CHECK(ring.getUsedSize() == 400 + 224 + 300);
+
+        // the head is now behind the tail and may not run into the second allocation
+        CHECK(!ring.allocate(200, 1, 4, offset));
+        ring.release(2);
+        CHECK(ring.getUsedSize() == 524);
+        CHECK(ring.allocate(200, 1, 4, offset));
+        CHECK(offset == 300);
+
+        // releases happen in order and only up to the completed value
+        ring.release(3);
+        CHECK(ring.getUsedSize() == 200);
+        ring.release(3);
+        CHECK(ring.getUsedSize() == 200);
+        ring.release(10);
+        CHECK(ring.getUsedSize() == 0);
+    }
+
+    /*
+    * A full ring refuses everything until its allocations complete, and nothing larger than the ring
+    * is ever accepted
+    */
+    void testFullRing()
+    {
+        StagingRingAllocator ring(k_capacity);
+        VkDeviceSize         offset = ~0ull;
+
+        CHECK(!ring.allocate(k_capacity + 1, 1, 1, offset));
+
+        CHECK(ring.allocate(k_capacity, 1, 1, offset));
+        CHECK(offset == 0);
+        CHECK(ring.getUsedSize() == k_capacity);
+        CHECK(!ring.allocate(1, 1, 2, offset));
+
+        ring.release(0);
+        CHECK(!ring.allocate(1, 1, 2, offset));
+        ring.release(1);
+        CHECK(ring.getUsedSize() == 0);
+
+        // filled in pieces the head meets the tail exactly
+        for (uint64_t timeline_value = 2; timeline_value < 6; ++timeline_value)
+        {
+            CHECK(ring.allocate(k_capacity / 4, 1, timeline_value, offset));
+            CHECK(offset == (timeline_value - 2) * (k_capacity / 4));
+        }
+        CHECK(ring.getUsedSize() == k_capacity);
+        CHECK(!ring.allocate(1, 1, 6, offset));
+
+        // freeing the first quarter makes room for exactly that much
+        ring.release(2);
+        CHECK(!ring.allocate(k_capacity / 4 + 1, 1, 6, offset));
+        CHECK(ring.allocate(k_capacity / 4, 1, 6, offset));
+        CHECK(offset == 0);
+        CHECK(ring.getUsedSize() == k_capacity);
+    }
+
+    /*
+    * Alignment near the end of the ring: padding that pushes the allocation past the end wraps it and
+    * the bytes up to the end are consumed, padding that lands exactly on the end does not wrap
+    */
+    void testAlignmentPaddingAtRingEnd()
+    {
+        VkDeviceSize offset = ~0ull;
+
+        StagingRingAllocator ring(k_capacity);
+        CHECK(ring.allocate(100, 1, 1, offset));
+        CHECK(ring.allocate(900, 1, 2, offset));
+        ring.release(1);
+
+        // 1000 aligned to 64 is the end of the ring, so it goes to the front
+        CHECK(ring.allocate(64, 64, 3, offset));
+        CHECK(offset == 0);
+        CHECK(ring.getUsedSize() == 900 + 24 + 64);
+
+        // the freed front is only 100 bytes
+        CHECK(!ring.allocate(64, 64, 4, offset));
+
+        ring.release(2);
+        CHECK(ring.getUsedSize() == 88);
+        ring.release(3);
+        CHECK(ring.getUsedSize() == 0);
+
+        StagingRingAllocator exact_ring(k_capacity);
+        CHECK(exact_ring.allocate(100, 1, 1, offset));
+        CHECK(exact_ring.allocate(900, 1, 2, offset));
+        exact_ring.release(1);
+
+        // 1000 is already aligned to 8 and the allocation ends right at the end of the ring
+        CHECK(exact_ring.allocate(24, 8, 3, offset));
+        CHECK(offset == 1000);
+        CHECK(exact_ring.getUsedSize() == 924);
+        // the head is back at the front and fills up to the tail
+        CHECK(exact_ring.allocate(100, 1, 4, offset));
+        CHECK(offset == 0);
+        CHECK(exact_ring.getUsedSize() == k_capacity);
+        CHECK(!exact_ring.allocate(1, 1, 5, offset));
+    }
+} // namespace
+
+int main()
+{
+    testAlignment();
+    testWrapAround();
+    testFullRing();
+    testAlignmentPaddingAtRingEnd();
+
+    if (g_failure_count != 0)
+    {
+        std::cerr << g_failure_count << " checks failed\n";
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}